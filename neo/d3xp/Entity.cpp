@@ -492,6 +492,10 @@ idEntity::idEntity():
 	
 	snapshotsReceived = 0;
 	
+	trackSnapshotFields = false;
+	snapshotDirty	= SNAPFIELD_ALL;
+	snapshotGUIState = 0;
+	
 	memset( PVSAreas, 0, sizeof( PVSAreas ) );
 	numPVSAreas		= -1;
 	
@@ -1109,6 +1113,8 @@ void idEntity::BecomeActive( int flags )
 {
 	if( ( flags & TH_PHYSICS ) )
 	{
+		SetSnapshotDirty( SNAPFIELD_PHYSICS );
+		
 		// enable the team master if this entity is part of a physics team
 		if( teamMaster && teamMaster != this )
 		{
@@ -1477,6 +1483,7 @@ void idEntity::UpdateVisuals()
 {
 	UpdateModel();
 	UpdateSound();
+	SetSnapshotDirty( SNAPFIELD_VISUALS );
 }
 
 /*
@@ -2137,6 +2144,7 @@ void idEntity::FinishBind()
 
 	// set the master on the physics object
 	physics->SetMaster( bindMaster, flags );
+	SetSnapshotDirty( SNAPFIELD_BIND | SNAPFIELD_PHYSICS );
 	
 	// We are now separated from our previous team and are either
 	// an individual, or have a team of our own.  Now we can join
@@ -2317,6 +2325,7 @@ void idEntity::Unbind()
 	{
 		physics->SetMaster( NULL, BFL_NONE );
 	}
+	SetSnapshotDirty( SNAPFIELD_BIND | SNAPFIELD_PHYSICS );
 	
 	// We're still part of a team, so that means I have to extricate myself
 	// and any entities that are bound to me from the old team.
@@ -3053,6 +3062,7 @@ bool idEntity::RunPhysics()
 		
 			// run physics
 			moved = part->physics->Evaluate( GetPhysicsTimeStep(), endTime );
+			part->SetSnapshotDirty( SNAPFIELD_PHYSICS );
 			
 			// check if the object is blocked
 			blockingEntity = part->physics->GetBlockingEntity();
@@ -6180,6 +6190,50 @@ void idEntity::FlagNewSnapshot()
 	}
 }
 
+/*
+================
+idEntity::TrackSnapshotFields
+
+Lets idGameLocal::ServerWriteSnapshot re-use the last written state while no replicated field is dirty.
+================
+*/
+void idEntity::TrackSnapshotFields( bool track )
+{
+	trackSnapshotFields = track;
+	snapshotDirty = SNAPFIELD_ALL;
+}
+
+/*
+================
+idEntity::GetSnapshotDirty
+================
+*/
+int idEntity::GetSnapshotDirty() const
+{
+	int dirty = snapshotDirty;
+	
+	// gui scripts change the network state without the entity knowing
+	if( renderEntity.gui[ 0 ] != NULL && renderEntity.gui[ 0 ]->State().GetInt( "networkState" ) != snapshotGUIState )
+	{
+		dirty |= SNAPFIELD_GUI;
+	}
+	
+	return dirty;
+}
+
+/*
+================
+idEntity::ClearSnapshotDirty
+
+Called after WriteToSnapshot.
+================
+*/
+void idEntity::ClearSnapshotDirty()
+{
+	snapshotDirty = 0;
+	snapshotGUIState = ( renderEntity.gui[ 0 ] != NULL ) ? renderEntity.gui[ 0 ]->State().GetInt( "networkState" ) : 0;
+}
+
 /*
 ================
 idEntity::ServerSendEvent
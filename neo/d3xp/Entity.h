@@ -525,10 +525,29 @@ public:
 	void					DecayOriginAndAxisDelta();
 
 	uint32_t					GetPredictedKey() { return predictionKey; }
-	void					SetPredictedKey( uint32_t key_ ) { predictionKey = key_; }
+	void					SetPredictedKey( uint32_t key_ ) { predictionKey = key_; SetSnapshotDirty( SNAPFIELD_ALL ); }
 	
 	void					FlagNewSnapshot();
 	
+	// Replicated fields for the opt-in change tracking of WriteToSnapshot. An entity that tracks its fields
+	// keeps the state it last wrote to a snapshot until one of them is marked dirty, so a class that turns
+	// tracking on has to mark SNAPFIELD_STATE whenever anything else it writes changes.
+	enum
+	{
+		SNAPFIELD_PHYSICS	= 1 << 0,	// marked when the physics runs or is activated
+		SNAPFIELD_BIND		= 1 << 1,	// marked on bind and unbind
+		SNAPFIELD_VISUALS	= 1 << 2,	// color, shader parms and hidden, marked by UpdateVisuals
+		SNAPFIELD_GUI		= 1 << 3,	// gui network state, compared when the snapshot is written
+		SNAPFIELD_STATE		= 1 << 4,	// class specific fields
+		SNAPFIELD_ALL		= -1
+	};
+	
+	void					TrackSnapshotFields( bool track );
+	bool					IsTrackingSnapshotFields() const { return trackSnapshotFields; }
+	void					SetSnapshotDirty( int fields ) { snapshotDirty |= fields; }
+	int						GetSnapshotDirty() const;
+	void					ClearSnapshotDirty();
+	
 	idEntity*				GetTeamChain()
 	{
 		return teamChain;
@@ -587,6 +606,10 @@ private:
 	
 	interpolationBehavior_t	interpolationBehavior;
 	unsigned int			snapshotsReceived;	
+	
+	bool					trackSnapshotFields;				// WriteToSnapshot is skipped while no field is dirty
+	int						snapshotDirty;						// SNAPFIELD_* bits changed since the last snapshot write
+	int						snapshotGUIState;					// gui network state at the last snapshot write
 private:
 	void					FixupLocalizedStrings();
 	
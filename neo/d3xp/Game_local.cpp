@@ -1627,6 +1627,9 @@ void idGameLocal::MapClear( bool clearClients )
 	
 	delete[] locationEntities;
 	locationEntities = NULL;
+	
+	snapshotFieldCache.Clear();
+	lagCompensation.Clear();
 }
 
 /*
@@ -2767,6 +2770,7 @@ void idGameLocal::RunFrame( idUserCmdMgr& cmdMgr, gameReturn_t& ret )
 		// do multiplayer related stuff
 		if( common->IsMultiplayer() )
 		{
+			lagCompensation.Record( serverTime );
 			mpGame.Run();
 		}
 		
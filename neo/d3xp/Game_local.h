@@ -97,6 +97,7 @@ void gameError( const char* fmt, ... );
 #include "physics/Push.h"
 
 #include "Pvs.h"
+#include "LagCompensation.h"
 #include "Leaderboards.h"
 #include "MultiplayerGame.h"
 
@@ -330,6 +331,7 @@ public:
 	idClip					clip;					// collision detection
 	idPush					push;					// geometric pushing
 	idPVS					pvs;					// potential visible set
+	idLagCompensation		lagCompensation;		// recent player hit boxes for checking hits in the past
 	
 	idTestModel* 			testmodel;				// for development testing of models
 	idEntityFx* 			testFx;					// for development testing of fx
@@ -716,6 +718,8 @@ private:
 	idArray< int, MAX_PLAYERS >	lastCmdRunTimeOnClient;
 	idArray< int, MAX_PLAYERS >	lastCmdRunTimeOnServer;
 	
+	idSnapShot				snapshotFieldCache;				// last written states of the entities that track their snapshot fields
+	
 	void					Clear();
 	// returns true if the entity shouldn't be spawned at all in this game type or difficulty level
 	bool					InhibitEntitySpawn( idDict& spawnArgs );
@@ -747,6 +751,7 @@ private:
 	void					NetworkEventWarning( const entityNetEvent_t* event, VERIFY_FORMAT_STRING const char* fmt, ... );
 	void					ServerProcessEntityNetworkEventQueue();
 	void					ClientProcessEntityNetworkEventQueue();
+	uint8_t					GetSnapshotPriority( idEntity* ent, idPlayer* viewer, const pvsHandle_t& viewerPVS ) const;
 	// call after any change to serverInfo. Will update various quick-access flags
 	void					UpdateServerInfoFlags();
 	void					RandomizeInitialSpawns();
@@ -392,9 +392,11 @@ void idGameLocal::ServerWriteSnapshot( idSnapShot& ss )
 	
 	// Build PVS data for each player and write their player state to the snapshot as well
 	pvsHandle_t pvsHandles[ MAX_PLAYERS ];
+	idPlayer* viewers[ MAX_PLAYERS ];
 	for( int i = 0; i < MAX_PLAYERS; i++ )
 	{
 		idPlayer* player = static_cast<idPlayer*>( entities[ i ] );
+		viewers[i] = NULL;
 		if( player == NULL )
 		{
 			pvsHandles[i].i = -1;
@@ -405,6 +407,7 @@ void idGameLocal::ServerWriteSnapshot( idSnapShot& ss )
 		{
 			spectated = static_cast< idPlayer* >( entities[ player->spectator ] );
 		}
+		viewers[i] = spectated;
 		
 		msg.InitWrite( buffer, sizeof( buffer ) );
 		spectated->WritePlayerStateToSnapshot( msg );
@@ -432,6 +435,19 @@ void idGameLocal::ServerWriteSnapshot( idSnapShot& ss )
 		pvs.FreeCurrentPVS( portalSkyPVS );
 	}
 	
+	// Snapshot priorities are per lobby peer (visIndex - 1), find the client each peer plays
+	int peerClients[ idSnapShot::MAX_PRIORITY_PEERS ];
+	for( int p = 0; p < idSnapShot::MAX_PRIORITY_PEERS; p++ )
+	{
+		peerClients[p] = MapPeerToClient( p );
+		if( peerClients[p] < 0 || peerClients[p] >= MAX_PLAYERS || viewers[ peerClients[p] ] == NULL )
+		{
+			peerClients[p] = -1;
+		}
+	}
+	
+	const bool trackFields = net_snapTrackFields.GetBool();
+	
 	// Add all entities to the snapshot
 	for( idEntity* ent = spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() )
 	{
@@ -440,20 +456,50 @@ void idGameLocal::ServerWriteSnapshot( idSnapShot& ss )
 			continue;
 		}
 		
-		msg.InitWrite( buffer, sizeof( buffer ) );
-		msg.WriteBits( spawnIds[ ent->entityNumber ], 32 - GENTITYNUM_BITS );
-		msg.WriteBits( ent->GetType()->typeNum, idClass::GetTypeNumBits() );
-		msg.WriteBits( ServerRemapDecl( -1, DECL_ENTITYDEF, ent->entityDefNumber ), entityDefBits );
+		const int objectNum = SNAP_ENTITIES + ent->entityNumber;
+		idSnapShot::objectState_t* state = NULL;
 		
-		msg.WriteBits( ent->GetPredictedKey(), 32 );
+		// entities that track their replicated fields share the state they last wrote until one of them is dirty
+		if( trackFields && ent->IsTrackingSnapshotFields() && ent->GetSnapshotDirty() == 0 )
+		{
+			idSnapShot::objectState_t* cached = snapshotFieldCache.FindObjectByID( objectNum );
+			if( cached != NULL && cached->buffer.NumRefs() < idSnapShot::objectBuffer_t::MAX_REFS && ss.CopyObject( snapshotFieldCache, objectNum ) )
+			{
+				state = ss.FindObjectByID( objectNum );
+			}
+		}
 		
-		if( ent->fl.networkSync )
+		if( state == NULL )
 		{
-			// write the class specific data to the snapshot
-			ent->WriteToSnapshot( msg );
+			msg.InitWrite( buffer, sizeof( buffer ) );
+			msg.WriteBits( spawnIds[ ent->entityNumber ], 32 - GENTITYNUM_BITS );
+			msg.WriteBits( ent->GetType()->typeNum, idClass::GetTypeNumBits() );
+			msg.WriteBits( ServerRemapDecl( -1, DECL_ENTITYDEF, ent->entityDefNumber ), entityDefBits );
+			
+			msg.WriteBits( ent->GetPredictedKey(), 32 );
+			
+			if( ent->fl.networkSync )
+			{
+				// write the class specific data to the snapshot
+				ent->WriteToSnapshot( msg );
+			}
+			
+			state = ss.S_AddObject( objectNum, ~0U, msg, ent->GetName() );
+			
+			if( ent->IsTrackingSnapshotFields() )
+			{
+				snapshotFieldCache.CopyObject( ss, objectNum );
+				ent->ClearSnapshotDirty();
+			}
 		}
 		
-		ss.S_AddObject( SNAP_ENTITIES + ent->entityNumber, ~0U, msg, ent->GetName() );
+		for( int p = 0; p < idSnapShot::MAX_PRIORITY_PEERS; p++ )
+		{
+			if( peerClients[p] >= 0 )
+			{
+				state->priority[p] = GetSnapshotPriority( ent, viewers[ peerClients[p] ], pvsHandles[ peerClients[p] ] );
+			}
+		}
 	}
 	
 	// Free PVS handles for all the players
@@ -467,6 +513,34 @@ void idGameLocal::ServerWriteSnapshot( idSnapShot& ss )
 	}
 }
 
+/*
+================
+idGameLocal::GetSnapshotPriority
+
+How fast an entity should build up snapshot priority for a viewer, see idSnapshotProcessor::PrioritizePendingSnap.
+Whatever the viewer is or carries is always sent, everything else ramps down with distance and when it's out of the PVS.
+================
+*/
+uint8_t idGameLocal::GetSnapshotPriority( idEntity* ent, idPlayer* viewer, const pvsHandle_t& viewerPVS ) const
+{
+	if( ent == viewer || ent->GetBindMaster() == viewer || ent->entityNumber < MAX_CLIENTS )
+	{
+		return idSnapShot::PRIORITY_ALWAYS;
+	}
+	
+	const float distance = ( ent->GetPhysics()->GetOrigin() - viewer->GetPhysics()->GetOrigin() ).LengthFast();
+	float scale = 1.0f - distance / Max( net_snapPriorityDistance.GetFloat(), 1.0f );
+	
+	if( viewerPVS.i < 0 || !pvs.InCurrentPVS( viewerPVS, ent->GetPVSAreas(), ent->GetNumPVSAreas() ) )
+	{
+		scale *= net_snapPriorityHidden.GetFloat();
+	}
+	
+	scale = idMath::ClampFloat( 0.0f, 1.0f, scale );
+	
+	return ( uint8_t )( 1 + idMath::Ftoi( scale * ( idSnapShot::PRIORITY_ALWAYS - 2 ) ) );
+}
+
 /*
 ================
 idGameLocal::NetworkEventWarning
@@ -690,7 +764,24 @@ void idGameLocal::ServerProcessReliableMessage( int clientNum, int type, const i
 			idVec3 targetLocation = victim.GetRenderEntity()->origin + victim.GetRenderEntity()->joints[location].ToVec3() * victim.GetRenderEntity()->axis;
 			
 			trace_t tr;
-			gameLocal.clip.Translation( tr, muzzleOrigin, targetLocation, NULL, mat3_identity, MASK_SHOT_RENDERMODEL, &attacker );
+			
+			// check the hit against where the victim was when the attacker fired
+			const int rewindTime = gameLocal.lagCompensation.GetRewindTime( attacker.usercmd.serverGameMilliseconds );
+			idVec3 rewindOrigin;
+			idMat3 rewindAxis;
+			idBounds rewindBounds;
+			if( rewindTime < gameLocal.GetServerGameTimeMs() && victimNum < MAX_CLIENTS && victim.GetCombatModel() != NULL &&
+					gameLocal.lagCompensation.GetPlayerState( victimNum, rewindTime, rewindOrigin, rewindAxis, rewindBounds ) )
+			{
+				// the render entity and the combat model share the same transform
+				const idVec3 jointOffset = ( targetLocation - victim.GetCombatModel()->GetOrigin() ) * victim.GetCombatModel()->GetAxis().Transpose();
+				targetLocation = rewindOrigin + jointOffset * rewindAxis;
+				gameLocal.lagCompensation.TracePoint( tr, muzzleOrigin, targetLocation, MASK_SHOT_RENDERMODEL, &attacker, rewindTime );
+			}
+			else
+			{
+				gameLocal.clip.Translation( tr, muzzleOrigin, targetLocation, NULL, mat3_identity, MASK_SHOT_RENDERMODEL, &attacker );
+			}
 			
 			idEntity* hitEnt = gameLocal.entities[ tr.c.entityNum ];
 			if( hitEnt != &victim )
@@ -0,0 +1,358 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+Copyright (C) 2014-2016 Robert Beckebans
+Copyright (C) 2014-2016 Kot in Action Creative Artel
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "Game_local.h"
+
+idCVar g_lagCompensation( "g_lagCompensation", "1", CVAR_GAME | CVAR_BOOL, "rewind the players to the time the shooter saw them when the server checks a hit" );
+idCVar g_lagCompensationMaxMs( "g_lagCompensationMaxMs", "300", CVAR_GAME | CVAR_INTEGER, "how many milliseconds the server is willing to rewind the players", 0, 1000 );
+idCVar g_debugLagCompensation( "g_debugLagCompensation", "0", CVAR_GAME | CVAR_BOOL, "draw the rewound and current bounds of the players a compensated trace is checked against" );
+
+// a player that moves further than this between two frames has teleported and his history is restarted
+static const float LAG_COMPENSATION_TELEPORT_DISTANCE = 256.0f;
+
+/*
+========================
+idLagCompensation::idLagCompensation
+========================
+*/
+idLagCompensation::idLagCompensation()
+{
+	Clear();
+}
+
+/*
+========================
+idLagCompensation::Clear
+========================
+*/
+void idLagCompensation::Clear()
+{
+	for( int i = 0; i < MAX_CLIENTS; i++ )
+	{
+		ClearPlayer( i );
+	}
+	lastRecordTime = -1;
+}
+
+/*
+========================
+idLagCompensation::ClearPlayer
+========================
+*/
+void idLagCompensation::ClearPlayer( int clientNum )
+{
+	assert( clientNum >= 0 && clientNum < MAX_CLIENTS );
+	history[clientNum].head = 0;
+	history[clientNum].count = 0;
+}
+
+/*
+========================
+idLagCompensation::Record
+========================
+*/
+void idLagCompensation::Record( int time )
+{
+	if( time == lastRecordTime )
+	{
+		return;
+	}
+	lastRecordTime = time;
+	
+	for( int i = 0; i < MAX_CLIENTS; i++ )
+	{
+		idEntity* ent = gameLocal.entities[i];
+		if( ent == NULL || !ent->IsType( idPlayer::Type ) )
+		{
+			ClearPlayer( i );
+			continue;
+		}
+		
+		idPlayer* player = static_cast< idPlayer* >( ent );
+		const idClipModel* combatModel = player->GetCombatModel();
+		if( player->spectating || player->health <= 0 || combatModel == NULL || !combatModel->IsLinked() )
+		{
+			ClearPlayer( i );
+			continue;
+		}
+		
+		history_t& h = history[i];
+		
+		if( h.count > 0 )
+		{
+			const sample_t& last = GetSample( h, 0 );
+			if( time < last.time || ( combatModel->GetOrigin() - last.origin ).LengthSqr() > Square( LAG_COMPENSATION_TELEPORT_DISTANCE ) )
+			{
+				// never interpolate across a teleport or a time reset
+				ClearPlayer( i );
+			}
+		}
+		
+		sample_t& sample = h.samples[h.head];
+		sample.time = time;
+		sample.origin = combatModel->GetOrigin();
+		sample.axis = combatModel->GetAxis();
+		sample.absBounds = combatModel->GetAbsBounds();
+		
+		h.head = ( h.head + 1 ) & ( HISTORY_SIZE - 1 );
+		if( h.count < HISTORY_SIZE )
+		{
+			h.count++;
+		}
+	}
+}
+
+/*
+========================
+idLagCompensation::FindSamples
+
+Finds the two samples around the given time. The samples are in time order
+so this is a binary search on the age of the sample.
+========================
+*/
+bool idLagCompensation::FindSamples( const history_t& h, int time, const sample_t*& from, const sample_t*& to, float& lerp ) const
+{
+	if( h.count == 0 )
+	{
+		return false;
+	}
+	
+	lerp = 0.0f;
+	
+	const sample_t& newest = GetSample( h, 0 );
+	if( time >= newest.time )
+	{
+		from = to = &newest;
+		return true;
+	}
+	
+	const sample_t& oldest = GetSample( h, h.count - 1 );
+	if( time <= oldest.time )
+	{
+		from = to = &oldest;
+		return true;
+	}
+	
+	// find the youngest sample that is not newer than the time
+	int lo = 1;
+	int hi = h.count - 1;
+	while( lo < hi )
+	{
+		const int mid = ( lo + hi ) >> 1;
+		if( GetSample( h, mid ).time <= time )
+		{
+			hi = mid;
+		}
+		else
+		{
+			lo = mid + 1;
+		}
+	}
+	
+	from = &GetSample( h, lo );
+	to = &GetSample( h, lo - 1 );
+	lerp = ( float )( time - from->time ) / ( float )( to->time - from->time );
+	return true;
+}
+
+/*
+========================
+idLagCompensation::GetPlayerState
+========================
+*/
+bool idLagCompensation::GetPlayerState( int clientNum, int time, idVec3& origin, idMat3& axis, idBounds& absBounds ) const
+{
+	if( clientNum < 0 || clientNum >= MAX_CLIENTS )
+	{
+		return false;
+	}
+	
+	const sample_t* from;
+	const sample_t* to;
+	float lerp;
+	if( !FindSamples( history[clientNum], time, from, to, lerp ) )
+	{
+		return false;
+	}
+	
+	if( from == to )
+	{
+		origin = from->origin;
+		axis = from->axis;
+		absBounds = from->absBounds;
+		return true;
+	}
+	
+	origin.Lerp( from->origin, to->origin, lerp );
+	
+	idQuat q;
+	q.Slerp( from->axis.ToQuat(), to->axis.ToQuat(), lerp );
+	axis = q.ToMat3();
+	
+	// the union of both samples is cheap and always contains the interpolated model
+	absBounds = from->absBounds;
+	absBounds.AddBounds( to->absBounds );
+	return true;
+}
+
+/*
+========================
+idLagCompensation::GetRewindTime
+========================
+*/
+int idLagCompensation::GetRewindTime( int clientTime ) const
+{
+	const int serverTime = gameLocal.GetServerGameTimeMs();
+	if( !g_lagCompensation.GetBool() )
+	{
+		return serverTime;
+	}
+	return idMath::ClampInt( serverTime - g_lagCompensationMaxMs.GetInteger(), serverTime, clientTime );
+}
+
+/*
+========================
+idLagCompensation::TracePoint
+
+The render models can only be traced where they are now, so instead of moving
+the players back the ray is moved into the space of each player's current
+transform.
+========================
+*/
+void idLagCompensation::TracePoint( trace_t& results, const idVec3& start, const idVec3& end, int contentMask, const idEntity* passEntity, int time )
+{
+	struct candidate_t
+	{
+		idPlayer* 		player;
+		idClipModel* 	combatModel;
+		idVec3			origin;
+		idMat3			axis;
+	};
+	candidate_t candidates[MAX_CLIENTS];
+	int numCandidates = 0;
+	
+	// only the players close to the ray at either time are rewound
+	for( int i = 0; i < MAX_CLIENTS; i++ )
+	{
+		idEntity* ent = gameLocal.entities[i];
+		if( ent == NULL || ent == passEntity || !ent->IsType( idPlayer::Type ) )
+		{
+			continue;
+		}
+		
+		idPlayer* player = static_cast< idPlayer* >( ent );
+		idClipModel* combatModel = player->GetCombatModel();
+		if( combatModel == NULL || !combatModel->IsLinked() || !( combatModel->GetContents() & contentMask ) )
+		{
+			continue;
+		}
+		
+		idVec3 origin;
+		idMat3 axis;
+		idBounds absBounds;
+		if( !GetPlayerState( i, time, origin, axis, absBounds ) )
+		{
+			continue;
+		}
+		
+		if( g_debugLagCompensation.GetBool() )
+		{
+			gameRenderWorld->DebugBounds( colorYellow, absBounds, vec3_origin, 5000 );
+			gameRenderWorld->DebugBounds( colorRed, combatModel->GetAbsBounds(), vec3_origin, 5000 );
+		}
+		
+		if( !absBounds.LineIntersection( start, end ) && !combatModel->GetAbsBounds().LineIntersection( start, end ) )
+		{
+			continue;
+		}
+		
+		candidate_t& c = candidates[numCandidates++];
+		c.player = player;
+		c.combatModel = combatModel;
+		c.origin = origin;
+		c.axis = axis;
+	}
+	
+	if( numCandidates == 0 )
+	{
+		gameLocal.clip.TracePoint( results, start, end, contentMask, passEntity );
+		return;
+	}
+	
+	// trace the world without the candidates
+	for( int i = 0; i < numCandidates; i++ )
+	{
+		candidates[i].combatModel->Unlink();
+	}
+	gameLocal.clip.TracePoint( results, start, end, contentMask, passEntity );
+	for( int i = 0; i < numCandidates; i++ )
+	{
+		candidates[i].combatModel->Link( gameLocal.clip );
+	}
+	
+	for( int i = 0; i < numCandidates; i++ )
+	{
+		const candidate_t& c = candidates[i];
+		const idVec3& curOrigin = c.combatModel->GetOrigin();
+		const idMat3& curAxis = c.combatModel->GetAxis();
+		const idMat3 rewindTranspose = c.axis.Transpose();
+		
+		const idVec3 localStart = curOrigin + ( ( start - c.origin ) * rewindTranspose ) * curAxis;
+		const idVec3 localEnd = curOrigin + ( ( end - c.origin ) * rewindTranspose ) * curAxis;
+		
+		modelTrace_t modelTrace;
+		if( !gameRenderWorld->ModelTrace( modelTrace, c.player->GetModelDefHandle(), localStart, localEnd, 0.0f ) )
+		{
+			continue;
+		}
+		
+		if( modelTrace.fraction >= results.fraction )
+		{
+			continue;
+		}
+		
+		// same as idClip::TraceRenderModel but moved back to the rewound transform
+		results.fraction = modelTrace.fraction;
+		results.endpos = start + modelTrace.fraction * ( end - start );
+		results.endAxis = mat3_identity;
+		results.c.normal = ( modelTrace.normal * curAxis.Transpose() ) * c.axis;
+		results.c.dist = results.endpos * results.c.normal;
+		results.c.point = results.endpos;
+		results.c.type = CONTACT_TRMVERTEX;
+		results.c.modelFeature = 0;
+		results.c.trmFeature = 0;
+		results.c.contents = modelTrace.material->GetContentFlags();
+		results.c.material = modelTrace.material;
+		results.c.entityNum = c.player->entityNumber;
+		results.c.id = JOINT_HANDLE_TO_CLIPMODEL_ID( modelTrace.jointNumber );
+	}
+}
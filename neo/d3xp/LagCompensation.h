@@ -0,0 +1,100 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+Copyright (C) 2014-2016 Robert Beckebans
+Copyright (C) 2014-2016 Kot in Action Creative Artel
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#ifndef __GAME_LAGCOMPENSATION_H__
+#define __GAME_LAGCOMPENSATION_H__
+
+/*
+===============================================================================
+
+	Lag compensation
+
+	The server keeps a short history of where the hit boxes (combat models)
+	of all players were, so a shot can be checked against the positions the
+	shooter saw when he fired instead of where the players are by the time the
+	shot reaches the server.
+
+	Every player has a fixed size ring of samples indexed by server game time.
+	A rewound trace only moves the players whose rewound or current bounds
+	touch the ray, everything else is traced as it is now. Only the transform
+	of a player is rewound, the animation is the current one.
+
+===============================================================================
+*/
+
+class idLagCompensation
+{
+public:
+	static const int		HISTORY_SIZE = 64;		// must be a power of 2, a bit over a second of server frames
+	
+	idLagCompensation();
+	
+	void					Clear();
+	void					ClearPlayer( int clientNum );
+	
+	// records the combat models of all players, called once per server frame
+	void					Record( int time );
+	
+	// gets the transform and bounds of the player's combat model at the given time
+	bool					GetPlayerState( int clientNum, int time, idVec3& origin, idMat3& axis, idBounds& absBounds ) const;
+	
+	// traces a point against the players as they were at the given time and the rest of the world as it is now
+	void					TracePoint( trace_t& results, const idVec3& start, const idVec3& end, int contentMask, const idEntity* passEntity, int time );
+	
+	// clamps a time the client saw to how far back the server is willing to rewind
+	int						GetRewindTime( int clientTime ) const;
+	
+private:
+	struct sample_t
+	{
+		int					time;
+		idVec3				origin;
+		idMat3				axis;
+		idBounds			absBounds;
+	};
+	
+	struct history_t
+	{
+		sample_t			samples[HISTORY_SIZE];
+		int					head;					// next sample to write
+		int					count;
+	};
+	
+	const sample_t& 		GetSample( const history_t& history, int age ) const
+	{
+		return history.samples[( history.head - 1 - age ) & ( HISTORY_SIZE - 1 )];
+	}
+	
+	bool					FindSamples( const history_t& history, int time, const sample_t*& from, const sample_t*& to, float& lerp ) const;
+	
+	history_t				history[MAX_CLIENTS];
+	int						lastRecordTime;
+};
+
+#endif /* !__GAME_LAGCOMPENSATION_H__ */
@@ -188,6 +188,9 @@ void idMoveable::Spawn()
 	
 	allowStep = spawnArgs.GetBool( "allowStep", "1" );
 	
+	// only the rigid body is replicated, and it doesn't change while at rest
+	TrackSnapshotFields( true );
+	
 	PostEventMS( &EV_SetOwnerFromSpawnArgs, 0 );
 }
 
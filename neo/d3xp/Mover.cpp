@@ -404,6 +404,8 @@ void idMover::Spawn()
 	
 	moving = false;	// ########################### SR
 	
+	// physics, move and rotation stage only change while moving
+	TrackSnapshotFields( true );
 }
 
 /*
@@ -832,6 +834,8 @@ void idMover::Event_UpdateMove()
 			break;
 		}
 	}
+	
+	SetSnapshotDirty( SNAPFIELD_STATE );
 }
 
 /*
@@ -924,6 +928,7 @@ void idMover::BeginMove( idThread* thread )
 	move.movetime		= move_time - at - dt;
 	move.deceleration	= dt;
 	move.dir			= move_delta;
+	SetSnapshotDirty( SNAPFIELD_STATE );
 	
 	ProcessEvent( &EV_ReachedPos );
 }
@@ -1078,6 +1083,8 @@ void idMover::Event_UpdateRotation()
 			break;
 		}
 	}
+	
+	SetSnapshotDirty( SNAPFIELD_STATE );
 }
 
 /*
@@ -1157,6 +1164,7 @@ void idMover::BeginRotation( idThread* thread, bool stopwhendone )
 	rot.movetime		= move_time - at - dt;
 	rot.deceleration	= dt;
 	rot.rot				= angle_delta;
+	SetSnapshotDirty( SNAPFIELD_STATE );
 	
 	ProcessEvent( &EV_ReachedAng );
 }
@@ -1357,6 +1365,7 @@ void idMover::Event_MoveAccelerateTo( float speed, float time )
 	move.acceleration	= at;
 	move.movetime		= 0;
 	move.deceleration	= 0;
+	SetSnapshotDirty( SNAPFIELD_STATE );
 	
 	StartSound( "snd_accel", SND_CHANNEL_BODY2, 0, false, NULL );
 	StartSound( "snd_move", SND_CHANNEL_BODY, 0, false, NULL );
@@ -1404,6 +1413,7 @@ void idMover::Event_MoveDecelerateTo( float speed, float time )
 	move.acceleration	= 0;
 	move.movetime		= 0;
 	move.deceleration	= dt;
+	SetSnapshotDirty( SNAPFIELD_STATE );
 	
 	StartSound( "snd_decel", SND_CHANNEL_BODY2, 0, false, NULL );
 	StartSound( "snd_move", SND_CHANNEL_BODY, 0, false, NULL );
@@ -1675,6 +1685,7 @@ void idMover::Event_StartSpline( idEntity* splineEntity )
 	move.acceleration	= acceltime;
 	move.movetime		= move_time;
 	move.deceleration	= deceltime;
+	SetSnapshotDirty( SNAPFIELD_STATE );
 	
 	spline->MakeUniform( move_time );
 	spline->ShiftTime( gameLocal.slow.time - spline->GetTime( 0 ) );
@@ -2754,6 +2765,9 @@ void idMover_Binary::Spawn()
 			FindGuiTargets();
 		}
 	}
+	
+	// physics and mover state only change while moving
+	TrackSnapshotFields( true );
 }
 
 /*
@@ -2867,6 +2881,7 @@ void idMover_Binary::SetMoverState( moverState_t newstate, int time )
 	
 	moverState = newstate;
 	move_thread = 0;
+	SetSnapshotDirty( SNAPFIELD_STATE );
 	
 	UpdateMoverSound( newstate );
 	
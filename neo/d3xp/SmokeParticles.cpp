@@ -395,7 +395,8 @@ bool idSmokeParticles::UpdateRenderEntity( renderEntity_s* renderEntity, const r
 			tri->bounds[1][1] =
 				tri->bounds[1][2] = 99999;
 				
-		tri->numVerts = 0;
+		// the batch keeps its memory for the next stage and frame
+		particleBatch.Alloc( count, true );
 		for( last = NULL, smoke = active->smokes; smoke; smoke = next )
 		{
 			next = smoke->next;
@@ -432,13 +433,11 @@ bool idSmokeParticles::UpdateRenderEntity( renderEntity_s* renderEntity, const r
 			g.origin = smoke->origin;
 			g.axis = smoke->axis;
 			
-			g.originalRandom = g.random;
-			g.age = g.frac * stage->particleLife;
-			
-			tri->numVerts += stage->CreateParticle( &g, tri->verts + tri->numVerts );
+			particleBatch.Append( g );
 			
 			last = smoke;
 		}
+		tri->numVerts = stage->CreateParticles( &g, particleBatch, tri->verts );
 		if( tri->numVerts > quads * 4 )
 		{
 			gameLocal.Error( "idSmokeParticles::UpdateRenderEntity: miscounted verts" );
@@ -96,6 +96,7 @@ private:
 	singleSmoke_t				smokes[MAX_SMOKE_PARTICLES];
 	
 	idList<activeSmokeStage_t, TAG_PARTICLE>	activeStages;
+	idParticleBatch								particleBatch;
 	singleSmoke_t* 				freeSmokes;
 	int							numActiveSmokes;
 	int							currentParticleTime;	// don't need to recalculate if == view time
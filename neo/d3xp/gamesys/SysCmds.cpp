@@ -1635,6 +1635,185 @@ static void Cmd_ListAnims_f( const idCmdArgs& args )
 	}
 }
 
+static const int BENCH_SKINNING_FRAMES		= 8;
+static const int BENCH_SKINNING_ITERATIONS	= 64;
+static const int BENCH_SKINNING_MAX_WEIGHTS	= 4;
+
+struct skinningBench_t
+{
+	int						numModels;
+	int64_t					numVerts;
+	uint64_t				microSec[2];			// serial, parallel
+};
+
+/*
+==================
+BenchSkinningModel
+
+Instantiates the model on the CPU for a set of frames sampled across the anim,
+once with the skinning on the calling thread and once split across the job
+threads. Results are accumulated by the largest joint-weight count of the mesh.
+==================
+*/
+static bool BenchSkinningModel( idRenderModel* model, const idMD5Anim* anim, skinningBench_t bench[BENCH_SKINNING_MAX_WEIGHTS] )
+{
+	if( model == NULL || model->IsDefaultModel() || model->NumJoints() == 0 || anim == NULL || anim->NumJoints() != model->NumJoints() )
+	{
+		return false;
+	}
+	
+	const int numJoints = model->NumJoints();
+	const int frameJoints = SIMD_ROUND_JOINTS( numJoints );
+	idJointMat* frames = ( idJointMat* )Mem_Alloc16( BENCH_SKINNING_FRAMES * frameJoints * sizeof( idJointMat ), TAG_JOINTMAT );
+	for( int i = 0; i < BENCH_SKINNING_FRAMES; i++ )
+	{
+		idJointMat* frame = frames + i * frameJoints;
+		gameEdit->ANIM_CreateAnimFrame( model, anim, numJoints, frame, anim->Length() * i / BENCH_SKINNING_FRAMES, vec3_origin, true );
+		SIMD_INIT_LAST_JOINT( frame, numJoints );
+	}
+	
+	renderEntity_t ent;
+	memset( &ent, 0, sizeof( ent ) );
+	ent.bounds.Clear();
+	ent.numJoints = numJoints;
+	ent.joints = frames;
+	
+	idRenderModel* snapshot = model->InstantiateDynamicModel( &ent, NULL, NULL );
+	if( snapshot == NULL )
+	{
+		Mem_Free16( frames );
+		return false;
+	}
+	
+	// the CPU skinned snapshot keeps the joint indexes and weights of the base verts
+	int numVerts = 0;
+	int maxWeights = 1;
+	for( int i = 0; i < snapshot->NumSurfaces(); i++ )
+	{
+		const srfTriangles_t* tri = snapshot->Surface( i )->geometry;
+		if( tri == NULL || tri->verts == NULL )
+		{
+			continue;
+		}
+		numVerts += tri->numVerts;
+		for( int j = 0; j < tri->numVerts; j++ )
+		{
+			const byte* weights = tri->verts[j].color2;
+			const int numWeights = ( weights[0] != 0 ) + ( weights[1] != 0 ) + ( weights[2] != 0 ) + ( weights[3] != 0 );
+			maxWeights = Max( maxWeights, numWeights );
+		}
+	}
+	
+	uint64_t microSec[2];
+	for( int pass = 0; pass < 2; pass++ )
+	{
+		cvarSystem->SetCVarBool( "r_useParallelSkinning", pass != 0 );
+		
+		const uint64_t start = Sys_Microseconds();
+		for( int i = 0; i < BENCH_SKINNING_ITERATIONS; i++ )
+		{
+			ent.joints = frames + ( i % BENCH_SKINNING_FRAMES ) * frameJoints;
+			snapshot = model->InstantiateDynamicModel( &ent, NULL, snapshot );
+		}
+		microSec[pass] = Max<uint64_t>( Sys_Microseconds() - start, 1 );
+	}
+	
+	delete snapshot;
+	Mem_Free16( frames );
+	
+	const double skinnedVerts = ( double )numVerts * BENCH_SKINNING_ITERATIONS;
+	gameLocal.Printf( "%-48s %6d verts %d weights %8.2f %8.2f Mverts/sec\n", model->Name(), numVerts, maxWeights,
+					  skinnedVerts / microSec[0], skinnedVerts / microSec[1] );
+					  
+	skinningBench_t& b = bench[maxWeights - 1];
+	b.numModels++;
+	b.numVerts += ( int64_t )numVerts * BENCH_SKINNING_ITERATIONS;
+	b.microSec[0] += microSec[0];
+	b.microSec[1] += microSec[1];
+	
+	return true;
+}
+
+/*
+==================
+Cmd_BenchSkinning_f
+
+benchSkinning [modelDef | md5mesh md5anim]
+
+Measures the CPU skinning rate of md5 meshes posed by their anims, without any
+GPU involvement. With no arguments every modelDef is measured with its first anim.
+==================
+*/
+static void Cmd_BenchSkinning_f( const idCmdArgs& args )
+{
+	skinningBench_t bench[BENCH_SKINNING_MAX_WEIGHTS];
+	memset( bench, 0, sizeof( bench ) );
+	
+	const bool gpuSkinning = cvarSystem->GetCVarBool( "r_useGPUSkinning" );
+	const bool parallelSkinning = cvarSystem->GetCVarBool( "r_useParallelSkinning" );
+	cvarSystem->SetCVarBool( "r_useGPUSkinning", false );
+	
+	gameLocal.Printf( "model, verts, max weights per vert, serial and parallel Mverts/sec\n" );
+	
+	if( args.Argc() > 2 )
+	{
+		idRenderModel* model = renderModelManager->FindModel( args.Argv( 1 ) );
+		const idMD5Anim* anim = animationLib.GetAnim( args.Argv( 2 ) );
+		if( !BenchSkinningModel( model, anim, bench ) )
+		{
+			gameLocal.Printf( "couldn't pose '%s' with '%s'\n", args.Argv( 1 ), args.Argv( 2 ) );
+		}
+	}
+	else
+	{
+		idList<const idRenderModel*> measured;
+		
+		const int numDecls = ( args.Argc() > 1 ) ? 1 : declManager->GetNumDecls( DECL_MODELDEF );
+		for( int i = 0; i < numDecls; i++ )
+		{
+			const idDeclModelDef* modelDef;
+			if( args.Argc() > 1 )
+			{
+				modelDef = static_cast<const idDeclModelDef*>( declManager->FindType( DECL_MODELDEF, args.Argv( 1 ), false ) );
+				if( modelDef == NULL )
+				{
+					gameLocal.Printf( "modelDef '%s' not found\n", args.Argv( 1 ) );
+					break;
+				}
+			}
+			else
+			{
+				modelDef = static_cast<const idDeclModelDef*>( declManager->DeclByIndex( DECL_MODELDEF, i, true ) );
+			}
+			
+			idRenderModel* model = modelDef->ModelHandle();
+			const idAnim* anim = modelDef->GetAnim( 1 );
+			if( model == NULL || anim == NULL || measured.FindIndex( model ) >= 0 )
+			{
+				continue;
+			}
+			measured.Append( model );
+			
+			BenchSkinningModel( model, anim->MD5Anim( 0 ), bench );
+		}
+	}
+	
+	cvarSystem->SetCVarBool( "r_useGPUSkinning", gpuSkinning );
+	cvarSystem->SetCVarBool( "r_useParallelSkinning", parallelSkinning );
+	
+	gameLocal.Printf( "----------------\n" );
+	for( int i = 0; i < BENCH_SKINNING_MAX_WEIGHTS; i++ )
+	{
+		const skinningBench_t& b = bench[i];
+		if( b.numModels == 0 )
+		{
+			continue;
+		}
+		gameLocal.Printf( "%d weights: %3d models %8.2f %8.2f Mverts/sec\n", i + 1, b.numModels,
+						  ( double )b.numVerts / b.microSec[0], ( double )b.numVerts / b.microSec[1] );
+	}
+}
+
 /*
 ==================
 Cmd_AASStats_f
@@ -2719,6 +2898,7 @@ void idGameLocal::InitConsoleCommands()
 	cmdSystem->AddCommand( "collisionModelInfo",	Cmd_CollisionModelInfo_f,	CMD_FL_GAME,				"shows collision model info" );
 	cmdSystem->AddCommand( "reloadanims",			Cmd_ReloadAnims_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"reloads animations" );
 	cmdSystem->AddCommand( "listAnims",				Cmd_ListAnims_f,			CMD_FL_GAME,				"lists all animations" );
+	cmdSystem->AddCommand( "benchSkinning",			Cmd_BenchSkinning_f,		CMD_FL_GAME,				"measures the CPU skinning rate of md5 meshes posed by their anims", idCmdSystem::ArgCompletion_Decl<DECL_MODELDEF> );
 	cmdSystem->AddCommand( "aasStats",				Cmd_AASStats_f,				CMD_FL_GAME,				"shows AAS stats" );
 	cmdSystem->AddCommand( "testDamage",			Cmd_TestDamage_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"tests a damage def", idCmdSystem::ArgCompletion_Decl<DECL_ENTITYDEF> );
 	cmdSystem->AddCommand( "weaponSplat",			Cmd_WeaponSplat_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"projects a blood splat on the player weapon" );
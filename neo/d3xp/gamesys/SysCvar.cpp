@@ -338,6 +338,9 @@ idCVar g_gameReviewPause(			"g_gameReviewPause",		"10",			CVAR_GAME | CVAR_NETWO
 idCVar g_CTFArrows(					"g_CTFArrows",				"1",			CVAR_GAME | CVAR_NETWORKSYNC | CVAR_BOOL, "draw arrows over teammates in CTF" );
 
 idCVar net_clientPredictGUI(		"net_clientPredictGUI",		"1",			CVAR_GAME | CVAR_BOOL, "test guis in networking without prediction" );
+idCVar net_snapPriorityDistance(	"net_snapPriorityDistance",	"4096",			CVAR_GAME | CVAR_FLOAT, "distance at which entities get the lowest snapshot priority" );
+idCVar net_snapPriorityHidden(		"net_snapPriorityHidden",	"0.25",			CVAR_GAME | CVAR_FLOAT, "snapshot priority scale of entities outside of the viewer's PVS", 0.0f, 1.0f );
+idCVar net_snapTrackFields(		"net_snapTrackFields",		"1",			CVAR_GAME | CVAR_BOOL, "re-use the last snapshot state of entities that track their replicated fields while none of them changed" );
 
 idCVar g_grabberHoldSeconds(		"g_grabberHoldSeconds",		"3",			CVAR_GAME | CVAR_FLOAT | CVAR_CHEAT, "number of seconds to hold object" );
 idCVar g_grabberEnableShake(		"g_grabberEnableShake",		"1",			CVAR_GAME | CVAR_BOOL | CVAR_CHEAT, "enable the grabber shake" );
@@ -270,6 +270,9 @@ extern idCVar	aas_goalArea;
 extern idCVar	aas_showPushIntoArea;
 
 extern idCVar	net_clientPredictGUI;
+extern idCVar	net_snapPriorityDistance;
+extern idCVar	net_snapPriorityHidden;
+extern idCVar	net_snapTrackFields;
 
 extern idCVar	si_timeLimit;
 extern idCVar	si_fragLimit;
@@ -1401,6 +1401,9 @@ void idCommonLocal::Init( int argc, const char* const* argv, const char* cmdline
 		// init the console so we can take prints
 		console->Init();
 		
+		// the video system needs to know about the null GL driver before it loads the GL library
+		StartupVariable( "r_glDriver" );
+		
 		// get architecture info
 		Sys_Init();
 		
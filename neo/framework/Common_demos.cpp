@@ -144,6 +144,26 @@ void idCommonLocal::StopRecordingRenderDemo()
 	com_smp.SetInteger(1); // motorsep 12-30-2014; turn multithreading back on
 }
 
+/*
+================
+idCommonLocal::WriteRenderDemoKeyframe
+
+Starts a new demo block between two frames with everything needed to start playing from there
+================
+*/
+void idCommonLocal::WriteRenderDemoKeyframe()
+{
+	if( !writeDemo )
+	{
+		return;
+	}
+	
+	writeDemo->BeginKeyframe();
+	
+	soundWorld->StartWritingDemo( writeDemo );
+	renderWorld->WriteDemoKeyframe();
+}
+
 /*
 ================
 idCommonLocal::StopPlayingRenderDemo
@@ -192,6 +212,35 @@ void idCommonLocal::StopPlayingRenderDemo()
 	com_smp.SetInteger(1); // motorsep 12-30-2014; turn multithreading back on
 }
 
+/*
+================
+idCommonLocal::SeekRenderDemo
+
+Jumps to the last keyframe before the time in milliseconds from the start of the demo
+================
+*/
+void idCommonLocal::SeekRenderDemo( int time )
+{
+	if( !readDemo )
+	{
+		common->Printf( "idCommonLocal::SeekRenderDemo: not playing a demo\n" );
+		return;
+	}
+	
+	const int keyframeTime = readDemo->SeekToKeyframe( time );
+	if( keyframeTime < 0 )
+	{
+		common->Printf( "%s has no keyframes to seek to\n", readDemo->GetName() );
+		return;
+	}
+	
+	soundWorld->StopAllSounds();
+	
+	AdvanceRenderDemo( true );
+	
+	common->Printf( "seeked to %1.1f of %1.1f seconds\n", keyframeTime * 0.001f, readDemo->GetLastKeyframeTime() * 0.001f );
+}
+
 /*
 ================
 idCommonLocal::DemoShot
@@ -458,14 +507,7 @@ void idCommonLocal::CompressDemoFile( const char* scheme, const char* demoName )
 	common->SetRefreshOnPrint( true );
 	common->Printf( "Compressing %s to %s...\n", fullDemoName.c_str(), compressedName.c_str() );
 	
-	static const int bufferSize = 65535;
-	char buffer[bufferSize];
-	int bytesRead;
-	while( 0 != ( bytesRead = demoread.Read( buffer, bufferSize ) ) )
-	{
-		demowrite.Write( buffer, bytesRead );
-		common->Printf( "." );
-	}
+	demowrite.CopyFrom( demoread );
 	
 	demoread.Close();
 	demowrite.Close();
@@ -515,6 +557,12 @@ void idCommonLocal::AdvanceRenderDemo( bool singleFrameOnly )
 		case DS_GAME:
 			Game()->ProcessDemoCommand( readDemo );
 			break;
+		case DS_KEYFRAME:
+		{
+			int keyframeTime = 0;
+			readDemo->ReadInt( keyframeTime );
+			break;
+		}
 		default:
 			common->Error( "Bad render demo token %d", ds );
 		}
@@ -601,6 +649,21 @@ CONSOLE_COMMAND( playDemo, "plays back a demo", idCmdSystem::ArgCompletion_DemoN
 	}
 }
 
+/*
+================
+Common_SeekDemo_f
+================
+*/
+CONSOLE_COMMAND( seekDemo, "jumps to the keyframe before a time in seconds in the demo that is playing", NULL )
+{
+	if( args.Argc() != 2 )
+	{
+		common->Printf( "use: seekDemo <seconds>\n" );
+		return;
+	}
+	commonLocal.SeekRenderDemo( idMath::Ftoi( atof( args.Argv( 1 ) ) * 1000.0f ) );
+}
+
 /*
 ================
 Common_TimeDemo_f
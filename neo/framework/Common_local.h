@@ -348,6 +348,7 @@ public:	// These are public because they are called directly by static functions
 	void	StopRecordingRenderDemo();
 	void	StartPlayingRenderDemo( idStr name );
 	void	StopPlayingRenderDemo();
+	void	SeekRenderDemo( int time );
 	void	CompressDemoFile( const char* scheme, const char* name );
 	void	TimeRenderDemo( const char* name, bool twice = false, bool quit = false );
 	void	AVIRenderDemo( const char* name );
@@ -576,6 +577,7 @@ private:
 	void	EndAVICapture();
 	
 	void	AdvanceRenderDemo( bool singleFrameOnly );
+	void	WriteRenderDemoKeyframe();
 	
 	void	ProcessGameReturn( const gameReturn_t& ret );
 	
@@ -1767,6 +1767,870 @@ int idParticleStage::CreateParticle( particleGen_t* g, idDrawVert* verts ) const
 	return numVerts * 2;
 }
 
+/*
+====================================================================================
+
+idParticleBatch
+
+====================================================================================
+*/
+
+idCVar r_useSIMDParticles( "r_useSIMDParticles", "1", CVAR_RENDERER | CVAR_BOOL, "create standard path particles four at a time with SIMD" );
+
+/*
+================
+idParticleBatch::idParticleBatch
+================
+*/
+idParticleBatch::idParticleBatch()
+{
+	indexes = NULL;
+	fracs = NULL;
+	seeds = NULL;
+	origins = NULL;
+	axis = NULL;
+	numParticles = 0;
+	maxParticles = 0;
+	ownedMemory = NULL;
+	ownedSize = 0;
+}
+
+/*
+================
+idParticleBatch::idParticleBatch
+================
+*/
+idParticleBatch::idParticleBatch( int maxParticles, bool perParticleOrigins )
+{
+	ownedMemory = NULL;
+	ownedSize = 0;
+	Alloc( maxParticles, perParticleOrigins );
+}
+
+/*
+================
+idParticleBatch::~idParticleBatch
+================
+*/
+idParticleBatch::~idParticleBatch()
+{
+	Mem_Free16( ownedMemory );
+}
+
+/*
+================
+idParticleBatch::StorageSize
+================
+*/
+int idParticleBatch::StorageSize( int maxParticles, bool perParticleOrigins )
+{
+	// round up so the last group of four can always be loaded, which also keeps every array 16 byte aligned
+	const int alignedNum = ( Max( maxParticles, 1 ) + 3 ) & ~3;
+	int size = alignedNum * ( sizeof( int ) + sizeof( float ) + sizeof( int ) );
+	if( perParticleOrigins )
+	{
+		size += alignedNum * ( sizeof( idVec3 ) + sizeof( idMat3 ) );
+	}
+	return size;
+}
+
+/*
+================
+idParticleBatch::Alloc
+================
+*/
+void idParticleBatch::Alloc( int maxParticles, bool perParticleOrigins )
+{
+	const int size = StorageSize( maxParticles, perParticleOrigins );
+	if( size > ownedSize )
+	{
+		Mem_Free16( ownedMemory );
+		ownedMemory = ( byte* )Mem_Alloc16( size, TAG_PARTICLE );
+		ownedSize = size;
+	}
+	SetMemory( ownedMemory, maxParticles, perParticleOrigins );
+}
+
+/*
+================
+idParticleBatch::SetMemory
+================
+*/
+void idParticleBatch::SetMemory( void* memory, int maxParticles, bool perParticleOrigins )
+{
+	assert( ( ( uintptr_t )memory & 15 ) == 0 );
+	
+	this->maxParticles = maxParticles;
+	numParticles = 0;
+	
+	const int alignedNum = ( Max( maxParticles, 1 ) + 3 ) & ~3;
+	byte* ptr = ( byte* )memory;
+	indexes = ( int* )ptr;
+	ptr += alignedNum * sizeof( int );
+	fracs = ( float* )ptr;
+	ptr += alignedNum * sizeof( float );
+	seeds = ( int* )ptr;
+	ptr += alignedNum * sizeof( int );
+	
+	// the unused entries of the last group of four are loaded as well
+	memset( indexes, 0, alignedNum * ( sizeof( int ) + sizeof( float ) + sizeof( int ) ) );
+	
+	if( perParticleOrigins )
+	{
+		origins = ( idVec3* )ptr;
+		ptr += alignedNum * sizeof( idVec3 );
+		axis = ( idMat3* )ptr;
+	}
+	else
+	{
+		origins = NULL;
+		axis = NULL;
+	}
+}
+
+/*
+================
+idParticleBatch::Append
+================
+*/
+void idParticleBatch::Append( const particleGen_t& g )
+{
+	assert( numParticles < maxParticles );
+	
+	indexes[numParticles] = g.index;
+	fracs[numParticles] = g.frac;
+	seeds[numParticles] = g.random.GetSeed();
+	if( origins != NULL )
+	{
+		origins[numParticles] = g.origin;
+		axis[numParticles] = g.axis;
+	}
+	numParticles++;
+}
+
+/*
+================
+idParticleStage::CanBatchParticles
+
+The SIMD path only does the standard path with camera or axis facing quads,
+everything else goes through CreateParticle.
+================
+*/
+bool idParticleStage::CanBatchParticles() const
+{
+	if( !r_useSIMDParticles.GetBool() )
+	{
+		return false;
+	}
+	if( customPathType != PPATH_STANDARD || orientation == POR_AIMED )
+	{
+		return false;
+	}
+	// tables can't be integrated, leave the warning to CreateParticle
+	if( speed.table != NULL || rotationSpeed.table != NULL )
+	{
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+Particle SIMD helpers
+
+These follow the scalar idRandom and idMath::SinCos16 code operation for
+operation so both paths create the same particles.
+================
+*/
+static ID_INLINE __m128 R_SelectPS( const __m128 mask, const __m128 a, const __m128 b )
+{
+	return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+}
+
+static ID_INLINE __m128i R_MulLo32( const __m128i a, const __m128i b )
+{
+	// SSE2 has no 32 bit low multiply, do the even and odd lanes separately
+	const __m128i even = _mm_mul_epu32( a, b );
+	const __m128i odd = _mm_mul_epu32( _mm_srli_epi64( a, 32 ), _mm_srli_epi64( b, 32 ) );
+	return _mm_unpacklo_epi32( _mm_shuffle_epi32( even, _MM_SHUFFLE( 0, 0, 2, 0 ) ), _mm_shuffle_epi32( odd, _MM_SHUFFLE( 0, 0, 2, 0 ) ) );
+}
+
+static ID_INLINE __m128 R_RandomFloat4( __m128i& seed )
+{
+	seed = _mm_add_epi32( R_MulLo32( seed, _mm_set1_epi32( 69069 ) ), _mm_set1_epi32( 1 ) );
+	const __m128 r = _mm_cvtepi32_ps( _mm_and_si128( seed, _mm_set1_epi32( idRandom::MAX_RAND ) ) );
+	return _mm_div_ps( r, _mm_set1_ps( ( float )( idRandom::MAX_RAND + 1 ) ) );
+}
+
+static ID_INLINE __m128 R_CRandomFloat4( __m128i& seed )
+{
+	return _mm_mul_ps( _mm_set1_ps( 2.0f ), _mm_sub_ps( R_RandomFloat4( seed ), _mm_set1_ps( 0.5f ) ) );
+}
+
+static ID_INLINE void R_SinCos16_4( __m128 a, __m128& s, __m128& c )
+{
+	const __m128 pi = _mm_set1_ps( idMath::PI );
+	const __m128 twoPi = _mm_set1_ps( idMath::TWO_PI );
+	
+	// floorf without SSE4.1, the values stay well inside the int range
+	const __m128 outside = _mm_or_ps( _mm_cmplt_ps( a, _mm_setzero_ps() ), _mm_cmpge_ps( a, twoPi ) );
+	const __m128 t = _mm_mul_ps( a, _mm_set1_ps( idMath::ONEOVER_TWOPI ) );
+	__m128 fl = _mm_cvtepi32_ps( _mm_cvttps_epi32( t ) );
+	fl = _mm_sub_ps( fl, _mm_and_ps( _mm_cmpgt_ps( fl, t ), _mm_set1_ps( 1.0f ) ) );
+	a = R_SelectPS( outside, _mm_sub_ps( a, _mm_mul_ps( fl, twoPi ) ), a );
+	
+	const __m128 belowPi = _mm_cmplt_ps( a, pi );
+	const __m128 keep = _mm_andnot_ps( _mm_cmpgt_ps( a, _mm_set1_ps( idMath::HALF_PI ) ), belowPi );
+	const __m128 wrap = _mm_andnot_ps( belowPi, _mm_cmpgt_ps( a, _mm_set1_ps( idMath::PI + idMath::HALF_PI ) ) );
+	const __m128 negate = _mm_andnot_ps( _mm_or_ps( keep, wrap ), _mm_castsi128_ps( _mm_set1_epi32( -1 ) ) );
+	a = R_SelectPS( keep, a, R_SelectPS( wrap, _mm_sub_ps( a, twoPi ), _mm_sub_ps( pi, a ) ) );
+	
+	const __m128 a2 = _mm_mul_ps( a, a );
+	__m128 ps = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( -2.39e-08f ), a2 ), _mm_set1_ps( 2.7526e-06f ) );
+	ps = _mm_sub_ps( _mm_mul_ps( ps, a2 ), _mm_set1_ps( 1.98409e-04f ) );
+	ps = _mm_add_ps( _mm_mul_ps( ps, a2 ), _mm_set1_ps( 8.3333315e-03f ) );
+	ps = _mm_sub_ps( _mm_mul_ps( ps, a2 ), _mm_set1_ps( 1.666666664e-01f ) );
+	ps = _mm_add_ps( _mm_mul_ps( ps, a2 ), _mm_set1_ps( 1.0f ) );
+	s = _mm_mul_ps( a, ps );
+	
+	__m128 pc = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( -2.605e-07f ), a2 ), _mm_set1_ps( 2.47609e-05f ) );
+	pc = _mm_sub_ps( _mm_mul_ps( pc, a2 ), _mm_set1_ps( 1.3888397e-03f ) );
+	pc = _mm_add_ps( _mm_mul_ps( pc, a2 ), _mm_set1_ps( 4.16666418e-02f ) );
+	pc = _mm_sub_ps( _mm_mul_ps( pc, a2 ), _mm_set1_ps( 4.999999963e-01f ) );
+	pc = _mm_add_ps( _mm_mul_ps( pc, a2 ), _mm_set1_ps( 1.0f ) );
+	c = _mm_xor_ps( pc, _mm_and_ps( negate, _mm_set1_ps( -0.0f ) ) );
+}
+
+static ID_INLINE __m128i R_F32toF16_4( const __m128 a )
+{
+	// F32toF16 for four floats, the halves end up in the low 16 bits
+	const __m128i f = _mm_castps_si128( a );
+	const __m128i signbit = _mm_srli_epi32( _mm_and_si128( f, _mm_set1_epi32( 0x80000000 ) ), 16 );
+	const __m128i exponent = _mm_sub_epi32( _mm_srli_epi32( _mm_and_si128( f, _mm_set1_epi32( 0x7F800000 ) ), 23 ), _mm_set1_epi32( 112 ) );
+	const __m128i mantissa = _mm_srli_epi32( _mm_and_si128( f, _mm_set1_epi32( 0x007FFFFF ) ), 13 );
+	
+	__m128i h = _mm_or_si128( signbit, _mm_or_si128( _mm_slli_epi32( exponent, 10 ), mantissa ) );
+	const __m128i overflow = _mm_cmpgt_epi32( exponent, _mm_set1_epi32( 30 ) );
+	h = _mm_or_si128( _mm_and_si128( overflow, _mm_or_si128( signbit, _mm_set1_epi32( 0x7BFF ) ) ), _mm_andnot_si128( overflow, h ) );
+	return _mm_andnot_si128( _mm_cmpgt_epi32( _mm_set1_epi32( 1 ), exponent ), h );
+}
+
+static ID_INLINE __m128 R_F16toF32_4( const __m128i h )
+{
+	// F16toF32 for halves in the low 16 bits, only normal numbers and zero come from F32toF16
+	const __m128i signbit = _mm_slli_epi32( _mm_and_si128( h, _mm_set1_epi32( 0x8000 ) ), 16 );
+	const __m128i isNormal = _mm_cmpgt_epi32( _mm_and_si128( h, _mm_set1_epi32( 0x7C00 ) ), _mm_setzero_si128() );
+	const __m128i bits = _mm_add_epi32( _mm_slli_epi32( _mm_and_si128( h, _mm_set1_epi32( 0x7FFF ) ), 13 ), _mm_set1_epi32( 112 << 23 ) );
+	return _mm_castsi128_ps( _mm_or_si128( signbit, _mm_and_si128( isNormal, bits ) ) );
+}
+
+static ID_INLINE void R_RingReproject4( const float ringFraction, const __m128 radiusSqr, __m128& x, __m128& y, __m128* z )
+{
+	const __m128 ring = _mm_set1_ps( ringFraction );
+	const __m128 inside = _mm_cmplt_ps( radiusSqr, _mm_set1_ps( ringFraction * ringFraction ) );
+	if( _mm_movemask_ps( inside ) == 0 )
+	{
+		return;
+	}
+	const __m128 f = _mm_div_ps( _mm_sqrt_ps( radiusSqr ), ring );
+	const __m128 invf = _mm_div_ps( _mm_set1_ps( 1.0f ), f );
+	const __m128 newRadius = _mm_add_ps( ring, _mm_mul_ps( f, _mm_set1_ps( 1.0f - ringFraction ) ) );
+	const __m128 rescale = _mm_mul_ps( invf, newRadius );
+	x = R_SelectPS( inside, _mm_mul_ps( x, rescale ), x );
+	y = R_SelectPS( inside, _mm_mul_ps( y, rescale ), y );
+	if( z != NULL )
+	{
+		*z = R_SelectPS( inside, _mm_mul_ps( *z, rescale ), *z );
+	}
+}
+
+/*
+================
+idParticleStage::CreateParticles
+
+Creates the same verts as calling CreateParticle for every particle in the
+batch.  Standard path particles are evaluated four at a time in SIMD lanes,
+with a random seed per lane, and only the vertex writes are scalar.
+================
+*/
+int idParticleStage::CreateParticles( particleGen_t* g, const idParticleBatch& batch, idDrawVert* verts ) const
+{
+	int numVerts = 0;
+	
+	if( !CanBatchParticles() )
+	{
+		for( int i = 0; i < batch.Num(); i++ )
+		{
+			g->index = batch.indexes[i];
+			g->frac = batch.fracs[i];
+			g->random.SetSeed( batch.seeds[i] );
+			g->originalRandom = g->random;
+			g->age = g->frac * particleLife;
+			if( batch.origins != NULL )
+			{
+				g->origin = batch.origins[i];
+				g->axis = batch.axis[i];
+			}
+			numVerts += CreateParticle( g, verts + numVerts );
+		}
+		return numVerts;
+	}
+	
+	ALIGNTYPE16 float	animFrac[4];
+	ALIGNTYPE16 dword	colors[4];
+	
+	//
+	// everything that is constant over the stage
+	//
+	const float fadeInDivisor = ( fadeInFraction > 0.0f ) ? fadeInFraction : 1.0f;
+	const float fadeOutDivisor = ( fadeOutFraction > 0.0f ) ? fadeOutFraction : 1.0f;
+	
+	idVec4 baseColor;
+	for( int i = 0; i < 4; i++ )
+	{
+		baseColor[i] = ( entityColor ) ? g->renderEnt->shaderParms[i] : color[i];
+	}
+	
+	idVec3 gravityVector( 0.0f, 0.0f, -gravity );
+	if( worldGravity )
+	{
+		gravityVector *= g->renderEnt->axis.Transpose();
+	}
+	
+	idVec3 entityLeft, entityUp;
+	if( orientation == POR_VIEW )
+	{
+		g->renderEnt->axis.ProjectVector( g->renderView->viewaxis[1], entityLeft );
+		g->renderEnt->axis.ProjectVector( g->renderView->viewaxis[2], entityUp );
+	}
+	
+	const float frameWidth = ( animationFrames > 1 ) ? 1.0f / animationFrames : 1.0f;
+	const __m128i texT0 = _mm_set1_epi32( F32toF16( 0.0f ) << 16 );
+	const __m128i texT1 = _mm_set1_epi32( F32toF16( 1.0f ) << 16 );
+	
+	for( int first = 0; first < batch.Num(); first += 4 )
+	{
+		const int numLanes = Min( batch.Num() - first, 4 );
+		
+		const __m128 frac = _mm_load_ps( batch.fracs + first );
+		const __m128i index = _mm_load_si128( ( const __m128i* )( batch.indexes + first ) );
+		__m128i seed = _mm_load_si128( ( const __m128i* )( batch.seeds + first ) );
+		const __m128 one = _mm_set1_ps( 1.0f );
+		
+		//
+		// colors, ParticleColors
+		//
+		__m128 fade = one;
+		fade = R_SelectPS( _mm_cmplt_ps( frac, _mm_set1_ps( fadeInFraction ) ), _mm_mul_ps( fade, _mm_div_ps( frac, _mm_set1_ps( fadeInDivisor ) ) ), fade );
+		const __m128 invFrac = _mm_sub_ps( one, frac );
+		fade = R_SelectPS( _mm_cmplt_ps( invFrac, _mm_set1_ps( fadeOutFraction ) ), _mm_mul_ps( fade, _mm_div_ps( invFrac, _mm_set1_ps( fadeOutDivisor ) ) ), fade );
+		if( fadeIndexFraction )
+		{
+			const __m128 indexFrac = _mm_div_ps( _mm_cvtepi32_ps( _mm_sub_epi32( _mm_set1_epi32( totalParticles ), index ) ), _mm_set1_ps( ( float )totalParticles ) );
+			fade = R_SelectPS( _mm_cmplt_ps( indexFrac, _mm_set1_ps( fadeIndexFraction ) ), _mm_mul_ps( fade, _mm_div_ps( indexFrac, _mm_set1_ps( fadeIndexFraction ) ) ), fade );
+		}
+		const __m128 invFade = _mm_sub_ps( one, fade );
+		
+		__m128i icolor[4];
+		for( int i = 0; i < 4; i++ )
+		{
+			const __m128 fcolor = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( baseColor[i] ), fade ), _mm_mul_ps( _mm_set1_ps( fadeColor[i] ), invFade ) );
+			icolor[i] = _mm_cvttps_epi32( _mm_mul_ps( fcolor, _mm_set1_ps( 255.0f ) ) );
+		}
+		// the saturating packs do the 0 - 255 clamp, then the bytes are
+		// interleaved into one idDrawVert color dword per lane
+		const __m128i rb = _mm_packs_epi32( icolor[0], icolor[2] );
+		const __m128i ga = _mm_packs_epi32( icolor[1], icolor[3] );
+		const __m128i rbga = _mm_packus_epi16( rb, ga );
+		const __m128i rgrgbaba = _mm_unpacklo_epi8( rbga, _mm_srli_si128( rbga, 8 ) );
+		const __m128i rgba = _mm_unpacklo_epi16( rgrgbaba, _mm_srli_si128( rgrgbaba, 8 ) );
+		_mm_store_si128( ( __m128i* )colors, rgba );
+		
+		// completely faded out particles are killed
+		const int alive = ~_mm_movemask_ps( _mm_castsi128_ps( _mm_cmpeq_epi32( rgba, _mm_setzero_si128() ) ) ) & ( ( 1 << numLanes ) - 1 );
+		if( alive == 0 )
+		{
+			continue;
+		}
+		
+		//
+		// initial origin distribution, ParticleOrigin
+		//
+		__m128 ox, oy, oz;
+		switch( distributionType )
+		{
+			case PDIST_RECT:
+			{
+				if( randomDistribution )
+				{
+					ox = R_CRandomFloat4( seed );
+					oy = R_CRandomFloat4( seed );
+					oz = R_CRandomFloat4( seed );
+				}
+				else
+				{
+					ox = oy = oz = one;
+				}
+				break;
+			}
+			case PDIST_CYLINDER:
+			{
+				const __m128 angle = _mm_mul_ps( ( randomDistribution ) ? R_CRandomFloat4( seed ) : one, _mm_set1_ps( idMath::TWO_PI ) );
+				R_SinCos16_4( angle, ox, oy );
+				oz = ( randomDistribution ) ? R_CRandomFloat4( seed ) : one;
+				if( distributionParms[3] > 0.0f )
+				{
+					const __m128 radiusSqr = _mm_add_ps( _mm_mul_ps( ox, ox ), _mm_mul_ps( oy, oy ) );
+					R_RingReproject4( distributionParms[3], radiusSqr, ox, oy, NULL );
+				}
+				break;
+			}
+			case PDIST_SPHERE:
+			default:
+			{
+				__m128 radiusSqr;
+				if( randomDistribution )
+				{
+					// every lane keeps drawing until it lands inside the sphere,
+					// lanes that are done keep their seed and point
+					__m128 retry = _mm_castsi128_ps( _mm_set1_epi32( -1 ) );
+					ox = oy = oz = radiusSqr = _mm_setzero_ps();
+					do
+					{
+						__m128i trySeed = seed;
+						const __m128 x = R_CRandomFloat4( trySeed );
+						const __m128 y = R_CRandomFloat4( trySeed );
+						const __m128 z = R_CRandomFloat4( trySeed );
+						const __m128 r = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) );
+						
+						seed = _mm_castps_si128( R_SelectPS( retry, _mm_castsi128_ps( trySeed ), _mm_castsi128_ps( seed ) ) );
+						ox = R_SelectPS( retry, x, ox );
+						oy = R_SelectPS( retry, y, oy );
+						oz = R_SelectPS( retry, z, oz );
+						radiusSqr = R_SelectPS( retry, r, radiusSqr );
+						
+						retry = _mm_and_ps( retry, _mm_cmpgt_ps( r, one ) );
+					}
+					while( _mm_movemask_ps( retry ) );
+				}
+				else
+				{
+					ox = oy = oz = one;
+					radiusSqr = _mm_set1_ps( 3.0f );
+				}
+				if( distributionParms[3] > 0.0f )
+				{
+					R_RingReproject4( distributionParms[3], radiusSqr, ox, oy, &oz );
+				}
+				break;
+			}
+		}
+		ox = _mm_add_ps( _mm_mul_ps( ox, _mm_set1_ps( distributionParms[0] ) ), _mm_set1_ps( offset.x ) );
+		oy = _mm_add_ps( _mm_mul_ps( oy, _mm_set1_ps( distributionParms[1] ) ), _mm_set1_ps( offset.y ) );
+		oz = _mm_add_ps( _mm_mul_ps( oz, _mm_set1_ps( distributionParms[2] ) ), _mm_set1_ps( offset.z ) );
+		
+		//
+		// velocity
+		//
+		__m128 dx, dy, dz;
+		if( directionType == PDIR_CONE )
+		{
+			const __m128 angle1 = _mm_mul_ps( _mm_mul_ps( R_CRandomFloat4( seed ), _mm_set1_ps( directionParms[0] ) ), _mm_set1_ps( idMath::M_DEG2RAD ) );
+			const __m128 angle2 = _mm_mul_ps( R_CRandomFloat4( seed ), _mm_set1_ps( idMath::PI ) );
+			
+			__m128 s1, c1, s2, c2;
+			R_SinCos16_4( angle1, s1, c1 );
+			R_SinCos16_4( angle2, s2, c2 );
+			
+			dx = _mm_mul_ps( s1, c2 );
+			dy = _mm_mul_ps( s1, s2 );
+			dz = c1;
+		}
+		else
+		{
+			const __m128 sqrLength = _mm_add_ps( _mm_add_ps( _mm_mul_ps( ox, ox ), _mm_mul_ps( oy, oy ) ), _mm_mul_ps( oz, oz ) );
+			const __m128 invLength = R_SelectPS( _mm_cmpgt_ps( sqrLength, _mm_set1_ps( idMath::FLT_SMALLEST_NON_DENORMAL ) ),
+												 _mm_sqrt_ps( _mm_div_ps( one, sqrLength ) ), _mm_set1_ps( idMath::INFINITY ) );
+			dx = _mm_mul_ps( ox, invLength );
+			dy = _mm_mul_ps( oy, invLength );
+			dz = _mm_add_ps( _mm_mul_ps( oz, invLength ), _mm_set1_ps( directionParms[0] ) );
+		}
+		
+		const __m128 life = _mm_set1_ps( particleLife );
+		const __m128 iSpeed = _mm_mul_ps( _mm_add_ps( _mm_set1_ps( speed.from ), _mm_mul_ps( _mm_mul_ps( frac, _mm_set1_ps( speed.to - speed.from ) ), _mm_set1_ps( 0.5f ) ) ), frac );
+		ox = _mm_add_ps( ox, _mm_mul_ps( _mm_mul_ps( dx, iSpeed ), life ) );
+		oy = _mm_add_ps( oy, _mm_mul_ps( _mm_mul_ps( dy, iSpeed ), life ) );
+		oz = _mm_add_ps( oz, _mm_mul_ps( _mm_mul_ps( dz, iSpeed ), life ) );
+		
+		//
+		// per particle smoke offset, then gravity
+		//
+		__m128 m[3][3], mo[3];
+		if( batch.origins != NULL )
+		{
+			// pad missing lanes with the first particle
+			const idMat3* ax[4];
+			const idVec3* org[4];
+			for( int lane = 0; lane < 4; lane++ )
+			{
+				ax[lane] = &batch.axis[first + ( ( lane < numLanes ) ? lane : 0 )];
+				org[lane] = &batch.origins[first + ( ( lane < numLanes ) ? lane : 0 )];
+			}
+			for( int r = 0; r < 3; r++ )
+			{
+				for( int c = 0; c < 3; c++ )
+				{
+					m[r][c] = _mm_setr_ps( ( *ax[0] )[r][c], ( *ax[1] )[r][c], ( *ax[2] )[r][c], ( *ax[3] )[r][c] );
+				}
+				mo[r] = _mm_setr_ps( ( *org[0] )[r], ( *org[1] )[r], ( *org[2] )[r], ( *org[3] )[r] );
+			}
+		}
+		else
+		{
+			for( int r = 0; r < 3; r++ )
+			{
+				for( int c = 0; c < 3; c++ )
+				{
+					m[r][c] = _mm_set1_ps( g->axis[r][c] );
+				}
+				mo[r] = _mm_set1_ps( g->origin[r] );
+			}
+		}
+		const __m128 tx = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m[0][0], ox ), _mm_mul_ps( m[1][0], oy ) ), _mm_mul_ps( m[2][0], oz ) );
+		const __m128 ty = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m[0][1], ox ), _mm_mul_ps( m[1][1], oy ) ), _mm_mul_ps( m[2][1], oz ) );
+		const __m128 tz = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m[0][2], ox ), _mm_mul_ps( m[1][2], oy ) ), _mm_mul_ps( m[2][2], oz ) );
+		ox = _mm_add_ps( tx, mo[0] );
+		oy = _mm_add_ps( ty, mo[1] );
+		oz = _mm_add_ps( tz, mo[2] );
+		
+		const __m128 age = _mm_mul_ps( frac, life );
+		if( worldGravity )
+		{
+			ox = _mm_add_ps( ox, _mm_mul_ps( _mm_mul_ps( _mm_set1_ps( gravityVector.x ), age ), age ) );
+			oy = _mm_add_ps( oy, _mm_mul_ps( _mm_mul_ps( _mm_set1_ps( gravityVector.y ), age ), age ) );
+			oz = _mm_add_ps( oz, _mm_mul_ps( _mm_mul_ps( _mm_set1_ps( gravityVector.z ), age ), age ) );
+		}
+		else
+		{
+			oz = _mm_sub_ps( oz, _mm_mul_ps( _mm_mul_ps( _mm_set1_ps( gravity ), age ), age ) );
+		}
+		
+		//
+		// texture animation, ParticleTexCoords
+		//
+		__m128 texS = _mm_setzero_ps();
+		if( animationFrames > 1 )
+		{
+			const __m128 floatFrame = ( animationRate ) ? _mm_mul_ps( age, _mm_set1_ps( animationRate ) ) : _mm_mul_ps( frac, _mm_set1_ps( ( float )animationFrames ) );
+			const __m128 intFrame = _mm_cvtepi32_ps( _mm_cvttps_epi32( floatFrame ) );
+			_mm_store_ps( animFrac, _mm_sub_ps( floatFrame, intFrame ) );
+			texS = _mm_mul_ps( _mm_set1_ps( frameWidth ), intFrame );
+		}
+		
+		//
+		// size and rotation, ParticleVerts
+		//
+		__m128 width, paspect;
+		if( size.table == NULL )
+		{
+			width = _mm_add_ps( _mm_set1_ps( size.from ), _mm_mul_ps( frac, _mm_set1_ps( size.to - size.from ) ) );
+		}
+		else
+		{
+			ALIGNTYPE16 float lanes[4];
+			for( int lane = 0; lane < 4; lane++ )
+			{
+				lanes[lane] = size.table->TableLookup( batch.fracs[first + lane] );
+			}
+			width = _mm_load_ps( lanes );
+		}
+		if( aspect.table == NULL )
+		{
+			paspect = _mm_add_ps( _mm_set1_ps( aspect.from ), _mm_mul_ps( frac, _mm_set1_ps( aspect.to - aspect.from ) ) );
+		}
+		else
+		{
+			ALIGNTYPE16 float lanes[4];
+			for( int lane = 0; lane < 4; lane++ )
+			{
+				lanes[lane] = aspect.table->TableLookup( batch.fracs[first + lane] );
+			}
+			paspect = _mm_load_ps( lanes );
+		}
+		const __m128 height = _mm_mul_ps( width, paspect );
+		
+		__m128 angle = ( initialAngle ) ? _mm_set1_ps( initialAngle ) : _mm_mul_ps( _mm_set1_ps( 360.0f ), R_RandomFloat4( seed ) );
+		const __m128 rotation = _mm_add_ps( _mm_set1_ps( rotationSpeed.from ), _mm_mul_ps( _mm_mul_ps( frac, _mm_set1_ps( rotationSpeed.to - rotationSpeed.from ) ), _mm_set1_ps( 0.5f ) ) );
+		const __m128 angleMove = _mm_mul_ps( _mm_mul_ps( rotation, frac ), life );
+		// half the particles rotate each way
+		const __m128 odd = _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_and_si128( index, _mm_set1_epi32( 1 ) ), _mm_set1_epi32( 1 ) ) );
+		angle = R_SelectPS( odd, _mm_add_ps( angle, angleMove ), _mm_sub_ps( angle, angleMove ) );
+		angle = _mm_mul_ps( _mm_div_ps( angle, _mm_set1_ps( 180.0f ) ), _mm_set1_ps( idMath::PI ) );
+		
+		__m128 s, c;
+		R_SinCos16_4( angle, s, c );
+		
+		__m128 leftX, leftY, leftZ, upX, upY, upZ;
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 negS = _mm_xor_ps( s, _mm_set1_ps( -0.0f ) );
+		switch( orientation )
+		{
+			case POR_Z:
+				leftX = s;
+				leftY = c;
+				leftZ = zero;
+				upX = c;
+				upY = negS;
+				upZ = zero;
+				break;
+			case POR_X:
+				leftX = zero;
+				leftY = c;
+				leftZ = s;
+				upX = zero;
+				upY = negS;
+				upZ = c;
+				break;
+			case POR_Y:
+				leftX = c;
+				leftY = zero;
+				leftZ = s;
+				upX = negS;
+				upY = zero;
+				upZ = c;
+				break;
+			default:
+				leftX = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( entityLeft.x ), c ), _mm_mul_ps( _mm_set1_ps( entityUp.x ), s ) );
+				leftY = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( entityLeft.y ), c ), _mm_mul_ps( _mm_set1_ps( entityUp.y ), s ) );
+				leftZ = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( entityLeft.z ), c ), _mm_mul_ps( _mm_set1_ps( entityUp.z ), s ) );
+				upX = _mm_sub_ps( _mm_mul_ps( _mm_set1_ps( entityUp.x ), c ), _mm_mul_ps( _mm_set1_ps( entityLeft.x ), s ) );
+				upY = _mm_sub_ps( _mm_mul_ps( _mm_set1_ps( entityUp.y ), c ), _mm_mul_ps( _mm_set1_ps( entityLeft.y ), s ) );
+				upZ = _mm_sub_ps( _mm_mul_ps( _mm_set1_ps( entityUp.z ), c ), _mm_mul_ps( _mm_set1_ps( entityLeft.z ), s ) );
+				break;
+		}
+		
+		// quad corners in the same order as ParticleVerts, transposed so
+		// each lane has its xyz and texcoords in the first half of a vert
+		//
+		// 0 1
+		// 2 3
+		const __m128 origins[3] = { ox, oy, oz };
+		const __m128 lefts[3] = { _mm_mul_ps( leftX, width ), _mm_mul_ps( leftY, width ), _mm_mul_ps( leftZ, width ) };
+		const __m128 ups[3] = { _mm_mul_ps( upX, height ), _mm_mul_ps( upY, height ), _mm_mul_ps( upZ, height ) };
+		__m128 corner[4][4];
+		for( int i = 0; i < 3; i++ )
+		{
+			const __m128 minusLeft = _mm_sub_ps( origins[i], lefts[i] );
+			const __m128 plusLeft = _mm_add_ps( origins[i], lefts[i] );
+			corner[0][i] = _mm_add_ps( minusLeft, ups[i] );
+			corner[1][i] = _mm_add_ps( plusLeft, ups[i] );
+			corner[2][i] = _mm_sub_ps( minusLeft, ups[i] );
+			corner[3][i] = _mm_sub_ps( plusLeft, ups[i] );
+		}
+		const __m128i s0 = R_F32toF16_4( texS );
+		const __m128i s1 = R_F32toF16_4( _mm_add_ps( texS, _mm_set1_ps( frameWidth ) ) );
+		corner[0][3] = _mm_castsi128_ps( _mm_or_si128( s0, texT0 ) );
+		corner[1][3] = _mm_castsi128_ps( _mm_or_si128( s1, texT0 ) );
+		corner[2][3] = _mm_castsi128_ps( _mm_or_si128( s0, texT1 ) );
+		corner[3][3] = _mm_castsi128_ps( _mm_or_si128( s1, texT1 ) );
+		
+		// the cross faded quad of an animated stage steps the already rounded
+		// texcoords one frame to the right, just like CreateParticle
+		__m128 nextCorner[4][4];
+		if( animationFrames > 1 )
+		{
+			const __m128i nextS0 = R_F32toF16_4( _mm_add_ps( R_F16toF32_4( s0 ), _mm_set1_ps( frameWidth ) ) );
+			const __m128i nextS1 = R_F32toF16_4( _mm_add_ps( R_F16toF32_4( s1 ), _mm_set1_ps( frameWidth ) ) );
+			for( int i = 0; i < 4; i++ )
+			{
+				nextCorner[i][0] = corner[i][0];
+				nextCorner[i][1] = corner[i][1];
+				nextCorner[i][2] = corner[i][2];
+			}
+			nextCorner[0][3] = _mm_castsi128_ps( _mm_or_si128( nextS0, texT0 ) );
+			nextCorner[1][3] = _mm_castsi128_ps( _mm_or_si128( nextS1, texT0 ) );
+			nextCorner[2][3] = _mm_castsi128_ps( _mm_or_si128( nextS0, texT1 ) );
+			nextCorner[3][3] = _mm_castsi128_ps( _mm_or_si128( nextS1, texT1 ) );
+			for( int i = 0; i < 4; i++ )
+			{
+				_MM_TRANSPOSE4_PS( nextCorner[i][0], nextCorner[i][1], nextCorner[i][2], nextCorner[i][3] );
+			}
+		}
+		for( int i = 0; i < 4; i++ )
+		{
+			_MM_TRANSPOSE4_PS( corner[i][0], corner[i][1], corner[i][2], corner[i][3] );
+		}
+		
+		//
+		// write out the quads of the live particles in batch order
+		//
+		for( int lane = 0; lane < numLanes; lane++ )
+		{
+			if( !( alive & ( 1 << lane ) ) )
+			{
+				continue;
+			}
+			
+			idDrawVert* v = verts + numVerts;
+			
+			if( animationFrames <= 1 )
+			{
+				// normal, tangent, color and color2 as set by idDrawVert::Clear
+				const __m128i second = _mm_setr_epi32( 0x00FF8080, 0xFF8080FF, colors[lane], 0 );
+				for( int i = 0; i < 4; i++ )
+				{
+					_mm_storeu_ps( &v[i].xyz.x, corner[i][lane] );
+					_mm_storeu_si128( ( __m128i* )v[i].normal, second );
+				}
+				numVerts += 4;
+				continue;
+			}
+			
+			// cross fade the colors, the byte * float truncation matches CreateParticle
+			const float frac = animFrac[lane];
+			const float iFrac = 1.0f - frac;
+			const byte* color = ( const byte* )&colors[lane];
+			ALIGNTYPE16 byte quadColors[2][4];
+			for( int j = 0; j < 4; j++ )
+			{
+				quadColors[0][j] = color[j];
+				quadColors[0][j] *= iFrac;
+				quadColors[1][j] = color[j];
+				quadColors[1][j] *= frac;
+			}
+			const __m128i second = _mm_setr_epi32( 0x00FF8080, 0xFF8080FF, *( const int* )quadColors[0], 0 );
+			const __m128i nextSecond = _mm_setr_epi32( 0x00FF8080, 0xFF8080FF, *( const int* )quadColors[1], 0 );
+			for( int i = 0; i < 4; i++ )
+			{
+				_mm_storeu_ps( &v[i].xyz.x, corner[i][lane] );
+				_mm_storeu_si128( ( __m128i* )v[i].normal, second );
+				_mm_storeu_ps( &v[4 + i].xyz.x, nextCorner[i][lane] );
+				_mm_storeu_si128( ( __m128i* )v[4 + i].normal, nextSecond );
+			}
+			numVerts += 8;
+		}
+	}
+	
+	return numVerts;
+}
+
+/*
+================
+TestParticleBatches_f
+
+Creates random particles for every loaded particle stage through both
+CreateParticle and CreateParticles and compares the verts.
+================
+*/
+void TestParticleBatches_f( const idCmdArgs& args )
+{
+	const int numParticles = ( args.Argc() > 1 ) ? Max( atoi( args.Argv( 1 ) ), 4 ) : 1024;
+	
+	renderEntity_t renderEntity;
+	memset( &renderEntity, 0, sizeof( renderEntity ) );
+	renderEntity.axis = idAngles( 10.0f, 30.0f, 5.0f ).ToMat3();
+	for( int i = 0; i < 4; i++ )
+	{
+		renderEntity.shaderParms[i] = 1.0f;
+	}
+	
+	renderView_t renderView;
+	memset( &renderView, 0, sizeof( renderView ) );
+	renderView.viewaxis = idAngles( 20.0f, 60.0f, 0.0f ).ToMat3();
+	
+	particleGen_t g;
+	memset( &g, 0, sizeof( g ) );
+	g.renderEnt = &renderEntity;
+	g.renderView = &renderView;
+	g.origin.Zero();
+	g.axis.Identity();
+	
+	idRandom random( 0 );
+	idParticleBatch batch( numParticles, true );
+	for( int i = 0; i < numParticles; i++ )
+	{
+		g.index = i;
+		g.frac = random.RandomFloat();
+		g.random.SetSeed( random.RandomInt() ^ ( i << 16 ) );
+		g.origin.Set( random.CRandomFloat() * 64.0f, random.CRandomFloat() * 64.0f, random.CRandomFloat() * 64.0f );
+		g.axis = idAngles( random.RandomFloat() * 360.0f, random.RandomFloat() * 360.0f, 0.0f ).ToMat3();
+		batch.Append( g );
+	}
+	
+	int maxQuads = 1;
+	for( int i = 0; i < declManager->GetNumDecls( DECL_PARTICLE ); i++ )
+	{
+		const idDeclParticle* decl = static_cast<const idDeclParticle*>( declManager->DeclByIndex( DECL_PARTICLE, i ) );
+		for( int j = 0; j < decl->stages.Num(); j++ )
+		{
+			maxQuads = Max( maxQuads, decl->stages[j]->NumQuadsPerParticle() );
+		}
+	}
+	idTempArray<idDrawVert> scalarVerts( numParticles * maxQuads * 4 );
+	idTempArray<idDrawVert> batchVerts( numParticles * maxQuads * 4 );
+	
+	int numStages = 0;
+	int numMismatched = 0;
+	float maxError = 0.0f;
+	uint64_t scalarTime = 0;
+	uint64_t batchTime = 0;
+	
+	for( int i = 0; i < declManager->GetNumDecls( DECL_PARTICLE ); i++ )
+	{
+		const idDeclParticle* decl = static_cast<const idDeclParticle*>( declManager->DeclByIndex( DECL_PARTICLE, i ) );
+		for( int j = 0; j < decl->stages.Num(); j++ )
+		{
+			const idParticleStage* stage = decl->stages[j];
+			if( !stage->CanBatchParticles() )
+			{
+				continue;
+			}
+			numStages++;
+			
+			uint64_t start = Sys_Microseconds();
+			int numScalarVerts = 0;
+			for( int k = 0; k < batch.Num(); k++ )
+			{
+				g.index = batch.indexes[k];
+				g.frac = batch.fracs[k];
+				g.random.SetSeed( batch.seeds[k] );
+				g.originalRandom = g.random;
+				g.age = g.frac * stage->particleLife;
+				g.origin = batch.origins[k];
+				g.axis = batch.axis[k];
+				numScalarVerts += stage->CreateParticle( &g, scalarVerts.Ptr() + numScalarVerts );
+			}
+			uint64_t mid = Sys_Microseconds();
+			const int numBatchVerts = stage->CreateParticles( &g, batch, batchVerts.Ptr() );
+			uint64_t end = Sys_Microseconds();
+			
+			scalarTime += mid - start;
+			batchTime += end - mid;
+			
+			bool mismatch = ( numScalarVerts != numBatchVerts );
+			for( int k = 0; k < numScalarVerts && !mismatch; k++ )
+			{
+				const idDrawVert& a = scalarVerts[k];
+				const idDrawVert& b = batchVerts[k];
+				const float error = ( a.xyz - b.xyz ).LengthFast() / Max( a.xyz.LengthFast(), 1.0f );
+				maxError = Max( maxError, error );
+				if( error > 1e-4f || a.GetColor() != b.GetColor() || a.st[0] != b.st[0] || a.st[1] != b.st[1] )
+				{
+					mismatch = true;
+				}
+			}
+			if( mismatch )
+			{
+				common->Printf( "%s stage %d: batched particles differ (%d / %d verts)\n", decl->GetName(), j, numBatchVerts, numScalarVerts );
+				numMismatched++;
+			}
+		}
+	}
+	
+	common->Printf( "%d stages, %d particles each, %d mismatched, max relative error %g\n", numStages, numParticles, numMismatched, maxError );
+	common->Printf( "CreateParticle %llu usec, CreateParticles %llu usec\n", ( unsigned long long )scalarTime, ( unsigned long long )batchTime );
+}
+
 /*
 ==================
 idParticleStage::GetCustomPathName
@@ -111,6 +111,57 @@ typedef struct
 } particleGen_t;
 
 
+//
+// particles collected for a single idParticleStage::CreateParticles call
+// the per particle values are kept in separate arrays so the SIMD path
+// can load four particles at a time
+//
+class idParticleBatch
+{
+public:
+	idParticleBatch();
+	idParticleBatch( int maxParticles, bool perParticleOrigins );
+	~idParticleBatch();
+	
+	// clears the batch and grows the memory owned by the batch if it can't hold maxParticles,
+	// so a batch that is kept around doesn't allocate every frame
+	void					Alloc( int maxParticles, bool perParticleOrigins );
+	// clears the batch and uses memory of at least StorageSize() bytes owned by the caller,
+	// which has to be 16 byte aligned and outlive the batch, like frame temporary memory
+	void					SetMemory( void* memory, int maxParticles, bool perParticleOrigins );
+	static int				StorageSize( int maxParticles, bool perParticleOrigins );
+	
+	// copies the index, frac and random seed out of g, and the origin and
+	// axis when the batch was created with perParticleOrigins
+	void					Append( const particleGen_t& g );
+	void					Clear()
+	{
+		numParticles = 0;
+	}
+	int						Num() const
+	{
+		return numParticles;
+	}
+	
+	int* 					indexes;
+	float* 					fracs;
+	int* 					seeds;
+	idVec3* 				origins;			// NULL if all particles use the particleGen_t origin and axis
+	idMat3* 				axis;
+	
+private:
+	int						numParticles;
+	int						maxParticles;
+	
+	byte* 					ownedMemory;
+	int						ownedSize;
+	
+	idParticleBatch( const idParticleBatch& );
+	void					operator=( const idParticleBatch& );
+};
+
+
+
 //
 // single particle stage
 //
@@ -124,6 +175,10 @@ public:
 	int						NumQuadsPerParticle() const;	// includes trails and cross faded animations
 	// returns the number of verts created, which will range from 0 to 4*NumQuadsPerParticle()
 	int						CreateParticle( particleGen_t* g, idDrawVert* verts ) const;
+	// creates all the particles of a batch in order, four at a time if CanBatchParticles()
+	// g supplies renderEnt, renderView and the origin and axis for batches without them
+	int						CreateParticles( particleGen_t* g, const idParticleBatch& batch, idDrawVert* verts ) const;
+	bool					CanBatchParticles() const;
 	
 	void					ParticleOrigin( particleGen_t* g, idVec3& origin ) const;
 	int						ParticleVerts( particleGen_t* g, const idVec3 origin, idDrawVert* verts ) const;
@@ -234,4 +289,6 @@ private:
 	void					WriteParticleParm( idFile* f, idParticleParm* parm, const char* name );
 };
 
+void TestParticleBatches_f( const idCmdArgs& args );
+
 #endif /* !__DECLPARTICLE_H__ */
@@ -33,8 +33,10 @@ If you have questions concerning this license or the applicable additional terms
 idCVar idDemoFile::com_logDemos( "com_logDemos", "0", CVAR_SYSTEM | CVAR_BOOL, "Write demo.log with debug information in it" );
 idCVar idDemoFile::com_compressDemos( "com_compressDemos", "1", CVAR_SYSTEM | CVAR_INTEGER | CVAR_ARCHIVE, "Compression scheme for demo files\n0: None    (Fast, large files)\n1: LZW     (Fast to compress, Fast to decompress, medium/small files)\n2: LZSS    (Slow to compress, Fast to decompress, small files)\n3: Huffman (Fast to compress, Slow to decompress, medium files)\nSee also: The 'CompressDemo' command" );
 idCVar idDemoFile::com_preloadDemos( "com_preloadDemos", "0", CVAR_SYSTEM | CVAR_BOOL | CVAR_ARCHIVE, "Load the whole demo in to RAM before running it" );
+idCVar idDemoFile::com_demoKeyframeInterval( "com_demoKeyframeInterval", "1000", CVAR_SYSTEM | CVAR_INTEGER | CVAR_ARCHIVE, "Milliseconds between the keyframes of a recorded demo, a demo can only seek to a keyframe. The block up to the next keyframe is held in memory while recording", 100, 60000 );
 
 #define DEMO_MAGIC GAME_NAME " RDEMO"
+#define DEMO_INDEXED_MAGIC GAME_NAME " IDEMO"
 
 /*
 ================
@@ -49,6 +51,11 @@ idDemoFile::idDemoFile()
 	fileImage = NULL;
 	compressor = NULL;
 	writing = false;
+	indexed = false;
+	compressionType = 0;
+	blockFile = NULL;
+	recordStartTime = 0;
+	lastKeyframeTime = 0;
 }
 
 /*
@@ -119,8 +126,15 @@ bool idDemoFile::OpenForReading( const char* fileName )
 	
 	writing = false;
 	
+	indexed = false;
+	
 	f->Read( magicBuffer, magicLen );
-	if( memcmp( magicBuffer, DEMO_MAGIC, magicLen ) == 0 )
+	if( memcmp( magicBuffer, DEMO_INDEXED_MAGIC, magicLen ) == 0 )
+	{
+		f->ReadInt( compression );
+		indexed = true;
+	}
+	else if( memcmp( magicBuffer, DEMO_MAGIC, magicLen ) == 0 )
 	{
 		f->ReadInt( compression );
 	}
@@ -132,6 +146,21 @@ bool idDemoFile::OpenForReading( const char* fileName )
 		f->Rewind();
 	}
 	
+	compressionType = compression;
+	
+	if( indexed )
+	{
+		// a demo that wasn't closed properly has no index and is missing the block that was
+		// still being recorded, the blocks before that play but can't seek
+		if( !ReadIndex( f->Tell() ) )
+		{
+			common->Warning( "demo %s has no keyframe index", fileName );
+		}
+		blockFile = new( TAG_SYSTEM ) idFile_Memory( "demoBlock", ( const char* )NULL, 0 );
+		ReadBlock();
+		return true;
+	}
+	
 	compressor = AllocCompressor( compression );
 	compressor->Init( f, false, 8 );
 	
@@ -186,17 +215,289 @@ bool idDemoFile::OpenForWriting( const char* fileName )
 	}
 	
 	writing = true;
+	indexed = true;
+	compressionType = com_compressDemos.GetInteger();
+	recordStartTime = Sys_Milliseconds();
+	lastKeyframeTime = 0;
 	
-	f->Write( DEMO_MAGIC, sizeof( DEMO_MAGIC ) );
-	f->WriteInt( com_compressDemos.GetInteger() );
+	f->Write( DEMO_INDEXED_MAGIC, sizeof( DEMO_INDEXED_MAGIC ) );
+	f->WriteInt( compressionType );
 	f->Flush();
 	
-	compressor = AllocCompressor( com_compressDemos.GetInteger() );
-	compressor->Init( f, true, 8 );
+	blockFile = new( TAG_SYSTEM ) idFile_Memory( "demoBlock" );
+	BeginWriteBlock();
+	
+	return true;
+}
+
+/*
+================
+idDemoFile::BeginWriteBlock
+================
+*/
+void idDemoFile::BeginWriteBlock()
+{
+	blockFile->Clear( false );
+	
+	compressor = AllocCompressor( compressionType );
+	compressor->Init( blockFile, true, 8 );
+	
+	// hash strings are never shared between blocks, so any block can be read on its own
+	demoStrings.DeleteContents( true );
+}
+
+/*
+================
+idDemoFile::FinishWriteBlock
+================
+*/
+void idDemoFile::FinishWriteBlock()
+{
+	if( compressor == NULL )
+	{
+		return;
+	}
+	
+	compressor->FinishCompress();
+	delete compressor;
+	compressor = NULL;
+	
+	f->WriteInt( blockFile->Length() );
+	f->Write( blockFile->GetDataPtr(), blockFile->Length() );
+}
+
+/*
+================
+idDemoFile::ReadBlock
+
+Returns false at the end of the blocks.
+================
+*/
+bool idDemoFile::ReadBlock()
+{
+	if( compressor != NULL )
+	{
+		delete compressor;
+		compressor = NULL;
+	}
+	
+	int length = 0;
+	if( f->ReadInt( length ) != sizeof( length ) || length <= 0 )
+	{
+		return false;
+	}
 	
+	blockData.SetNum( length );
+	if( f->Read( blockData.Ptr(), length ) != length )
+	{
+		return false;
+	}
+	blockFile->SetData( ( const char* )blockData.Ptr(), length );
+	
+	compressor = AllocCompressor( compressionType );
+	compressor->Init( blockFile, false, 8 );
+	
+	demoStrings.DeleteContents( true );
 	return true;
 }
 
+/*
+================
+idDemoFile::WriteIndex
+
+The blocks end with an empty block, followed by the keyframe index and
+the offset of the index as the last int of the file.
+================
+*/
+void idDemoFile::WriteIndex()
+{
+	f->WriteInt( 0 );
+	
+	const int indexOffset = f->Tell();
+	f->WriteInt( keyframes.Num() );
+	for( int i = 0; i < keyframes.Num(); i++ )
+	{
+		f->WriteInt( keyframes[i].time );
+		f->WriteInt( keyframes[i].offset );
+	}
+	f->WriteInt( indexOffset );
+}
+
+/*
+================
+idDemoFile::ReadIndex
+
+Leaves the file at the first block.
+================
+*/
+bool idDemoFile::ReadIndex( int firstBlockOffset )
+{
+	keyframes.Clear();
+	
+	const int fileLength = f->Length();
+	int indexOffset = -1;
+	int numKeyframes = -1;
+	
+	bool valid = false;
+	if( fileLength >= firstBlockOffset + 12 )
+	{
+		f->Seek( fileLength - 4, FS_SEEK_SET );
+		f->ReadInt( indexOffset );
+		if( indexOffset >= firstBlockOffset && indexOffset <= fileLength - 8 )
+		{
+			f->Seek( indexOffset, FS_SEEK_SET );
+			f->ReadInt( numKeyframes );
+			valid = ( numKeyframes >= 0 && indexOffset + 8 + numKeyframes * ( int )sizeof( int ) * 2 == fileLength );
+		}
+	}
+	
+	if( valid )
+	{
+		keyframes.SetNum( numKeyframes );
+		for( int i = 0; i < numKeyframes; i++ )
+		{
+			f->ReadInt( keyframes[i].time );
+			f->ReadInt( keyframes[i].offset );
+		}
+	}
+	
+	f->Seek( firstBlockOffset, FS_SEEK_SET );
+	return valid;
+}
+
+/*
+================
+idDemoFile::WantsKeyframe
+================
+*/
+bool idDemoFile::WantsKeyframe() const
+{
+	if( !writing || !indexed || com_demoKeyframeInterval.GetInteger() <= 0 )
+	{
+		return false;
+	}
+	return ( Sys_Milliseconds() - recordStartTime ) - lastKeyframeTime >= com_demoKeyframeInterval.GetInteger();
+}
+
+/*
+================
+idDemoFile::BeginKeyframe
+================
+*/
+void idDemoFile::BeginKeyframe()
+{
+	assert( writing && indexed );
+	
+	FinishWriteBlock();
+	
+	demoKeyframe_t& keyframe = keyframes.Alloc();
+	keyframe.time = Sys_Milliseconds() - recordStartTime;
+	keyframe.offset = f->Tell();
+	lastKeyframeTime = keyframe.time;
+	
+	BeginWriteBlock();
+	
+	WriteInt( DS_KEYFRAME );
+	WriteInt( keyframe.time );
+}
+
+/*
+================
+idDemoFile::CopyFrom
+
+Writes the rest of another demo with the compression of this one. The blocks of an
+indexed demo are copied one by one, a hash string index is only valid in its own
+block and the keyframes have to start a block to be found again.
+================
+*/
+void idDemoFile::CopyFrom( idDemoFile& source )
+{
+	assert( writing && indexed && !source.writing );
+	
+	static const int bufferSize = 65535;
+	byte* buffer = ( byte* )Mem_Alloc( bufferSize, TAG_CRAP );
+	
+	if( !source.indexed )
+	{
+		// an old demo is a single stream with a single hash string table, so it fits in one block
+		int bytesRead;
+		while( 0 != ( bytesRead = source.Read( buffer, bufferSize ) ) )
+		{
+			Write( buffer, bytesRead );
+		}
+		Mem_Free( buffer );
+		return;
+	}
+	
+	while( source.compressor != NULL )
+	{
+		int bytesRead;
+		while( 0 != ( bytesRead = source.compressor->Read( buffer, bufferSize ) ) )
+		{
+			Write( buffer, bytesRead );
+		}
+		
+		if( !source.ReadBlock() )
+		{
+			break;
+		}
+		
+		FinishWriteBlock();
+		
+		// the time of a keyframe is at the start of its block, so a demo without an index gets one
+		int header[2] = { 0, 0 };
+		const int headerLength = source.compressor->Read( header, sizeof( header ) );
+		if( headerLength == sizeof( header ) && LittleLong( header[0] ) == DS_KEYFRAME )
+		{
+			demoKeyframe_t& keyframe = keyframes.Alloc();
+			keyframe.time = LittleLong( header[1] );
+			keyframe.offset = f->Tell();
+			lastKeyframeTime = keyframe.time;
+		}
+		
+		BeginWriteBlock();
+		Write( header, headerLength );
+	}
+	
+	Mem_Free( buffer );
+}
+
+/*
+================
+idDemoFile::SeekToKeyframe
+================
+*/
+int idDemoFile::SeekToKeyframe( int time )
+{
+	if( writing || !indexed || keyframes.Num() == 0 )
+	{
+		return -1;
+	}
+	
+	// find the last keyframe that isn't after the time, or the first one
+	int lo = 0;
+	int hi = keyframes.Num() - 1;
+	while( lo < hi )
+	{
+		const int mid = ( lo + hi + 1 ) >> 1;
+		if( keyframes[mid].time <= time )
+		{
+			lo = mid;
+		}
+		else
+		{
+			hi = mid - 1;
+		}
+	}
+	
+	f->Seek( keyframes[lo].offset, FS_SEEK_SET );
+	if( !ReadBlock() )
+	{
+		return -1;
+	}
+	return keyframes[lo].time;
+}
+
 /*
 ================
 idDemoFile::Close
@@ -204,7 +505,12 @@ idDemoFile::Close
 */
 void idDemoFile::Close()
 {
-	if( writing && compressor )
+	if( writing && indexed && f )
+	{
+		FinishWriteBlock();
+		WriteIndex();
+	}
+	else if( writing && compressor )
 	{
 		compressor->FinishCompress();
 	}
@@ -229,6 +535,16 @@ void idDemoFile::Close()
 		delete compressor;
 		compressor = NULL;
 	}
+	if( blockFile )
+	{
+		delete blockFile;
+		blockFile = NULL;
+	}
+	blockData.Clear();
+	keyframes.Clear();
+	
+	writing = false;
+	indexed = false;
 	
 	demoStrings.DeleteContents( true );
 }
@@ -349,7 +665,15 @@ void idDemoFile::WriteDict( const idDict& dict )
  */
 int idDemoFile::Read( void* buffer, int len )
 {
-	int read = compressor->Read( buffer, len );
+	int read = ( compressor != NULL ) ? compressor->Read( buffer, len ) : 0;
+	if( indexed )
+	{
+		// continue with the next block when this one runs out
+		while( read < len && ReadBlock() )
+		{
+			read += compressor->Read( ( byte* )buffer + read, len - read );
+		}
+	}
 	if( read == 0 && len >= 4 )
 	{
 		*( demoSystem_t* )buffer = DS_FINISHED;
@@ -364,6 +688,10 @@ int idDemoFile::Read( void* buffer, int len )
  */
 int idDemoFile::Write( const void* buffer, int len )
 {
+	if( compressor == NULL )
+	{
+		return 0;
+	}
 	return compressor->Write( buffer, len );
 }
 
@@ -35,6 +35,12 @@ If you have questions concerning this license or the applicable additional terms
 
 	Demo file
 
+	Demos are written as a series of independently compressed blocks. Every
+	block but the first starts with a keyframe that holds enough state to
+	start playing from there, and an index of the keyframes at the end of the
+	file lets playback jump to any of them without reading what comes before.
+	Demos written before the index was added are still read as one stream.
+
 ===============================================================================
 */
 
@@ -44,7 +50,8 @@ typedef enum
 	DS_RENDER,
 	DS_SOUND,
 	DS_GAME,	
-	DS_VERSION
+	DS_VERSION,
+	DS_KEYFRAME
 } demoSystem_t;
 
 class idDemoFile : public idFile
@@ -77,13 +84,53 @@ public:
 	int				Read( void* buffer, int len );
 	int				Write( const void* buffer, int len );
 	
+	// true if it is time to start a new keyframe
+	bool			WantsKeyframe() const;
+	// ends the current block and starts a keyframe block, the caller writes the state after this
+	void			BeginKeyframe();
+	// jumps to the last keyframe at or before the time in milliseconds from the start
+	// of the recording, or the first one, returns the time of the keyframe or -1 if
+	// the demo has no keyframes
+	int				SeekToKeyframe( int time );
+	// writes the rest of a demo that is open for reading to this one
+	void			CopyFrom( idDemoFile& source );
+	int				GetNumKeyframes() const
+	{
+		return keyframes.Num();
+	}
+	// time of the last keyframe in milliseconds from the start of the recording
+	int				GetLastKeyframeTime() const
+	{
+		return ( keyframes.Num() > 0 ? keyframes[keyframes.Num() - 1].time : 0 );
+	}
+	
 private:
+	struct demoKeyframe_t
+	{
+		int			time;				// milliseconds from the start of the recording
+		int			offset;				// file offset of the block
+	};
+	
 	static idCompressor* AllocCompressor( int type );
 	
+	void			BeginWriteBlock();
+	void			FinishWriteBlock();
+	bool			ReadBlock();
+	void			WriteIndex();
+	bool			ReadIndex( int firstBlockOffset );
+	
 	bool			writing;
+	bool			indexed;
 	byte* 			fileImage;
 	idFile* 		f;
 	idCompressor* 	compressor;
+	int				compressionType;
+	
+	idFile_Memory* 	blockFile;			// the current block before it is compressed to / after it is read from the file
+	idList<byte>	blockData;
+	idList<demoKeyframe_t>	keyframes;
+	int				recordStartTime;
+	int				lastKeyframeTime;
 	
 	idList<idStr*>	demoStrings;
 	idFile* 		fLog;
@@ -93,6 +140,7 @@ private:
 	static idCVar	com_logDemos;
 	static idCVar	com_compressDemos;
 	static idCVar	com_preloadDemos;
+	static idCVar	com_demoKeyframeInterval;
 };
 
 #endif /* !__DEMOFILE_H__ */
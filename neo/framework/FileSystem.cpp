@@ -197,6 +197,7 @@ public:
 	virtual bool			IsSoundSample( const idStr& resName ) const;
 	virtual void			FreeResourceBuffer()
 	{
+		idScopedCriticalSection cs( resourceFileMutex );
 		resourceBufferAvailable = resourceBufferSize;
 	}
 	virtual void			AddImagePreload( const char* resName, int _filter, int _repeat, int _usage, int _cube )
@@ -262,6 +263,7 @@ private:
 	idPreloadManifest		preloadList;
 	
 	idList< idResourceContainer* > resourceFiles;
+	idSysMutex				resourceFileMutex;		// the container handles are shared by all threads reading from them
 	byte* 	resourceBufferPtr;
 	int		resourceBufferSize;
 	int		resourceBufferAvailable;
@@ -278,6 +280,7 @@ private:
 	bool 					IsFileSameAsInResources(const char *filename);
 
 	void					ReplaceSeparators( idStr& path, char sep = PATHSEPARATOR_CHAR );
+	void					BuildOSPath( const char* base, const char* game, const char* relativePath, idStr& OSPath );
 	int						ListOSFiles( const char* directory, const char* extension, idStrList& list );
 	idFileHandle			OpenOSFile( const char* name, fsMode_t mode );
 	void					CloseOSFile( idFileHandle o );
@@ -331,6 +334,9 @@ idFileSystemLocal::ReadFromBGL
 */
 int idFileSystemLocal::ReadFromBGL( idFile* _resourceFile, void* _buffer, int _offset, int _len )
 {
+	// the image loader thread reads from the same handles as the main thread
+	idScopedCriticalSection cs( resourceFileMutex );
+	
 	if( _resourceFile->Tell() != _offset )
 	{
 		_resourceFile->Seek( _offset, FS_SEEK_SET );
@@ -2206,13 +2212,33 @@ const char* idFileSystemLocal::BuildOSPath( const char* base, const char* game,
 		return relativePath;
 	}
 	
+	BuildOSPath( base, game, relativePath, newPath );
+	idStr::Copynz( OSPath, newPath, sizeof( OSPath ) );
+	return OSPath;
+}
+
+/*
+===================
+idFileSystemLocal::BuildOSPath
+
+Builds the path in a string of the caller instead of the shared buffer, files are also
+opened for reading from other threads than the main thread
+===================
+*/
+void idFileSystemLocal::BuildOSPath( const char* base, const char* game, const char* relativePath, idStr& OSPath )
+{
+	// handle case of this already being an OS path
+	if( IsOSPath( relativePath ) )
+	{
+		OSPath = relativePath;
+		return;
+	}
+	
 	idStr strBase = base;
 	strBase.StripTrailing( '/' );
 	strBase.StripTrailing( '\\' );
-	sprintf( newPath, "%s/%s/%s", strBase.c_str(), game, relativePath );
-	ReplaceSeparators( newPath );
-	idStr::Copynz( OSPath, newPath, sizeof( OSPath ) );
-	return OSPath;
+	sprintf( OSPath, "%s/%s/%s", strBase.c_str(), game, relativePath );
+	ReplaceSeparators( OSPath );
 }
 
 /*
@@ -3825,7 +3851,7 @@ idFile* idFileSystemLocal::GetResourceFile( const char* fileName, bool memFile )
 		return NULL;
 	}
 	
-	static idResourceCacheEntry rc;
+	idResourceCacheEntry rc;
 	if( GetResourceCacheEntry( fileName, rc ) )
 	{
 		if( fs_debugResources.GetBool() )
@@ -3837,12 +3863,14 @@ idFile* idFileSystemLocal::GetResourceFile( const char* fileName, bool memFile )
 		if( file != NULL && ( ( memFile || rc.length <= resourceBufferAvailable ) || rc.length < 8 * 1024 * 1024 ) )
 		{
 			byte* buf = NULL;
+			resourceFileMutex.Lock();
 			if( rc.length < resourceBufferAvailable )
 			{
 				buf = resourceBufferPtr;
 				resourceBufferAvailable = 0;
 			}
-			else
+			resourceFileMutex.Unlock();
+			if( buf == NULL )
 			{
 				if( fs_debugResources.GetBool() )
 				{
@@ -3949,7 +3977,8 @@ idFile* idFileSystemLocal::OpenFileReadFlags( const char* relativePath, int sear
 				}
 			}
 			
-			idStr netpath = BuildOSPath( searchPaths[sp].path, searchPaths[sp].gamedir, relativePath );
+			idStr netpath;
+			BuildOSPath( searchPaths[sp].path, searchPaths[sp].gamedir, relativePath, netpath );
 			idFileHandle fp = OpenOSFile( netpath, FS_READ );
 			if( !fp )
 			{
@@ -3973,7 +4002,7 @@ idFile* idFileSystemLocal::OpenFileReadFlags( const char* relativePath, int sear
 			
 				idStr copypath;
 				idStr name;
-				copypath = BuildOSPath( fs_savepath.GetString(), searchPaths[sp].gamedir, relativePath );
+				BuildOSPath( fs_savepath.GetString(), searchPaths[sp].gamedir, relativePath, copypath );
 				netpath.ExtractFileName( name );
 				copypath.StripFilename();
 				copypath += PATHSEPARATOR_STR;
@@ -848,34 +848,11 @@ ID_INLINE void idSerializer::SerializePacked( int& original )
 	
 	if( IsWriting() )
 	{
-		uint32_t value = original;
-		
-		while( true )
-		{
-			uint8_t byte = value & 0x7F;
-			value >>= 7;
-			byte |= value ? 0x80 : 0;
-			msg->WriteByte( byte );		// Emit byte
-			if( value == 0 )
-			{
-				break;
-			}
-		}
+		msg->WritePackedInt( original );
 	}
 	else
 	{
-		uint8_t byte = 0x80;
-		uint32_t value = 0;
-		int32_t shift = 0;
-		
-		while( byte & 0x80 && shift < 32 )
-		{
-			byte = msg->ReadByte();
-			value |= ( byte & 0x7F ) << shift;
-			shift += 7;
-		}
-		
-		original = value;
+		original = msg->ReadPackedInt();
 	}
 }
 
@@ -894,41 +871,11 @@ ID_INLINE void idSerializer::SerializeSPacked( int& value )
 	
 	if( IsWriting() )
 	{
-	
-		uint32_t uvalue = idMath::Abs( value );
-		
-		// Write the first byte specifically to handle the sign bit
-		uint8_t byte = uvalue & 0x3f;
-		byte |= value < 0 ? 0x40 : 0;
-		uvalue >>= 6;
-		byte |= uvalue > 0 ? 0x80 : 0;
-		
-		msg->WriteByte( byte );
-		
-		while( uvalue > 0 )
-		{
-			uint8_t byte2 = uvalue & 0x7F;
-			uvalue >>= 7;
-			byte2 |= uvalue ? 0x80 : 0;
-			msg->WriteByte( byte2 );		// Emit byte
-		}
+		msg->WriteSPackedInt( value );
 	}
 	else
 	{
-		// Load the first byte specifically to handle the sign bit
-		uint8_t byte		= msg->ReadByte();
-		uint32_t uvalue	= byte & 0x3f;
-		bool sgn		= ( byte & 0x40 ) ? true : false;
-		int32_t shift		= 6;
-		
-		while( byte & 0x80 && shift < 32 )
-		{
-			byte = msg->ReadByte();		// Read byte
-			uvalue |= ( byte & 0x7F ) << shift;
-			shift += 7;
-		}
-		
-		value = sgn ? -( ( int )uvalue ) : uvalue;
+		value = msg->ReadSPackedInt();
 	}
 }
 
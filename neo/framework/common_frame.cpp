@@ -320,6 +320,11 @@ void idCommonLocal::Draw( void )
 		{
 			renderSystem->WriteDemoPics();
 			renderSystem->WriteEndFrame();
+			
+			if( writeDemo->WantsKeyframe() )
+			{
+				WriteRenderDemoKeyframe();
+			}
 		}
 	}
 	else
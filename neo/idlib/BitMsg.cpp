@@ -98,6 +98,52 @@ static uint64_t maskForNumBits64[33] = {	NBM( 0x00 ), NBM( 0x01 ), NBM( 0x02 ),
 										NBM( 0x1C ), NBM( 0x1D ), NBM( 0x1E ), NBM( 0x1F ), 0xFFFFFFFF
 									 };
 
+/*
+========================
+BitsValueFits
+
+If the number of bits is negative a sign is included.
+========================
+*/
+static ID_INLINE bool BitsValueFits( int value, int numBits )
+{
+	if( numBits == 32 )
+	{
+		return true;
+	}
+	if( numBits > 0 )
+	{
+		return value >= 0 && ( int64_t )value <= ( ( int64_t )1 << numBits ) - 1;
+	}
+	const int64_t r = ( int64_t )1 << ( -1 - numBits );
+	return value >= -r && value <= r - 1;
+}
+
+/*
+========================
+LoadBits64
+
+Loads the 8 bytes at offset as a little endian word, bytes past the end of the data read as zero.
+========================
+*/
+static ID_INLINE uint64_t LoadBits64( const byte* data, int offset, int size )
+{
+	uint64_t bits = 0;
+	if( offset + 8 <= size )
+	{
+		memcpy( &bits, data + offset, 8 );
+		idSwap::Little( bits );
+	}
+	else
+	{
+		for( int i = offset; i < size; i++ )
+		{
+			bits |= ( uint64_t )data[i] << ( ( i - offset ) << 3 );
+		}
+	}
+	return bits;
+}
+
 /*
 ========================
 idBitMsg::WriteBits
@@ -119,38 +165,9 @@ void idBitMsg::WriteBits( int value, int numBits )
 	}
 	
 	// check for value overflows
-	if( numBits != 32 )
+	if( !BitsValueFits( value, numBits ) )
 	{
-		if( numBits > 0 )
-		{
-			if( value > ( 1 << numBits ) - 1 )
-			{
-				idLib::FatalError( "idBitMsg::WriteBits: value overflow %d %d",
-								   value, numBits );
-								   
-			}
-			else if( value < 0 )
-			{
-				idLib::FatalError( "idBitMsg::WriteBits: value overflow %d %d",
-								   value, numBits );
-			}
-		}
-		else
-		{
-			const unsigned shift = ( -1 - numBits );
-			int r = 1 << shift;
-			if( value > r - 1 )
-			{
-				idLib::FatalError( "idBitMsg::WriteBits: value overflow %d %d",
-								   value, numBits );
-								   
-			}
-			else if( value < -r )
-			{
-				idLib::FatalError( "idBitMsg::WriteBits: value overflow %d %d",
-								   value, numBits );
-			}
-		}
+		idLib::FatalError( "idBitMsg::WriteBits: value overflow %d %d", value, numBits );
 	}
 	
 	if( numBits < 0 )
@@ -169,7 +186,23 @@ void idBitMsg::WriteBits( int value, int numBits )
 	
 	writeBit += numBits;
 	
-	// Flush 8 bits (1 byte) at a time
+	if( curSize + 8 <= maxSize )
+	{
+		// Merge the accumulator into a single word, bytes past the leftover are kept because
+		// some callers place data after the write position before writing in front of it
+		const int numBytes = ( writeBit + 7 ) >> 3;
+		uint64_t word = ( LoadBits64( writeData, curSize, maxSize ) & ( ~0ULL << ( numBytes << 3 ) ) ) | tempValue;
+		idSwap::Little( word );
+		memcpy( writeData + curSize, &word, 8 );
+		
+		const int numFullBytes = writeBit >> 3;
+		curSize += numFullBytes;
+		tempValue >>= numFullBytes << 3;
+		writeBit &= 7;
+		return;
+	}
+	
+	// Flush 8 bits (1 byte) at a time near the end of the buffer
 	while( writeBit >= 8 )
 	{
 		writeData[curSize++] = tempValue & 255;
@@ -184,6 +217,175 @@ void idBitMsg::WriteBits( int value, int numBits )
 	}
 }
 
+/*
+========================
+idBitMsg::WritePackedBits
+
+Appends the low numBits of each value with a single overflow check, the bits are gathered in a local
+accumulator and stored 32 at a time. The result is identical to a WriteBits call per value.
+========================
+*/
+void idBitMsg::WritePackedBits( const uint32_t* values, int count, int numBits )
+{
+	if( !writeData )
+	{
+		idLib::FatalError( "idBitMsg::WritePackedBits: cannot write to message" );
+	}
+	
+	assert( numBits > 0 && numBits <= 32 );
+	
+	if( count <= 0 || CheckOverflow( numBits * count ) )
+	{
+		return;
+	}
+	
+	const uint64_t mask = maskForNumBits64[numBits];
+	uint64_t accumulator = tempValue;
+	int accumulatorBits = writeBit;
+	byte* out = writeData + curSize;
+	
+	for( int i = 0; i < count; i++ )
+	{
+		accumulator |= ( values[i] & mask ) << accumulatorBits;
+		accumulatorBits += numBits;
+		
+		// at most 31 leftover bits plus 32 new ones are held
+		if( accumulatorBits >= 32 )
+		{
+			uint32_t word = ( uint32_t )accumulator;
+			idSwap::Little( word );
+			memcpy( out, &word, 4 );
+			out += 4;
+			accumulator >>= 32;
+			accumulatorBits -= 32;
+		}
+	}
+	
+	while( accumulatorBits >= 8 )
+	{
+		*out++ = accumulator & 255;
+		accumulator >>= 8;
+		accumulatorBits -= 8;
+	}
+	
+	if( accumulatorBits > 0 )
+	{
+		*out = accumulator & 255;
+	}
+	
+	curSize = out - writeData;
+	writeBit = accumulatorBits;
+	tempValue = accumulator;
+}
+
+/*
+========================
+idBitMsg::WriteBitsArray
+
+If the number of bits is negative a sign is included.
+========================
+*/
+void idBitMsg::WriteBitsArray( const int* values, int count, int numBits )
+{
+	if( numBits == 0 || numBits < -31 || numBits > 32 )
+	{
+		idLib::FatalError( "idBitMsg::WriteBitsArray: bad numBits %i", numBits );
+	}
+	
+	for( int i = 0; i < count; i++ )
+	{
+		if( !BitsValueFits( values[i], numBits ) )
+		{
+			idLib::FatalError( "idBitMsg::WriteBitsArray: value overflow %d %d", values[i], numBits );
+		}
+	}
+	
+	WritePackedBits( reinterpret_cast< const uint32_t* >( values ), count, abs( numBits ) );
+}
+
+/*
+========================
+idBitMsg::WriteFloatArray
+========================
+*/
+void idBitMsg::WriteFloatArray( const float* f, int count )
+{
+	WritePackedBits( reinterpret_cast< const uint32_t* >( f ), count, 32 );
+}
+
+/*
+========================
+idBitMsg::WriteFloatArray
+========================
+*/
+void idBitMsg::WriteFloatArray( const float* f, int count, int exponentBits, int mantissaBits )
+{
+	uint32_t bits[MAX_BULK_VALUES];
+	
+	while( count > 0 )
+	{
+		const int num = Min( count, MAX_BULK_VALUES );
+		for( int i = 0; i < num; i++ )
+		{
+			bits[i] = idMath::FloatToBits( f[i], exponentBits, mantissaBits );
+		}
+		WritePackedBits( bits, num, 1 + exponentBits + mantissaBits );
+		f += num;
+		count -= num;
+	}
+}
+
+/*
+========================
+idBitMsg::WritePackedInt
+
+Writes out 7 bits at a time, using every 8th bit to signify more bits exist.
+========================
+*/
+void idBitMsg::WritePackedInt( int original )
+{
+	uint32_t value = original;
+	uint32_t bytes[5];
+	int numBytes = 0;
+	
+	do
+	{
+		bytes[numBytes] = value & 0x7F;
+		value >>= 7;
+		bytes[numBytes++] |= value ? 0x80 : 0;
+	}
+	while( value != 0 );
+	
+	WritePackedBits( bytes, numBytes, 8 );
+}
+
+/*
+========================
+idBitMsg::WriteSPackedInt
+
+An extra bit of the first byte is used to store the sign.
+========================
+*/
+void idBitMsg::WriteSPackedInt( int original )
+{
+	uint32_t value = idMath::Abs( original );
+	uint32_t bytes[5];
+	int numBytes = 0;
+	
+	bytes[0] = ( value & 0x3F ) | ( original < 0 ? 0x40 : 0 );
+	value >>= 6;
+	bytes[numBytes++] |= value ? 0x80 : 0;
+	
+	while( value != 0 )
+	{
+		bytes[numBytes] = value & 0x7F;
+		value >>= 7;
+		bytes[numBytes++] |= value ? 0x80 : 0;
+	}
+	
+	WritePackedBits( bytes, numBytes, 8 );
+}
+
 /*
 ========================
 idBitMsg::WriteString
@@ -326,9 +528,6 @@ If the number of bits is negative a sign is included.
 int idBitMsg::ReadBits( int numBits ) const
 {
 	int		value;
-	int		valueBits;
-	int		get;
-	int		fraction;
 	bool	sgn;
 	
 	if( !readData )
@@ -342,9 +541,6 @@ int idBitMsg::ReadBits( int numBits ) const
 		idLib::FatalError( "idBitMsg::ReadBits: bad numBits %i", numBits );
 	}
 	
-	value = 0;
-	valueBits = 0;
-	
 	if( numBits < 0 )
 	{
 		numBits = -numBits;
@@ -361,38 +557,204 @@ int idBitMsg::ReadBits( int numBits ) const
 		return -1;
 	}
 	
-	while( valueBits < numBits )
+	// at most 7 bits into the first byte plus 32 bits, a single word holds the value
+	const int bitPos = GetNumBitsRead();
+	value = ( int )( ( LoadBits64( readData, bitPos >> 3, curSize ) >> ( bitPos & 7 ) ) & maskForNumBits64[numBits] );
+	SetReadPosition( bitPos + numBits );
+	
+	if( sgn )
 	{
-		if( readBit == 0 )
+		if( value & ( 1 << ( numBits - 1 ) ) )
 		{
-			readCount++;
+			value |= -1 ^ ( ( 1 << numBits ) - 1 );
 		}
-		get = 8 - readBit;
-		if( get > ( numBits - valueBits ) )
+	}
+	
+	return value;
+}
+
+/*
+========================
+idBitMsg::ReadPackedBits
+
+Reads count values of numBits each, the caller has checked they are all in the message.
+========================
+*/
+void idBitMsg::ReadPackedBits( int* values, int count, int numBits, bool sgn ) const
+{
+	assert( numBits > 0 && numBits <= 32 );
+	
+	const uint64_t mask = maskForNumBits64[numBits];
+	const uint32_t signBit = 1u << ( numBits - 1 );
+	int bitPos = GetNumBitsRead();
+	
+	for( int i = 0; i < count; i++ )
+	{
+		uint32_t value = ( uint32_t )( ( LoadBits64( readData, bitPos >> 3, curSize ) >> ( bitPos & 7 ) ) & mask );
+		if( sgn && ( value & signBit ) )
 		{
-			get = ( numBits - valueBits );
+			value |= ~( uint32_t )mask;
 		}
-		fraction = readData[readCount - 1];
-		fraction >>= readBit;
-		// this doesn't really do anything: the bits set to 0 here are already shifted to 0
-		fraction &= ( 1 << get ) - 1;
-		value |= fraction << valueBits;
-		
-		valueBits += get;
-		readBit = ( readBit + get ) & 7;
+		values[i] = ( int )value;
+		bitPos += numBits;
 	}
 	
-	if( sgn )
+	SetReadPosition( bitPos );
+}
+
+/*
+========================
+idBitMsg::ReadBitsArray
+
+If the number of bits is negative a sign is included. Values past the end of the message read as -1, like ReadBits.
+========================
+*/
+void idBitMsg::ReadBitsArray( int* values, int count, int numBits ) const
+{
+	if( !readData )
 	{
-		if( value & ( 1 << ( numBits - 1 ) ) )
+		idLib::FatalError( "idBitMsg::ReadBitsArray: cannot read from message" );
+	}
+	
+	if( numBits == 0 || numBits < -31 || numBits > 32 )
+	{
+		idLib::FatalError( "idBitMsg::ReadBitsArray: bad numBits %i", numBits );
+	}
+	
+	if( count <= 0 )
+	{
+		return;
+	}
+	
+	if( abs( numBits ) * count > GetRemainingReadBits() )
+	{
+		for( int i = 0; i < count; i++ )
 		{
-			value |= -1 ^ ( ( 1 << numBits ) - 1 );
+			values[i] = ReadBits( numBits );
+		}
+		return;
+	}
+	
+	ReadPackedBits( values, count, abs( numBits ), numBits < 0 );
+}
+
+/*
+========================
+idBitMsg::ReadFloatArray
+========================
+*/
+void idBitMsg::ReadFloatArray( float* f, int count ) const
+{
+	compile_time_assert( sizeof( float ) == sizeof( int ) );
+	ReadBitsArray( reinterpret_cast< int* >( f ), count, 32 );
+}
+
+/*
+========================
+idBitMsg::ReadFloatArray
+========================
+*/
+void idBitMsg::ReadFloatArray( float* f, int count, int exponentBits, int mantissaBits ) const
+{
+	int bits[MAX_BULK_VALUES];
+	
+	while( count > 0 )
+	{
+		const int num = Min( count, MAX_BULK_VALUES );
+		ReadBitsArray( bits, num, 1 + exponentBits + mantissaBits );
+		for( int i = 0; i < num; i++ )
+		{
+			f[i] = idMath::BitsToFloat( bits[i], exponentBits, mantissaBits );
+		}
+		f += num;
+		count -= num;
+	}
+}
+
+/*
+========================
+idBitMsg::ReadPackedInt
+
+Decodes from a single word when the longest encoding fits in the message.
+========================
+*/
+int idBitMsg::ReadPackedInt() const
+{
+	uint32_t value = 0;
+	uint32_t byte = 0x80;
+	int shift = 0;
+	
+	if( GetRemainingReadBits() < 5 * 8 )
+	{
+		while( ( byte & 0x80 ) && shift < 32 )
+		{
+			byte = ReadByte();
+			value |= ( byte & 0x7F ) << shift;
+			shift += 7;
 		}
+		return value;
+	}
+	
+	const int bitPos = GetNumBitsRead();
+	const uint64_t word = LoadBits64( readData, bitPos >> 3, curSize ) >> ( bitPos & 7 );
+	int numBytes = 0;
+	
+	while( ( byte & 0x80 ) && shift < 32 )
+	{
+		byte = ( word >> ( numBytes << 3 ) ) & 0xFF;
+		value |= ( byte & 0x7F ) << shift;
+		shift += 7;
+		numBytes++;
 	}
 	
+	SetReadPosition( bitPos + ( numBytes << 3 ) );
 	return value;
 }
 
+/*
+========================
+idBitMsg::ReadSPackedInt
+========================
+*/
+int idBitMsg::ReadSPackedInt() const
+{
+	if( GetRemainingReadBits() < 5 * 8 )
+	{
+		uint32_t byte = ReadByte();
+		uint32_t value = byte & 0x3F;
+		const bool sgn = ( byte & 0x40 ) != 0;
+		int shift = 6;
+		
+		while( ( byte & 0x80 ) && shift < 32 )
+		{
+			byte = ReadByte();
+			value |= ( byte & 0x7F ) << shift;
+			shift += 7;
+		}
+		return sgn ? -( int )value : value;
+	}
+	
+	const int bitPos = GetNumBitsRead();
+	const uint64_t word = LoadBits64( readData, bitPos >> 3, curSize ) >> ( bitPos & 7 );
+	
+	uint32_t byte = word & 0xFF;
+	uint32_t value = byte & 0x3F;
+	const bool sgn = ( byte & 0x40 ) != 0;
+	int shift = 6;
+	int numBytes = 1;
+	
+	while( ( byte & 0x80 ) && shift < 32 )
+	{
+		byte = ( word >> ( numBytes << 3 ) ) & 0xFF;
+		value |= ( byte & 0x7F ) << shift;
+		shift += 7;
+		numBytes++;
+	}
+	
+	SetReadPosition( bitPos + ( numBytes << 3 ) );
+	return sgn ? -( int )value : value;
+}
+
 /*
 ========================
 idBitMsg::ReadString
@@ -593,3 +955,446 @@ idVec3 idBitMsg::BitsToDir( int bits, int numBits )
 	dir.NormalizeFast();
 	return dir;
 }
+
+/*
+================================================================================================
+
+	idBitMsg benchmark
+
+================================================================================================
+*/
+
+static const int BENCH_ENTITIES			= 256;
+static const int BENCH_USERCMDS			= 512;
+static const int BENCH_PACKED_INTS		= 2048;
+static const int BENCH_MSG_SIZE			= 64 * 1024;
+
+// entity layout of idGameLocal::ServerWriteSnapshot followed by rigid body physics and a bind
+struct benchEntity_t
+{
+	int		header[4];			// spawn id, type, entity def, predicted key
+	float	position[3];
+	float	orientation[3];
+	float	momentum[3];
+	float	velocity[3];		// quantized
+	int		bind[3];			// entity, flags, joint
+};
+
+// fields of usercmd_t::Serialize
+struct benchUsercmd_t
+{
+	int		buttons[3];			// buttons, forward, right
+	int		angles[3];
+	float	pos[3];
+	int		times[2];
+	float	speedSquared;
+	int		impulse[3];			// fire count, impulse, sequence
+};
+
+static const int benchHeaderBits[4] = { 20, 10, 12, 32 };
+
+/*
+========================
+BenchWriteEntities
+========================
+*/
+static void BenchWriteEntities( idBitMsg& msg, const benchEntity_t* ents, bool arrays )
+{
+	for( int e = 0; e < BENCH_ENTITIES; e++ )
+	{
+		const benchEntity_t& ent = ents[e];
+		for( int i = 0; i < 4; i++ )
+		{
+			msg.WriteBits( ent.header[i], benchHeaderBits[i] );
+		}
+		if( arrays )
+		{
+			msg.WriteFloatArray( ent.position, 3 );
+			msg.WriteFloatArray( ent.orientation, 3 );
+			msg.WriteFloatArray( ent.momentum, 3, 5, 10 );
+			msg.WriteQuantizedFloatArray< 2048, 16 >( ent.velocity, 3 );
+		}
+		else
+		{
+			for( int i = 0; i < 3; i++ )
+			{
+				msg.WriteFloat( ent.position[i] );
+			}
+			for( int i = 0; i < 3; i++ )
+			{
+				msg.WriteFloat( ent.orientation[i] );
+			}
+			for( int i = 0; i < 3; i++ )
+			{
+				msg.WriteFloat( ent.momentum[i], 5, 10 );
+			}
+			for( int i = 0; i < 3; i++ )
+			{
+				msg.WriteQuantizedFloat< 2048, 16 >( ent.velocity[i] );
+			}
+		}
+		msg.WriteBits( ent.bind[0], 12 );
+		msg.WriteBits( ent.bind[1], 2 );
+		msg.WriteBits( ent.bind[2], 7 );
+	}
+}
+
+/*
+========================
+BenchReadEntities
+========================
+*/
+static void BenchReadEntities( const idBitMsg& msg, benchEntity_t* ents, bool arrays )
+{
+	for( int e = 0; e < BENCH_ENTITIES; e++ )
+	{
+		benchEntity_t& ent = ents[e];
+		for( int i = 0; i < 4; i++ )
+		{
+			ent.header[i] = msg.ReadBits( benchHeaderBits[i] );
+		}
+		if( arrays )
+		{
+			msg.ReadFloatArray( ent.position, 3 );
+			msg.ReadFloatArray( ent.orientation, 3 );
+			msg.ReadFloatArray( ent.momentum, 3, 5, 10 );
+			msg.ReadQuantizedFloatArray< 2048, 16 >( ent.velocity, 3 );
+		}
+		else
+		{
+			for( int i = 0; i < 3; i++ )
+			{
+				ent.position[i] = msg.ReadFloat();
+			}
+			for( int i = 0; i < 3; i++ )
+			{
+				ent.orientation[i] = msg.ReadFloat();
+			}
+			for( int i = 0; i < 3; i++ )
+			{
+				ent.momentum[i] = msg.ReadFloat( 5, 10 );
+			}
+			for( int i = 0; i < 3; i++ )
+			{
+				ent.velocity[i] = msg.ReadQuantizedFloat< 2048, 16 >();
+			}
+		}
+		ent.bind[0] = msg.ReadBits( 12 );
+		ent.bind[1] = msg.ReadBits( 2 );
+		ent.bind[2] = msg.ReadBits( 7 );
+	}
+}
+
+/*
+========================
+BenchWriteUsercmds
+========================
+*/
+static void BenchWriteUsercmds( idBitMsg& msg, const benchUsercmd_t* cmds, bool arrays )
+{
+	for( int c = 0; c < BENCH_USERCMDS; c++ )
+	{
+		const benchUsercmd_t& cmd = cmds[c];
+		if( arrays )
+		{
+			msg.WriteBitsArray( cmd.buttons, 3, -8 );
+			msg.WriteBitsArray( cmd.angles, 3, -16 );
+			msg.WriteFloatArray( cmd.pos, 3 );
+			msg.WriteBitsArray( cmd.times, 2, 32 );
+			msg.WriteFloat( cmd.speedSquared );
+			msg.WriteBitsArray( cmd.impulse, 3, 8 );
+		}
+		else
+		{
+			for( int i = 0; i < 3; i++ )
+			{
+				msg.WriteChar( cmd.buttons[i] );
+			}
+			for( int i = 0; i < 3; i++ )
+			{
+				msg.WriteShort( cmd.angles[i] );
+			}
+			for( int i = 0; i < 3; i++ )
+			{
+				msg.WriteFloat( cmd.pos[i] );
+			}
+			for( int i = 0; i < 2; i++ )
+			{
+				msg.WriteLong( cmd.times[i] );
+			}
+			msg.WriteFloat( cmd.speedSquared );
+			for( int i = 0; i < 3; i++ )
+			{
+				msg.WriteByte( cmd.impulse[i] );
+			}
+		}
+	}
+}
+
+/*
+========================
+BenchReadUsercmds
+========================
+*/
+static void BenchReadUsercmds( const idBitMsg& msg, benchUsercmd_t* cmds, bool arrays )
+{
+	for( int c = 0; c < BENCH_USERCMDS; c++ )
+	{
+		benchUsercmd_t& cmd = cmds[c];
+		if( arrays )
+		{
+			msg.ReadBitsArray( cmd.buttons, 3, -8 );
+			msg.ReadBitsArray( cmd.angles, 3, -16 );
+			msg.ReadFloatArray( cmd.pos, 3 );
+			msg.ReadBitsArray( cmd.times, 2, 32 );
+			cmd.speedSquared = msg.ReadFloat();
+			msg.ReadBitsArray( cmd.impulse, 3, 8 );
+		}
+		else
+		{
+			for( int i = 0; i < 3; i++ )
+			{
+				cmd.buttons[i] = msg.ReadChar();
+			}
+			for( int i = 0; i < 3; i++ )
+			{
+				cmd.angles[i] = msg.ReadShort();
+			}
+			for( int i = 0; i < 3; i++ )
+			{
+				cmd.pos[i] = msg.ReadFloat();
+			}
+			for( int i = 0; i < 2; i++ )
+			{
+				cmd.times[i] = msg.ReadLong();
+			}
+			cmd.speedSquared = msg.ReadFloat();
+			for( int i = 0; i < 3; i++ )
+			{
+				cmd.impulse[i] = msg.ReadByte();
+			}
+		}
+	}
+}
+
+/*
+========================
+BenchWritePackedInts
+
+The byte loop is what idSerializer::SerializePacked used to do.
+========================
+*/
+static void BenchWritePackedInts( idBitMsg& msg, const int* values, bool arrays )
+{
+	for( int v = 0; v < BENCH_PACKED_INTS; v++ )
+	{
+		if( arrays )
+		{
+			msg.WritePackedInt( values[v] );
+			continue;
+		}
+		uint32_t value = values[v];
+		while( true )
+		{
+			uint8_t byte = value & 0x7F;
+			value >>= 7;
+			byte |= value ? 0x80 : 0;
+			msg.WriteByte( byte );
+			if( value == 0 )
+			{
+				break;
+			}
+		}
+	}
+}
+
+/*
+========================
+BenchReadPackedInts
+========================
+*/
+static void BenchReadPackedInts( const idBitMsg& msg, int* values, bool arrays )
+{
+	for( int v = 0; v < BENCH_PACKED_INTS; v++ )
+	{
+		if( arrays )
+		{
+			values[v] = msg.ReadPackedInt();
+			continue;
+		}
+		uint32_t byte = 0x80;
+		uint32_t value = 0;
+		int shift = 0;
+		while( ( byte & 0x80 ) && shift < 32 )
+		{
+			byte = msg.ReadByte();
+			value |= ( byte & 0x7F ) << shift;
+			shift += 7;
+		}
+		values[v] = value;
+	}
+}
+
+/*
+========================
+BitMsgBenchmark_f
+
+Packs the message patterns of snapshots and usercmds with single writes and with the array writes, checks that
+both produce the same bits and read back the same values, and reports the throughput.
+========================
+*/
+CONSOLE_COMMAND( bitMsgBenchmark, "times idBitMsg packing of snapshot and usercmd patterns, usage: bitMsgBenchmark [passes]", 0 )
+{
+	const int passes = ( args.Argc() > 1 ) ? Max( 1, atoi( args.Argv( 1 ) ) ) : 200;
+	
+	idRandom random( 1234 );
+	
+	benchEntity_t* ents = ( benchEntity_t* )Mem_Alloc( sizeof( benchEntity_t ) * BENCH_ENTITIES * 2, TAG_TEMP );
+	benchUsercmd_t* cmds = ( benchUsercmd_t* )Mem_Alloc( sizeof( benchUsercmd_t ) * BENCH_USERCMDS * 2, TAG_TEMP );
+	int* ints = ( int* )Mem_Alloc( sizeof( int ) * BENCH_PACKED_INTS * 2, TAG_TEMP );
+	byte* buffers[2];
+	buffers[0] = ( byte* )Mem_Alloc( BENCH_MSG_SIZE, TAG_TEMP );
+	buffers[1] = ( byte* )Mem_Alloc( BENCH_MSG_SIZE, TAG_TEMP );
+	
+	for( int e = 0; e < BENCH_ENTITIES; e++ )
+	{
+		benchEntity_t& ent = ents[e];
+		for( int i = 0; i < 4; i++ )
+		{
+			ent.header[i] = ( benchHeaderBits[i] == 32 ) ? random.RandomInt() : random.RandomInt( 1 << benchHeaderBits[i] );
+		}
+		for( int i = 0; i < 3; i++ )
+		{
+			ent.position[i] = random.CRandomFloat() * 4096.0f;
+			ent.orientation[i] = random.CRandomFloat();
+			ent.momentum[i] = random.CRandomFloat() * 100.0f;
+			ent.velocity[i] = random.CRandomFloat() * 1000.0f;
+		}
+		ent.bind[0] = random.RandomInt( 1 << 12 );
+		ent.bind[1] = random.RandomInt( 4 );
+		ent.bind[2] = random.RandomInt( 128 );
+	}
+	
+	for( int c = 0; c < BENCH_USERCMDS; c++ )
+	{
+		benchUsercmd_t& cmd = cmds[c];
+		for( int i = 0; i < 3; i++ )
+		{
+			cmd.buttons[i] = random.RandomInt( 256 ) - 128;
+			cmd.angles[i] = random.RandomInt( 65536 ) - 32768;
+			cmd.pos[i] = random.CRandomFloat() * 4096.0f;
+			cmd.impulse[i] = random.RandomInt( 256 );
+		}
+		cmd.times[0] = random.RandomInt();
+		cmd.times[1] = random.RandomInt();
+		cmd.speedSquared = random.RandomFloat() * 90000.0f;
+	}
+	
+	// mostly small counts and indices, like the profile and dict serializers write
+	for( int v = 0; v < BENCH_PACKED_INTS; v++ )
+	{
+		ints[v] = ( v & 7 ) ? random.RandomInt( 128 ) : random.RandomInt();
+	}
+	
+	const char* patternNames[3] = { "snapshot entities", "usercmds", "packed ints" };
+	
+	idLib::Printf( "bitMsgBenchmark: %d entities, %d usercmds, %d packed ints, %d passes\n", BENCH_ENTITIES, BENCH_USERCMDS, BENCH_PACKED_INTS, passes );
+	idLib::Printf( "pattern              bytes   single write  array write   single read   array read\n" );
+	
+	for( int pattern = 0; pattern < 3; pattern++ )
+	{
+		uint64_t writeTime[2] = { 0, 0 };
+		uint64_t readTime[2] = { 0, 0 };
+		int size[2] = { 0, 0 };
+		
+		for( int arrays = 0; arrays < 2; arrays++ )
+		{
+			idBitMsg msg( buffers[arrays], BENCH_MSG_SIZE );
+			
+			for( int pass = 0; pass < passes; pass++ )
+			{
+				msg.BeginWriting();
+				
+				uint64_t start = Sys_Microseconds();
+				switch( pattern )
+				{
+					case 0:
+						BenchWriteEntities( msg, ents, arrays != 0 );
+						break;
+					case 1:
+						BenchWriteUsercmds( msg, cmds, arrays != 0 );
+						break;
+					default:
+						BenchWritePackedInts( msg, ints, arrays != 0 );
+						break;
+				}
+				msg.WriteByteAlign();
+				writeTime[arrays] += Sys_Microseconds() - start;
+				
+				msg.BeginReading();
+				
+				start = Sys_Microseconds();
+				switch( pattern )
+				{
+					case 0:
+						BenchReadEntities( msg, ents + BENCH_ENTITIES, arrays != 0 );
+						break;
+					case 1:
+						BenchReadUsercmds( msg, cmds + BENCH_USERCMDS, arrays != 0 );
+						break;
+					default:
+						BenchReadPackedInts( msg, ints + BENCH_PACKED_INTS, arrays != 0 );
+						break;
+				}
+				readTime[arrays] += Sys_Microseconds() - start;
+			}
+			
+			size[arrays] = msg.GetSize();
+			
+			// the quantized velocities don't survive the round trip, compare them re-quantized
+			bool matches = true;
+			switch( pattern )
+			{
+				case 0:
+					for( int e = 0; e < BENCH_ENTITIES && matches; e++ )
+					{
+						const benchEntity_t& a = ents[e];
+						const benchEntity_t& b = ents[BENCH_ENTITIES + e];
+						matches = memcmp( a.header, b.header, sizeof( a.header ) ) == 0 && memcmp( a.position, b.position, sizeof( a.position ) ) == 0 &&
+								  memcmp( a.orientation, b.orientation, sizeof( a.orientation ) ) == 0 && memcmp( a.bind, b.bind, sizeof( a.bind ) ) == 0;
+						for( int i = 0; i < 3 && matches; i++ )
+						{
+							matches = idMath::Fabs( a.velocity[i] - b.velocity[i] ) < 1.0f && idMath::Fabs( a.momentum[i] - b.momentum[i] ) < idMath::Fabs( a.momentum[i] ) * 0.01f + 0.01f;
+						}
+					}
+					break;
+				case 1:
+					matches = memcmp( cmds, cmds + BENCH_USERCMDS, sizeof( benchUsercmd_t ) * BENCH_USERCMDS ) == 0;
+					break;
+				default:
+					matches = memcmp( ints, ints + BENCH_PACKED_INTS, sizeof( int ) * BENCH_PACKED_INTS ) == 0;
+					break;
+			}
+			if( !matches )
+			{
+				idLib::Warning( "bitMsgBenchmark: %s %s round trip mismatch", patternNames[pattern], arrays ? "array" : "single" );
+			}
+		}
+		
+		if( size[0] != size[1] || memcmp( buffers[0], buffers[1], size[0] ) != 0 )
+		{
+			idLib::Warning( "bitMsgBenchmark: %s array writes differ from single writes", patternNames[pattern] );
+		}
+		
+		const double megaBytes = ( double )size[0] * passes / ( 1024.0 * 1024.0 );
+		idLib::Printf( "%-18s %7d  %8.1f MB/s  %8.1f MB/s  %8.1f MB/s  %8.1f MB/s\n", patternNames[pattern], size[0],
+					   megaBytes / Max( writeTime[0], ( uint64_t )1 ) * 1000000.0, megaBytes / Max( writeTime[1], ( uint64_t )1 ) * 1000000.0,
+					   megaBytes / Max( readTime[0], ( uint64_t )1 ) * 1000000.0, megaBytes / Max( readTime[1], ( uint64_t )1 ) * 1000000.0 );
+	}
+	
+	Mem_Free( ents );
+	Mem_Free( cmds );
+	Mem_Free( ints );
+	Mem_Free( buffers[0] );
+	Mem_Free( buffers[1] );
+}
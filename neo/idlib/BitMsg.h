@@ -212,13 +212,24 @@ public:
 	template< int _max_, int _numBits_ >
 	void			WriteQuantizedUFloat( float value );		// Quantize a float to a variable number of bits (assumes unsigned, uses simple quantization)
 	
+	// Write arrays with a single overflow check, the bits are identical to a single write per value
+	void			WriteBitsArray( const int* values, int count, int numBits );
+	void			WriteFloatArray( const float* f, int count );
+	void			WriteFloatArray( const float* f, int count, int exponentBits, int mantissaBits );
+	template< int _max_, int _numBits_ >
+	void			WriteQuantizedFloatArray( const float* f, int count );
+	template< int _max_, int _numBits_ >
+	void			WriteQuantizedUFloatArray( const float* f, int count );
+	
+	// 7 bits per byte with the 8th bit flagging more bytes, the encoding of idSerializer::SerializePacked
+	// and SerializeSPacked. The SPacked version keeps a sign bit in the first byte.
+	void			WritePackedInt( int value );
+	void			WriteSPackedInt( int value );
+	
 	template< typename T >
 	void			WriteVectorFloat( const T& v )
 	{
-		for( int i = 0; i < v.GetDimension(); i++ )
-		{
-			WriteFloat( v[i] );
-		}
+		WriteFloatArray( v.ToFloatPtr(), v.GetDimension() );
 	}
 	template< typename T >
 	void			WriteVectorUNorm8( const T& v )
@@ -249,10 +260,7 @@ public:
 	template< typename T, int _max_, int _numBits_  >
 	void			WriteQuantizedVector( const T& v )
 	{
-		for( int i = 0; i < v.GetDimension(); i++ )
-		{
-			WriteQuantizedFloat< _max_, _numBits_ >( v[i] );
-		}
+		WriteQuantizedFloatArray< _max_, _numBits_ >( v.ToFloatPtr(), v.GetDimension() );
 	}
 	
 	// begin reading.
@@ -329,13 +337,22 @@ public:
 	template< int _max_, int _numBits_ >
 	float			ReadQuantizedUFloat() const;
 	
+	// Read arrays written by the array writes, or by single writes of the same size
+	void			ReadBitsArray( int* values, int count, int numBits ) const;
+	void			ReadFloatArray( float* f, int count ) const;
+	void			ReadFloatArray( float* f, int count, int exponentBits, int mantissaBits ) const;
+	template< int _max_, int _numBits_ >
+	void			ReadQuantizedFloatArray( float* f, int count ) const;
+	template< int _max_, int _numBits_ >
+	void			ReadQuantizedUFloatArray( float* f, int count ) const;
+	
+	int				ReadPackedInt() const;
+	int				ReadSPackedInt() const;
+	
 	template< typename T >
 	void			ReadVectorFloat( T& v ) const
 	{
-		for( int i = 0; i < v.GetDimension(); i++ )
-		{
-			v[i] = ReadFloat();
-		}
+		ReadFloatArray( v.ToFloatPtr(), v.GetDimension() );
 	}
 	template< typename T >
 	void			ReadVectorUNorm8( T& v ) const
@@ -364,10 +381,7 @@ public:
 	template< typename T, int _max_, int _numBits_ >
 	void			ReadQuantizedVector( T& v ) const
 	{
-		for( int i = 0; i < v.GetDimension(); i++ )
-		{
-			v[i] = ReadQuantizedFloat< _max_, _numBits_ >();
-		}
+		ReadQuantizedFloatArray< _max_, _numBits_ >( v.ToFloatPtr(), v.GetDimension() );
 	}
 	
 	static int		DirToBits( const idVec3& dir, int numBits );
@@ -396,9 +410,15 @@ private:
 	
 	mutable uint64_t	tempValue;
 	
+	static const int	MAX_BULK_VALUES = 64;	// values converted on the stack per packed write or read
+	
 private:
 	bool			CheckOverflow( int numBits );
 	byte* 			GetByteSpace( int length );
+	
+	void			WritePackedBits( const uint32_t* values, int count, int numBits );
+	void			ReadPackedBits( int* values, int count, int numBits, bool sgn ) const;
+	void			SetReadPosition( int numBitsRead ) const;
 };
 
 /*
@@ -702,6 +722,18 @@ ID_INLINE void idBitMsg::RestoreReadState( int c, int b )
 	readBit = b & 7;
 }
 
+/*
+========================
+idBitMsg::SetReadPosition
+========================
+*/
+ID_INLINE void idBitMsg::SetReadPosition( int numBitsRead ) const
+{
+	// readCount includes the partially read byte
+	readCount = ( numBitsRead + 7 ) >> 3;
+	readBit = numBitsRead & 7;
+}
+
 /*
 ========================
 idBitMsg::BeginWriting
@@ -1105,6 +1137,110 @@ float idBitMsg::ReadQuantizedUFloat() const
 	}
 }
 
+/*
+========================
+idBitMsg::WriteQuantizedFloatArray
+========================
+*/
+template< int _max_, int _numBits_ >
+ID_INLINE void idBitMsg::WriteQuantizedFloatArray( const float* f, int count )
+{
+	enum { storeMax = ( 1 << ( _numBits_ - 1 ) ) - 1 };
+	// same scale as WriteQuantizedFloat
+	const float scale = ( _max_ > storeMax ) ? ( float )storeMax / ( float )_max_ : ( float )( storeMax / _max_ );
+	
+	uint32_t bits[MAX_BULK_VALUES];
+	while( count > 0 )
+	{
+		const int num = Min( count, MAX_BULK_VALUES );
+		for( int i = 0; i < num; i++ )
+		{
+			bits[i] = idMath::ClampInt( -storeMax, storeMax, idMath::Ftoi( f[i] * scale ) );
+		}
+		WritePackedBits( bits, num, _numBits_ );
+		f += num;
+		count -= num;
+	}
+}
+
+/*
+========================
+idBitMsg::WriteQuantizedUFloatArray
+========================
+*/
+template< int _max_, int _numBits_ >
+ID_INLINE void idBitMsg::WriteQuantizedUFloatArray( const float* f, int count )
+{
+	enum { storeMax = ( 1 << _numBits_ ) - 1 };
+	// same scale as WriteQuantizedUFloat
+	const float scale = ( _max_ > storeMax ) ? ( float )storeMax / ( float )_max_ : ( float )( storeMax / _max_ );
+	
+	uint32_t bits[MAX_BULK_VALUES];
+	while( count > 0 )
+	{
+		const int num = Min( count, MAX_BULK_VALUES );
+		for( int i = 0; i < num; i++ )
+		{
+			bits[i] = idMath::ClampInt( 0, storeMax, idMath::Ftoi( f[i] * scale ) );
+		}
+		WritePackedBits( bits, num, _numBits_ );
+		f += num;
+		count -= num;
+	}
+}
+
+/*
+========================
+idBitMsg::ReadQuantizedFloatArray
+========================
+*/
+template< int _max_, int _numBits_ >
+ID_INLINE void idBitMsg::ReadQuantizedFloatArray( float* f, int count ) const
+{
+	enum { storeMax = ( 1 << ( _numBits_ - 1 ) ) - 1 };
+	// same scale as ReadQuantizedFloat
+	const float invScale = ( _max_ > storeMax ) ? ( float )_max_ / ( float )storeMax : 1.0f / ( float )( storeMax / _max_ );
+	
+	int bits[MAX_BULK_VALUES];
+	while( count > 0 )
+	{
+		const int num = Min( count, MAX_BULK_VALUES );
+		ReadBitsArray( bits, num, -_numBits_ );
+		for( int i = 0; i < num; i++ )
+		{
+			f[i] = ( float )bits[i] * invScale;
+		}
+		f += num;
+		count -= num;
+	}
+}
+
+/*
+========================
+idBitMsg::ReadQuantizedUFloatArray
+========================
+*/
+template< int _max_, int _numBits_ >
+ID_INLINE void idBitMsg::ReadQuantizedUFloatArray( float* f, int count ) const
+{
+	enum { storeMax = ( 1 << _numBits_ ) - 1 };
+	// same scale as ReadQuantizedUFloat
+	const float invScale = ( _max_ > storeMax ) ? ( float )_max_ / ( float )storeMax : 1.0f / ( float )( storeMax / _max_ );
+	
+	int bits[MAX_BULK_VALUES];
+	while( count > 0 )
+	{
+		const int num = Min( count, MAX_BULK_VALUES );
+		ReadBitsArray( bits, num, _numBits_ );
+		for( int i = 0; i < num; i++ )
+		{
+			f[i] = ( float )bits[i] * invScale;
+		}
+		f += num;
+		count -= num;
+	}
+}
+
 /*
 ================
 WriteFloatArray
@@ -1114,10 +1250,12 @@ Writes all the values from the array to the bit message.
 template< class _arrayType_ >
 void WriteFloatArray( idBitMsg& message, const _arrayType_ & sourceArray )
 {
+	float values[ idTupleSize< _arrayType_ >::value ];
 	for( int i = 0; i < idTupleSize< _arrayType_ >::value; ++i )
 	{
-		message.WriteFloat( sourceArray[i] );
+		values[i] = sourceArray[i];
 	}
+	message.WriteFloatArray( values, idTupleSize< _arrayType_ >::value );
 }
 
 /*
@@ -1129,10 +1267,12 @@ Writes _num_ values from the array to the bit message.
 template< class _arrayType_ >
 void WriteDeltaFloatArray( idBitMsg& message, const _arrayType_ & oldArray, const _arrayType_ & newArray )
 {
+	float values[ idTupleSize< _arrayType_ >::value ];
 	for( int i = 0; i < idTupleSize< _arrayType_ >::value; ++i )
 	{
-		message.WriteDeltaFloat( oldArray[i], newArray[i] );
+		values[i] = newArray[i] - oldArray[i];
 	}
+	message.WriteFloatArray( values, idTupleSize< _arrayType_ >::value );
 }
 
 /*
@@ -1146,9 +1286,11 @@ _arrayType_ ReadFloatArray( const idBitMsg& message )
 {
 	_arrayType_ result;
 	
+	float values[ idTupleSize< _arrayType_ >::value ];
+	message.ReadFloatArray( values, idTupleSize< _arrayType_ >::value );
 	for( int i = 0; i < idTupleSize< _arrayType_ >::value; ++i )
 	{
-		result[i] = message.ReadFloat();
+		result[i] = values[i];
 	}
 	
 	return result;
@@ -1165,9 +1307,11 @@ _arrayType_ ReadDeltaFloatArray( const idBitMsg& message, const _arrayType_ & ol
 {
 	_arrayType_ result;
 	
+	float values[ idTupleSize< _arrayType_ >::value ];
+	message.ReadFloatArray( values, idTupleSize< _arrayType_ >::value );
 	for( int i = 0; i < idTupleSize< _arrayType_ >::value; ++i )
 	{
-		result[i] = message.ReadDeltaFloat( oldArray[i] );
+		result[i] = oldArray[i] + values[i];
 	}
 	
 	return result;
@@ -7,6 +7,7 @@ class idDataQueue
 public:
 	idDataQueue()
 	{
+		dataStart = 0;
 		dataLength = 0;
 	}
 	bool Append( int sequence, const byte* b1, int b1Len, const byte* b2 = NULL, int b2Len = 0 );
@@ -36,6 +37,7 @@ public:
 	
 	void Clear()
 	{
+		dataStart = 0;
 		dataLength = 0;
 		items.Clear();
 		memset( data, 0, sizeof( data ) );
@@ -48,7 +50,10 @@ private:
 		int		length;
 		int		dataOffset;
 	};
+	void Compact();
+	
 	idStaticList<msgItem_t, maxItems > items;
+	int		dataStart;		// removed items leave a gap in front of the data, it is only closed when an append needs the room
 	int		dataLength;
 	byte	data[ maxBuffer ];
 };
@@ -71,20 +76,35 @@ void idDataQueue< maxItems, maxBuffer >::RemoveOlderThan( int sequence )
 	{
 		assert( items.Num() == 0 );
 		assert( dataLength == length );
+		dataStart = 0;
 		dataLength = 0;
 	}
 	else if( length > 0 )
 	{
-		memmove( data, data + length, dataLength - length );
+		dataStart += length;
 		dataLength -= length;
 	}
-	length = 0;
+	assert( items.Num() == 0 || items[0].dataOffset == dataStart );
+}
+
+/*
+========================
+idDataQueue::Compact
+========================
+*/
+template< int maxItems, int maxBuffer >
+void idDataQueue< maxItems, maxBuffer >::Compact()
+{
+	if( dataStart == 0 )
+	{
+		return;
+	}
+	memmove( data, data + dataStart, dataLength );
 	for( int i = 0; i < items.Num(); i++ )
 	{
-		items[i].dataOffset = length;
-		length += items[i].length;
+		items[i].dataOffset -= dataStart;
 	}
-	assert( length == dataLength );
+	dataStart = 0;
 }
 
 /*
@@ -103,14 +123,17 @@ bool idDataQueue< maxItems, maxBuffer >::Append( int sequence, const byte* b1, i
 	{
 		return false;
 	}
+	if( dataStart + dataLength + b1Len + b2Len > maxBuffer )
+	{
+		Compact();
+	}
 	msgItem_t& item = *items.Alloc();
 	item.length = b1Len + b2Len;
 	item.sequence = sequence;
-	item.dataOffset = dataLength;
-	memcpy( data + dataLength, b1, b1Len );
-	dataLength += b1Len;
-	memcpy( data + dataLength, b2, b2Len );
-	dataLength += b2Len;
+	item.dataOffset = dataStart + dataLength;
+	memcpy( data + item.dataOffset, b1, b1Len );
+	memcpy( data + item.dataOffset + b1Len, b2, b2Len );
+	dataLength += b1Len + b2Len;
 	return true;
 }
 
@@ -113,6 +113,214 @@ int default_setup;
 
 char idLexer::baseFolder[ 256 ];
 
+/*
+================================================================================================
+
+	SSE2 scanning helpers
+
+	The scanners below classify 16 characters at a time with unaligned loads, as long as 16
+	characters are left before the end of the script. The rest is finished one character at a
+	time, so nothing is read past the end of the buffer. Characters are compared as signed chars
+	to match the scalar '<= ' '' tests.
+
+================================================================================================
+*/
+
+/*
+================
+Lexer_FirstBit
+================
+*/
+static ID_FORCE_INLINE int Lexer_FirstBit( unsigned int mask )
+{
+	assert( mask != 0 );
+#if __COMPILER_MSVC__
+	unsigned long index;
+	_BitScanForward( &index, mask );
+	return ( int )index;
+#else
+	return __builtin_ctz( mask );
+#endif
+}
+
+/*
+================
+Lexer_SkipSpaces
+
+Skips characters in the range [1, ' '] and counts the newlines crossed.
+Returns a pointer to the first character that is not white space, the zero terminator or the end.
+================
+*/
+static const char* Lexer_SkipSpaces( const char* p, const char* end, int& lines )
+{
+	const __m128i vzero = _mm_setzero_si128();
+	const __m128i vspace = _mm_set1_epi8( ' ' );
+	const __m128i vnewline = _mm_set1_epi8( '\n' );
+	
+	while( end - p >= 16 )
+	{
+		const __m128i v = _mm_loadu_si128( ( const __m128i* )p );
+		const unsigned int stop = _mm_movemask_epi8( _mm_or_si128( _mm_cmpgt_epi8( v, vspace ), _mm_cmpeq_epi8( v, vzero ) ) );
+		unsigned int newlines = _mm_movemask_epi8( _mm_cmpeq_epi8( v, vnewline ) );
+		if( stop != 0 )
+		{
+			const int first = Lexer_FirstBit( stop );
+			newlines &= ( 1u << first ) - 1;
+			lines += idMath::BitCount( newlines );
+			return p + first;
+		}
+		lines += idMath::BitCount( newlines );
+		p += 16;
+	}
+	
+	for( ; p < end && *p != '\0' && ( signed char )*p <= ' '; p++ )
+	{
+		if( *p == '\n' )
+		{
+			lines++;
+		}
+	}
+	return p;
+}
+
+/*
+================
+Lexer_FindChar
+
+Returns a pointer to the first occurrence of a or b, to the zero terminator or to the end.
+================
+*/
+static const char* Lexer_FindChar( const char* p, const char* end, char a, char b )
+{
+	const __m128i vzero = _mm_setzero_si128();
+	const __m128i va = _mm_set1_epi8( a );
+	const __m128i vb = _mm_set1_epi8( b );
+	
+	while( end - p >= 16 )
+	{
+		const __m128i v = _mm_loadu_si128( ( const __m128i* )p );
+		const __m128i m = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( v, va ), _mm_cmpeq_epi8( v, vb ) ), _mm_cmpeq_epi8( v, vzero ) );
+		const unsigned int stop = _mm_movemask_epi8( m );
+		if( stop != 0 )
+		{
+			return p + Lexer_FirstBit( stop );
+		}
+		p += 16;
+	}
+	
+	for( ; p < end && *p != '\0' && *p != a && *p != b; p++ )
+	{
+	}
+	return p;
+}
+
+/*
+================
+Lexer_FindStringChar
+
+Returns a pointer to the first quote, escape character, newline, zero terminator or to the end.
+================
+*/
+static const char* Lexer_FindStringChar( const char* p, const char* end, char quote, bool escapes )
+{
+	const __m128i vzero = _mm_setzero_si128();
+	const __m128i vquote = _mm_set1_epi8( quote );
+	const __m128i vnewline = _mm_set1_epi8( '\n' );
+	// when escapes are disabled the backslash compare degenerates to another quote compare
+	const char escape = escapes ? '\\' : quote;
+	const __m128i vescape = _mm_set1_epi8( escape );
+	
+	while( end - p >= 16 )
+	{
+		const __m128i v = _mm_loadu_si128( ( const __m128i* )p );
+		const __m128i m0 = _mm_or_si128( _mm_cmpeq_epi8( v, vquote ), _mm_cmpeq_epi8( v, vescape ) );
+		const __m128i m1 = _mm_or_si128( _mm_cmpeq_epi8( v, vnewline ), _mm_cmpeq_epi8( v, vzero ) );
+		const unsigned int stop = _mm_movemask_epi8( _mm_or_si128( m0, m1 ) );
+		if( stop != 0 )
+		{
+			return p + Lexer_FirstBit( stop );
+		}
+		p += 16;
+	}
+	
+	for( ; p < end && *p != '\0' && *p != quote && *p != escape && *p != '\n'; p++ )
+	{
+	}
+	return p;
+}
+
+/*
+================
+Lexer_IsNameChar
+================
+*/
+static ID_FORCE_INLINE bool Lexer_IsNameChar( char c, bool minus, bool paths )
+{
+	if( ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ) || ( c >= '0' && c <= '9' ) || c == '_' )
+	{
+		return true;
+	}
+	if( minus && c == '-' )
+	{
+		return true;
+	}
+	return paths && ( c == '/' || c == '\\' || c == ':' || c == '.' );
+}
+
+/*
+================
+Lexer_SkipName
+
+Returns a pointer to the first character that can not be part of a name with the given lexer flags.
+================
+*/
+static const char* Lexer_SkipName( const char* p, const char* end, int flags )
+{
+	const __m128i vcase = _mm_set1_epi8( 0x20 );
+	const __m128i vlowerMin = _mm_set1_epi8( 'a' - 1 );
+	const __m128i vlowerMax = _mm_set1_epi8( 'z' + 1 );
+	const __m128i vdigitMin = _mm_set1_epi8( '0' - 1 );
+	const __m128i vdigitMax = _mm_set1_epi8( '9' + 1 );
+	const __m128i vunderscore = _mm_set1_epi8( '_' );
+	const __m128i vminus = _mm_set1_epi8( '-' );
+	const __m128i vslash = _mm_set1_epi8( '/' );
+	const __m128i vbackslash = _mm_set1_epi8( '\\' );
+	const __m128i vcolon = _mm_set1_epi8( ':' );
+	const __m128i vdot = _mm_set1_epi8( '.' );
+	const bool minus = ( flags & LEXFL_ONLYSTRINGS ) != 0;
+	const bool paths = ( flags & LEXFL_ALLOWPATHNAMES ) != 0;
+	
+	while( end - p >= 16 )
+	{
+		const __m128i v = _mm_loadu_si128( ( const __m128i* )p );
+		// folding the case bit maps 'A'-'Z' onto 'a'-'z' and leaves no other character in that range
+		const __m128i lower = _mm_or_si128( v, vcase );
+		__m128i name = _mm_and_si128( _mm_cmpgt_epi8( lower, vlowerMin ), _mm_cmpgt_epi8( vlowerMax, lower ) );
+		name = _mm_or_si128( name, _mm_and_si128( _mm_cmpgt_epi8( v, vdigitMin ), _mm_cmpgt_epi8( vdigitMax, v ) ) );
+		name = _mm_or_si128( name, _mm_cmpeq_epi8( v, vunderscore ) );
+		if( minus )
+		{
+			name = _mm_or_si128( name, _mm_cmpeq_epi8( v, vminus ) );
+		}
+		if( paths )
+		{
+			name = _mm_or_si128( name, _mm_or_si128( _mm_cmpeq_epi8( v, vslash ), _mm_cmpeq_epi8( v, vbackslash ) ) );
+			name = _mm_or_si128( name, _mm_or_si128( _mm_cmpeq_epi8( v, vcolon ), _mm_cmpeq_epi8( v, vdot ) ) );
+		}
+		const unsigned int stop = ~_mm_movemask_epi8( name ) & 0xFFFFu;
+		if( stop != 0 )
+		{
+			return p + Lexer_FirstBit( stop );
+		}
+		p += 16;
+	}
+	
+	for( ; p < end && Lexer_IsNameChar( *p, minus, paths ); p++ )
+	{
+	}
+	return p;
+}
+
 /*
 ================
 idLexer::CreatePunctuationTable
@@ -321,17 +529,10 @@ int idLexer::ReadWhiteSpace()
 	while( 1 )
 	{
 		// skip white space
-		while( *idLexer::script_p <= ' ' )
+		idLexer::script_p = Lexer_SkipSpaces( idLexer::script_p, idLexer::end_p, idLexer::line );
+		if( !*idLexer::script_p )
 		{
-			if( !*idLexer::script_p )
-			{
-				return 0;
-			}
-			if( *idLexer::script_p == '\n' )
-			{
-				idLexer::line++;
-			}
-			idLexer::script_p++;
+			return 0;
 		}
 		// skip comments
 		if( *idLexer::script_p == '/' )
@@ -339,16 +540,11 @@ int idLexer::ReadWhiteSpace()
 			// comments //
 			if( *( idLexer::script_p + 1 ) == '/' )
 			{
-				idLexer::script_p++;
-				do
+				idLexer::script_p = Lexer_FindChar( idLexer::script_p + 2, idLexer::end_p, '\n', '\n' );
+				if( !*idLexer::script_p )
 				{
-					idLexer::script_p++;
-					if( !*idLexer::script_p )
-					{
-						return 0;
-					}
+					return 0;
 				}
-				while( *idLexer::script_p != '\n' );
 				idLexer::line++;
 				idLexer::script_p++;
 				if( !*idLexer::script_p )
@@ -360,10 +556,10 @@ int idLexer::ReadWhiteSpace()
 			// comments /* */
 			else if( *( idLexer::script_p + 1 ) == '*' )
 			{
-				idLexer::script_p++;
+				idLexer::script_p += 2;
 				while( 1 )
 				{
-					idLexer::script_p++;
+					idLexer::script_p = Lexer_FindChar( idLexer::script_p, idLexer::end_p, '\n', '/' );
 					if( !*idLexer::script_p )
 					{
 						return 0;
@@ -372,7 +568,7 @@ int idLexer::ReadWhiteSpace()
 					{
 						idLexer::line++;
 					}
-					else if( *idLexer::script_p == '/' )
+					else
 					{
 						if( *( idLexer::script_p - 1 ) == '*' )
 						{
@@ -383,6 +579,7 @@ int idLexer::ReadWhiteSpace()
 							idLexer::Warning( "nested comment" );
 						}
 					}
+					idLexer::script_p++;
 				}
 				idLexer::script_p++;
 				if( !*idLexer::script_p )
@@ -712,7 +909,13 @@ int idLexer::ReadString( idToken* token, int quote )
 				idLexer::Error( "newline inside string" );
 				return 0;
 			}
-			token->AppendDirty( *idLexer::script_p++ );
+			// copy the run of plain characters up to the next quote, escape character or newline
+			const char* start = idLexer::script_p;
+			idLexer::script_p = Lexer_FindStringChar( start + 1, idLexer::end_p, quote, !( idLexer::flags & LEXFL_NOSTRINGESCAPECHARS ) );
+			const int n = idLexer::script_p - start;
+			token->EnsureAlloced( token->len + n + 2, true );
+			memcpy( token->data + token->len, start, n );
+			token->len += n;
 		}
 	}
 	token->data[token->len] = '\0';
@@ -743,22 +946,15 @@ idLexer::ReadName
 */
 int idLexer::ReadName( idToken* token )
 {
-	char c;
+	const char* start = idLexer::script_p;
 	
 	token->type = TT_NAME;
-	do
-	{
-		token->AppendDirty( *idLexer::script_p++ );
-		c = *idLexer::script_p;
-	}
-	while( ( c >= 'a' && c <= 'z' ) ||
-			( c >= 'A' && c <= 'Z' ) ||
-			( c >= '0' && c <= '9' ) ||
-			c == '_' ||
-			// if treating all tokens as strings, don't parse '-' as a seperate token
-			( ( idLexer::flags & LEXFL_ONLYSTRINGS ) && ( c == '-' ) ) ||
-			// if special path name characters are allowed
-			( ( idLexer::flags & LEXFL_ALLOWPATHNAMES ) && ( c == '/' || c == '\\' || c == ':' || c == '.' ) ) );
+	// the first character is always part of the name
+	idLexer::script_p = Lexer_SkipName( start + 1, idLexer::end_p, idLexer::flags );
+	const int n = idLexer::script_p - start;
+	token->EnsureAlloced( token->len + n + 1, true );
+	memcpy( token->data + token->len, start, n );
+	token->len += n;
 	token->data[token->len] = '\0';
 	//the sub type is the length of the name
 	token->subtype = token->Length();
@@ -1206,6 +1402,188 @@ int idLexer::ReadToken( idToken* token )
 	return 1;
 }
 
+/*
+================
+idLexer::ReadTokenView
+
+Reads the next token without copying names, numbers and punctuations out of the
+source buffer. Text that differs from the source (escaped or concatenated strings,
+number suffixes, unread tokens) is stored in the token arena.
+================
+*/
+int idLexer::ReadTokenView( idTokenView* view )
+{
+	int c;
+	
+	if( !loaded )
+	{
+		idLib::common->Error( "idLexer::ReadTokenView: no file loaded" );
+		return 0;
+	}
+	
+	if( script_p == NULL )
+	{
+		return 0;
+	}
+	
+	// if there is a token available (from unreadToken)
+	if( tokenavailable )
+	{
+		tokenavailable = 0;
+		view->text = AllocTokenText( idLexer::token.c_str(), idLexer::token.Length() );
+		view->length = idLexer::token.Length();
+		view->type = idLexer::token.type;
+		view->subtype = idLexer::token.subtype;
+		view->line = idLexer::token.line;
+		view->linesCrossed = idLexer::token.linesCrossed;
+		return 1;
+	}
+	// save script pointer
+	lastScript_p = script_p;
+	// save line counter
+	lastline = line;
+	// start of the white space
+	whiteSpaceStart_p = script_p;
+	// read white space before token
+	if( !ReadWhiteSpace() )
+	{
+		return 0;
+	}
+	// end of the white space
+	whiteSpaceEnd_p = script_p;
+	view->line = line;
+	view->linesCrossed = line - lastline;
+	
+	const char* start = script_p;
+	c = *script_p;
+	
+	const bool isQuote = ( c == '\"' || c == '\'' );
+	const bool isNumber = ( c >= '0' && c <= '9' ) || ( c == '.' && ( *( script_p + 1 ) >= '0' && *( script_p + 1 ) <= '9' ) );
+	bool isName;
+	if( flags & LEXFL_ONLYSTRINGS )
+	{
+		isName = !isQuote;
+	}
+	else
+	{
+		isName = !isNumber && ( ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ) || c == '_' ||
+								( ( flags & LEXFL_ALLOWPATHNAMES ) && ( c == '/' || c == '\\' || c == '.' ) ) );
+	}
+	
+	// names are the most common tokens and never need the scratch token
+	if( isName )
+	{
+		script_p = Lexer_SkipName( start + 1, end_p, flags );
+		view->text = start;
+		view->length = script_p - start;
+		view->type = TT_NAME;
+		view->subtype = view->length;
+		return 1;
+	}
+	
+	viewToken.data[0] = '\0';
+	viewToken.len = 0;
+	viewToken.line = line;
+	viewToken.linesCrossed = view->linesCrossed;
+	viewToken.flags = 0;
+	
+	// if there is a number
+	if( isNumber && !( flags & LEXFL_ONLYSTRINGS ) )
+	{
+		if( !ReadNumber( &viewToken ) )
+		{
+			return 0;
+		}
+		// if names are allowed to start with a number
+		if( flags & LEXFL_ALLOWNUMBERNAMES )
+		{
+			c = *script_p;
+			if( ( c >= 'a' && c <= 'z' ) ||	( c >= 'A' && c <= 'Z' ) || c == '_' )
+			{
+				if( !ReadName( &viewToken ) )
+				{
+					return 0;
+				}
+			}
+		}
+	}
+	// if there is a leading quote
+	else if( isQuote )
+	{
+		if( !ReadString( &viewToken, c ) )
+		{
+			return 0;
+		}
+		// a string without escapes or concatenation is the source text between the quotes
+		if( viewToken.len == script_p - start - 2 && memcmp( viewToken.data, start + 1, viewToken.len ) == 0 )
+		{
+			view->text = start + 1;
+			view->length = viewToken.len;
+			view->type = viewToken.type;
+			view->subtype = viewToken.subtype;
+			return 1;
+		}
+	}
+	// check for punctuations
+	else if( !ReadPunctuation( &viewToken ) )
+	{
+		Error( "unknown punctuation %c", c );
+		return 0;
+	}
+	
+	view->type = viewToken.type;
+	view->subtype = viewToken.subtype;
+	view->length = viewToken.len;
+	if( viewToken.len == script_p - start && memcmp( viewToken.data, start, viewToken.len ) == 0 )
+	{
+		view->text = start;
+	}
+	else
+	{
+		view->text = AllocTokenText( viewToken.data, viewToken.len );
+	}
+	return 1;
+}
+
+/*
+================
+idLexer::AllocTokenText
+
+Copies decoded token text into the token arena, the arena is only released with the source.
+================
+*/
+const char* idLexer::AllocTokenText( const char* text, int length )
+{
+	const int size = length + 1;
+	if( tokenArena.Num() == 0 || tokenArenaUsed + size > tokenArenaSize )
+	{
+		tokenArenaSize = Max( size, TOKEN_ARENA_BLOCK_SIZE );
+		tokenArena.Append( ( char* ) Mem_Alloc( tokenArenaSize, TAG_IDLIB_LEXER ) );
+		tokenArenaUsed = 0;
+	}
+	char* dest = tokenArena[ tokenArena.Num() - 1 ] + tokenArenaUsed;
+	memcpy( dest, text, length );
+	dest[length] = '\0';
+	tokenArenaUsed += size;
+	return dest;
+}
+
+/*
+================
+idLexer::FreeTokenArena
+================
+*/
+void idLexer::FreeTokenArena()
+{
+	for( int i = 0; i < tokenArena.Num(); i++ )
+	{
+		Mem_Free( tokenArena[i] );
+	}
+	tokenArena.Clear();
+	tokenArenaUsed = 0;
+	tokenArenaSize = 0;
+}
+
 /*
 ================
 idLexer::ExpectTokenString
@@ -1430,9 +1808,9 @@ idLexer::SkipUntilString
 */
 int idLexer::SkipUntilString( const char* string )
 {
-	idToken token;
+	idTokenView token;
 	
-	while( idLexer::ReadToken( &token ) )
+	while( idLexer::ReadTokenView( &token ) )
 	{
 		if( token == string )
 		{
@@ -1473,13 +1851,13 @@ Internal brace depths are properly skipped.
 */
 int idLexer::SkipBracedSection( bool parseFirstBrace )
 {
-	idToken token;
+	idTokenView token;
 	int depth;
 	
 	depth = parseFirstBrace ? 0 : 1;
 	do
 	{
-		if( !ReadToken( &token ) )
+		if( !ReadTokenView( &token ) )
 		{
 			return false;
 		}
@@ -2166,6 +2544,7 @@ void idLexer::FreeSource()
 		idLexer::buffer = NULL;
 		idLexer::allocated = false;
 	}
+	idLexer::FreeTokenArena();
 	idLexer::tokenavailable = 0;
 	idLexer::token = "";
 	idLexer::loaded = false;
@@ -2191,6 +2570,8 @@ idLexer::idLexer()
 	idLexer::token = "";
 	idLexer::next = NULL;
 	idLexer::hadError = false;
+	idLexer::tokenArenaUsed = 0;
+	idLexer::tokenArenaSize = 0;
 }
 
 /*
@@ -2213,6 +2594,8 @@ idLexer::idLexer( int flags )
 	idLexer::token = "";
 	idLexer::next = NULL;
 	idLexer::hadError = false;
+	idLexer::tokenArenaUsed = 0;
+	idLexer::tokenArenaSize = 0;
 }
 
 /*
@@ -2229,6 +2612,8 @@ idLexer::idLexer( const char* filename, int flags, bool OSPath )
 	idLexer::token = "";
 	idLexer::next = NULL;
 	idLexer::hadError = false;
+	idLexer::tokenArenaUsed = 0;
+	idLexer::tokenArenaSize = 0;
 	idLexer::LoadFile( filename, OSPath );
 }
 
@@ -2246,6 +2631,8 @@ idLexer::idLexer( const char* ptr, int length, const char* name, int flags )
 	idLexer::token = "";
 	idLexer::next = NULL;
 	idLexer::hadError = false;
+	idLexer::tokenArenaUsed = 0;
+	idLexer::tokenArenaSize = 0;
 	idLexer::LoadMemory( ptr, length, name );
 }
 
@@ -2279,3 +2666,102 @@ bool idLexer::HadError() const
 	return hadError;
 }
 
+
+/*
+================
+LexerBenchmark_f
+
+Lexes the decl and script corpus from memory with both token modes and reports the throughput.
+================
+*/
+CONSOLE_COMMAND( lexerBenchmark, "lexes all decls and scripts and reports MB/s, usage: lexerBenchmark [passes]", 0 )
+{
+	static const char* corpus[][2] =
+	{
+		{ "def", ".def" },
+		{ "materials", ".mtr" },
+		{ "script", ".script" },
+		{ "guis", ".gui" },
+		{ "particles", ".prt" },
+		{ "fx", ".fx" },
+		{ "skins", ".skin" },
+		{ "af", ".af" },
+		{ "sound", ".sndshd" },
+		{ "maps", ".map" },
+	};
+	
+	const int passes = ( args.Argc() > 1 ) ? Max( 1, atoi( args.Argv( 1 ) ) ) : 4;
+	
+	// load everything up front so only the lexer is timed
+	idList<char*> buffers;
+	idList<int> lengths;
+	int64_t totalBytes = 0;
+	for( int i = 0; i < ( int )ARRAY_COUNT( corpus ); i++ )
+	{
+		idFileList* files = idLib::fileSystem->ListFilesTree( corpus[i][0], corpus[i][1], true );
+		for( int j = 0; j < files->GetNumFiles(); j++ )
+		{
+			void* buffer = NULL;
+			const int length = idLib::fileSystem->ReadFile( files->GetFile( j ), &buffer );
+			if( length <= 0 || buffer == NULL )
+			{
+				continue;
+			}
+			// ReadFile zero terminates the buffer
+			buffers.Append( ( char* ) buffer );
+			lengths.Append( length );
+			totalBytes += length;
+		}
+		idLib::fileSystem->FreeFileList( files );
+	}
+	
+	if( totalBytes == 0 )
+	{
+		idLib::Printf( "lexerBenchmark: no files found\n" );
+		return;
+	}
+	
+	const int lexFlags = LEXFL_NOERRORS | LEXFL_NOFATALERRORS | LEXFL_NOWARNINGS | LEXFL_NOSTRINGCONCAT | LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_ALLOWBACKSLASHSTRINGCONCAT;
+	
+	int64_t numTokens = 0;
+	uint64_t tokenTime = 0;
+	uint64_t viewTime = 0;
+	
+	for( int pass = 0; pass < passes; pass++ )
+	{
+		numTokens = 0;
+		
+		uint64_t start = Sys_Microseconds();
+		for( int i = 0; i < buffers.Num(); i++ )
+		{
+			idLexer src( buffers[i], lengths[i], "lexerBenchmark", lexFlags );
+			idToken token;
+			while( src.ReadToken( &token ) )
+			{
+				numTokens++;
+			}
+		}
+		tokenTime += Sys_Microseconds() - start;
+		
+		start = Sys_Microseconds();
+		for( int i = 0; i < buffers.Num(); i++ )
+		{
+			idLexer src( buffers[i], lengths[i], "lexerBenchmark", lexFlags );
+			idTokenView token;
+			while( src.ReadTokenView( &token ) )
+			{
+			}
+		}
+		viewTime += Sys_Microseconds() - start;
+	}
+	
+	for( int i = 0; i < buffers.Num(); i++ )
+	{
+		idLib::fileSystem->FreeFile( buffers[i] );
+	}
+	
+	const double megaBytes = ( double ) totalBytes * passes / ( 1024.0 * 1024.0 );
+	idLib::Printf( "lexerBenchmark: %d files, %.2f MB, %lld tokens, %d passes\n", buffers.Num(), totalBytes / ( 1024.0 * 1024.0 ), ( long long ) numTokens, passes );
+	idLib::Printf( "  ReadToken     : %8.2f MB/s (%6.2f ms per pass)\n", megaBytes / Max( tokenTime, ( uint64_t )1 ) * 1000000.0, tokenTime / ( 1000.0 * passes ) );
+	idLib::Printf( "  ReadTokenView : %8.2f MB/s (%6.2f ms per pass)\n", megaBytes / Max( viewTime, ( uint64_t )1 ) * 1000000.0, viewTime / ( 1000.0 * passes ) );
+}
@@ -37,6 +37,8 @@ If you have questions concerning this license or the applicable additional terms
 	Does not use memory allocation during parsing. The lexer uses no
 	memory allocation if a source is loaded with LoadMemory().
 	However, idToken may still allocate memory for large strings.
+	ReadTokenView avoids that by returning views into the source buffer,
+	only text that has to be decoded is stored in the lexer token arena.
 
 	A number directly following the escape character '\' in a string is
 	assumed to be in decimal format instead of octal. Binary numbers of
@@ -163,6 +165,8 @@ public:
 	};
 	// read a token
 	int				ReadToken( idToken* token );
+	// read a token as a view into the source buffer, the text stays valid until the source is freed
+	int				ReadTokenView( idTokenView* token );
 	// expect a certain token, reads the token when available
 	int				ExpectTokenString( const char* string );
 	// expect a certain token type
@@ -272,8 +276,13 @@ private:
 	idToken			token;					// available token
 	idLexer* 		next;					// next script in a chain
 	bool			hadError;				// set by idLexer::Error, even if the error is supressed
+	idToken			viewToken;				// scratch token for text decoded by ReadTokenView
+	idList<char*, TAG_IDLIB_LEXER>	tokenArena;	// blocks holding decoded token view text
+	int				tokenArenaUsed;			// bytes used in the last arena block
+	int				tokenArenaSize;			// size of the last arena block
 	
 	static char		baseFolder[ 256 ];		// base folder to load files from
+	static const int TOKEN_ARENA_BLOCK_SIZE = 4096;
 	
 private:
 	void			CreatePunctuationTable( const punctuation_t* punctuations );
@@ -286,6 +295,8 @@ private:
 	int				ReadPrimitive( idToken* token );
 	int				CheckString( const char* str ) const;
 	int				NumLinesCrossed();
+	const char* 	AllocTokenText( const char* text, int length );
+	void			FreeTokenArena();
 };
 
 ID_INLINE const char* idLexer::GetFileName()
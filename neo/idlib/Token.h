@@ -180,4 +180,77 @@ ID_INLINE void idToken::AppendDirty( const char a )
 	data[len++] = a;
 }
 
+/*
+===============================================================================
+
+	idTokenView is a token read with idLexer::ReadTokenView
+
+	The token text is not copied into the token. It points into the lexer
+	source buffer, or into the lexer token arena for text that had to be
+	decoded (strings with escape characters or concatenated strings).
+	The text stays valid until the lexer source is freed and is NOT zero
+	terminated when it points into the source buffer.
+
+===============================================================================
+*/
+
+class idTokenView
+{
+public:
+	const char* 	text;								// token text, not zero terminated
+	int				length;								// length of the token text
+	int				type;								// token type
+	int				subtype;							// token sub type
+	int				line;								// line in script the token was on
+	int				linesCrossed;						// number of lines crossed in white space before token
+	
+public:
+	idTokenView();
+	
+	int				Length() const;
+	int				Cmp( const char* text ) const;
+	int				Icmp( const char* text ) const;
+	bool			operator==( const char* text ) const;
+	bool			operator!=( const char* text ) const;
+	
+	void			ToString( idStr& out ) const;		// copies the text into a zero terminated string
+};
+
+ID_INLINE idTokenView::idTokenView() : text( "" ), length(), type(), subtype(), line(), linesCrossed()
+{
+}
+
+ID_INLINE int idTokenView::Length() const
+{
+	return length;
+}
+
+ID_INLINE int idTokenView::Cmp( const char* text ) const
+{
+	const int c = idStr::Cmpn( this->text, text, length );
+	return ( c != 0 ) ? c : -( ( unsigned char ) text[length] );
+}
+
+ID_INLINE int idTokenView::Icmp( const char* text ) const
+{
+	const int c = idStr::Icmpn( this->text, text, length );
+	return ( c != 0 ) ? c : -( ( unsigned char ) text[length] );
+}
+
+ID_INLINE bool idTokenView::operator==( const char* text ) const
+{
+	return Cmp( text ) == 0;
+}
+
+ID_INLINE bool idTokenView::operator!=( const char* text ) const
+{
+	return Cmp( text ) != 0;
+}
+
+ID_INLINE void idTokenView::ToString( idStr& out ) const
+{
+	out.Clear();
+	out.Append( text, length );
+}
+
 #endif /* !__TOKEN_H__ */
@@ -149,6 +149,7 @@ const int MAX_EXPRESSION_REGISTERS = 4096;
 #include "sys/LightweightCompression.h"
 #include "sys/Snapshot.h"
 #include "sys/PacketProcessor.h"
+#include "sys/PacketBuffer.h"
 #include "sys/SnapshotProcessor.h"
 
 #include "sys/sys_savegame.h"
@@ -58,9 +58,12 @@ public:
 	idDxtEncoder()
 	{
 		srcPadding = dstPadding = 0;
+		progressCounter = NULL;
 	}
 	~idDxtEncoder() {}
 	
+	typedef void ( idDxtEncoder::*compressFunc_t )( const byte* inBuf, byte* outBuf, int width, int height );
+	
 	void	SetSrcPadding( int pad )
 	{
 		srcPadding = pad;
@@ -69,6 +72,19 @@ public:
 	{
 		dstPadding = pad;
 	}
+	// progress is added to the counter instead of the binarize load pacifier
+	void	SetProgressCounter( idSysInterlockedInteger* counter )
+	{
+		progressCounter = counter;
+	}
+	
+	// splits the image in bands of block rows that are compressed by separate jobs on the given job list,
+	// every 4x4 block is encoded independently so the output does not depend on the number of jobs,
+	// a NULL job list or a small image simply runs the compress function on the calling thread
+	void	CompressImageParallel( idParallelJobList* jobList, compressFunc_t func, const byte* inBuf, byte* outBuf, int width, int height, int blockSize );
+	
+	// true if the processor and the OS support the AVX2 code paths
+	static bool	HasAVX2();
 	
 	// high quality DXT1 compression (no alpha), uses exhaustive search to find a line through color space and is very slow
 	void	CompressImageDXT1HQ( const byte* inBuf, byte* outBuf, int width, int height );
@@ -77,6 +93,7 @@ public:
 	void	CompressImageDXT1Fast( const byte* inBuf, byte* outBuf, int width, int height );
 	void	CompressImageDXT1Fast_Generic( const byte* inBuf, byte* outBuf, int width, int height );
 	void	CompressImageDXT1Fast_SSE2( const byte* inBuf, byte* outBuf, int width, int height );
+	void	CompressImageDXT1Fast_AVX2( const byte* inBuf, byte* outBuf, int width, int height );
 	
 	// high quality DXT1 compression (with alpha), uses exhaustive search to find a line through color space and is very slow
 	void	CompressImageDXT1AlphaHQ( const byte* inBuf, byte* outBuf, int width, int height )
@@ -97,6 +114,7 @@ public:
 	void	CompressImageDXT5Fast( const byte* inBuf, byte* outBuf, int width, int height );
 	void	CompressImageDXT5Fast_Generic( const byte* inBuf, byte* outBuf, int width, int height );
 	void	CompressImageDXT5Fast_SSE2( const byte* inBuf, byte* outBuf, int width, int height );
+	void	CompressImageDXT5Fast_AVX2( const byte* inBuf, byte* outBuf, int width, int height );
 	
 	// high quality CTX1 compression, uses exhaustive search to find a line through 2D space and is very slow
 	void	CompressImageCTX1HQ( const byte* inBuf, byte* outBuf, int width, int height );
@@ -136,6 +154,7 @@ public:
 	void	CompressYCoCgDXT5Fast( const byte* inBuf, byte* outBuf, int width, int height );
 	void	CompressYCoCgDXT5Fast_Generic( const byte* inBuf, byte* outBuf, int width, int height );
 	void	CompressYCoCgDXT5Fast_SSE2( const byte* inBuf, byte* outBuf, int width, int height );
+	void	CompressYCoCgDXT5Fast_AVX2( const byte* inBuf, byte* outBuf, int width, int height );
 	
 	// fast YCoCg-Alpha DXT5 compression for real-time use (the input is expected to be in CoCgAY format)
 	void	CompressYCoCgAlphaDXT5Fast( const byte* inBuf, byte* outBuf, int width, int height );
@@ -177,6 +196,7 @@ public:
 	void	CompressNormalMapDXT5Fast( const byte* inBuf, byte* outBuf, int width, int height );
 	void	CompressNormalMapDXT5Fast_Generic( const byte* inBuf, byte* outBuf, int width, int height );
 	void	CompressNormalMapDXT5Fast_SSE2( const byte* inBuf, byte* outBuf, int width, int height );
+	void	CompressNormalMapDXT5Fast_AVX2( const byte* inBuf, byte* outBuf, int width, int height );
 	
 	// high quality tangent space NxNy_ normal map compression into DXN2 (3Dc, ATI2N) format
 	void	CompressNormalMapDXN2HQ( const byte* inBuf, byte* outBuf, int width, int height );
@@ -210,7 +230,9 @@ private:
 	byte* 				outData;
 	int					srcPadding;
 	int					dstPadding;
+	idSysInterlockedInteger* progressCounter;	// NULL reports progress to the binarize load pacifier
 	
+	void				ProgressIncrement( int step );
 	void				EmitByte( byte b );
 	void				EmitUShort( unsigned short s );
 	void				EmitUInt( unsigned int i );
@@ -243,6 +265,8 @@ private:
 	int					GetMinMaxCTX1HQ( const byte* colorBlock, byte* minColor, byte* maxColor ) const;
 	int					GetSquareNormalYError( const byte* colorBlock, const unsigned short color0, const unsigned short color1, int lastError, int scale ) const;
 	int					GetMinMaxNormalYHQ( const byte* colorBlock, byte* minColor, byte* maxColor, bool noBlack, int scale ) const;
+	int					GetMinMaxAlphaHQ_AVX2( const byte* colorBlock, const int alphaOffset, byte* minColor, byte* maxColor ) const;
+	int					GetMinMaxNormalYHQ_AVX2( const byte* colorBlock, byte* minColor, byte* maxColor, bool noBlack, int scale ) const;
 	int					GetSquareNormalsDXT1Error( const int* colorBlock, const unsigned short color0, const unsigned short color1, int lastError, unsigned int& colorIndices ) const;
 	int					GetMinMaxNormalsDXT1HQ( const byte* colorBlock, byte* minColor, byte* maxColor, unsigned int& colorIndices, bool noBlack ) const;
 	int					GetSquareNormalsDXT5Error( const int* normalBlock, const byte* minNormal, const byte* maxNormal, int lastError, unsigned int& colorIndices, byte* alphaIndices ) const;
@@ -317,7 +341,14 @@ idDxtEncoder::CompressImageDXT1Fast
 */
 ID_INLINE void idDxtEncoder::CompressImageDXT1Fast( const byte* inBuf, byte* outBuf, int width, int height )
 {
-	CompressImageDXT1Fast_SSE2( inBuf, outBuf, width, height );
+	if( HasAVX2() )
+	{
+		CompressImageDXT1Fast_AVX2( inBuf, outBuf, width, height );
+	}
+	else
+	{
+		CompressImageDXT1Fast_SSE2( inBuf, outBuf, width, height );
+	}
 }
 
 /*
@@ -337,7 +368,14 @@ idDxtEncoder::CompressImageDXT5Fast
 */
 ID_INLINE void idDxtEncoder::CompressImageDXT5Fast( const byte* inBuf, byte* outBuf, int width, int height )
 {
-	CompressImageDXT5Fast_SSE2( inBuf, outBuf, width, height );
+	if( HasAVX2() )
+	{
+		CompressImageDXT5Fast_AVX2( inBuf, outBuf, width, height );
+	}
+	else
+	{
+		CompressImageDXT5Fast_SSE2( inBuf, outBuf, width, height );
+	}
 }
 
 /*
@@ -357,7 +395,14 @@ idDxtEncoder::CompressYCoCgDXT5Fast
 */
 ID_INLINE void idDxtEncoder::CompressYCoCgDXT5Fast( const byte* inBuf, byte* outBuf, int width, int height )
 {
-	CompressYCoCgDXT5Fast_SSE2( inBuf, outBuf, width, height );
+	if( HasAVX2() )
+	{
+		CompressYCoCgDXT5Fast_AVX2( inBuf, outBuf, width, height );
+	}
+	else
+	{
+		CompressYCoCgDXT5Fast_SSE2( inBuf, outBuf, width, height );
+	}
 }
 
 /*
@@ -377,7 +422,14 @@ idDxtEncoder::CompressNormalMapDXT5Fast
 */
 ID_INLINE void idDxtEncoder::CompressNormalMapDXT5Fast( const byte* inBuf, byte* outBuf, int width, int height )
 {
-	CompressNormalMapDXT5Fast_SSE2( inBuf, outBuf, width, height );
+	if( HasAVX2() )
+	{
+		CompressNormalMapDXT5Fast_AVX2( inBuf, outBuf, width, height );
+	}
+	else
+	{
+		CompressNormalMapDXT5Fast_SSE2( inBuf, outBuf, width, height );
+	}
 }
 
 /*
@@ -67,6 +67,26 @@ typedef uint32_t	dword;
 
 #define BLOCK_OFFSET( x, y, w, bs )  ( ( ( y ) >> 2 ) * ( ( bs ) * ( ( ( w ) + 3 ) >> 2 ) ) + ( ( bs ) * ( ( x ) >> 2 ) ) )
 
+/*
+========================
+idDxtEncoder::ProgressIncrement
+
+The load pacifier redraws the screen, so the bands of a parallel compress only count their
+progress and leave the reporting to the thread that submitted them.
+========================
+*/
+void idDxtEncoder::ProgressIncrement( int step )
+{
+	if( progressCounter != NULL )
+	{
+		progressCounter->Add( step );
+	}
+	else
+	{
+		commonLocal.LoadPacifierBinarizeProgressIncrement( step );
+	}
+}
+
 /*
 ========================
 idDxtEncoder::NV4XHardwareBugFix
@@ -520,6 +540,11 @@ int idDxtEncoder::GetMinMaxAlphaHQ( const byte* colorBlock, const int alphaOffse
 	byte alphaMin, alphaMax;
 	int error, bestError = MAX_TYPE( int );
 	
+	if( HasAVX2() )
+	{
+		return GetMinMaxAlphaHQ_AVX2( colorBlock, alphaOffset, minColor, maxColor );
+	}
+	
 	alphaMin = 255;
 	alphaMax = 0;
 	
@@ -1031,6 +1056,11 @@ int idDxtEncoder::GetMinMaxNormalYHQ( const byte* colorBlock, byte* minColor, by
 	byte bboxMin[3], bboxMax[3];
 	int error, bestError = MAX_TYPE( int );
 	
+	if( HasAVX2() )
+	{
+		return GetMinMaxNormalYHQ_AVX2( colorBlock, minColor, maxColor, noBlack, scale );
+	}
+	
 	bboxMin[1] = 255;
 	bboxMax[1] = 0;
 	
@@ -2176,7 +2206,7 @@ void idDxtEncoder::CompressImageDXT1HQ( const byte* inBuf, byte* outBuf, int wid
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -2258,7 +2288,7 @@ void idDxtEncoder::CompressImageDXT5HQ( const byte* inBuf, byte* outBuf, int wid
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -2358,7 +2388,7 @@ void idDxtEncoder::CompressImageCTX1HQ( const byte* inBuf, byte* outBuf, int wid
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -2806,7 +2836,7 @@ void idDxtEncoder::CompressYCoCgDXT5HQ( const byte* inBuf, byte* outBuf, int wid
 
 	for( i = 0; i < block_count; i++ )
 	{
-		commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+		ProgressIncrement( 16 );
 		// FIXME: NVIDIA_7X_HARDWARE_BUG_FIX?
 		x = ( i % ( ( width + 3 ) >> 2 ) ) << 2;
 		y = ( i / ( ( width + 3 ) >> 2 ) ) << 2;
@@ -2865,7 +2895,7 @@ void idDxtEncoder::CompressYCoCgCTX1DXT5AHQ( const byte* inBuf, byte* outBuf, in
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -3014,7 +3044,7 @@ void idDxtEncoder::CompressNormalMapDXT1HQ( const byte* inBuf, byte* outBuf, int
 	{	
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -3085,7 +3115,7 @@ void idDxtEncoder::CompressNormalMapDXT1RenormalizeHQ( const byte* inBuf, byte*
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -3342,7 +3372,7 @@ void idDxtEncoder::CompressNormalMapDXT5HQ( const byte* inBuf, byte* outBuf, int
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -3454,7 +3484,7 @@ void idDxtEncoder::CompressNormalMapDXT5RenormalizeHQ( const byte* inBuf, byte*
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -3541,7 +3571,7 @@ void idDxtEncoder::CompressNormalMapDXN2HQ( const byte* inBuf, byte* outBuf, int
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -4304,7 +4334,7 @@ void idDxtEncoder::CompressImageDXT1Fast_Generic( const byte* inBuf, byte* outBu
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -4349,7 +4379,7 @@ void idDxtEncoder::CompressImageDXT1AlphaFast_Generic( const byte* inBuf, byte*
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -4404,7 +4434,7 @@ void idDxtEncoder::CompressImageDXT5Fast_Generic( const byte* inBuf, byte* outBu
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -4727,7 +4757,7 @@ void idDxtEncoder::CompressYCoCgDXT5Fast_Generic( const byte* inBuf, byte* outBu
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -4781,7 +4811,7 @@ void idDxtEncoder::CompressYCoCgAlphaDXT5Fast( const byte* inBuf, byte* outBuf,
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -4848,7 +4878,7 @@ void idDxtEncoder::CompressYCoCgCTX1DXT5AFast_Generic( const byte* inBuf, byte*
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -5042,7 +5072,7 @@ void idDxtEncoder::CompressNormalMapDXT5Fast_Generic( const byte* inBuf, byte* o
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -5091,7 +5121,7 @@ void idDxtEncoder::CompressImageDXN1Fast_Generic( const byte* inBuf, byte* outBu
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -5135,7 +5165,7 @@ void idDxtEncoder::CompressNormalMapDXN2Fast_Generic( const byte* inBuf, byte* o
 	{
 		for( int i = 0; i < width; i += 4 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			ExtractBlock( inBuf + i * 4, width, block );
 			
@@ -5299,7 +5329,7 @@ void idDxtEncoder::ConvertNormalMapDXN2_DXT5( const byte* inBuf, byte* outBuf, i
 	{
 		for( int i = 0; i < width; i += 4, inBuf += 16, outBuf += 16 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			// decode normal Y stored as a DXT5 alpha channel
 			DecodeDXNAlphaValues( inBuf + 0, values );
@@ -5451,7 +5481,7 @@ void idDxtEncoder::ConvertNormalMapDXT5_DXN2( const byte* inBuf, byte* outBuf, i
 	{
 		for( int i = 0; i < width; i += 4, inBuf += 16, outBuf += 16 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			// decode normal Y stored as a DXT5 alpha channel
 			DecodeNormalYValues( inBuf + 8, minNormalY, maxNormalY, values );
@@ -5503,7 +5533,7 @@ void idDxtEncoder::ConvertImageDXN1_DXT1( const byte* inBuf, byte* outBuf, int w
 	{
 		for( int i = 0; i < width; i += 4, inBuf += 8, outBuf += 8 )
 		{
-			commonLocal.LoadPacifierBinarizeProgressIncrement(16);
+			ProgressIncrement( 16 );
 		
 			// decode single channel stored as a DXT5 alpha channel
 			DecodeDXNAlphaValues( inBuf + 0, values );
@@ -5531,3 +5561,113 @@ void idDxtEncoder::ConvertImageDXN1_DXT1( const byte* inBuf, byte* outBuf, int w
 	}
 }
 
+/*
+================================================================================================
+
+	Parallel compression
+
+================================================================================================
+*/
+
+static const int MAX_COMPRESS_JOBS			= 64;
+static const int MIN_BLOCKS_PER_JOB			= 256;		// a 64x64 texel area, smaller bands cost more in job overhead than they gain
+
+struct dxtCompressJobParms_t
+{
+	idDxtEncoder					encoder;
+	idDxtEncoder::compressFunc_t	func;
+	const byte* 					inBuf;
+	byte* 							outBuf;
+	int								width;
+	int								height;
+};
+
+/*
+========================
+DxtCompressJob
+========================
+*/
+static void DxtCompressJob( dxtCompressJobParms_t* parms )
+{
+	( parms->encoder.*( parms->func ) )( parms->inBuf, parms->outBuf, parms->width, parms->height );
+}
+
+REGISTER_PARALLEL_JOB( DxtCompressJob, "DxtCompressJob" );
+
+/*
+========================
+idDxtEncoder::CompressImageParallel
+
+params:	jobList		- job list to submit the bands to, NULL compresses on the calling thread
+params:	func		- compress function used for every band
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+params:	blockSize	- number of bytes written per 4x4 block, 8 for DXT1 and 16 for DXT5
+
+The source image has to be tightly packed, the bands are cut at multiples of the block row size.
+========================
+*/
+void idDxtEncoder::CompressImageParallel( idParallelJobList* jobList, compressFunc_t func, const byte* inBuf, byte* outBuf, int width, int height, int blockSize )
+{
+	assert( srcPadding == 0 );
+	
+	const int blocksPerRow = width >> 2;
+	const int blockRows = height >> 2;
+	
+	int numJobs = 0;
+	if( jobList != NULL && ( width & 3 ) == 0 && ( height & 3 ) == 0 )
+	{
+		numJobs = Min( blockRows, Min( MAX_COMPRESS_JOBS, blocksPerRow * blockRows / MIN_BLOCKS_PER_JOB ) );
+	}
+	
+	if( numJobs <= 1 )
+	{
+		( this->*func )( inBuf, outBuf, width, height );
+		return;
+	}
+	
+	idSysInterlockedInteger progress;
+	dxtCompressJobParms_t parms[MAX_COMPRESS_JOBS];
+	
+	const int srcRowPitch = width * 4 * 4;
+	const int dstRowPitch = blocksPerRow * blockSize + dstPadding;
+	
+	for( int i = 0; i < numJobs; i++ )
+	{
+		const int firstRow = blockRows * i / numJobs;
+		const int lastRow = blockRows * ( i + 1 ) / numJobs;
+		
+		dxtCompressJobParms_t& job = parms[i];
+		job.encoder.SetDstPadding( dstPadding );
+		job.encoder.SetProgressCounter( &progress );
+		job.func = func;
+		job.inBuf = inBuf + firstRow * srcRowPitch;
+		job.outBuf = outBuf + firstRow * dstRowPitch;
+		job.width = width;
+		job.height = ( lastRow - firstRow ) * 4;
+		
+		jobList->AddJob( ( jobRun_t )DxtCompressJob, &job );
+	}
+	
+	jobList->Submit();
+	
+	// forward the progress of the bands to the load pacifier while waiting
+	int reported = 0;
+	for( ;; )
+	{
+		const bool done = jobList->TryWait();
+		const int current = progress.GetValue();
+		if( current > reported )
+		{
+			ProgressIncrement( current - reported );
+			reported = current;
+		}
+		if( done )
+		{
+			break;
+		}
+		Sys_Yield();
+	}
+}
@@ -0,0 +1,1415 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+Copyright (C) 2014-2016 Robert Beckebans
+Copyright (C) 2014-2016 Kot in Action Creative Artel
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#pragma hdrstop
+#include "precompiled.h"
+#include "DXTCodec_local.h"
+#include "DXTCodec.h"
+
+#include <immintrin.h>
+
+/*
+================================================================================================
+
+	AVX2 versions of the fast encoders and the exhaustive HQ searches.
+
+	The fast encoders are a straight port of the SSE2 code where every 128-bit lane of a 256-bit
+	register holds one 4x4 block, so two horizontally adjacent blocks are encoded with the same
+	instructions. AVX2 integer instructions don't cross lanes, which keeps the result of every
+	block bit identical to the SSE2 encoder.
+
+	Only the functions in this file are compiled for AVX2, the rest of the engine keeps running
+	on processors without it as long as HasAVX2() is checked first.
+
+================================================================================================
+*/
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define DXT_AVX2						__attribute__(( target( "avx2" ) ))
+#else
+#define DXT_AVX2
+#endif
+
+#define INSET_COLOR_SHIFT		4		// inset the bounding box with ( range >> shift )
+#define INSET_ALPHA_SHIFT		5		// inset alpha channel
+
+#define C565_5_MASK				0xF8	// 0xFF minus last three bits
+#define C565_6_MASK				0xFC	// 0xFF minus last two bits
+
+#define NVIDIA_7X_HARDWARE_BUG_FIX		// keep the DXT5 colors sorted as: max, min
+
+#if !defined( R_SHUFFLE_D )
+#define R_SHUFFLE_D( x, y, z, w )	(( (w) & 3 ) << 6 | ( (z) & 3 ) << 4 | ( (y) & 3 ) << 2 | ( (x) & 3 ))
+#endif
+
+#define _mm256_shuffle_ps_si256( a, b, imm )	_mm256_castps_si256( _mm256_shuffle_ps( _mm256_castsi256_ps( a ), _mm256_castsi256_ps( b ), imm ) )
+
+/*
+========================
+idDxtEncoder::HasAVX2
+========================
+*/
+bool idDxtEncoder::HasAVX2()
+{
+	static const bool hasAVX2 = ( Sys_GetProcessorId() & CPUID_AVX2 ) != 0;
+	return hasAVX2;
+}
+
+/*
+========================
+KeepFirstDword_AVX2
+
+Keeps the first dword of both lanes, the same as an _mm_cvtsi128_si32 / _mm_cvtsi32_si128 round
+trip through memory in the SSE2 code.
+========================
+*/
+static DXT_AVX2 ID_INLINE __m256i KeepFirstDword_AVX2( __m256i x )
+{
+	return _mm256_and_si256( x, _mm256_setr_epi32( -1, 0, 0, 0, -1, 0, 0, 0 ) );
+}
+
+/*
+========================
+ExtractBlocks_AVX2
+
+Loads two horizontally adjacent 4x4 blocks, one per lane. A single block is duplicated into both lanes.
+
+params:	inPtr		- input image, 4 bytes per pixel
+params:	numBlocks	- 1 or 2
+paramO:	block		- 4 rows of 2 blocks
+========================
+*/
+static DXT_AVX2 ID_INLINE void ExtractBlocks_AVX2( const byte* inPtr, int width, int numBlocks, __m256i* block )
+{
+	if( numBlocks == 2 )
+	{
+		block[0] = _mm256_loadu_si256( ( const __m256i* )( inPtr + width * 4 * 0 ) );
+		block[1] = _mm256_loadu_si256( ( const __m256i* )( inPtr + width * 4 * 1 ) );
+		block[2] = _mm256_loadu_si256( ( const __m256i* )( inPtr + width * 4 * 2 ) );
+		block[3] = _mm256_loadu_si256( ( const __m256i* )( inPtr + width * 4 * 3 ) );
+	}
+	else
+	{
+		block[0] = _mm256_broadcastsi128_si256( _mm_loadu_si128( ( const __m128i* )( inPtr + width * 4 * 0 ) ) );
+		block[1] = _mm256_broadcastsi128_si256( _mm_loadu_si128( ( const __m128i* )( inPtr + width * 4 * 1 ) ) );
+		block[2] = _mm256_broadcastsi128_si256( _mm_loadu_si128( ( const __m128i* )( inPtr + width * 4 * 2 ) ) );
+		block[3] = _mm256_broadcastsi128_si256( _mm_loadu_si128( ( const __m128i* )( inPtr + width * 4 * 3 ) ) );
+	}
+}
+
+/*
+========================
+StoreLanes_AVX2
+
+Stores the first dword of both lanes.
+========================
+*/
+static DXT_AVX2 ID_INLINE void StoreLanes_AVX2( __m256i x, unsigned int* lanes )
+{
+	lanes[0] = _mm256_cvtsi256_si32( x );
+	lanes[1] = _mm256_extract_epi32( x, 4 );
+}
+
+/*
+========================
+GetMinMaxBBox_AVX2
+
+Takes the extents of the bounding box of the colors in the 4x4 blocks.
+========================
+*/
+static DXT_AVX2 ID_INLINE void GetMinMaxBBox_AVX2( const __m256i* block, __m256i& minColor, __m256i& maxColor )
+{
+	__m256i max1 = _mm256_max_epu8( block[0], block[1] );
+	__m256i min1 = _mm256_min_epu8( block[0], block[1] );
+	__m256i max2 = _mm256_max_epu8( block[2], block[3] );
+	__m256i min2 = _mm256_min_epu8( block[2], block[3] );
+
+	__m256i max3 = _mm256_max_epu8( max1, max2 );
+	__m256i min3 = _mm256_min_epu8( min1, min2 );
+
+	__m256i max4 = _mm256_shuffle_epi32( max3, R_SHUFFLE_D( 2, 3, 2, 3 ) );
+	__m256i min4 = _mm256_shuffle_epi32( min3, R_SHUFFLE_D( 2, 3, 2, 3 ) );
+
+	__m256i max5 = _mm256_max_epu8( max3, max4 );
+	__m256i min5 = _mm256_min_epu8( min3, min4 );
+
+	__m256i max6 = _mm256_shufflelo_epi16( max5, R_SHUFFLE_D( 2, 3, 2, 3 ) );
+	__m256i min6 = _mm256_shufflelo_epi16( min5, R_SHUFFLE_D( 2, 3, 2, 3 ) );
+
+	maxColor = KeepFirstDword_AVX2( _mm256_max_epu8( max5, max6 ) );
+	minColor = KeepFirstDword_AVX2( _mm256_min_epu8( min5, min6 ) );
+}
+
+/*
+========================
+InsetColorsBBox_AVX2
+========================
+*/
+static DXT_AVX2 ID_INLINE void InsetColorsBBox_AVX2( __m256i& minColor, __m256i& maxColor )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i insetShift = _mm256_setr_epi16(	1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_ALPHA_SHIFT ), 0, 0, 0, 0,
+													1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_ALPHA_SHIFT ), 0, 0, 0, 0 );
+
+	__m256i xmm0 = _mm256_unpacklo_epi8( minColor, zero );
+	__m256i xmm1 = _mm256_unpacklo_epi8( maxColor, zero );
+
+	__m256i xmm2 = _mm256_sub_epi16( xmm1, xmm0 );
+
+	xmm2 = _mm256_mulhi_epi16( xmm2, insetShift );
+
+	xmm0 = _mm256_add_epi16( xmm0, xmm2 );
+	xmm1 = _mm256_sub_epi16( xmm1, xmm2 );
+
+	minColor = KeepFirstDword_AVX2( _mm256_packus_epi16( xmm0, xmm0 ) );
+	maxColor = KeepFirstDword_AVX2( _mm256_packus_epi16( xmm1, xmm1 ) );
+}
+
+/*
+========================
+FindIndices_AVX2
+
+Finds the closest of the four colors for every pixel of the blocks, the color distances are
+compared exactly like the SSE2 encoder does.
+
+return: 4 byte color index block in the first dword of every lane
+========================
+*/
+static DXT_AVX2 ID_INLINE __m256i FindIndices_AVX2( const __m256i* block, const __m256i color0, const __m256i color1, const __m256i color2, const __m256i color3 )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i word1 = _mm256_set1_epi16( 1 );
+	const __m256i word2 = _mm256_set1_epi16( 2 );
+	__m256i result = zero;
+	__m256i temp0, temp1, temp2, temp3, temp4, temp5, temp6, temp7;
+
+	for( int i = 1; i >= 0; i-- )
+	{
+		const __m256i blocka = block[i * 2 + 0];
+		const __m256i blockb = block[i * 2 + 1];
+
+		// Load block
+		temp3 = _mm256_shuffle_epi32( blocka, R_SHUFFLE_D( 0, 2, 1, 3 ) );
+		temp5 = _mm256_shuffle_ps_si256( blocka, zero, R_SHUFFLE_D( 2, 3, 0, 1 ) );
+		temp5 = _mm256_shuffle_epi32( temp5, R_SHUFFLE_D( 0, 2, 1, 3 ) );
+
+		temp0 = _mm256_sad_epu8( temp3, color0 );
+		temp6 = _mm256_sad_epu8( temp5, color0 );
+		temp0 = _mm256_packs_epi32( temp0, temp6 );
+
+		temp1 = _mm256_sad_epu8( temp3, color1 );
+		temp6 = _mm256_sad_epu8( temp5, color1 );
+		temp1 = _mm256_packs_epi32( temp1, temp6 );
+
+		temp2 = _mm256_sad_epu8( temp3, color2 );
+		temp6 = _mm256_sad_epu8( temp5, color2 );
+		temp2 = _mm256_packs_epi32( temp2, temp6 );
+
+		temp3 = _mm256_sad_epu8( temp3, color3 );
+		temp5 = _mm256_sad_epu8( temp5, color3 );
+		temp3 = _mm256_packs_epi32( temp3, temp5 );
+
+		// Load block
+		temp4 = _mm256_shuffle_epi32( blockb, R_SHUFFLE_D( 0, 2, 1, 3 ) );
+		temp5 = _mm256_shuffle_ps_si256( blockb, zero, R_SHUFFLE_D( 2, 3, 0, 1 ) );
+		temp5 = _mm256_shuffle_epi32( temp5, R_SHUFFLE_D( 0, 2, 1, 3 ) );
+
+		temp6 = _mm256_sad_epu8( temp4, color0 );
+		temp7 = _mm256_sad_epu8( temp5, color0 );
+		temp6 = _mm256_packs_epi32( temp6, temp7 );
+		temp0 = _mm256_packs_epi32( temp0, temp6 );	// d0
+
+		temp6 = _mm256_sad_epu8( temp4, color1 );
+		temp7 = _mm256_sad_epu8( temp5, color1 );
+		temp6 = _mm256_packs_epi32( temp6, temp7 );
+		temp1 = _mm256_packs_epi32( temp1, temp6 );	// d1
+
+		temp6 = _mm256_sad_epu8( temp4, color2 );
+		temp7 = _mm256_sad_epu8( temp5, color2 );
+		temp6 = _mm256_packs_epi32( temp6, temp7 );
+		temp2 = _mm256_packs_epi32( temp2, temp6 );	// d2
+
+		temp4 = _mm256_sad_epu8( temp4, color3 );
+		temp5 = _mm256_sad_epu8( temp5, color3 );
+		temp4 = _mm256_packs_epi32( temp4, temp5 );
+		temp3 = _mm256_packs_epi32( temp3, temp4 );	// d3
+
+		temp7 = _mm256_slli_epi32( result, 16 );
+
+		temp4 = _mm256_cmpgt_epi16( temp0, temp2 );	// b2
+		temp5 = _mm256_cmpgt_epi16( temp1, temp3 );	// b3
+		temp0 = _mm256_cmpgt_epi16( temp0, temp3 );	// b0
+		temp1 = _mm256_cmpgt_epi16( temp1, temp2 );	// b1
+		temp2 = _mm256_cmpgt_epi16( temp2, temp3 );	// b4
+
+		temp4 = _mm256_and_si256( temp4, temp1 );	// x0
+		temp5 = _mm256_and_si256( temp5, temp0 );	// x1
+		temp2 = _mm256_and_si256( temp2, temp0 );	// x2
+		temp4 = _mm256_or_si256( temp4, temp5 );
+		temp2 = _mm256_and_si256( temp2, word1 );
+		temp4 = _mm256_and_si256( temp4, word2 );
+		temp2 = _mm256_or_si256( temp2, temp4 );
+
+		temp5 = _mm256_shuffle_epi32( temp2, R_SHUFFLE_D( 2, 3, 0, 1 ) );
+		temp2 = _mm256_unpacklo_epi16( temp2, zero );
+		temp5 = _mm256_unpacklo_epi16( temp5, zero );
+		temp5 = _mm256_slli_epi32( temp5, 8 );
+		temp7 = _mm256_or_si256( temp7, temp5 );
+		result = _mm256_or_si256( temp7, temp2 );
+	}
+
+	temp4 = _mm256_shuffle_epi32( result, R_SHUFFLE_D( 1, 2, 3, 0 ) );
+	temp5 = _mm256_shuffle_epi32( result, R_SHUFFLE_D( 2, 3, 0, 1 ) );
+	temp6 = _mm256_shuffle_epi32( result, R_SHUFFLE_D( 3, 0, 1, 2 ) );
+	temp4 = _mm256_slli_epi32( temp4, 2 );
+	temp5 = _mm256_slli_epi32( temp5, 4 );
+	temp6 = _mm256_slli_epi32( temp6, 6 );
+	temp7 = _mm256_or_si256( result, temp4 );
+	temp7 = _mm256_or_si256( temp7, temp5 );
+	temp7 = _mm256_or_si256( temp7, temp6 );
+
+	return temp7;
+}
+
+/*
+========================
+ColorIndices_AVX2
+
+return: 4 byte color index block in the first dword of every lane
+========================
+*/
+static DXT_AVX2 ID_INLINE __m256i ColorIndices_AVX2( const __m256i* block, const __m256i minColor, const __m256i maxColor )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i colorMask = _mm256_setr_epi8(	C565_5_MASK, C565_6_MASK, C565_5_MASK, 0x00, 0x00, 0x00, 0x00, 0x00, C565_5_MASK, C565_6_MASK, C565_5_MASK, 0x00, 0x00, 0x00, 0x00, 0x00,
+												C565_5_MASK, C565_6_MASK, C565_5_MASK, 0x00, 0x00, 0x00, 0x00, 0x00, C565_5_MASK, C565_6_MASK, C565_5_MASK, 0x00, 0x00, 0x00, 0x00, 0x00 );
+	const __m256i divBy3 = _mm256_set1_epi16( ( 1 << 16 ) / 3 + 1 );
+	__m256i color0, color1, color2, color3;
+	__m256i temp0, temp1, temp2, temp3, temp4, temp5, temp6;
+
+	temp0 = _mm256_and_si256( maxColor, colorMask );
+	temp0 = _mm256_unpacklo_epi8( temp0, zero );
+	temp4 = _mm256_shufflelo_epi16( temp0, R_SHUFFLE_D( 0, 3, 2, 3 ) );
+	temp5 = _mm256_shufflelo_epi16( temp0, R_SHUFFLE_D( 3, 1, 3, 3 ) );
+	temp4 = _mm256_srli_epi16( temp4, 5 );
+	temp5 = _mm256_srli_epi16( temp5, 6 );
+	temp0 = _mm256_or_si256( temp0, temp4 );
+	temp0 = _mm256_or_si256( temp0, temp5 );
+
+	temp1 = _mm256_and_si256( minColor, colorMask );
+	temp1 = _mm256_unpacklo_epi8( temp1, zero );
+	temp4 = _mm256_shufflelo_epi16( temp1, R_SHUFFLE_D( 0, 3, 2, 3 ) );
+	temp5 = _mm256_shufflelo_epi16( temp1, R_SHUFFLE_D( 3, 1, 3, 3 ) );
+	temp4 = _mm256_srli_epi16( temp4, 5 );
+	temp5 = _mm256_srli_epi16( temp5, 6 );
+	temp1 = _mm256_or_si256( temp1, temp4 );
+	temp1 = _mm256_or_si256( temp1, temp5 );
+
+	temp2 = _mm256_packus_epi16( temp0, zero );
+	color0 = _mm256_shuffle_epi32( temp2, R_SHUFFLE_D( 0, 1, 0, 1 ) );
+
+	temp6 = _mm256_add_epi16( temp0, temp0 );
+	temp6 = _mm256_add_epi16( temp6, temp1 );
+	temp6 = _mm256_mulhi_epi16( temp6, divBy3 );		// * ( ( 1 << 16 ) / 3 + 1 ) ) >> 16
+	temp6 = _mm256_packus_epi16( temp6, zero );
+	color2 = _mm256_shuffle_epi32( temp6, R_SHUFFLE_D( 0, 1, 0, 1 ) );
+
+	temp3 = _mm256_packus_epi16( temp1, zero );
+	color1 = _mm256_shuffle_epi32( temp3, R_SHUFFLE_D( 0, 1, 0, 1 ) );
+
+	temp1 = _mm256_add_epi16( temp1, temp1 );
+	temp0 = _mm256_add_epi16( temp0, temp1 );
+	temp0 = _mm256_mulhi_epi16( temp0, divBy3 );		// * ( ( 1 << 16 ) / 3 + 1 ) ) >> 16
+	temp0 = _mm256_packus_epi16( temp0, zero );
+	color3 = _mm256_shuffle_epi32( temp0, R_SHUFFLE_D( 0, 1, 0, 1 ) );
+
+	return FindIndices_AVX2( block, color0, color1, color2, color3 );
+}
+
+/*
+========================
+CoCgIndices_AVX2
+
+return: 4 byte color index block in the first dword of every lane
+========================
+*/
+static DXT_AVX2 ID_INLINE __m256i CoCgIndices_AVX2( const __m256i* block, const __m256i minColor, const __m256i maxColor )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i colorMask2 = _mm256_setr_epi32( 0x00FFFFFF, 0, 0x00FFFFFF, 0, 0x00FFFFFF, 0, 0x00FFFFFF, 0 );
+	const __m256i divBy3 = _mm256_set1_epi16( ( 1 << 16 ) / 3 + 1 );
+	__m256i color0, color1, color2, color3;
+	__m256i temp0, temp1, temp6;
+
+	temp0 = _mm256_and_si256( maxColor, colorMask2 );
+	color0 = _mm256_shuffle_epi32( temp0, R_SHUFFLE_D( 0, 1, 0, 1 ) );
+
+	temp1 = _mm256_and_si256( minColor, colorMask2 );
+	color1 = _mm256_shuffle_epi32( temp1, R_SHUFFLE_D( 0, 1, 0, 1 ) );
+
+	temp0 = _mm256_unpacklo_epi8( color0, zero );
+	temp1 = _mm256_unpacklo_epi8( color1, zero );
+
+	temp6 = _mm256_add_epi16( temp1, temp0 );
+	temp0 = _mm256_add_epi16( temp0, temp6 );
+	temp0 = _mm256_mulhi_epi16( temp0, divBy3 );		// * ( ( 1 << 16 ) / 3 + 1 ) ) >> 16
+	temp0 = _mm256_packus_epi16( temp0, zero );
+	color2 = _mm256_shuffle_epi32( temp0, R_SHUFFLE_D( 0, 1, 0, 1 ) );
+
+	temp1 = _mm256_add_epi16( temp1, temp6 );
+	temp1 = _mm256_mulhi_epi16( temp1, divBy3 );		// * ( ( 1 << 16 ) / 3 + 1 ) ) >> 16
+	temp1 = _mm256_packus_epi16( temp1, zero );
+	color3 = _mm256_shuffle_epi32( temp1, R_SHUFFLE_D( 0, 1, 0, 1 ) );
+
+	return FindIndices_AVX2( block, color0, color1, color2, color3 );
+}
+
+/*
+========================
+AlphaIndices_AVX2
+
+params:	block				- 4 rows of 2 blocks
+params:	channelBitOffset	- bit offset of the channel to encode
+params:	minAlpha			- min alpha in the first dword of every lane
+params:	maxAlpha			- max alpha in the first dword of every lane
+return: two times 3 bytes of alpha indices in the first and third dword of every lane
+========================
+*/
+static DXT_AVX2 ID_INLINE __m256i AlphaIndices_AVX2( const __m256i* block, const int channelBitOffset, const __m256i minAlpha, const __m256i maxAlpha )
+{
+	const __m256i byteMask = _mm256_set1_epi32( 0x000000FF );
+	const __m256i scale_7_5_3_1 = _mm256_setr_epi16( 7, 7, 5, 5, 3, 3, 1, 1, 7, 7, 5, 5, 3, 3, 1, 1 );
+	const __m256i scale_7_9_11_13 = _mm256_setr_epi16( 7, 7, 9, 9, 11, 11, 13, 13, 7, 7, 9, 9, 11, 11, 13, 13 );
+	const __m256i word7 = _mm256_set1_epi16( 7 );
+	const __m256i divBy14 = _mm256_set1_epi16( ( 1 << 16 ) / 14 + 1 );
+	const __m128i shift = _mm_cvtsi32_si128( channelBitOffset );
+	__m256i temp0, temp1, temp2, temp3, temp4, temp5, temp6, temp7;
+
+	temp0 = _mm256_srl_epi32( block[0], shift );
+	temp5 = _mm256_srl_epi32( block[1], shift );
+	temp6 = _mm256_srl_epi32( block[2], shift );
+	temp4 = _mm256_srl_epi32( block[3], shift );
+
+	temp0 = _mm256_and_si256( temp0, byteMask );
+	temp5 = _mm256_and_si256( temp5, byteMask );
+	temp6 = _mm256_and_si256( temp6, byteMask );
+	temp4 = _mm256_and_si256( temp4, byteMask );
+
+	temp0 = _mm256_packus_epi16( temp0, temp5 );
+	temp6 = _mm256_packus_epi16( temp6, temp4 );
+
+	//---------------------
+
+	// ab0 = (  7 * maxAlpha +  7 * minAlpha + ALPHA_RANGE ) / 14
+	// ab3 = (  9 * maxAlpha +  5 * minAlpha + ALPHA_RANGE ) / 14
+	// ab2 = ( 11 * maxAlpha +  3 * minAlpha + ALPHA_RANGE ) / 14
+	// ab1 = ( 13 * maxAlpha +  1 * minAlpha + ALPHA_RANGE ) / 14
+
+	// ab4 = (  7 * maxAlpha +  7 * minAlpha + ALPHA_RANGE ) / 14
+	// ab5 = (  5 * maxAlpha +  9 * minAlpha + ALPHA_RANGE ) / 14
+	// ab6 = (  3 * maxAlpha + 11 * minAlpha + ALPHA_RANGE ) / 14
+	// ab7 = (  1 * maxAlpha + 13 * minAlpha + ALPHA_RANGE ) / 14
+
+	temp5 = _mm256_shufflelo_epi16( maxAlpha, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	temp5 = _mm256_shuffle_epi32( temp5, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+
+	temp2 = _mm256_shufflelo_epi16( minAlpha, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	temp2 = _mm256_shuffle_epi32( temp2, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+
+	temp7 = _mm256_mullo_epi16( temp5, scale_7_5_3_1 );
+	temp5 = _mm256_mullo_epi16( temp5, scale_7_9_11_13 );
+	temp3 = _mm256_mullo_epi16( temp2, scale_7_9_11_13 );
+	temp2 = _mm256_mullo_epi16( temp2, scale_7_5_3_1 );
+
+	temp5 = _mm256_add_epi16( temp5, temp2 );
+	temp7 = _mm256_add_epi16( temp7, temp3 );
+
+	temp5 = _mm256_add_epi16( temp5, word7 );
+	temp7 = _mm256_add_epi16( temp7, word7 );
+
+	temp5 = _mm256_mulhi_epi16( temp5, divBy14 );
+	temp7 = _mm256_mulhi_epi16( temp7, divBy14 );
+
+	temp1 = _mm256_shuffle_epi32( temp5, R_SHUFFLE_D( 3, 3, 3, 3 ) );
+	temp2 = _mm256_shuffle_epi32( temp5, R_SHUFFLE_D( 2, 2, 2, 2 ) );
+	temp3 = _mm256_shuffle_epi32( temp5, R_SHUFFLE_D( 1, 1, 1, 1 ) );
+	temp1 = _mm256_packus_epi16( temp1, temp1 );
+	temp2 = _mm256_packus_epi16( temp2, temp2 );
+	temp3 = _mm256_packus_epi16( temp3, temp3 );
+
+	temp0 = _mm256_packus_epi16( temp0, temp6 );
+
+	temp4 = _mm256_shuffle_epi32( temp7, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	temp5 = _mm256_shuffle_epi32( temp7, R_SHUFFLE_D( 1, 1, 1, 1 ) );
+	temp6 = _mm256_shuffle_epi32( temp7, R_SHUFFLE_D( 2, 2, 2, 2 ) );
+	temp7 = _mm256_shuffle_epi32( temp7, R_SHUFFLE_D( 3, 3, 3, 3 ) );
+	temp4 = _mm256_packus_epi16( temp4, temp4 );
+	temp5 = _mm256_packus_epi16( temp5, temp5 );
+	temp6 = _mm256_packus_epi16( temp6, temp6 );
+	temp7 = _mm256_packus_epi16( temp7, temp7 );
+
+	temp1 = _mm256_max_epu8( temp1, temp0 );
+	temp2 = _mm256_max_epu8( temp2, temp0 );
+	temp3 = _mm256_max_epu8( temp3, temp0 );
+	temp1 = _mm256_cmpeq_epi8( temp1, temp0 );
+	temp2 = _mm256_cmpeq_epi8( temp2, temp0 );
+	temp3 = _mm256_cmpeq_epi8( temp3, temp0 );
+	temp4 = _mm256_max_epu8( temp4, temp0 );
+	temp5 = _mm256_max_epu8( temp5, temp0 );
+	temp6 = _mm256_max_epu8( temp6, temp0 );
+	temp7 = _mm256_max_epu8( temp7, temp0 );
+	temp4 = _mm256_cmpeq_epi8( temp4, temp0 );
+	temp5 = _mm256_cmpeq_epi8( temp5, temp0 );
+	temp6 = _mm256_cmpeq_epi8( temp6, temp0 );
+	temp7 = _mm256_cmpeq_epi8( temp7, temp0 );
+	temp0 = _mm256_adds_epi8( _mm256_set1_epi8( 8 ), temp1 );
+	temp2 = _mm256_adds_epi8( temp2, temp3 );
+	temp4 = _mm256_adds_epi8( temp4, temp5 );
+	temp6 = _mm256_adds_epi8( temp6, temp7 );
+	temp0 = _mm256_adds_epi8( temp0, temp2 );
+	temp4 = _mm256_adds_epi8( temp4, temp6 );
+	temp0 = _mm256_adds_epi8( temp0, temp4 );
+	temp0 = _mm256_and_si256( temp0, _mm256_set1_epi8( 7 ) );
+	temp1 = _mm256_cmpgt_epi8( _mm256_set1_epi8( 2 ), temp0 );
+	temp1 = _mm256_and_si256( temp1, _mm256_set1_epi8( 1 ) );
+	temp0 = _mm256_xor_si256( temp0, temp1 );
+
+	temp1 = _mm256_srli_epi64( temp0,  8 -  3 );
+	temp2 = _mm256_srli_epi64( temp0, 16 -  6 );
+	temp3 = _mm256_srli_epi64( temp0, 24 -  9 );
+	temp4 = _mm256_srli_epi64( temp0, 32 - 12 );
+	temp5 = _mm256_srli_epi64( temp0, 40 - 15 );
+	temp6 = _mm256_srli_epi64( temp0, 48 - 18 );
+	temp7 = _mm256_srli_epi64( temp0, 56 - 21 );
+	temp0 = _mm256_and_si256( temp0, _mm256_set1_epi64x( 7 << 0 ) );
+	temp1 = _mm256_and_si256( temp1, _mm256_set1_epi64x( 7 << 3 ) );
+	temp2 = _mm256_and_si256( temp2, _mm256_set1_epi64x( 7 << 6 ) );
+	temp3 = _mm256_and_si256( temp3, _mm256_set1_epi64x( 7 << 9 ) );
+	temp4 = _mm256_and_si256( temp4, _mm256_set1_epi64x( 7 << 12 ) );
+	temp5 = _mm256_and_si256( temp5, _mm256_set1_epi64x( 7 << 15 ) );
+	temp6 = _mm256_and_si256( temp6, _mm256_set1_epi64x( 7 << 18 ) );
+	temp7 = _mm256_and_si256( temp7, _mm256_set1_epi64x( 7 << 21 ) );
+	temp0 = _mm256_or_si256( temp0, temp1 );
+	temp2 = _mm256_or_si256( temp2, temp3 );
+	temp4 = _mm256_or_si256( temp4, temp5 );
+	temp6 = _mm256_or_si256( temp6, temp7 );
+	temp0 = _mm256_or_si256( temp0, temp2 );
+	temp4 = _mm256_or_si256( temp4, temp6 );
+	temp0 = _mm256_or_si256( temp0, temp4 );
+
+	return temp0;
+}
+
+/*
+========================
+GreenIndices_AVX2
+
+params:	block				- 4 rows of 2 blocks
+params:	channelBitOffset	- bit offset of the channel to encode
+params:	minGreen			- min green in the first dword of every lane
+params:	maxGreen			- max green in the first dword of every lane
+return: 4 byte index block in the first dword of every lane
+========================
+*/
+static DXT_AVX2 ID_INLINE __m256i GreenIndices_AVX2( const __m256i* block, const int channelBitOffset, const __m256i minGreen, const __m256i maxGreen )
+{
+	const __m256i byteMask = _mm256_set1_epi32( 0x000000FF );
+	const __m256i scale_5_3_1 = _mm256_setr_epi16( 5, 3, 1, 0, 5, 3, 1, 0, 5, 3, 1, 0, 5, 3, 1, 0 );
+	const __m256i scale_1_3_5 = _mm256_setr_epi16( 1, 3, 5, 0, 1, 3, 5, 0, 1, 3, 5, 0, 1, 3, 5, 0 );
+	const __m256i divBy6 = _mm256_set1_epi16( ( 1 << 16 ) / 6 + 1 );
+	const __m128i shift = _mm_cvtsi32_si128( channelBitOffset );
+	__m256i temp0, temp1, temp2, temp3, temp4, temp5, temp6, temp7;
+
+	temp0 = _mm256_srl_epi32( block[0], shift );
+	temp5 = _mm256_srl_epi32( block[1], shift );
+	temp6 = _mm256_srl_epi32( block[2], shift );
+	temp4 = _mm256_srl_epi32( block[3], shift );
+
+	temp0 = _mm256_and_si256( temp0, byteMask );
+	temp5 = _mm256_and_si256( temp5, byteMask );
+	temp6 = _mm256_and_si256( temp6, byteMask );
+	temp4 = _mm256_and_si256( temp4, byteMask );
+
+	temp0 = _mm256_packus_epi16( temp0, temp5 );
+	temp6 = _mm256_packus_epi16( temp6, temp4 );
+
+	//---------------------
+
+	temp2 = _mm256_shufflelo_epi16( maxGreen, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	temp3 = _mm256_shufflelo_epi16( minGreen, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+
+	temp2 = _mm256_mullo_epi16( temp2, scale_5_3_1 );
+	temp3 = _mm256_mullo_epi16( temp3, scale_1_3_5 );
+	temp2 = _mm256_add_epi16( temp2, _mm256_set1_epi16( 3 ) );
+	temp3 = _mm256_add_epi16( temp3, temp2 );
+	temp3 = _mm256_mulhi_epi16( temp3, divBy6 );
+
+	temp1 = _mm256_shufflelo_epi16( temp3, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	temp2 = _mm256_shufflelo_epi16( temp3, R_SHUFFLE_D( 1, 1, 1, 1 ) );
+	temp3 = _mm256_shufflelo_epi16( temp3, R_SHUFFLE_D( 2, 2, 2, 2 ) );
+
+	temp1 = _mm256_shuffle_epi32( temp1, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	temp2 = _mm256_shuffle_epi32( temp2, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	temp3 = _mm256_shuffle_epi32( temp3, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+
+	temp1 = _mm256_packus_epi16( temp1, temp1 );
+	temp2 = _mm256_packus_epi16( temp2, temp2 );
+	temp3 = _mm256_packus_epi16( temp3, temp3 );
+
+	temp0 = _mm256_packus_epi16( temp0, temp6 );
+
+	temp1 = _mm256_max_epu8( temp1, temp0 );
+	temp2 = _mm256_max_epu8( temp2, temp0 );
+	temp3 = _mm256_max_epu8( temp3, temp0 );
+	temp1 = _mm256_cmpeq_epi8( temp1, temp0 );
+	temp2 = _mm256_cmpeq_epi8( temp2, temp0 );
+	temp3 = _mm256_cmpeq_epi8( temp3, temp0 );
+	temp0 = _mm256_set1_epi8( 4 );
+
+	temp0 = _mm256_adds_epi8( temp0, temp1 );
+	temp2 = _mm256_adds_epi8( temp2, temp3 );
+	temp0 = _mm256_adds_epi8( temp0, temp2 );
+	temp0 = _mm256_and_si256( temp0, _mm256_set1_epi8( 3 ) );
+	temp4 = _mm256_cmpgt_epi8( _mm256_set1_epi8( 2 ), temp0 );
+	temp4 = _mm256_and_si256( temp4, _mm256_set1_epi8( 1 ) );
+
+	temp0 = _mm256_xor_si256( temp0, temp4 );
+	temp4 = _mm256_srli_epi64( temp0,  8 - 2 );
+	temp5 = _mm256_srli_epi64( temp0, 16 - 4 );
+	temp6 = _mm256_srli_epi64( temp0, 24 - 6 );
+	temp7 = _mm256_srli_epi64( temp0, 32 - 8 );
+
+	temp4 = _mm256_and_si256( temp4, _mm256_set1_epi64x( 3 << 2 ) );
+	temp5 = _mm256_and_si256( temp5, _mm256_set1_epi64x( 3 << 4 ) );
+	temp6 = _mm256_and_si256( temp6, _mm256_set1_epi64x( 3 << 6 ) );
+	temp7 = _mm256_and_si256( temp7, _mm256_set1_epi64x( 3 << 8 ) );
+	temp5 = _mm256_or_si256( temp5, temp4 );
+	temp7 = _mm256_or_si256( temp7, temp6 );
+	temp7 = _mm256_or_si256( temp7, temp5 );
+
+	temp4 = _mm256_srli_epi64( temp0, 40 - 10 );
+	temp5 = _mm256_srli_epi64( temp0, 48 - 12 );
+	temp6 = _mm256_srli_epi64( temp0, 56 - 14 );
+
+	temp0 = _mm256_and_si256( temp0, _mm256_set1_epi64x( 3 << 0 ) );
+	temp4 = _mm256_and_si256( temp4, _mm256_set1_epi64x( 3 << 10 ) );
+	temp5 = _mm256_and_si256( temp5, _mm256_set1_epi64x( 3 << 12 ) );
+	temp6 = _mm256_and_si256( temp6, _mm256_set1_epi64x( 3 << 14 ) );
+	temp4 = _mm256_or_si256( temp4, temp5 );
+	temp0 = _mm256_or_si256( temp0, temp6 );
+	temp7 = _mm256_or_si256( temp7, temp4 );
+	temp7 = _mm256_or_si256( temp7, temp0 );
+
+	temp7 = _mm256_shuffle_epi32( temp7, R_SHUFFLE_D( 0, 2, 1, 3 ) );
+	temp7 = _mm256_shufflelo_epi16( temp7, R_SHUFFLE_D( 0, 2, 1, 3 ) );
+
+	return temp7;
+}
+
+/*
+========================
+ScaleYCoCg_AVX2
+========================
+*/
+static DXT_AVX2 ID_INLINE void ScaleYCoCg_AVX2( __m256i* block, __m256i& minColor, __m256i& maxColor )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i center128 = _mm256_setr_epi16( 128, 128, 0, 0, 0, 0, 0, 0, 128, 128, 0, 0, 0, 0, 0, 0 );
+	const __m256i byte1 = _mm256_set1_epi8( 1 );
+	const __m256i minus128 = _mm256_set1_epi32( 0x00008080 );
+	const __m256i scaleMask0 = _mm256_set1_epi32( 0xFFFF0000 );
+	const __m256i scaleMask1 = _mm256_set1_epi32( 0x000000FF );
+	const __m256i scaleMask2 = _mm256_set1_epi32( 0x00010000 );
+	const __m256i scaleMask3 = _mm256_setr_epi32( 0xFF00FFFF, 0, 0xFF00FFFF, 0, 0xFF00FFFF, 0, 0xFF00FFFF, 0 );
+	const __m256i scaleMask4 = _mm256_setr_epi32( 0x00FF0000, 0, 0x00FF0000, 0, 0x00FF0000, 0, 0x00FF0000, 0 );
+	__m256i temp0, temp1, temp2, temp3, temp4, temp5, temp6, temp7;
+
+	temp0 = _mm256_unpacklo_epi8( minColor, zero );
+	temp1 = _mm256_unpacklo_epi8( maxColor, zero );
+
+	temp6 = _mm256_sub_epi16( center128, temp0 );
+	temp7 = _mm256_sub_epi16( center128, temp1 );
+	temp0 = _mm256_sub_epi16( temp0, center128 );
+	temp1 = _mm256_sub_epi16( temp1, center128 );
+	temp6 = _mm256_max_epi16( temp6, temp0 );
+	temp7 = _mm256_max_epi16( temp7, temp1 );
+
+	temp6 = _mm256_max_epi16( temp6, temp7 );
+	temp7 = _mm256_shufflelo_epi16( temp6, R_SHUFFLE_D( 1, 0, 1, 0 ) );
+	temp6 = _mm256_max_epi16( temp6, temp7 );
+	temp6 = _mm256_shuffle_epi32( temp6, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+
+	temp7 = temp6;
+	temp6 = _mm256_cmpgt_epi16( temp6, _mm256_set1_epi16( 63 ) );		// mask0
+	temp7 = _mm256_cmpgt_epi16( temp7, _mm256_set1_epi16( 31 ) );		// mask1
+
+	temp7 = _mm256_andnot_si256( temp7, _mm256_set1_epi8( 2 ) );
+	temp7 = _mm256_or_si256( temp7, byte1 );
+	temp6 = _mm256_andnot_si256( temp6, temp7 );
+	temp3 = temp6;
+	temp7 = temp6;
+	temp7 = _mm256_xor_si256( temp7, _mm256_set1_epi8( -1 ) );
+	temp7 = _mm256_or_si256( temp7, scaleMask0 );
+	temp6 = _mm256_add_epi16( temp6, byte1 );
+	temp6 = _mm256_and_si256( temp6, scaleMask1 );
+	temp6 = _mm256_or_si256( temp6, scaleMask2 );
+
+	temp4 = _mm256_and_si256( minColor, scaleMask3 );
+	temp5 = _mm256_and_si256( maxColor, scaleMask3 );
+
+	temp3 = _mm256_slli_epi32( temp3, 3 );
+	temp3 = _mm256_and_si256( temp3, scaleMask4 );
+
+	temp4 = _mm256_or_si256( temp4, temp3 );
+	temp5 = _mm256_or_si256( temp5, temp3 );
+
+	temp4 = _mm256_add_epi8( temp4, minus128 );
+	temp5 = _mm256_add_epi8( temp5, minus128 );
+
+	temp4 = _mm256_mullo_epi16( temp4, temp6 );
+	temp5 = _mm256_mullo_epi16( temp5, temp6 );
+
+	temp4 = _mm256_and_si256( temp4, temp7 );
+	temp5 = _mm256_and_si256( temp5, temp7 );
+
+	temp4 = _mm256_sub_epi8( temp4, minus128 );
+	temp5 = _mm256_sub_epi8( temp5, minus128 );
+
+	minColor = KeepFirstDword_AVX2( temp4 );
+	maxColor = KeepFirstDword_AVX2( temp5 );
+
+	temp0 = _mm256_add_epi8( block[0], minus128 );
+	temp1 = _mm256_add_epi8( block[1], minus128 );
+	temp2 = _mm256_add_epi8( block[2], minus128 );
+	temp3 = _mm256_add_epi8( block[3], minus128 );
+
+	temp0 = _mm256_mullo_epi16( temp0, temp6 );
+	temp1 = _mm256_mullo_epi16( temp1, temp6 );
+	temp2 = _mm256_mullo_epi16( temp2, temp6 );
+	temp3 = _mm256_mullo_epi16( temp3, temp6 );
+
+	temp0 = _mm256_and_si256( temp0, temp7 );
+	temp1 = _mm256_and_si256( temp1, temp7 );
+	temp2 = _mm256_and_si256( temp2, temp7 );
+	temp3 = _mm256_and_si256( temp3, temp7 );
+
+	block[0] = _mm256_sub_epi8( temp0, minus128 );
+	block[1] = _mm256_sub_epi8( temp1, minus128 );
+	block[2] = _mm256_sub_epi8( temp2, minus128 );
+	block[3] = _mm256_sub_epi8( temp3, minus128 );
+}
+
+/*
+========================
+InsetYCoCgBBox_AVX2
+========================
+*/
+static DXT_AVX2 ID_INLINE void InsetYCoCgBBox_AVX2( __m256i& minColor, __m256i& maxColor )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i insetRound = _mm256_setr_epi16(	( ( 1 << ( INSET_COLOR_SHIFT - 1 ) ) - 1 ), ( ( 1 << ( INSET_COLOR_SHIFT - 1 ) ) - 1 ), ( ( 1 << ( INSET_COLOR_SHIFT - 1 ) ) - 1 ), ( ( 1 << ( INSET_ALPHA_SHIFT - 1 ) ) - 1 ), 0, 0, 0, 0,
+													( ( 1 << ( INSET_COLOR_SHIFT - 1 ) ) - 1 ), ( ( 1 << ( INSET_COLOR_SHIFT - 1 ) ) - 1 ), ( ( 1 << ( INSET_COLOR_SHIFT - 1 ) ) - 1 ), ( ( 1 << ( INSET_ALPHA_SHIFT - 1 ) ) - 1 ), 0, 0, 0, 0 );
+	const __m256i insetMask = _mm256_setr_epi16( -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1 );
+	const __m256i insetShiftUp = _mm256_setr_epi16(	1 << INSET_COLOR_SHIFT, 1 << INSET_COLOR_SHIFT, 1 << INSET_COLOR_SHIFT, 1 << INSET_ALPHA_SHIFT, 0, 0, 0, 0,
+													1 << INSET_COLOR_SHIFT, 1 << INSET_COLOR_SHIFT, 1 << INSET_COLOR_SHIFT, 1 << INSET_ALPHA_SHIFT, 0, 0, 0, 0 );
+	const __m256i insetShiftDown = _mm256_setr_epi16(	1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_ALPHA_SHIFT ), 0, 0, 0, 0,
+														1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_COLOR_SHIFT ), 1 << ( 16 - INSET_ALPHA_SHIFT ), 0, 0, 0, 0 );
+	const __m256i quantMask = _mm256_setr_epi16(	C565_5_MASK, C565_6_MASK, C565_5_MASK, 0xFF, C565_5_MASK, C565_6_MASK, C565_5_MASK, 0xFF,
+													C565_5_MASK, C565_6_MASK, C565_5_MASK, 0xFF, C565_5_MASK, C565_6_MASK, C565_5_MASK, 0xFF );
+	const __m256i rep = _mm256_setr_epi16(	1 << ( 16 - 5 ), 1 << ( 16 - 6 ), 1 << ( 16 - 5 ), 0, 1 << ( 16 - 5 ), 1 << ( 16 - 6 ), 1 << ( 16 - 5 ), 0,
+											1 << ( 16 - 5 ), 1 << ( 16 - 6 ), 1 << ( 16 - 5 ), 0, 1 << ( 16 - 5 ), 1 << ( 16 - 6 ), 1 << ( 16 - 5 ), 0 );
+	__m256i temp0, temp1, temp2, temp3;
+
+	temp0 = _mm256_unpacklo_epi8( minColor, zero );
+	temp1 = _mm256_unpacklo_epi8( maxColor, zero );
+
+	temp2 = _mm256_sub_epi16( temp1, temp0 );
+	temp2 = _mm256_sub_epi16( temp2, insetRound );
+	temp2 = _mm256_and_si256( temp2, insetMask );
+	temp0 = _mm256_mullo_epi16( temp0, insetShiftUp );
+	temp1 = _mm256_mullo_epi16( temp1, insetShiftUp );
+	temp0 = _mm256_add_epi16( temp0, temp2 );
+	temp1 = _mm256_sub_epi16( temp1, temp2 );
+	temp0 = _mm256_mulhi_epi16( temp0, insetShiftDown );
+	temp1 = _mm256_mulhi_epi16( temp1, insetShiftDown );
+	temp0 = _mm256_max_epi16( temp0, zero );
+	temp1 = _mm256_max_epi16( temp1, zero );
+	temp0 = _mm256_and_si256( temp0, quantMask );
+	temp1 = _mm256_and_si256( temp1, quantMask );
+	temp2 = _mm256_mulhi_epi16( temp0, rep );
+	temp3 = _mm256_mulhi_epi16( temp1, rep );
+	temp0 = _mm256_or_si256( temp0, temp2 );
+	temp1 = _mm256_or_si256( temp1, temp3 );
+	temp0 = _mm256_packus_epi16( temp0, temp0 );
+	temp1 = _mm256_packus_epi16( temp1, temp1 );
+
+	minColor = KeepFirstDword_AVX2( temp0 );
+	maxColor = KeepFirstDword_AVX2( temp1 );
+}
+
+/*
+========================
+SelectYCoCgDiagonal_AVX2
+========================
+*/
+static DXT_AVX2 ID_INLINE void SelectYCoCgDiagonal_AVX2( const __m256i* block, __m256i& minColor, __m256i& maxColor )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i wordMask = _mm256_set1_epi32( 0x0000FFFF );
+	const __m256i word1 = _mm256_set1_epi16( 1 );
+	const __m256i diagonalMask = _mm256_setr_epi8(	0x00, ( char )0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+													0x00, ( char )0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 );
+	__m256i temp0, temp1, temp2, temp3, temp6, temp7;
+
+	temp0 = _mm256_and_si256( block[0], wordMask );
+	temp1 = _mm256_and_si256( block[1], wordMask );
+	temp2 = _mm256_and_si256( block[2], wordMask );
+	temp3 = _mm256_and_si256( block[3], wordMask );
+
+	temp1 = _mm256_slli_si256( temp1, 2 );
+	temp3 = _mm256_slli_si256( temp3, 2 );
+	temp0 = _mm256_or_si256( temp0, temp1 );
+	temp2 = _mm256_or_si256( temp2, temp3 );
+
+	temp6 = minColor;
+	temp7 = maxColor;
+
+	temp1 = _mm256_avg_epu8( temp6, temp7 );
+	temp1 = _mm256_shufflelo_epi16( temp1, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+	temp1 = _mm256_shuffle_epi32( temp1, R_SHUFFLE_D( 0, 0, 0, 0 ) );
+
+	temp3 = _mm256_max_epu8( temp1, temp2 );
+	temp1 = _mm256_max_epu8( temp1, temp0 );
+	temp1 = _mm256_cmpeq_epi8( temp1, temp0 );
+	temp3 = _mm256_cmpeq_epi8( temp3, temp2 );
+
+	temp0 = _mm256_srli_si256( temp1, 1 );
+	temp2 = _mm256_srli_si256( temp3, 1 );
+
+	temp0 = _mm256_xor_si256( temp0, temp1 );
+	temp2 = _mm256_xor_si256( temp2, temp3 );
+	temp0 = _mm256_and_si256( temp0, word1 );
+	temp2 = _mm256_and_si256( temp2, word1 );
+
+	temp0 = _mm256_add_epi16( temp0, temp2 );
+	temp0 = _mm256_sad_epu8( temp0, zero );
+	temp1 = _mm256_shuffle_epi32( temp0, R_SHUFFLE_D( 2, 3, 0, 1 ) );
+
+#ifdef NVIDIA_7X_HARDWARE_BUG_FIX
+	temp1 = _mm256_add_epi16( temp1, temp0 );
+	temp1 = _mm256_cmpgt_epi16( temp1, _mm256_set1_epi16( 8 ) );
+	temp1 = _mm256_and_si256( temp1, diagonalMask );
+	temp0 = _mm256_cmpeq_epi8( temp6, temp7 );
+	temp0 = _mm256_slli_si256( temp0, 1 );
+	temp0 = _mm256_andnot_si256( temp0, temp1 );
+#else
+	temp0 = _mm256_add_epi16( temp0, temp1 );
+	temp0 = _mm256_cmpgt_epi16( temp0, _mm256_set1_epi16( 8 ) );
+	temp0 = _mm256_and_si256( temp0, diagonalMask );
+#endif
+
+	temp6 = _mm256_xor_si256( temp6, temp7 );
+	temp0 = _mm256_and_si256( temp0, temp6 );
+	temp7 = _mm256_xor_si256( temp7, temp0 );
+	temp6 = _mm256_xor_si256( temp6, temp7 );
+
+	minColor = KeepFirstDword_AVX2( temp6 );
+	maxColor = KeepFirstDword_AVX2( temp7 );
+}
+
+/*
+========================
+InsetNormalsBBoxDXT5_AVX2
+========================
+*/
+static DXT_AVX2 ID_INLINE void InsetNormalsBBoxDXT5_AVX2( __m256i& minNormal, __m256i& maxNormal )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i insetRound = _mm256_setr_epi16(	0, ( ( 1 << ( INSET_COLOR_SHIFT - 1 ) ) - 1 ), 0, ( ( 1 << ( INSET_ALPHA_SHIFT - 1 ) ) - 1 ), 0, 0, 0, 0,
+													0, ( ( 1 << ( INSET_COLOR_SHIFT - 1 ) ) - 1 ), 0, ( ( 1 << ( INSET_ALPHA_SHIFT - 1 ) ) - 1 ), 0, 0, 0, 0 );
+	const __m256i insetMask = _mm256_setr_epi16( 0, -1, 0, -1, 0, 0, 0, 0, 0, -1, 0, -1, 0, 0, 0, 0 );
+	const __m256i insetShiftUp = _mm256_setr_epi16(	1, 1 << INSET_COLOR_SHIFT, 1, 1 << INSET_ALPHA_SHIFT, 1, 1, 1, 1,
+													1, 1 << INSET_COLOR_SHIFT, 1, 1 << INSET_ALPHA_SHIFT, 1, 1, 1, 1 );
+	const __m256i insetShiftDown = _mm256_setr_epi16(	0, 1 << ( 16 - INSET_COLOR_SHIFT ), 0, 1 << ( 16 - INSET_ALPHA_SHIFT ), 0, 0, 0, 0,
+														0, 1 << ( 16 - INSET_COLOR_SHIFT ), 0, 1 << ( 16 - INSET_ALPHA_SHIFT ), 0, 0, 0, 0 );
+	const __m256i quantMask = _mm256_setr_epi16(	0xFF, C565_6_MASK, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+													0xFF, C565_6_MASK, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF );
+	const __m256i rep = _mm256_setr_epi16( 0, 1 << ( 16 - 6 ), 0, 0, 0, 0, 0, 0, 0, 1 << ( 16 - 6 ), 0, 0, 0, 0, 0, 0 );
+	__m256i temp0, temp1, temp2, temp3;
+
+	temp0 = _mm256_unpacklo_epi8( minNormal, zero );
+	temp1 = _mm256_unpacklo_epi8( maxNormal, zero );
+
+	temp2 = _mm256_sub_epi16( temp1, temp0 );
+	temp2 = _mm256_sub_epi16( temp2, insetRound );
+	temp2 = _mm256_and_si256( temp2, insetMask );		// xmm2 = inset (1 & 3)
+
+	temp0 = _mm256_mullo_epi16( temp0, insetShiftUp );
+	temp1 = _mm256_mullo_epi16( temp1, insetShiftUp );
+	temp0 = _mm256_add_epi16( temp0, temp2 );
+	temp1 = _mm256_sub_epi16( temp1, temp2 );
+	temp0 = _mm256_mulhi_epi16( temp0, insetShiftDown );	// xmm0 = mini
+	temp1 = _mm256_mulhi_epi16( temp1, insetShiftDown );	// xmm1 = maxi
+
+	// mini and maxi must be >= 0 and <= 255
+	temp0 = _mm256_max_epi16( temp0, zero );
+	temp1 = _mm256_max_epi16( temp1, zero );
+	temp0 = _mm256_min_epi16( temp0, _mm256_set1_epi16( 255 ) );
+	temp1 = _mm256_min_epi16( temp1, _mm256_set1_epi16( 255 ) );
+
+	temp0 = _mm256_and_si256( temp0, quantMask );
+	temp1 = _mm256_and_si256( temp1, quantMask );
+	temp2 = _mm256_mulhi_epi16( temp0, rep );
+	temp3 = _mm256_mulhi_epi16( temp1, rep );
+	temp0 = _mm256_or_si256( temp0, temp2 );
+	temp1 = _mm256_or_si256( temp1, temp3 );
+	temp0 = _mm256_packus_epi16( temp0, temp0 );
+	temp1 = _mm256_packus_epi16( temp1, temp1 );
+
+	minNormal = KeepFirstDword_AVX2( temp0 );
+	maxNormal = KeepFirstDword_AVX2( temp1 );
+}
+
+/*
+========================
+idDxtEncoder::CompressImageDXT1Fast_AVX2
+
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+DXT_AVX2 void idDxtEncoder::CompressImageDXT1Fast_AVX2( const byte* inBuf, byte* outBuf, int width, int height )
+{
+	__m256i block[4];
+	__m256i minColor, maxColor;
+	ALIGN16( byte minColors[2][4] );
+	ALIGN16( byte maxColors[2][4] );
+	unsigned int indices[2];
+
+	assert( width >= 4 && ( width & 3 ) == 0 );
+	assert( height >= 4 && ( height & 3 ) == 0 );
+
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+
+	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
+	{
+		ProgressIncrement( width * 4 );
+		for( int i = 0; i < width; i += 8 )
+		{
+			const int numBlocks = ( i + 8 <= width ) ? 2 : 1;
+
+			ExtractBlocks_AVX2( inBuf + i * 4, width, numBlocks, block );
+			GetMinMaxBBox_AVX2( block, minColor, maxColor );
+			InsetColorsBBox_AVX2( minColor, maxColor );
+
+			StoreLanes_AVX2( minColor, ( unsigned int* )minColors );
+			StoreLanes_AVX2( maxColor, ( unsigned int* )maxColors );
+			StoreLanes_AVX2( ColorIndices_AVX2( block, minColor, maxColor ), indices );
+
+			for( int k = 0; k < numBlocks; k++ )
+			{
+				EmitUShort( ColorTo565( maxColors[k] ) );
+				EmitUShort( ColorTo565( minColors[k] ) );
+				EmitUInt( indices[k] );
+			}
+		}
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
+/*
+========================
+idDxtEncoder::CompressImageDXT5Fast_AVX2
+
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+DXT_AVX2 void idDxtEncoder::CompressImageDXT5Fast_AVX2( const byte* inBuf, byte* outBuf, int width, int height )
+{
+	__m256i block[4];
+	__m256i minColor, maxColor;
+	ALIGN16( byte minColors[2][4] );
+	ALIGN16( byte maxColors[2][4] );
+	ALIGN16( unsigned int alphaIndices[8] );
+	unsigned int indices[2];
+
+	assert( width >= 4 && ( width & 3 ) == 0 );
+	assert( height >= 4 && ( height & 3 ) == 0 );
+
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+
+	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
+	{
+		ProgressIncrement( width * 4 );
+		for( int i = 0; i < width; i += 8 )
+		{
+			const int numBlocks = ( i + 8 <= width ) ? 2 : 1;
+
+			ExtractBlocks_AVX2( inBuf + i * 4, width, numBlocks, block );
+			GetMinMaxBBox_AVX2( block, minColor, maxColor );
+			InsetColorsBBox_AVX2( minColor, maxColor );
+
+			StoreLanes_AVX2( minColor, ( unsigned int* )minColors );
+			StoreLanes_AVX2( maxColor, ( unsigned int* )maxColors );
+			_mm256_storeu_si256( ( __m256i* )alphaIndices, AlphaIndices_AVX2( block, 3 * 8, _mm256_srli_epi32( minColor, 24 ), _mm256_srli_epi32( maxColor, 24 ) ) );
+			StoreLanes_AVX2( ColorIndices_AVX2( block, minColor, maxColor ), indices );
+
+			for( int k = 0; k < numBlocks; k++ )
+			{
+				EmitByte( maxColors[k][3] );
+				EmitByte( minColors[k][3] );
+
+				EmitUInt( alphaIndices[k * 4 + 0] );
+				outData--;
+				EmitUInt( alphaIndices[k * 4 + 2] );
+				outData--;
+
+				EmitUShort( ColorTo565( maxColors[k] ) );
+				EmitUShort( ColorTo565( minColors[k] ) );
+
+				EmitUInt( indices[k] );
+			}
+		}
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
+/*
+========================
+idDxtEncoder::CompressYCoCgDXT5Fast_AVX2
+
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+DXT_AVX2 void idDxtEncoder::CompressYCoCgDXT5Fast_AVX2( const byte* inBuf, byte* outBuf, int width, int height )
+{
+	__m256i block[4];
+	__m256i minColor, maxColor;
+	ALIGN16( byte minColors[2][4] );
+	ALIGN16( byte maxColors[2][4] );
+	ALIGN16( unsigned int alphaIndices[8] );
+	unsigned int indices[2];
+
+	assert( width >= 4 && ( width & 3 ) == 0 );
+	assert( height >= 4 && ( height & 3 ) == 0 );
+
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+
+	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
+	{
+		ProgressIncrement( width * 4 );
+		for( int i = 0; i < width; i += 8 )
+		{
+			const int numBlocks = ( i + 8 <= width ) ? 2 : 1;
+
+			ExtractBlocks_AVX2( inBuf + i * 4, width, numBlocks, block );
+			GetMinMaxBBox_AVX2( block, minColor, maxColor );
+
+			ScaleYCoCg_AVX2( block, minColor, maxColor );
+			InsetYCoCgBBox_AVX2( minColor, maxColor );
+			SelectYCoCgDiagonal_AVX2( block, minColor, maxColor );
+
+			StoreLanes_AVX2( minColor, ( unsigned int* )minColors );
+			StoreLanes_AVX2( maxColor, ( unsigned int* )maxColors );
+			_mm256_storeu_si256( ( __m256i* )alphaIndices, AlphaIndices_AVX2( block, 3 * 8, _mm256_srli_epi32( minColor, 24 ), _mm256_srli_epi32( maxColor, 24 ) ) );
+			StoreLanes_AVX2( CoCgIndices_AVX2( block, minColor, maxColor ), indices );
+
+			for( int k = 0; k < numBlocks; k++ )
+			{
+				EmitByte( maxColors[k][3] );
+				EmitByte( minColors[k][3] );
+
+				EmitUInt( alphaIndices[k * 4 + 0] );
+				outData--;
+				EmitUInt( alphaIndices[k * 4 + 2] );
+				outData--;
+
+				EmitUShort( ColorTo565( maxColors[k] ) );
+				EmitUShort( ColorTo565( minColors[k] ) );
+
+				EmitUInt( indices[k] );
+			}
+		}
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
+/*
+========================
+idDxtEncoder::CompressNormalMapDXT5Fast_AVX2
+
+params:	inBuf		- image to compress in _y_x component order
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+========================
+*/
+DXT_AVX2 void idDxtEncoder::CompressNormalMapDXT5Fast_AVX2( const byte* inBuf, byte* outBuf, int width, int height )
+{
+	__m256i block[4];
+	__m256i normal1, normal2;
+	ALIGN16( byte minNormals[2][4] );
+	ALIGN16( byte maxNormals[2][4] );
+	ALIGN16( unsigned int firstPixels[8] );
+	ALIGN16( unsigned int alphaIndices[8] );
+	unsigned int indices[2];
+
+	assert( width >= 4 && ( width & 3 ) == 0 );
+	assert( height >= 4 && ( height & 3 ) == 0 );
+
+	this->width = width;
+	this->height = height;
+	this->outData = outBuf;
+
+	for( int j = 0; j < height; j += 4, inBuf += width * 4 * 4 )
+	{
+		ProgressIncrement( width * 4 );
+		for( int i = 0; i < width; i += 8 )
+		{
+			const int numBlocks = ( i + 8 <= width ) ? 2 : 1;
+
+			ExtractBlocks_AVX2( inBuf + i * 4, width, numBlocks, block );
+			GetMinMaxBBox_AVX2( block, normal1, normal2 );
+			InsetNormalsBBoxDXT5_AVX2( normal1, normal2 );
+
+			_mm256_storeu_si256( ( __m256i* )firstPixels, block[0] );
+			StoreLanes_AVX2( normal1, ( unsigned int* )minNormals );
+			StoreLanes_AVX2( normal2, ( unsigned int* )maxNormals );
+			_mm256_storeu_si256( ( __m256i* )alphaIndices, AlphaIndices_AVX2( block, 3 * 8, _mm256_srli_epi32( normal1, 24 ), _mm256_srli_epi32( normal2, 24 ) ) );
+			StoreLanes_AVX2( GreenIndices_AVX2( block, 1 * 8, _mm256_and_si256( _mm256_srli_epi32( normal1, 8 ), _mm256_set1_epi32( 0xFF ) ), _mm256_and_si256( _mm256_srli_epi32( normal2, 8 ), _mm256_set1_epi32( 0xFF ) ) ), indices );
+
+			for( int k = 0; k < numBlocks; k++ )
+			{
+				const byte* firstPixel = ( const byte* )&firstPixels[k * 4];
+
+				// Write out Nx into alpha channel.
+				EmitByte( maxNormals[k][3] );
+				EmitByte( minNormals[k][3] );
+
+				EmitUInt( alphaIndices[k * 4 + 0] );
+				outData--;
+				EmitUInt( alphaIndices[k * 4 + 2] );
+				outData--;
+
+				// Write out Ny into green channel.
+				EmitUShort( ColorTo565( firstPixel[0], maxNormals[k][1], firstPixel[2] ) );
+				EmitUShort( ColorTo565( firstPixel[0], minNormals[k][1], firstPixel[2] ) );
+				EmitUInt( indices[k] );
+			}
+		}
+		outData += dstPadding;
+		inBuf += srcPadding;
+	}
+}
+
+/*
+========================
+GetSquareAlphaError_AVX2
+
+The SSE2 and generic versions stop as soon as the error reaches the last error, here the full
+error of all 16 pixels is always calculated. The caller only keeps errors below the last error
+so the choice of the end points is the same.
+
+params:	alpha		- the 16 alpha values of the block as words
+return: the squared error
+========================
+*/
+static DXT_AVX2 ID_INLINE int GetSquareAlphaError_AVX2( const __m256i alpha, const byte minAlpha, const byte maxAlpha )
+{
+	byte alphas[8];
+
+	alphas[0] = maxAlpha;
+	alphas[1] = minAlpha;
+
+	if( maxAlpha > minAlpha )
+	{
+		alphas[2] = ( 6 * alphas[0] + 1 * alphas[1] ) / 7;
+		alphas[3] = ( 5 * alphas[0] + 2 * alphas[1] ) / 7;
+		alphas[4] = ( 4 * alphas[0] + 3 * alphas[1] ) / 7;
+		alphas[5] = ( 3 * alphas[0] + 4 * alphas[1] ) / 7;
+		alphas[6] = ( 2 * alphas[0] + 5 * alphas[1] ) / 7;
+		alphas[7] = ( 1 * alphas[0] + 6 * alphas[1] ) / 7;
+	}
+	else
+	{
+		alphas[2] = ( 4 * alphas[0] + 1 * alphas[1] ) / 5;
+		alphas[3] = ( 3 * alphas[0] + 2 * alphas[1] ) / 5;
+		alphas[4] = ( 2 * alphas[0] + 3 * alphas[1] ) / 5;
+		alphas[5] = ( 1 * alphas[0] + 4 * alphas[1] ) / 5;
+		alphas[6] = 0;
+		alphas[7] = 255;
+	}
+
+	// the squared distance of two bytes fits in an unsigned word
+	__m256i minDist = _mm256_set1_epi16( -1 );
+	for( int j = 0; j < 8; j++ )
+	{
+		__m256i dist = _mm256_abs_epi16( _mm256_sub_epi16( alpha, _mm256_set1_epi16( alphas[j] ) ) );
+		minDist = _mm256_min_epu16( minDist, _mm256_mullo_epi16( dist, dist ) );
+	}
+
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i sum = _mm256_add_epi32( _mm256_unpacklo_epi16( minDist, zero ), _mm256_unpackhi_epi16( minDist, zero ) );
+	__m128i sum4 = _mm_add_epi32( _mm256_castsi256_si128( sum ), _mm256_extracti128_si256( sum, 1 ) );
+	sum4 = _mm_add_epi32( sum4, _mm_shuffle_epi32( sum4, R_SHUFFLE_D( 2, 3, 0, 1 ) ) );
+	sum4 = _mm_add_epi32( sum4, _mm_shuffle_epi32( sum4, R_SHUFFLE_D( 1, 0, 3, 2 ) ) );
+	return _mm_cvtsi128_si32( sum4 );
+}
+
+/*
+========================
+idDxtEncoder::GetMinMaxAlphaHQ_AVX2
+
+params:	colorBlock	- 4*4 input tile, 4 bytes per pixel
+paramO:	minColor		- 4 byte min color found
+paramO:	maxColor		- 4 byte max color found
+========================
+*/
+DXT_AVX2 int idDxtEncoder::GetMinMaxAlphaHQ_AVX2( const byte* colorBlock, const int alphaOffset, byte* minColor, byte* maxColor ) const
+{
+	int i, j;
+	byte alphaMin, alphaMax;
+	int error, bestError = MAX_TYPE( int );
+	ALIGN16( short alphaWords[16] );
+
+	alphaMin = 255;
+	alphaMax = 0;
+
+	// get alpha min / max
+	for( i = 0; i < 16; i++ )
+	{
+		if( colorBlock[i * 4 + alphaOffset] < alphaMin )
+		{
+			alphaMin = colorBlock[i * 4 + alphaOffset];
+		}
+		if( colorBlock[i * 4 + alphaOffset] > alphaMax )
+		{
+			alphaMax = colorBlock[i * 4 + alphaOffset];
+		}
+		alphaWords[i] = colorBlock[i * 4 + alphaOffset];
+	}
+
+	const __m256i alpha = _mm256_loadu_si256( ( const __m256i* )alphaWords );
+
+	const int ALPHA_EXPAND = 32;
+
+	alphaMin = ( alphaMin <= ALPHA_EXPAND ) ? 0 : alphaMin - ALPHA_EXPAND;
+	alphaMax = ( alphaMax >= 255 - ALPHA_EXPAND ) ? 255 : alphaMax + ALPHA_EXPAND;
+
+	for( i = alphaMin; i <= alphaMax; i++ )
+	{
+		for( j = alphaMax; j >= i; j-- )
+		{
+
+			error = GetSquareAlphaError_AVX2( alpha, ( byte )i, ( byte )j );
+			if( error < bestError )
+			{
+				bestError = error;
+				minColor[alphaOffset] = ( byte )i;
+				maxColor[alphaOffset] = ( byte )j;
+			}
+
+			error = GetSquareAlphaError_AVX2( alpha, ( byte )j, ( byte )i );
+			if( error < bestError )
+			{
+				bestError = error;
+				minColor[alphaOffset] = ( byte )i;
+				maxColor[alphaOffset] = ( byte )j;
+			}
+		}
+	}
+
+	return bestError;
+}
+
+/*
+========================
+GetSquareNormalYError_AVX2
+
+Same as GetSquareAlphaError_AVX2 the full error is always calculated.
+
+params:	green0		- pixels 0-7 green divided by the scale
+params:	green1		- pixels 8-15 green divided by the scale
+params:	colors		- green of the four colors
+return: the squared error
+========================
+*/
+static DXT_AVX2 ID_INLINE int GetSquareNormalYError_AVX2( const __m256 green0, const __m256 green1, const byte* colors, int scale )
+{
+	__m256i minDist0 = _mm256_set1_epi32( -1 );
+	__m256i minDist1 = _mm256_set1_epi32( -1 );
+	for( int j = 0; j < 4; j++ )
+	{
+		const __m256 s = _mm256_set1_ps( ( float ) colors[j] / scale );
+		const __m256 d0 = _mm256_sub_ps( green0, s );
+		const __m256 d1 = _mm256_sub_ps( green1, s );
+		minDist0 = _mm256_min_epu32( minDist0, _mm256_cvttps_epi32( _mm256_mul_ps( d0, d0 ) ) );
+		minDist1 = _mm256_min_epu32( minDist1, _mm256_cvttps_epi32( _mm256_mul_ps( d1, d1 ) ) );
+	}
+
+	__m256i sum = _mm256_add_epi32( minDist0, minDist1 );
+	__m128i sum4 = _mm_add_epi32( _mm256_castsi256_si128( sum ), _mm256_extracti128_si256( sum, 1 ) );
+	sum4 = _mm_add_epi32( sum4, _mm_shuffle_epi32( sum4, R_SHUFFLE_D( 2, 3, 0, 1 ) ) );
+	sum4 = _mm_add_epi32( sum4, _mm_shuffle_epi32( sum4, R_SHUFFLE_D( 1, 0, 3, 2 ) ) );
+	return _mm_cvtsi128_si32( sum4 );
+}
+
+/*
+========================
+idDxtEncoder::GetMinMaxNormalYHQ_AVX2
+
+params:	colorBlock	- 4*4 input tile, 4 bytes per pixel
+paramO:	minColor	- 4 byte Min color found
+paramO:	maxColor	- 4 byte Max color found
+========================
+*/
+DXT_AVX2 int idDxtEncoder::GetMinMaxNormalYHQ_AVX2( const byte* colorBlock, byte* minColor, byte* maxColor, bool noBlack, int scale ) const
+{
+	unsigned short bestMinColor565, bestMaxColor565;
+	byte bboxMin[3], bboxMax[3];
+	int error, bestError = MAX_TYPE( int );
+	ALIGN16( int greenInts[16] );
+
+	bboxMin[1] = 255;
+	bboxMax[1] = 0;
+
+	// get color bbox
+	for( int i = 0; i < 16; i++ )
+	{
+		if( colorBlock[i * 4 + 1] < bboxMin[1] )
+		{
+			bboxMin[1] = colorBlock[i * 4 + 1];
+		}
+		if( colorBlock[i * 4 + 1] > bboxMax[1] )
+		{
+			bboxMax[1] = colorBlock[i * 4 + 1];
+		}
+		greenInts[i] = colorBlock[i * 4 + 1];
+	}
+
+	const __m256 fscale = _mm256_set1_ps( ( float ) scale );
+	const __m256 green0 = _mm256_div_ps( _mm256_cvtepi32_ps( _mm256_loadu_si256( ( const __m256i* )&greenInts[0] ) ), fscale );
+	const __m256 green1 = _mm256_div_ps( _mm256_cvtepi32_ps( _mm256_loadu_si256( ( const __m256i* )&greenInts[8] ) ), fscale );
+
+	// decrease range for 565 encoding
+	bboxMin[1] >>= 2;
+	bboxMax[1] >>= 2;
+
+	// expand the bounding box
+	const int C565_BBOX_EXPAND = 1;
+
+	bboxMin[1] = ( bboxMin[1] <= C565_BBOX_EXPAND ) ? 0 : bboxMin[1] - C565_BBOX_EXPAND;
+	bboxMax[1] = ( bboxMax[1] >= ( 255 >> 2 ) - C565_BBOX_EXPAND ) ? ( 255 >> 2 ) : bboxMax[1] + C565_BBOX_EXPAND;
+
+	bestMinColor565 = 0;
+	bestMaxColor565 = 0;
+
+	for( int i1 = bboxMin[1]; i1 <= bboxMax[1]; i1++ )
+	{
+		for( int j1 = bboxMax[1]; j1 >= bboxMin[1]; j1-- )
+		{
+			unsigned short minColor565 = ( unsigned short )i1 << 5;
+			unsigned short maxColor565 = ( unsigned short )j1 << 5;
+
+			for( int pass = noBlack ? 1 : 0; pass < 2; pass++ )
+			{
+				unsigned short color0, color1;
+				byte colors[4][4];
+
+				if( pass == 0 )
+				{
+					color0 = maxColor565;
+					color1 = minColor565;
+				}
+				else
+				{
+					if( noBlack && minColor565 <= maxColor565 )
+					{
+						SwapValues( minColor565, maxColor565 );
+					}
+					color0 = minColor565;
+					color1 = maxColor565;
+				}
+
+				ColorFrom565( color0, colors[0] );
+				ColorFrom565( color1, colors[1] );
+
+				byte greens[4];
+				greens[0] = colors[0][1];
+				greens[1] = colors[1][1];
+				if( color0 > color1 )
+				{
+					greens[2] = ( 2 * colors[0][1] + 1 * colors[1][1] ) / 3;
+					greens[3] = ( 1 * colors[0][1] + 2 * colors[1][1] ) / 3;
+				}
+				else
+				{
+					greens[2] = ( 1 * colors[0][1] + 1 * colors[1][1] ) / 2;
+					greens[3] = 0;
+				}
+
+				error = GetSquareNormalYError_AVX2( green0, green1, greens, scale );
+				if( error < bestError )
+				{
+					bestError = error;
+					bestMinColor565 = minColor565;
+					bestMaxColor565 = maxColor565;
+				}
+			}
+		}
+	}
+
+	ColorFrom565( bestMinColor565, minColor );
+	ColorFrom565( bestMaxColor565, maxColor );
+
+	int bias = colorBlock[0 * 4 + 0];
+	int size = colorBlock[0 * 4 + 2];
+
+	minColor[0] = maxColor[0] = ( byte )bias;
+	minColor[2] = maxColor[2] = ( byte )size;
+
+	return bestError;
+}
@@ -566,14 +566,13 @@ idInteraction* idInteraction::AllocAndLink( idRenderEntityLocal* edef, idRenderL
 	}
 	
 	// update the interaction table
-	if( renderWorld->interactionTable != NULL )
+	if( renderWorld->interactionTable.IsInitialized() )
 	{
-		int index = ldef->index * renderWorld->interactionTableWidth + edef->index;
-		if( renderWorld->interactionTable[index] != NULL )
+		if( renderWorld->interactionTable.Find( ldef->index, edef->index ) != NULL )
 		{
 			common->Error( "idInteraction::AllocAndLink: non NULL table entry" );
 		}
-		renderWorld->interactionTable[ index ] = interaction;
+		renderWorld->interactionTable.Set( ldef->index, edef->index, interaction );
 	}
 	
 	return interaction;
@@ -665,14 +664,14 @@ void idInteraction::UnlinkAndFree()
 	// clear the table pointer
 	idRenderWorldLocal* renderWorld = this->lightDef->world;
 	// RB: added check for NULL
-	if( renderWorld->interactionTable != NULL )
+	if( renderWorld->interactionTable.IsInitialized() )
 	{
-		int index = this->lightDef->index * renderWorld->interactionTableWidth + this->entityDef->index;
-		if( renderWorld->interactionTable[index] != this && renderWorld->interactionTable[index] != INTERACTION_EMPTY )
+		const idInteraction* entry = renderWorld->interactionTable.Find( this->lightDef->index, this->entityDef->index );
+		if( entry != this && entry != INTERACTION_EMPTY )
 		{
 			common->Error( "idInteraction::UnlinkAndFree: interactionTable wasn't set" );
 		}
-		renderWorld->interactionTable[index] = NULL;
+		renderWorld->interactionTable.Remove( this->lightDef->index, this->entityDef->index );
 	}
 	// RB end
 	
@@ -692,7 +691,7 @@ Relinks the interaction at the end of both the light and entity chains
 and adds the INTERACTION_EMPTY marker to the interactionTable.
 
 It is necessary to keep the empty interaction so when entities or lights move
-they can set all the interactionTable values to NULL.
+they can remove all their interactionTable entries.
 ===============
 */
 void idInteraction::MakeEmpty()
@@ -729,9 +728,9 @@ void idInteraction::MakeEmpty()
 	}
 	
 	// store the special marker in the interaction table
-	const int interactionIndex = lightDef->index * entityDef->world->interactionTableWidth + entityDef->index;
-	assert( entityDef->world->interactionTable[ interactionIndex ] == this );
-	entityDef->world->interactionTable[ interactionIndex ] = INTERACTION_EMPTY;
+	idInteractionTable& interactionTable = entityDef->world->interactionTable;
+	assert( interactionTable.Find( lightDef->index, entityDef->index ) == this );
+	interactionTable.Set( lightDef->index, entityDef->index, INTERACTION_EMPTY );
 }
 
 /*
@@ -865,6 +864,216 @@ void idInteraction::CreateStaticInteraction()
 	}
 }
 
+/*
+===============================================================================
+
+	idInteractionTable
+
+===============================================================================
+*/
+
+/*
+===============
+idInteractionTable::idInteractionTable
+===============
+*/
+idInteractionTable::idInteractionTable()
+{
+	initialized = false;
+	numInteractions = 0;
+}
+
+/*
+===============
+idInteractionTable::~idInteractionTable
+===============
+*/
+idInteractionTable::~idInteractionTable()
+{
+	Shutdown();
+}
+
+/*
+===============
+idInteractionTable::Init
+
+Any entries already present are dropped.
+===============
+*/
+void idInteractionTable::Init( int numLightDefs )
+{
+	Shutdown();
+	
+	const lightInteractions_t emptySet = { NULL, NULL, 0, 0 };
+	lights.AssureSize( Max( numLightDefs, 1 ), emptySet );
+	initialized = true;
+}
+
+/*
+===============
+idInteractionTable::Shutdown
+===============
+*/
+void idInteractionTable::Shutdown()
+{
+	for( int i = 0; i < lights.Num(); i++ )
+	{
+		Mem_Free( lights[i].interactions );
+	}
+	lights.Clear();
+	numInteractions = 0;
+	initialized = false;
+}
+
+/*
+===============
+idInteractionTable::Rehash
+
+The interaction pointers and entity indexes share one allocation.
+===============
+*/
+void idInteractionTable::Rehash( lightInteractions_t& set, int newSize )
+{
+	idInteraction** oldInteractions = set.interactions;
+	int* oldEntities = set.entities;
+	const int oldSize = set.size;
+	
+	set.interactions = ( idInteraction** )Mem_Alloc( newSize * ( sizeof( idInteraction* ) + sizeof( int ) ), TAG_RENDER_INTERACTION );
+	set.entities = ( int* )( set.interactions + newSize );
+	set.size = newSize;
+	memset( set.entities, -1, newSize * sizeof( int ) );
+	
+	for( int i = 0; i < oldSize; i++ )
+	{
+		if( oldEntities[i] == -1 )
+		{
+			continue;
+		}
+		int slot = Slot( oldEntities[i], newSize );
+		while( set.entities[slot] != -1 )
+		{
+			slot = ( slot + 1 ) & ( newSize - 1 );
+		}
+		set.entities[slot] = oldEntities[i];
+		set.interactions[slot] = oldInteractions[i];
+	}
+	
+	Mem_Free( oldInteractions );
+}
+
+/*
+===============
+idInteractionTable::Set
+===============
+*/
+void idInteractionTable::Set( int lightIndex, int entityIndex, idInteraction* interaction )
+{
+	assert( lightIndex >= 0 && entityIndex >= 0 );
+	
+	if( lightIndex >= lights.Num() )
+	{
+		const lightInteractions_t emptySet = { NULL, NULL, 0, 0 };
+		lights.AssureSize( lightIndex + 1, emptySet );
+	}
+	
+	lightInteractions_t& set = lights[lightIndex];
+	
+	// keep the load factor at or below one half so probes stay short
+	// and there is always a free slot to terminate a miss
+	if( ( set.num + 1 ) * 2 > set.size )
+	{
+		Rehash( set, Max( set.size * 2, ( int )MIN_SET_SIZE ) );
+	}
+	
+	int slot = Slot( entityIndex, set.size );
+	while( set.entities[slot] != -1 )
+	{
+		if( set.entities[slot] == entityIndex )
+		{
+			set.interactions[slot] = interaction;
+			return;
+		}
+		slot = ( slot + 1 ) & ( set.size - 1 );
+	}
+	
+	set.entities[slot] = entityIndex;
+	set.interactions[slot] = interaction;
+	set.num++;
+	numInteractions++;
+}
+
+/*
+===============
+idInteractionTable::Remove
+
+Uses backward shift deletion so lookups never have to skip tombstones.
+===============
+*/
+void idInteractionTable::Remove( int lightIndex, int entityIndex )
+{
+	if( lightIndex < 0 || lightIndex >= lights.Num() )
+	{
+		return;
+	}
+	
+	lightInteractions_t& set = lights[lightIndex];
+	if( set.num == 0 )
+	{
+		return;
+	}
+	
+	const int mask = set.size - 1;
+	int hole = Slot( entityIndex, set.size );
+	while( set.entities[hole] != entityIndex )
+	{
+		if( set.entities[hole] == -1 )
+		{
+			return;
+		}
+		hole = ( hole + 1 ) & mask;
+	}
+	
+	// pull back any entry of the same cluster whose home slot doesn't lie between the hole and itself
+	for( int next = ( hole + 1 ) & mask; set.entities[next] != -1; next = ( next + 1 ) & mask )
+	{
+		const int home = Slot( set.entities[next], set.size );
+		if( ( ( next - home ) & mask ) >= ( ( next - hole ) & mask ) )
+		{
+			set.entities[hole] = set.entities[next];
+			set.interactions[hole] = set.interactions[next];
+			hole = next;
+		}
+	}
+	set.entities[hole] = -1;
+	set.interactions[hole] = NULL;
+	set.num--;
+	numInteractions--;
+	
+	// lights that lost all their interactions give the memory back
+	if( set.num == 0 )
+	{
+		Mem_Free( set.interactions );
+		set.interactions = NULL;
+		set.entities = NULL;
+		set.size = 0;
+	}
+}
+
+/*
+===============
+idInteractionTable::Allocated
+===============
+*/
+size_t idInteractionTable::Allocated() const
+{
+	size_t total = lights.Allocated();
+	for( int i = 0; i < lights.Num(); i++ )
+	{
+		total += lights[i].size * ( sizeof( idInteraction* ) + sizeof( int ) );
+	}
+	return total;
+}
+
 /*
 ===================
 R_ShowInteractionMemory_f
@@ -967,4 +1176,136 @@ void R_ShowInteractionMemory_f( const idCmdArgs& args )
 	common->Printf( "%5i indexes in %5i shadow tris\n", shadowTriIndexes, shadowTris );
 	common->Printf( "%i maxInteractionsForEntity\n", maxInteractionsForEntity );
 	common->Printf( "%i maxInteractionsForLight\n", maxInteractionsForLight );
+	common->Printf( "%i interactionTable entries in %i bytes\n", tr.primaryWorld->interactionTable.Num(), ( int )tr.primaryWorld->interactionTable.Allocated() );
+}
+
+/*
+===================
+R_BenchInteractionTable_f
+
+Compares memory and lookup time of the sparse interaction table against the
+dense lightDefs * entityDefs table it replaced.  The scan test looks up every
+light / entity pair like R_AddSingleLight does for the entities in a light's
+areas, so it is mostly misses; the hit test only looks up existing entries.
+===================
+*/
+void R_BenchInteractionTable_f( const idCmdArgs& args )
+{
+	idRenderWorldLocal* world = tr.primaryWorld;
+	if( world == NULL || !world->interactionTable.IsInitialized() )
+	{
+		common->Printf( "no interaction table, load a map first\n" );
+		return;
+	}
+	
+	const idInteractionTable& table = world->interactionTable;
+	const int numLights = world->lightDefs.Num();
+	const int numEntities = world->entityDefs.Num();
+	const int passes = ( args.Argc() > 1 ) ? Max( atoi( args.Argv( 1 ) ), 1 ) : 10;
+	
+	// the dense table was padded by 1000 in both dimensions so it rarely had to grow
+	const int64_t paddedBytes = ( int64_t )( numEntities + 1000 ) * ( numLights + 1000 ) * sizeof( idInteraction* );
+	const int64_t denseBytes = ( int64_t )numEntities * numLights * sizeof( idInteraction* );
+	
+	common->Printf( "%i lightDefs, %i entityDefs, %i table entries\n", numLights, numEntities, table.Num() );
+	common->Printf( "sparse table: %8i kB\n", ( int )( table.Allocated() >> 10 ) );
+	common->Printf( "dense table:  %8i kB (%i kB unpadded)\n", ( int )( paddedBytes >> 10 ), ( int )( denseBytes >> 10 ) );
+	
+	if( numLights == 0 || numEntities == 0 )
+	{
+		return;
+	}
+	
+	// collect the existing pairs from the light chains
+	idList<int, TAG_RENDER_INTERACTION> hitPairs;
+	hitPairs.SetGranularity( 1024 );
+	for( int l = 0; l < numLights; l++ )
+	{
+		const idRenderLightLocal* ldef = world->lightDefs[l];
+		if( ldef == NULL )
+		{
+			continue;
+		}
+		for( const idInteraction* inter = ldef->firstInteraction; inter != NULL; inter = inter->lightNext )
+		{
+			hitPairs.Append( l );
+			hitPairs.Append( inter->entityDef->index );
+		}
+	}
+	const int numHits = hitPairs.Num() / 2;
+	
+	int found = 0;
+	uint64_t start = Sys_Microseconds();
+	for( int p = 0; p < passes; p++ )
+	{
+		for( int l = 0; l < numLights; l++ )
+		{
+			for( int e = 0; e < numEntities; e++ )
+			{
+				found += ( table.Find( l, e ) != NULL );
+			}
+		}
+	}
+	const uint64_t sparseScan = Sys_Microseconds() - start;
+	
+	start = Sys_Microseconds();
+	for( int p = 0; p < passes; p++ )
+	{
+		for( int i = 0; i < numHits; i++ )
+		{
+			found += ( table.Find( hitPairs[i * 2 + 0], hitPairs[i * 2 + 1] ) != NULL );
+		}
+	}
+	const uint64_t sparseHit = Sys_Microseconds() - start;
+	
+	const int64_t scanLookups = ( int64_t )passes * numLights * numEntities;
+	const int64_t hitLookups = ( int64_t )passes * numHits;
+	
+	common->Printf( "sparse: scan %7.2f ns/lookup, hit %7.2f ns/lookup\n",
+					sparseScan * 1000.0 / scanLookups, ( hitLookups > 0 ) ? sparseHit * 1000.0 / hitLookups : 0.0 );
+					
+	if( denseBytes > 256 * 1024 * 1024 )
+	{
+		common->Printf( "dense table too large to build for comparison\n" );
+		return;
+	}
+	
+	idInteraction** dense = ( idInteraction** )Mem_Alloc( ( size_t )denseBytes, TAG_RENDER_INTERACTION );
+	for( int l = 0; l < numLights; l++ )
+	{
+		for( int e = 0; e < numEntities; e++ )
+		{
+			dense[l * numEntities + e] = table.Find( l, e );
+		}
+	}
+	
+	start = Sys_Microseconds();
+	for( int p = 0; p < passes; p++ )
+	{
+		for( int l = 0; l < numLights; l++ )
+		{
+			idInteraction* const* row = dense + l * numEntities;
+			for( int e = 0; e < numEntities; e++ )
+			{
+				found += ( row[e] != NULL );
+			}
+		}
+	}
+	const uint64_t denseScan = Sys_Microseconds() - start;
+	
+	start = Sys_Microseconds();
+	for( int p = 0; p < passes; p++ )
+	{
+		for( int i = 0; i < numHits; i++ )
+		{
+			found += ( dense[hitPairs[i * 2 + 0] * numEntities + hitPairs[i * 2 + 1]] != NULL );
+		}
+	}
+	const uint64_t denseHit = Sys_Microseconds() - start;
+	
+	Mem_Free( dense );
+	
+	common->Printf( "dense:  scan %7.2f ns/lookup, hit %7.2f ns/lookup\n",
+					denseScan * 1000.0 / scanLookups, ( hitLookups > 0 ) ? denseHit * 1000.0 / hitLookups : 0.0 );
+	common->Printf( "(%i found)\n", found );
 }
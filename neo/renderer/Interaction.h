@@ -152,7 +152,100 @@ private:
 	void					Unlink();
 };
 
+/*
+===============================================================================
+
+	idInteractionTable
+
+	Sparse light / entity interaction lookup. Each lightDef owns a small open
+	addressing hash set keyed by entityDef index, so memory only grows with the
+	number of interactions that actually exist instead of entityDefs * lightDefs,
+	and nothing has to be rebuilt when the def counts grow.
+
+	Only written at map load and when defs are freed by the game thread; the
+	parallel front end jobs only call Find().
+
+===============================================================================
+*/
+
+class idInteractionTable
+{
+public:
+	idInteractionTable();
+	~idInteractionTable();
+
+	void					Init( int numLightDefs );
+	void					Shutdown();
+
+	bool					IsInitialized() const
+	{
+		return initialized;
+	}
+
+	// returns NULL if the pair has no entry, INTERACTION_EMPTY if it was statically found to be empty
+	idInteraction* 			Find( int lightIndex, int entityIndex ) const;
+
+	// adds or replaces the entry for the pair
+	void					Set( int lightIndex, int entityIndex, idInteraction* interaction );
+	void					Remove( int lightIndex, int entityIndex );
+
+	int						Num() const
+	{
+		return numInteractions;
+	}
+
+	// bytes used by the hash sets and the per light headers
+	size_t					Allocated() const;
+
+private:
+	struct lightInteractions_t
+	{
+		idInteraction** 	interactions;
+		int* 				entities;				// -1 for free slots
+		int					size;					// power of two, 0 if nothing was ever added
+		int					num;
+	};
+
+	static const int		MIN_SET_SIZE = 8;
+
+	bool					initialized;
+	int						numInteractions;
+	idList<lightInteractions_t, TAG_RENDER_INTERACTION>	lights;
+
+	static int				Slot( int entityIndex, int size )
+	{
+		return ( int )( ( ( unsigned int )entityIndex * 0x9E3779B1u ) & ( size - 1 ) );
+	}
+
+	void					Rehash( lightInteractions_t& set, int newSize );
+};
+
+ID_INLINE idInteraction* idInteractionTable::Find( int lightIndex, int entityIndex ) const
+{
+	if( lightIndex < 0 || lightIndex >= lights.Num() )
+	{
+		return NULL;
+	}
+	const lightInteractions_t& set = lights[lightIndex];
+	if( set.num == 0 )
+	{
+		return NULL;
+	}
+	for( int slot = Slot( entityIndex, set.size ); ; slot = ( slot + 1 ) & ( set.size - 1 ) )
+	{
+		if( set.entities[slot] == entityIndex )
+		{
+			return set.interactions[slot];
+		}
+		if( set.entities[slot] == -1 )
+		{
+			return NULL;
+		}
+	}
+}
+
 void R_ShowInteractionMemory_f( const idCmdArgs& args );
+void R_BenchInteractionTable_f( const idCmdArgs& args );
 void R_FreeInteractionCullInfo(srfCullInfo_t &cullInfo);
 
 #endif /* !__INTERACTION_H__ */
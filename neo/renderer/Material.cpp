@@ -68,6 +68,7 @@ typedef struct mtrParsingData_s
 	shaderStage_t	parseStages[MAX_SHADER_STAGES];
 	
 	bool			registersAreConstant;
+	bool			registersUseEntityParms;
 	bool			forceOverlays;
 } mtrParsingData_t;
 
@@ -94,6 +95,10 @@ void idMaterial::CommonInit()
 	deform = DFRM_NONE;
 	numOps = 0;
 	ops = NULL;
+	programOps = NULL;
+	numFrameOps = 0;
+	numEntityOps = 0;
+	entityRegisters = false;
 	numRegisters = 0;
 	expressionRegisters = NULL;
 	constantRegisters = NULL;
@@ -204,6 +209,14 @@ void idMaterial::FreeData()
 		R_StaticFree( ops );
 		ops = NULL;
 	}
+	if( programOps != NULL )
+	{
+		R_StaticFree( programOps );
+		programOps = NULL;
+	}
+	numFrameOps = 0;
+	numEntityOps = 0;
+	entityRegisters = false;
 }
 
 /*
@@ -648,61 +661,73 @@ int idMaterial::ParseTerm( idLexer& src )
 	if( !token.Icmp( "parm0" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registersUseEntityParms = true;
 		return EXP_REG_PARM0;
 	}
 	if( !token.Icmp( "parm1" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registersUseEntityParms = true;
 		return EXP_REG_PARM1;
 	}
 	if( !token.Icmp( "parm2" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registersUseEntityParms = true;
 		return EXP_REG_PARM2;
 	}
 	if( !token.Icmp( "parm3" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registersUseEntityParms = true;
 		return EXP_REG_PARM3;
 	}
 	if( !token.Icmp( "parm4" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registersUseEntityParms = true;
 		return EXP_REG_PARM4;
 	}
 	if( !token.Icmp( "parm5" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registersUseEntityParms = true;
 		return EXP_REG_PARM5;
 	}
 	if( !token.Icmp( "parm6" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registersUseEntityParms = true;
 		return EXP_REG_PARM6;
 	}
 	if( !token.Icmp( "parm7" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registersUseEntityParms = true;
 		return EXP_REG_PARM7;
 	}
 	if( !token.Icmp( "parm8" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registersUseEntityParms = true;
 		return EXP_REG_PARM8;
 	}
 	if( !token.Icmp( "parm9" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registersUseEntityParms = true;
 		return EXP_REG_PARM9;
 	}
 	if( !token.Icmp( "parm10" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registersUseEntityParms = true;
 		return EXP_REG_PARM10;
 	}
 	if( !token.Icmp( "parm11" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registersUseEntityParms = true;
 		return EXP_REG_PARM11;
 	}
 	if( !token.Icmp( "global0" ) )
@@ -752,6 +777,7 @@ int idMaterial::ParseTerm( idLexer& src )
 	if( !token.Icmp( "sound" ) )
 	{
 		pd->registersAreConstant = false;
+		pd->registersUseEntityParms = true;
 		return EmitOp( 0, 0, OP_TYPE_SOUND );
 	}
 	
@@ -1830,6 +1856,7 @@ void idMaterial::ParseStage( idLexer& src, const textureRepeat_t trpDefault )
 			ss->color.registers[2] = EXP_REG_PARM2;
 			ss->color.registers[3] = EXP_REG_PARM3;
 			pd->registersAreConstant = false;
+			pd->registersUseEntityParms = true;
 			continue;
 		}
 		
@@ -2286,6 +2313,7 @@ void idMaterial::ParseMaterial( idLexer& src )
 	
 	numStages = 0;
 	pd->registersAreConstant = true;			// until shown otherwise
+	pd->registersUseEntityParms = false;
 	textureRepeat_t	trpDefault = TR_REPEAT;		// allow a global setting for repeat
 	
 	while( 1 )
@@ -2373,6 +2401,13 @@ void idMaterial::ParseMaterial( idLexer& src )
 			SetMaterialFlag( MF_FORCESHADOWS );
 			continue;
 		}
+		// occluder makes every triangle hide what is behind it for software occlusion culling,
+		// nodraw surfaces can be used as simplified occluders
+		else if( !token.Icmp( "occluder" ) )
+		{
+			SetMaterialFlag( MF_OCCLUDER );
+			continue;
+		}
 		// overlay / decal suppression
 		else if( !token.Icmp( "noOverlays" ) )
 		{
@@ -2949,6 +2984,9 @@ bool idMaterial::Parse( const char* text, const int textLength, bool allowBinary
 		memcpy( expressionRegisters, pd->shaderRegisters, numRegisters * sizeof( expressionRegisters[0] ) );
 	}
 	
+	// fold the constant ops and split the rest by what they depend on
+	CompileRegisterProgram();
+	
 	// see if the registers are completely constant, and don't need to be evaluated
 	// per-surface
 	CheckForConstantRegisters();
@@ -2988,7 +3026,8 @@ const char* opNames[] =
 	"OP_TYPE_EQ",
 	"OP_TYPE_NE",
 	"OP_TYPE_AND",
-	"OP_TYPE_OR"
+	"OP_TYPE_OR",
+	"OP_TYPE_SOUND"
 };
 
 void idMaterial::Print() const
@@ -3012,6 +3051,7 @@ void idMaterial::Print() const
 			common->Printf( "%i = %i %s %i\n", op->c, op->a, opNames[ op->opType ], op->b );
 		}
 	}
+	common->Printf( "%i ops folded, %i frame ops, %i entity ops\n", numOps - numFrameOps - numEntityOps, numFrameOps, numEntityOps );
 }
 
 /*
@@ -3046,55 +3086,14 @@ void idMaterial::AddReference()
 
 /*
 ===============
-idMaterial::EvaluateRegisters
-
-Parameters are taken from the localSpace and the renderView,
-then all expressions are evaluated, leaving the material registers
-set to their apropriate values.
+R_EvaluateRegisterOps
 ===============
 */
-void idMaterial::EvaluateRegisters(
-	float* 			registers,
-	const float		localShaderParms[MAX_ENTITY_SHADER_PARMS],
-	const float		globalShaderParms[MAX_GLOBAL_SHADER_PARMS],
-	const float		floatTime,
-	idSoundEmitter* soundEmitter ) const
+static void R_EvaluateRegisterOps( float* registers, const expOp_t* op, const int numOps, idSoundEmitter* soundEmitter )
 {
-
-	int		i, b;
-	expOp_t*	op;
-	
-	// copy the material constants
-	for( i = EXP_REG_NUM_PREDEFINED ; i < numRegisters ; i++ )
-	{
-		registers[i] = expressionRegisters[i];
-	}
-	
-	// copy the local and global parameters
-	registers[EXP_REG_TIME] = floatTime;
-	registers[EXP_REG_PARM0] = localShaderParms[0];
-	registers[EXP_REG_PARM1] = localShaderParms[1];
-	registers[EXP_REG_PARM2] = localShaderParms[2];
-	registers[EXP_REG_PARM3] = localShaderParms[3];
-	registers[EXP_REG_PARM4] = localShaderParms[4];
-	registers[EXP_REG_PARM5] = localShaderParms[5];
-	registers[EXP_REG_PARM6] = localShaderParms[6];
-	registers[EXP_REG_PARM7] = localShaderParms[7];
-	registers[EXP_REG_PARM8] = localShaderParms[8];
-	registers[EXP_REG_PARM9] = localShaderParms[9];
-	registers[EXP_REG_PARM10] = localShaderParms[10];
-	registers[EXP_REG_PARM11] = localShaderParms[11];
-	registers[EXP_REG_GLOBAL0] = globalShaderParms[0];
-	registers[EXP_REG_GLOBAL1] = globalShaderParms[1];
-	registers[EXP_REG_GLOBAL2] = globalShaderParms[2];
-	registers[EXP_REG_GLOBAL3] = globalShaderParms[3];
-	registers[EXP_REG_GLOBAL4] = globalShaderParms[4];
-	registers[EXP_REG_GLOBAL5] = globalShaderParms[5];
-	registers[EXP_REG_GLOBAL6] = globalShaderParms[6];
-	registers[EXP_REG_GLOBAL7] = globalShaderParms[7];
+	int		b;
 	
-	op = ops;
-	for( i = 0 ; i < numOps ; i++, op++ )
+	for( int i = 0 ; i < numOps ; i++, op++ )
 	{
 		switch( op->opType )
 		{
@@ -3169,7 +3168,169 @@ void idMaterial::EvaluateRegisters(
 				common->FatalError( "R_EvaluateExpression: bad opcode" );
 		}
 	}
+}
+
+/*
+===============
+idMaterial::CompileRegisterProgram
+
+EmitOp only folds additions and multiplications of two constants while parsing,
+this folds every other op whose inputs are all constant by evaluating it once and
+storing the result as a constant register.  Table lookups are never folded, they
+go through the table decl every time so a reloaded table is picked up.  The remaining
+ops are split into the ones that only depend on time and the globalParms, and the
+ones that read entityParms or a sound amplitude.  Every op writes a new temporary,
+so moving the entity ops after all the frame ops doesn't change the results.
+===============
+*/
+void idMaterial::CompileRegisterProgram()
+{
+	static const byte REG_DEPENDS_FRAME = BIT( 0 );
+	static const byte REG_DEPENDS_ENTITY = BIT( 1 );
+	
+	entityRegisters = pd->registersUseEntityParms;
+	numFrameOps = 0;
+	numEntityOps = 0;
+	
+	if( numOps == 0 )
+	{
+		return;
+	}
+	
+	byte dependencies[MAX_EXPRESSION_REGISTERS];
+	memset( dependencies, 0, numRegisters * sizeof( dependencies[0] ) );
+	dependencies[EXP_REG_TIME] = REG_DEPENDS_FRAME;
+	for( int i = EXP_REG_PARM0; i <= EXP_REG_PARM11; i++ )
+	{
+		dependencies[i] = REG_DEPENDS_ENTITY;
+	}
+	for( int i = EXP_REG_GLOBAL0; i <= EXP_REG_GLOBAL7; i++ )
+	{
+		dependencies[i] = REG_DEPENDS_FRAME;
+	}
+	
+	// the folded temporaries are written straight into expressionRegisters,
+	// which get copied in as constants by EvaluateFrameRegisters
+	expOp_t* frameOps = ( expOp_t* )_alloca( numOps * sizeof( expOp_t ) );
+	expOp_t* entityOps = ( expOp_t* )_alloca( numOps * sizeof( expOp_t ) );
+	for( int i = 0; i < numOps; i++ )
+	{
+		const expOp_t& op = ops[i];
+		
+		byte dependency;
+		switch( op.opType )
+		{
+			case OP_TYPE_TABLE:
+			case OP_TYPE_TABLE2D:
+				// a table lookup with a constant index is evaluated with the frame ops
+				dependency = dependencies[op.b] | REG_DEPENDS_FRAME;
+				break;
+			case OP_TYPE_SOUND:
+				dependency = REG_DEPENDS_ENTITY;
+				break;
+			default:
+				dependency = dependencies[op.a] | dependencies[op.b];
+				break;
+		}
+		dependencies[op.c] = dependency;
+		
+		if( dependency == 0 )
+		{
+			R_EvaluateRegisterOps( expressionRegisters, &op, 1, NULL );
+		}
+		else if( dependency == REG_DEPENDS_FRAME )
+		{
+			frameOps[numFrameOps++] = op;
+		}
+		else
+		{
+			entityOps[numEntityOps++] = op;
+		}
+	}
+	
+	if( numFrameOps + numEntityOps == 0 )
+	{
+		return;
+	}
+	
+	programOps = ( expOp_t* )R_StaticAlloc( ( numFrameOps + numEntityOps ) * sizeof( programOps[0] ), TAG_MATERIAL );
+	memcpy( programOps, frameOps, numFrameOps * sizeof( programOps[0] ) );
+	memcpy( programOps + numFrameOps, entityOps, numEntityOps * sizeof( programOps[0] ) );
+}
+
+/*
+===============
+idMaterial::EvaluateRegisters
+
+Parameters are taken from the localSpace and the renderView,
+then all expressions are evaluated, leaving the material registers
+set to their apropriate values.
+===============
+*/
+void idMaterial::EvaluateRegisters(
+	float* 			registers,
+	const float		localShaderParms[MAX_ENTITY_SHADER_PARMS],
+	const float		globalShaderParms[MAX_GLOBAL_SHADER_PARMS],
+	const float		floatTime,
+	idSoundEmitter* soundEmitter ) const
+{
+	EvaluateFrameRegisters( registers, globalShaderParms, floatTime );
+	EvaluateEntityRegisters( registers, localShaderParms, soundEmitter );
+}
+
+/*
+===============
+idMaterial::EvaluateFrameRegisters
+===============
+*/
+void idMaterial::EvaluateFrameRegisters(
+	float* 			registers,
+	const float		globalShaderParms[MAX_GLOBAL_SHADER_PARMS],
+	const float		floatTime ) const
+{
+	// copy the material constants
+	memcpy( registers + EXP_REG_NUM_PREDEFINED, expressionRegisters + EXP_REG_NUM_PREDEFINED, ( numRegisters - EXP_REG_NUM_PREDEFINED ) * sizeof( float ) );
+	
+	// copy the global parameters, the local ones are only valid after EvaluateEntityRegisters
+	registers[EXP_REG_TIME] = floatTime;
+	memset( &registers[EXP_REG_PARM0], 0, ( EXP_REG_PARM11 - EXP_REG_PARM0 + 1 ) * sizeof( float ) );
+	registers[EXP_REG_GLOBAL0] = globalShaderParms[0];
+	registers[EXP_REG_GLOBAL1] = globalShaderParms[1];
+	registers[EXP_REG_GLOBAL2] = globalShaderParms[2];
+	registers[EXP_REG_GLOBAL3] = globalShaderParms[3];
+	registers[EXP_REG_GLOBAL4] = globalShaderParms[4];
+	registers[EXP_REG_GLOBAL5] = globalShaderParms[5];
+	registers[EXP_REG_GLOBAL6] = globalShaderParms[6];
+	registers[EXP_REG_GLOBAL7] = globalShaderParms[7];
+	
+	R_EvaluateRegisterOps( registers, programOps, numFrameOps, NULL );
+}
+
+/*
+===============
+idMaterial::EvaluateEntityRegisters
+===============
+*/
+void idMaterial::EvaluateEntityRegisters(
+	float* 			registers,
+	const float		localShaderParms[MAX_ENTITY_SHADER_PARMS],
+	idSoundEmitter* soundEmitter ) const
+{
+	// copy the local parameters
+	registers[EXP_REG_PARM0] = localShaderParms[0];
+	registers[EXP_REG_PARM1] = localShaderParms[1];
+	registers[EXP_REG_PARM2] = localShaderParms[2];
+	registers[EXP_REG_PARM3] = localShaderParms[3];
+	registers[EXP_REG_PARM4] = localShaderParms[4];
+	registers[EXP_REG_PARM5] = localShaderParms[5];
+	registers[EXP_REG_PARM6] = localShaderParms[6];
+	registers[EXP_REG_PARM7] = localShaderParms[7];
+	registers[EXP_REG_PARM8] = localShaderParms[8];
+	registers[EXP_REG_PARM9] = localShaderParms[9];
+	registers[EXP_REG_PARM10] = localShaderParms[10];
+	registers[EXP_REG_PARM11] = localShaderParms[11];
 	
+	R_EvaluateRegisterOps( registers, programOps + numFrameOps, numEntityOps, soundEmitter );
 }
 
 /*
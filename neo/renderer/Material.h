@@ -300,7 +300,8 @@ typedef enum
 	MF_LOD2						= BIT( 8 ),	 // motorsep 11-24-2014; material flag for LOD2 iteration
 	MF_LOD3						= BIT( 9 ),	 // motorsep 11-24-2014; material flag for LOD3 iteration
 	MF_LOD4						= BIT( 10 ), // motorsep 11-24-2014; material flag for LOD4 iteration
-	MF_LOD_PERSISTENT			= BIT( 11 )	 // motorsep 11-24-2014; material flag for persistent LOD iteration
+	MF_LOD_PERSISTENT			= BIT( 11 ),	 // motorsep 11-24-2014; material flag for persistent LOD iteration
+	MF_OCCLUDER					= BIT( 12 )	 // always used for software occlusion culling, even when not drawn
 } materialFlags_t;
 
 // contents flags, NOTE: make sure to keep the defines in doom_defs.script up to date with these!
@@ -791,6 +792,25 @@ public:
 		const float		floatTime,
 		idSoundEmitter* soundEmitter ) const;
 		
+	// EvaluateRegisters split in two: the first part copies the constants and runs the ops that
+	// only depend on time and the globalParms, so the result can be shared by all the surfaces
+	// of a view, the second part is run on a copy of it for the ops that read entityParms or sound
+	void				EvaluateFrameRegisters(
+		float* 			registers,
+		const float		globalShaderParms[MAX_GLOBAL_SHADER_PARMS],
+		const float		floatTime ) const;
+	void				EvaluateEntityRegisters(
+		float* 			registers,
+		const float		localShaderParms[MAX_ENTITY_SHADER_PARMS],
+		idSoundEmitter* soundEmitter ) const;
+		
+	// if false, EvaluateFrameRegisters gives the final register values
+	bool				RegistersDependOnEntity() const
+	{
+		return entityRegisters;
+	}
+	
+
 	// if a material only uses constants (no entityParm or globalparm references), this
 	// will return a pointer to an internal table, and EvaluateRegisters will not need
 	// to be called.  If NULL is returned, EvaluateRegisters must be used.
@@ -854,6 +874,7 @@ private:
 	void				MultiplyTextureMatrix( textureStage_t* ts, int registers[2][3] );	// FIXME: for some reason the const is bad for gcc and Mac
 	void				SortInteractionStages();
 	void				AddImplicitStages( const textureRepeat_t trpDefault = TR_REPEAT );
+	void				CompileRegisterProgram();
 	void				CheckForConstantRegisters();
 	void				SetFastPathImages();
 	
@@ -907,6 +928,13 @@ private:
 	int					numOps;
 	expOp_t* 			ops;				// evaluate to make expressionRegisters
 	
+	// ops with only constant inputs are folded into expressionRegisters at parse time,
+	// the rest are split by what they depend on, frame ops first
+	expOp_t* 			programOps;
+	int					numFrameOps;		// time and globalParms
+	int					numEntityOps;		// entityParms and sound
+	bool				entityRegisters;	// true if any register reads entityParms or sound
+	
 	int					numRegisters;																			//
 	float* 				expressionRegisters;
 	
@@ -217,6 +217,7 @@ static struct OpenGL
 {
     SDL_Window*     window = nullptr;
     SDL_GLContext   context = nullptr;
+    bool            nullDriver = false;
 }context;
 
 static bool QGL_Init( const char* dllname );
@@ -256,6 +257,25 @@ bool GLimp_Init( const bool in_stereo, const uint8_t in_multiSamples )
     context.window = static_cast<SDL_Window*>( sys->GetVideoSystem()->WindowHandler() );
 	assert( context.window != nullptr );
 
+	// no context at all, the renderer runs against the null driver
+	if( idStr::Icmp( r_glDriver.GetString(), "null" ) == 0 )
+	{
+		common->Printf( "Using the null GL driver, nothing will be drawn\n" );
+		
+		SDL_GetWindowSize( context.window, &glConfig.nativeScreenWidth, &glConfig.nativeScreenHeight );
+		glConfig.isFullscreen = false;
+		glConfig.colorBits = 24;
+		glConfig.depthBits = 24;
+		glConfig.stencilBits = 8;
+		glConfig.isStereoPixelFormat = false;
+		glConfig.multisamples = in_multiSamples;
+		glConfig.pixelAspect = 1.0f;
+		
+		context.nullDriver = true;
+		QGL_Init( "null" );
+		return true;
+	}
+
 	int colorbits = 24;
 	int depthbits = 24;
 	int stencilbits = 8;
@@ -424,6 +444,12 @@ GLimp_Shutdown
 */
 void GLimp_Shutdown( void )
 {
+	if( context.nullDriver )
+	{
+		QGL_Shutdown();
+		context.nullDriver = false;
+	}
+
 	if ( !context.context )
 		return;
 
@@ -457,6 +483,12 @@ GLimp_SwapBuffers
 */
 void GLimp_SwapBuffers( void )
 {
+	if( context.nullDriver )
+	{
+		QGL_NullDriverEndFrame();
+		return;
+	}
+
     if( r_swapInterval.IsModified() )
 	{
 		r_swapInterval.ClearModified();
@@ -485,10 +517,13 @@ void GLimp_SetGamma( unsigned short red[256], unsigned short green[256], unsigne
 {
 }
 
-#define GET_GL_PROC( T, P ) P = reinterpret_cast<T>( SDL_GL_GetProcAddress( #P ) )
+// the null driver points every entry point at a function that does nothing, see gl_null.cpp
+#define GET_GL_PROC( T, P ) P = ( nullDriver ? &idNullGLProc<T>::Proc : reinterpret_cast<T>( SDL_GL_GetProcAddress( #P ) ) )
 
 bool QGL_Init( const char* dllname )
 {
+	const bool nullDriver = ( idStr::Icmp( dllname, "null" ) == 0 );
+	
 	GET_GL_PROC( PFNGLGETERRORPROC, glGetError );
 	GET_GL_PROC( PFNGLGETINTEGERVPROC, glGetIntegerv );
 	GET_GL_PROC( PFNGLGETFLOATVPROC, glGetFloatv );
@@ -667,33 +702,39 @@ bool QGL_Init( const char* dllname )
 	GET_GL_PROC( PFNGLDEBUGMESSAGECALLBACKPROC, glDebugMessageCallback );
 	GET_GL_PROC( PFNGLGETDEBUGMESSAGELOGPROC, glGetDebugMessageLog );
 
-	glRasterPos2f = (decltype(glRasterPos2f))SDL_GL_GetProcAddress( "glRasterPos2f" );
-
-	glOrtho = ( decltype( glOrtho ) )SDL_GL_GetProcAddress( "glOrtho" );
-	glBegin = ( decltype( glBegin ) )SDL_GL_GetProcAddress( "glBegin" );
-	glDrawPixels = ( decltype( glDrawPixels ) )SDL_GL_GetProcAddress( "glDrawPixels" );
-	glEnd = ( decltype( glEnd ) )SDL_GL_GetProcAddress( "glEnd" );
-	glVertex3f = ( decltype( glVertex3f ) )SDL_GL_GetProcAddress( "glVertex3f" );
-	glVertex3fv = ( decltype( glVertex3fv ) )SDL_GL_GetProcAddress( "glVertex3fv" );
-	glColor4fv = ( decltype( glColor4fv ) )SDL_GL_GetProcAddress( "glColor4fv" );
-	glColor4ubv = ( decltype( glColor4ubv ) )SDL_GL_GetProcAddress( "glColor4ubv" );
-	glColor3f = ( decltype( glColor3f ) )SDL_GL_GetProcAddress( "glColor3f" );
-	glColor3fv = ( decltype( glColor3fv ) )SDL_GL_GetProcAddress( "glColor3fv" );
-	glColor4f = ( decltype( glColor4f ) )SDL_GL_GetProcAddress( "glColor4f" );
-	glLoadIdentity = ( decltype( glLoadIdentity ) )SDL_GL_GetProcAddress( "glLoadIdentity" );
-	glPushMatrix = ( decltype( glPushMatrix ) )SDL_GL_GetProcAddress( "glPushMatrix" );
-	glPopMatrix = ( decltype( glPopMatrix ) )SDL_GL_GetProcAddress( "glPopMatrix" );
-	glMatrixMode = ( decltype( glMatrixMode ) )SDL_GL_GetProcAddress( "glMatrixMode" );
-	glLoadMatrixf = ( decltype( glLoadMatrixf ) )SDL_GL_GetProcAddress( "glLoadMatrixf" );
-	glPushAttrib = ( decltype( glPushAttrib ) )SDL_GL_GetProcAddress( "glPushAttrib" );
-	glPopAttrib = ( decltype( glPopAttrib ) )SDL_GL_GetProcAddress( "glPopAttrib" );
-	glArrayElement = ( decltype( glArrayElement ) )SDL_GL_GetProcAddress( "glArrayElement" );
+	GET_GL_PROC( decltype( glRasterPos2f ), glRasterPos2f );
+
+	GET_GL_PROC( decltype( glOrtho ), glOrtho );
+	GET_GL_PROC( decltype( glBegin ), glBegin );
+	GET_GL_PROC( decltype( glDrawPixels ), glDrawPixels );
+	GET_GL_PROC( decltype( glEnd ), glEnd );
+	GET_GL_PROC( decltype( glVertex3f ), glVertex3f );
+	GET_GL_PROC( decltype( glVertex3fv ), glVertex3fv );
+	GET_GL_PROC( decltype( glColor4fv ), glColor4fv );
+	GET_GL_PROC( decltype( glColor4ubv ), glColor4ubv );
+	GET_GL_PROC( decltype( glColor3f ), glColor3f );
+	GET_GL_PROC( decltype( glColor3fv ), glColor3fv );
+	GET_GL_PROC( decltype( glColor4f ), glColor4f );
+	GET_GL_PROC( decltype( glLoadIdentity ), glLoadIdentity );
+	GET_GL_PROC( decltype( glPushMatrix ), glPushMatrix );
+	GET_GL_PROC( decltype( glPopMatrix ), glPopMatrix );
+	GET_GL_PROC( decltype( glMatrixMode ), glMatrixMode );
+	GET_GL_PROC( decltype( glLoadMatrixf ), glLoadMatrixf );
+	GET_GL_PROC( decltype( glPushAttrib ), glPushAttrib );
+	GET_GL_PROC( decltype( glPopAttrib ), glPopAttrib );
+	GET_GL_PROC( decltype( glArrayElement ), glArrayElement );
+
+	if( nullDriver )
+	{
+		QGL_InitNullDriver();
+	}
 
 	return true;
 }
 
 void QGL_Shutdown( void )
 {
+	QGL_ShutdownNullDriver();
 }
 
 void APIENTRY DebugOutputCall( GLenum in_source, GLenum in_type, GLuint in_id, GLenum in_severity, GLsizei in_length, const GLchar *in_message, const void *in_userParam )
@@ -223,6 +223,23 @@ extern void ( APIENTRYP glPushAttrib )(GLbitfield mask);
 extern void ( APIENTRYP glPopAttrib )(void);
 extern void ( APIENTRYP glArrayElement )(GLint i);
 
+// null driver, r_glDriver "null"
+// every entry point gets a function with the same signature that returns zero,
+// the ones the renderer depends on are replaced in QGL_InitNullDriver
+template< typename T > struct idNullGLProc;
+template< typename R, typename... Args > struct idNullGLProc< R ( APIENTRY* )( Args... ) >
+{
+	static R APIENTRY Proc( Args... )
+	{
+		return R();
+	}
+};
+
+void QGL_InitNullDriver( void );
+void QGL_ShutdownNullDriver( void );
+// counts the frame, called in place of swapping buffers
+void QGL_NullDriverEndFrame( void );
+
 // DG: R_GetModeListForDisplay is called before GLimp_Init(), but SDL needs SDL_Init() first.
 // So add PreInit for platforms that need it, others can just stub it.
 void GLimp_PreInit( void );
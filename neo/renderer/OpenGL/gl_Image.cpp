@@ -616,6 +616,8 @@ void idImage::PurgeImage()
 		if ( glDeleteTextures )
 			glDeleteTextures( 1, ( GLuint* )&texnum );	// this should be the ONLY place it is ever called!
 		texnum = TEXTURE_NOT_LOADED;
+		globalImages->SetResidency( this, IMAGE_NOT_RESIDENT );
+		residentMip = 0;
 	}
 	// clear all the current binding caches, so the next bind will do a real one
 	for( int i = 0 ; i < MAX_MULTITEXTURE_UNITS ; i++ )
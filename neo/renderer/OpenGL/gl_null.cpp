@@ -0,0 +1,820 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#pragma hdrstop
+
+#include "precompiled.h"
+#include "OpenGL.h"
+
+#include "../tr_local.h"
+
+/*
+================================================================================================
+
+	Null OpenGL driver
+
+	Selected with r_glDriver "null". Every GL entry point goes to a function that does
+	no rendering, so the game, the frontend and the backend command processing can be run
+	and profiled on machines without a GPU or a display. Everything that isn't listed here
+	gets a generic function that returns zero.
+
+	The driver answers the queries the renderer makes during init, hands out object
+	names, keeps a CPU copy of buffer objects so they can be mapped, and counts the draw
+	calls, state changes and bytes that would have been sent to the GPU.
+
+================================================================================================
+*/
+
+idCVar r_showNullDriver( "r_showNullDriver", "0", CVAR_RENDERER | CVAR_BOOL, "print the draw calls, state changes and uploads of every frame when r_glDriver is \"null\"" );
+
+struct nullDriverStats_t
+{
+	int				frames;
+	int				draws;
+	int64_t			indices;
+	int				stateChanges;
+	int				programBinds;
+	int				textureBinds;
+	int				bufferBinds;
+	int				framebufferBinds;
+	int64_t			bufferBytes;
+	int64_t			textureBytes;
+	int64_t			uniformBytes;
+};
+
+struct nullBuffer_t
+{
+	byte* 			data;
+	int				size;
+};
+
+struct nullBufferBinding_t
+{
+	GLenum			target;
+	GLuint			buffer;
+};
+
+static const int MAX_NULL_BUFFER_BINDINGS = 16;
+
+static struct nullDriver_t
+{
+	nullDriverStats_t		frame;
+	nullDriverStats_t		total;
+	
+	GLuint					nextName;
+	idList<nullBuffer_t>	buffers;		// indexed by buffer name
+	nullBufferBinding_t		bindings[MAX_NULL_BUFFER_BINDINGS];
+	int						numBindings;
+} nullDriver;
+
+static const char* nullExtensions[] =
+{
+	"GL_ARB_multitexture",
+	"GL_ARB_texture_compression",
+	"GL_EXT_texture_compression_s3tc",
+	"GL_EXT_texture_filter_anisotropic",
+	"GL_ARB_vertex_buffer_object",
+	"GL_ARB_map_buffer_range",
+	"GL_ARB_vertex_array_object",
+	"GL_ARB_draw_elements_base_vertex",
+	"GL_ARB_framebuffer_object",
+	"GL_ARB_texture_float",
+	"GL_ARB_uniform_buffer_object",
+	"GL_ARB_seamless_cube_map",
+	"GL_ARB_sync",
+	"GL_ARB_occlusion_query",
+	"GL_ARB_timer_query",
+};
+
+/*
+========================
+NullGL_GenNames
+========================
+*/
+static void NullGL_GenNames( GLsizei n, GLuint* names )
+{
+	for( GLsizei i = 0; i < n; i++ )
+	{
+		names[i] = ++nullDriver.nextName;
+	}
+}
+
+/*
+========================
+NullGL_BoundBuffer
+========================
+*/
+static nullBuffer_t* NullGL_BoundBuffer( GLenum target )
+{
+	for( int i = 0; i < nullDriver.numBindings; i++ )
+	{
+		if( nullDriver.bindings[i].target == target )
+		{
+			const GLuint buffer = nullDriver.bindings[i].buffer;
+			if( buffer == 0 || ( int )buffer >= nullDriver.buffers.Num() )
+			{
+				return NULL;
+			}
+			return &nullDriver.buffers[buffer];
+		}
+	}
+	return NULL;
+}
+
+/*
+========================
+NullGL_BindBuffer
+========================
+*/
+static void NullGL_BindBuffer( GLenum target, GLuint buffer )
+{
+	nullDriver.frame.bufferBinds++;
+	
+	if( ( int )buffer >= nullDriver.buffers.Num() )
+	{
+		const int oldNum = nullDriver.buffers.Num();
+		nullDriver.buffers.SetNum( buffer + 1 );
+		for( int i = oldNum; i < nullDriver.buffers.Num(); i++ )
+		{
+			nullDriver.buffers[i].data = NULL;
+			nullDriver.buffers[i].size = 0;
+		}
+	}
+	
+	for( int i = 0; i < nullDriver.numBindings; i++ )
+	{
+		if( nullDriver.bindings[i].target == target )
+		{
+			nullDriver.bindings[i].buffer = buffer;
+			return;
+		}
+	}
+	if( nullDriver.numBindings < MAX_NULL_BUFFER_BINDINGS )
+	{
+		nullDriver.bindings[nullDriver.numBindings].target = target;
+		nullDriver.bindings[nullDriver.numBindings].buffer = buffer;
+		nullDriver.numBindings++;
+	}
+}
+
+/*
+========================
+NullGL_PixelBytes
+
+Approximate size of uncompressed texture data.
+========================
+*/
+static int64_t NullGL_PixelBytes( GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type )
+{
+	int components = 4;
+	switch( format )
+	{
+		case GL_RED:
+		case GL_DEPTH_COMPONENT:
+			components = 1;
+			break;
+		case GL_RG:
+		case GL_DEPTH_STENCIL:
+			components = 2;
+			break;
+		case GL_RGB:
+		case GL_BGR:
+			components = 3;
+			break;
+	}
+	
+	int componentSize = 1;
+	switch( type )
+	{
+		case GL_SHORT:
+		case GL_UNSIGNED_SHORT:
+		case GL_HALF_FLOAT:
+			componentSize = 2;
+			break;
+		case GL_INT:
+		case GL_UNSIGNED_INT:
+		case GL_FLOAT:
+			componentSize = 4;
+			break;
+		case GL_UNSIGNED_SHORT_5_6_5:
+		case GL_UNSIGNED_SHORT_4_4_4_4:
+		case GL_UNSIGNED_SHORT_5_5_5_1:
+			components = 1;
+			componentSize = 2;
+			break;
+		case GL_UNSIGNED_INT_24_8:
+		case GL_UNSIGNED_INT_8_8_8_8:
+		case GL_UNSIGNED_INT_8_8_8_8_REV:
+			components = 1;
+			componentSize = 4;
+			break;
+	}
+	return ( int64_t )width * height * depth * components * componentSize;
+}
+
+/*
+================================================================================================
+
+	Queries
+
+================================================================================================
+*/
+
+static GLenum APIENTRY NullGL_GetError()
+{
+	return GL_NO_ERROR;
+}
+
+static void APIENTRY NullGL_GetIntegerv( GLenum pname, GLint* data )
+{
+	switch( pname )
+	{
+		case GL_NUM_EXTENSIONS:
+			*data = sizeof( nullExtensions ) / sizeof( nullExtensions[0] );
+			break;
+		case GL_MAX_TEXTURE_SIZE:
+			*data = 16384;
+			break;
+		case GL_MAX_TEXTURE_IMAGE_UNITS:
+			*data = 16;
+			break;
+		case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:
+			*data = 256;
+			break;
+		default:
+			*data = 0;
+			break;
+	}
+}
+
+static void APIENTRY NullGL_GetFloatv( GLenum pname, GLfloat* data )
+{
+	*data = ( pname == GL_MAX_TEXTURE_MAX_ANISOTROPY ) ? 16.0f : 0.0f;
+}
+
+static const GLubyte* APIENTRY NullGL_GetString( GLenum name )
+{
+	switch( name )
+	{
+		case GL_VENDOR:
+			return ( const GLubyte* )"crEngine";
+		case GL_RENDERER:
+			return ( const GLubyte* )"null driver";
+		case GL_VERSION:
+			return ( const GLubyte* )"3.2 null";
+		case GL_SHADING_LANGUAGE_VERSION:
+			return ( const GLubyte* )"1.50 null";
+	}
+	return ( const GLubyte* )"";
+}
+
+static const GLubyte* APIENTRY NullGL_GetStringi( GLenum name, GLuint index )
+{
+	if( name == GL_EXTENSIONS && index < sizeof( nullExtensions ) / sizeof( nullExtensions[0] ) )
+	{
+		return ( const GLubyte* )nullExtensions[index];
+	}
+	return ( const GLubyte* )"";
+}
+
+static void APIENTRY NullGL_GetShaderiv( GLuint shader, GLenum pname, GLint* params )
+{
+	*params = ( pname == GL_COMPILE_STATUS ) ? GL_TRUE : 0;
+}
+
+static void APIENTRY NullGL_GetProgramiv( GLuint program, GLenum pname, GLint* params )
+{
+	*params = ( pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS ) ? GL_TRUE : 0;
+}
+
+static GLenum APIENTRY NullGL_CheckFramebufferStatus( GLenum target )
+{
+	return GL_FRAMEBUFFER_COMPLETE;
+}
+
+static void APIENTRY NullGL_GetQueryObjectuiv( GLuint id, GLenum pname, GLuint* params )
+{
+	*params = ( pname == GL_QUERY_RESULT_AVAILABLE ) ? GL_TRUE : 0;
+}
+
+static void APIENTRY NullGL_GetQueryObjectiv( GLuint id, GLenum pname, GLint* params )
+{
+	*params = ( pname == GL_QUERY_RESULT_AVAILABLE ) ? GL_TRUE : 0;
+}
+
+static void APIENTRY NullGL_GetQueryObjectui64v( GLuint id, GLenum pname, GLuint64* params )
+{
+	*params = 0;
+}
+
+static GLsync APIENTRY NullGL_FenceSync( GLenum condition, GLbitfield flags )
+{
+	// any non-NULL handle, it is never dereferenced
+	return ( GLsync )&nullDriver;
+}
+
+static GLboolean APIENTRY NullGL_IsSync( GLsync sync )
+{
+	return ( sync != NULL ) ? GL_TRUE : GL_FALSE;
+}
+
+static GLenum APIENTRY NullGL_ClientWaitSync( GLsync sync, GLbitfield flags, GLuint64 timeout )
+{
+	return GL_ALREADY_SIGNALED;
+}
+
+/*
+================================================================================================
+
+	Objects
+
+================================================================================================
+*/
+
+static void APIENTRY NullGL_GenTextures( GLsizei n, GLuint* textures )
+{
+	NullGL_GenNames( n, textures );
+}
+
+static void APIENTRY NullGL_GenBuffers( GLsizei n, GLuint* buffers )
+{
+	NullGL_GenNames( n, buffers );
+}
+
+static void APIENTRY NullGL_DeleteBuffers( GLsizei n, const GLuint* buffers )
+{
+	for( GLsizei i = 0; i < n; i++ )
+	{
+		if( ( int )buffers[i] < nullDriver.buffers.Num() )
+		{
+			nullBuffer_t& buffer = nullDriver.buffers[buffers[i]];
+			Mem_Free( buffer.data );
+			buffer.data = NULL;
+			buffer.size = 0;
+		}
+	}
+}
+
+static void APIENTRY NullGL_GenFramebuffers( GLsizei n, GLuint* framebuffers )
+{
+	NullGL_GenNames( n, framebuffers );
+}
+
+static void APIENTRY NullGL_GenRenderbuffers( GLsizei n, GLuint* renderbuffers )
+{
+	NullGL_GenNames( n, renderbuffers );
+}
+
+static void APIENTRY NullGL_GenVertexArrays( GLsizei n, GLuint* arrays )
+{
+	NullGL_GenNames( n, arrays );
+}
+
+static void APIENTRY NullGL_GenQueries( GLsizei n, GLuint* ids )
+{
+	NullGL_GenNames( n, ids );
+}
+
+static GLuint APIENTRY NullGL_CreateShader( GLenum type )
+{
+	return ++nullDriver.nextName;
+}
+
+static GLuint APIENTRY NullGL_CreateProgram()
+{
+	return ++nullDriver.nextName;
+}
+
+/*
+================================================================================================
+
+	Buffers
+
+================================================================================================
+*/
+
+static void APIENTRY NullGL_BindBufferProc( GLenum target, GLuint buffer )
+{
+	NullGL_BindBuffer( target, buffer );
+}
+
+static void APIENTRY NullGL_BindBufferRange( GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size )
+{
+	NullGL_BindBuffer( target, buffer );
+}
+
+static void APIENTRY NullGL_BufferData( GLenum target, GLsizeiptr size, const void* data, GLenum usage )
+{
+	nullBuffer_t* buffer = NullGL_BoundBuffer( target );
+	if( buffer == NULL )
+	{
+		return;
+	}
+	
+	if( buffer->size != ( int )size )
+	{
+		Mem_Free( buffer->data );
+		buffer->data = ( byte* )Mem_Alloc( ( int )size, TAG_RENDER );
+		buffer->size = ( int )size;
+	}
+	if( data != NULL )
+	{
+		memcpy( buffer->data, data, size );
+		nullDriver.frame.bufferBytes += size;
+	}
+}
+
+static void APIENTRY NullGL_BufferSubData( GLenum target, GLintptr offset, GLsizeiptr size, const void* data )
+{
+	nullBuffer_t* buffer = NullGL_BoundBuffer( target );
+	if( buffer == NULL || offset + size > buffer->size )
+	{
+		return;
+	}
+	memcpy( buffer->data + offset, data, size );
+	nullDriver.frame.bufferBytes += size;
+}
+
+static void* APIENTRY NullGL_MapBufferRange( GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access )
+{
+	nullBuffer_t* buffer = NullGL_BoundBuffer( target );
+	if( buffer == NULL || offset + length > buffer->size )
+	{
+		return NULL;
+	}
+	if( access & GL_MAP_WRITE_BIT )
+	{
+		// assume everything that is mapped for writing gets written
+		nullDriver.frame.bufferBytes += length;
+	}
+	return buffer->data + offset;
+}
+
+static void* APIENTRY NullGL_MapBuffer( GLenum target, GLenum access )
+{
+	nullBuffer_t* buffer = NullGL_BoundBuffer( target );
+	if( buffer == NULL )
+	{
+		return NULL;
+	}
+	if( access != GL_READ_ONLY )
+	{
+		nullDriver.frame.bufferBytes += buffer->size;
+	}
+	return buffer->data;
+}
+
+static GLboolean APIENTRY NullGL_UnmapBuffer( GLenum target )
+{
+	return GL_TRUE;
+}
+
+/*
+================================================================================================
+
+	Textures
+
+================================================================================================
+*/
+
+static void APIENTRY NullGL_BindTexture( GLenum target, GLuint texture )
+{
+	nullDriver.frame.textureBinds++;
+}
+
+static void APIENTRY NullGL_BindTextureUnit( GLuint unit, GLuint texture )
+{
+	nullDriver.frame.textureBinds++;
+}
+
+static void APIENTRY NullGL_TexImage2D( GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels )
+{
+	if( pixels != NULL )
+	{
+		nullDriver.frame.textureBytes += NullGL_PixelBytes( width, height, 1, format, type );
+	}
+}
+
+static void APIENTRY NullGL_TexSubImage2D( GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels )
+{
+	nullDriver.frame.textureBytes += NullGL_PixelBytes( width, height, 1, format, type );
+}
+
+static void APIENTRY NullGL_TexImage3D( GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void* pixels )
+{
+	if( pixels != NULL )
+	{
+		nullDriver.frame.textureBytes += NullGL_PixelBytes( width, height, depth, format, type );
+	}
+}
+
+static void APIENTRY NullGL_CompressedTexImage2D( GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data )
+{
+	if( data != NULL )
+	{
+		nullDriver.frame.textureBytes += imageSize;
+	}
+}
+
+static void APIENTRY NullGL_CompressedTexSubImage2D( GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void* data )
+{
+	nullDriver.frame.textureBytes += imageSize;
+}
+
+/*
+================================================================================================
+
+	State and drawing
+
+================================================================================================
+*/
+
+static void APIENTRY NullGL_Enable( GLenum cap )
+{
+	nullDriver.frame.stateChanges++;
+}
+
+static void APIENTRY NullGL_Disable( GLenum cap )
+{
+	nullDriver.frame.stateChanges++;
+}
+
+static void APIENTRY NullGL_BlendFunc( GLenum sfactor, GLenum dfactor )
+{
+	nullDriver.frame.stateChanges++;
+}
+
+static void APIENTRY NullGL_DepthFunc( GLenum func )
+{
+	nullDriver.frame.stateChanges++;
+}
+
+static void APIENTRY NullGL_DepthMask( GLboolean flag )
+{
+	nullDriver.frame.stateChanges++;
+}
+
+static void APIENTRY NullGL_ColorMask( GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha )
+{
+	nullDriver.frame.stateChanges++;
+}
+
+static void APIENTRY NullGL_StencilFunc( GLenum func, GLint ref, GLuint mask )
+{
+	nullDriver.frame.stateChanges++;
+}
+
+static void APIENTRY NullGL_StencilOp( GLenum fail, GLenum zfail, GLenum zpass )
+{
+	nullDriver.frame.stateChanges++;
+}
+
+static void APIENTRY NullGL_StencilFuncSeparate( GLenum face, GLenum func, GLint ref, GLuint mask )
+{
+	nullDriver.frame.stateChanges++;
+}
+
+static void APIENTRY NullGL_StencilOpSeparate( GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass )
+{
+	nullDriver.frame.stateChanges++;
+}
+
+static void APIENTRY NullGL_CullFace( GLenum mode )
+{
+	nullDriver.frame.stateChanges++;
+}
+
+static void APIENTRY NullGL_PolygonMode( GLenum face, GLenum mode )
+{
+	nullDriver.frame.stateChanges++;
+}
+
+static void APIENTRY NullGL_PolygonOffset( GLfloat factor, GLfloat units )
+{
+	nullDriver.frame.stateChanges++;
+}
+
+static void APIENTRY NullGL_DepthBoundsEXT( GLclampd zmin, GLclampd zmax )
+{
+	nullDriver.frame.stateChanges++;
+}
+
+static void APIENTRY NullGL_Scissor( GLint x, GLint y, GLsizei width, GLsizei height )
+{
+	nullDriver.frame.stateChanges++;
+}
+
+static void APIENTRY NullGL_Viewport( GLint x, GLint y, GLsizei width, GLsizei height )
+{
+	nullDriver.frame.stateChanges++;
+}
+
+static void APIENTRY NullGL_UseProgram( GLuint program )
+{
+	nullDriver.frame.programBinds++;
+}
+
+static void APIENTRY NullGL_BindFramebuffer( GLenum target, GLuint framebuffer )
+{
+	nullDriver.frame.framebufferBinds++;
+}
+
+static void APIENTRY NullGL_Uniform4fv( GLint location, GLsizei count, const GLfloat* value )
+{
+	nullDriver.frame.uniformBytes += count * 4 * sizeof( GLfloat );
+}
+
+static void APIENTRY NullGL_DrawElementsBaseVertex( GLenum mode, GLsizei count, GLenum type, const void* indices, GLint basevertex )
+{
+	nullDriver.frame.draws++;
+	nullDriver.frame.indices += count;
+}
+
+/*
+========================
+NullGL_AddStats
+========================
+*/
+static void NullGL_AddStats( nullDriverStats_t& to, const nullDriverStats_t& from )
+{
+	to.frames += from.frames;
+	to.draws += from.draws;
+	to.indices += from.indices;
+	to.stateChanges += from.stateChanges;
+	to.programBinds += from.programBinds;
+	to.textureBinds += from.textureBinds;
+	to.bufferBinds += from.bufferBinds;
+	to.framebufferBinds += from.framebufferBinds;
+	to.bufferBytes += from.bufferBytes;
+	to.textureBytes += from.textureBytes;
+	to.uniformBytes += from.uniformBytes;
+}
+
+/*
+========================
+QGL_InitNullDriver
+
+Called by QGL_Init after every entry point got the generic null function.
+========================
+*/
+void QGL_InitNullDriver( void )
+{
+	memset( &nullDriver.frame, 0, sizeof( nullDriver.frame ) );
+	memset( &nullDriver.total, 0, sizeof( nullDriver.total ) );
+	nullDriver.nextName = 0;
+	nullDriver.numBindings = 0;
+	
+	glGetError = NullGL_GetError;
+	glGetIntegerv = NullGL_GetIntegerv;
+	glGetFloatv = NullGL_GetFloatv;
+	glGetString = NullGL_GetString;
+	glGetStringi = NullGL_GetStringi;
+	glGetShaderiv = NullGL_GetShaderiv;
+	glGetProgramiv = NullGL_GetProgramiv;
+	glCheckFramebufferStatus = NullGL_CheckFramebufferStatus;
+	glGetQueryObjectiv = NullGL_GetQueryObjectiv;
+	glGetQueryObjectuiv = NullGL_GetQueryObjectuiv;
+	glGetQueryObjectui64v = NullGL_GetQueryObjectui64v;
+	glFenceSync = NullGL_FenceSync;
+	glIsSync = NullGL_IsSync;
+	glClientWaitSync = NullGL_ClientWaitSync;
+	
+	glGenTextures = NullGL_GenTextures;
+	glGenBuffers = NullGL_GenBuffers;
+	glDeleteBuffers = NullGL_DeleteBuffers;
+	glGenFramebuffers = NullGL_GenFramebuffers;
+	glGenRenderbuffers = NullGL_GenRenderbuffers;
+	glGenVertexArrays = NullGL_GenVertexArrays;
+	glGenQueries = NullGL_GenQueries;
+	glCreateShader = NullGL_CreateShader;
+	glCreateProgram = NullGL_CreateProgram;
+	
+	glBindBuffer = NullGL_BindBufferProc;
+	glBindBufferRange = NullGL_BindBufferRange;
+	glBufferData = NullGL_BufferData;
+	glBufferSubData = NullGL_BufferSubData;
+	glMapBufferRange = NullGL_MapBufferRange;
+	glMapBuffer = NullGL_MapBuffer;
+	glUnmapBuffer = NullGL_UnmapBuffer;
+	
+	glBindTexture = NullGL_BindTexture;
+	glBindTextureUnit = NullGL_BindTextureUnit;
+	glTexImage2D = NullGL_TexImage2D;
+	glTexSubImage2D = NullGL_TexSubImage2D;
+	glTexImage3D = NullGL_TexImage3D;
+	glCompressedTexImage2D = NullGL_CompressedTexImage2D;
+	glCompressedTexSubImage2D = NullGL_CompressedTexSubImage2D;
+	
+	glEnable = NullGL_Enable;
+	glDisable = NullGL_Disable;
+	glBlendFunc = NullGL_BlendFunc;
+	glDepthFunc = NullGL_DepthFunc;
+	glDepthMask = NullGL_DepthMask;
+	glColorMask = NullGL_ColorMask;
+	glStencilFunc = NullGL_StencilFunc;
+	glStencilOp = NullGL_StencilOp;
+	glStencilFuncSeparate = NullGL_StencilFuncSeparate;
+	glStencilOpSeparate = NullGL_StencilOpSeparate;
+	glCullFace = NullGL_CullFace;
+	glPolygonMode = NullGL_PolygonMode;
+	glPolygonOffset = NullGL_PolygonOffset;
+	glDepthBoundsEXT = NullGL_DepthBoundsEXT;
+	glScissor = NullGL_Scissor;
+	glViewport = NullGL_Viewport;
+	glUseProgram = NullGL_UseProgram;
+	glBindFramebuffer = NullGL_BindFramebuffer;
+	glUniform4fv = NullGL_Uniform4fv;
+	glDrawElementsBaseVertex = NullGL_DrawElementsBaseVertex;
+}
+
+/*
+========================
+QGL_ShutdownNullDriver
+========================
+*/
+void QGL_ShutdownNullDriver( void )
+{
+	for( int i = 0; i < nullDriver.buffers.Num(); i++ )
+	{
+		Mem_Free( nullDriver.buffers[i].data );
+	}
+	nullDriver.buffers.Clear();
+	nullDriver.numBindings = 0;
+}
+
+/*
+========================
+QGL_NullDriverEndFrame
+
+Called instead of swapping buffers.
+========================
+*/
+void QGL_NullDriverEndFrame( void )
+{
+	nullDriverStats_t& f = nullDriver.frame;
+	f.frames = 1;
+	
+	if( r_showNullDriver.GetBool() )
+	{
+		common->Printf( "null: %i draws %lld indices %i state %i prog %i tex %i buf %i fbo, upload %lld buffer %lld texture %lld uniform bytes\n",
+						f.draws, ( long long )f.indices, f.stateChanges, f.programBinds, f.textureBinds, f.bufferBinds, f.framebufferBinds,
+						( long long )f.bufferBytes, ( long long )f.textureBytes, ( long long )f.uniformBytes );
+	}
+	
+	NullGL_AddStats( nullDriver.total, f );
+	memset( &f, 0, sizeof( f ) );
+}
+
+/*
+========================
+NullDriverStats_f
+========================
+*/
+CONSOLE_COMMAND( nullDriverStats, "prints and resets what the null GL driver counted since the last call", NULL )
+{
+	const nullDriverStats_t& t = nullDriver.total;
+	if( t.frames == 0 )
+	{
+		common->Printf( "no frames, the null driver is used with r_glDriver \"null\"\n" );
+		return;
+	}
+	
+	const float scale = 1.0f / t.frames;
+	common->Printf( "%i frames, per frame:\n", t.frames );
+	common->Printf( "%8.1f draws\n", t.draws * scale );
+	common->Printf( "%8.0f indices\n", t.indices * scale );
+	common->Printf( "%8.1f state changes\n", t.stateChanges * scale );
+	common->Printf( "%8.1f program binds\n", t.programBinds * scale );
+	common->Printf( "%8.1f texture binds\n", t.textureBinds * scale );
+	common->Printf( "%8.1f buffer binds\n", t.bufferBinds * scale );
+	common->Printf( "%8.1f framebuffer binds\n", t.framebufferBinds * scale );
+	common->Printf( "%8.1f kB buffer uploads\n", t.bufferBytes * scale / 1024.0f );
+	common->Printf( "%8.1f kB texture uploads\n", t.textureBytes * scale / 1024.0f );
+	common->Printf( "%8.1f kB uniform uploads\n", t.uniformBytes * scale / 1024.0f );
+	
+	memset( &nullDriver.total, 0, sizeof( nullDriver.total ) );
+}
@@ -66,14 +66,21 @@ static void R_PerformanceCounters()
 	
 	if( r_showDynamic.GetBool() )
 	{
-		common->Printf( "callback:%i md5:%i dfrmVerts:%i dfrmTris:%i tangTris:%i guis:%i\n",
+		common->Printf( "callback:%i md5:%i dfrmVerts:%i (%i parallel) dfrmTris:%i tangTris:%i guis:%i\n",
 						tr.pc.c_entityDefCallbacks,
 						tr.pc.c_generateMd5,
 						tr.pc.c_deformedVerts,
+						tr.pc.c_parallelSkinnedVerts,
 						tr.pc.c_deformedIndexes / 3,
 						tr.pc.c_tangentIndexes / 3,
 						tr.pc.c_guiSurfs
 					  );
+		const int dynamicModels = tr.pc.c_dynamicModelInstances + tr.pc.c_dynamicModelReuses;
+		common->Printf( "dynamicModels instantiated:%i reused:%i (%i%% hits)\n",
+						tr.pc.c_dynamicModelInstances,
+						tr.pc.c_dynamicModelReuses,
+						( dynamicModels > 0 ) ? tr.pc.c_dynamicModelReuses * 100 / dynamicModels : 0
+					  );
 	}
 	
 	if( r_showCull.GetBool() )
@@ -88,6 +95,12 @@ static void R_PerformanceCounters()
 						tr.pc.c_entityDefCallbacks, tr.pc.c_createInteractions, tr.pc.c_createShadowVolumes );
 		common->Printf( "viewEntities:%i  shadowEntities:%i  viewLights:%i\n", tr.pc.c_visibleViewEntities,
 						tr.pc.c_shadowViewEntities, tr.pc.c_viewLights );
+		const int shadowCacheLookups = tr.pc.c_shadowCacheHits + tr.pc.c_shadowCacheMisses;
+		common->Printf( "shadowCache hits:%i misses:%i (%i%% hits) %ik\n",
+						tr.pc.c_shadowCacheHits,
+						tr.pc.c_shadowCacheMisses,
+						shadowCacheLookups > 0 ? tr.pc.c_shadowCacheHits * 100 / shadowCacheLookups : 0,
+						tr.pc.c_shadowCacheAllocated / 1024 );
 	}
 	if( r_showUpdates.GetBool() )
 	{
@@ -95,6 +108,11 @@ static void R_PerformanceCounters()
 						tr.pc.c_entityUpdates, tr.pc.c_entityReferences,
 						tr.pc.c_lightUpdates, tr.pc.c_lightReferences );
 	}
+	if( r_showOcclusion.GetBool() )
+	{
+		common->Printf( "occluderTris:%i  occludedEntities:%i  occludedLights:%i  %i usec\n",
+						tr.pc.c_occluderTris, tr.pc.c_occludedEntities, tr.pc.c_occludedLights, tr.pc.occlusionMicroSec );
+	}
 	if( r_showMemory.GetBool() )
 	{
 		common->Printf( "frameData: %i (%i)\n", frameData->frameMemoryAllocated.GetValue(), frameData->highWaterAllocated );
@@ -753,6 +771,12 @@ void idRenderSystemLocal::SwapCommandBuffers_FinishRendering(
 	if( shadowMicroSec != NULL )
 		*shadowMicroSec = backEnd.pc.shadowMicroSec;
 	
+	// upload the images the loader thread finished reading and give it a new budget
+	globalImages->UpdateBackgroundLoads();
+	
+	// evict unused images and change mip levels to stay inside the image memory budget
+	globalImages->UpdateResidency();
+	
 	// print any other statistics and clear all of them
 	R_PerformanceCounters();
 	
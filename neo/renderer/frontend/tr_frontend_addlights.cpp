@@ -350,12 +350,8 @@ static void R_AddSingleLight( viewLight_t* vLight )
 	
 	// this bool array will be set true whenever the entity will visibly interact with the light
 	vLight->entityInteractionState = ( byte* )R_ClearedFrameAlloc( light->world->entityDefs.Num() * sizeof( vLight->entityInteractionState[0] ), FRAME_ALLOC_INTERACTION_STATE );
-
-	// foresthale 2014-05-10: don't crash if the interaction table hasn't been created yet
-	if (!light->world->interactionTable)
-		light->world->ResizeInteractionTable();
-
-	idInteraction * * const interactionTableRow = light->world->interactionTable + light->index * light->world->interactionTableWidth;
+	
+	const idInteractionTable& interactionTable = light->world->interactionTable;
 	
 	for( areaReference_t* lref = light->references; lref != NULL; lref = lref->ownerNext )
 	{
@@ -385,7 +381,7 @@ static void R_AddSingleLight( viewLight_t* vLight )
 			vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_NO;
 			
 			// The table is updated at interaction::AllocAndLink() and interaction::UnlinkAndFree()
-			const idInteraction* inter = interactionTableRow[ edef->index ];
+			const idInteraction* inter = interactionTable.Find( light->index, edef->index );
 			
 			const renderEntity_t& eParms = edef->parms;
 			const idRenderModel* eModel = eParms.hModel;
@@ -590,6 +586,16 @@ void R_AddLights()
 {
 	SCOPED_PROFILE_EVENT( "R_AddLights" );
 	
+	// lights that only touch space hidden behind occluders can't light anything visible
+	R_CullLightsToOccluders();
+	
+	// foresthale 2014-05-10: don't crash if the interaction table hasn't been created yet
+	// (this happens in the editor), create it before the jobs start reading it
+	if( tr.viewDef->renderWorld != NULL && !tr.viewDef->renderWorld->interactionTable.IsInitialized() )
+	{
+		tr.viewDef->renderWorld->interactionTable.Init( tr.viewDef->renderWorld->lightDefs.Num() );
+	}
+	
 	//-------------------------------------------------
 	// check each light individually, possibly in parallel
 	//-------------------------------------------------
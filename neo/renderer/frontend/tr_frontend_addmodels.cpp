@@ -33,6 +33,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "tr_local.h"
 #include "renderer/models/Model_local.h"
 
+extern idCVar image_mipStreaming;
+
 idCVar r_skipStaticShadows( "r_skipStaticShadows", "0", CVAR_RENDERER | CVAR_BOOL, "skip static shadows" );
 idCVar r_skipDynamicShadows( "r_skipDynamicShadows", "0", CVAR_RENDERER | CVAR_BOOL, "skip dynamic shadows" );
 idCVar r_useParallelAddModels( "r_useParallelAddModels", "1", CVAR_RENDERER | CVAR_BOOL, "add all models in parallel with jobs" );
@@ -41,6 +43,8 @@ idCVar r_useShadowPreciseInsideTest( "r_useShadowPreciseInsideTest", "1", CVAR_R
 idCVar r_cullDynamicShadowTriangles( "r_cullDynamicShadowTriangles", "1", CVAR_RENDERER | CVAR_BOOL, "cull occluder triangles that are outside the light frustum so they do not contribute to the dynamic shadow volume" );
 idCVar r_cullDynamicLightTriangles( "r_cullDynamicLightTriangles", "1", CVAR_RENDERER | CVAR_BOOL, "cull surface triangles that are outside the light frustum so they do not get rendered for interactions" );
 idCVar r_forceShadowCaps( "r_forceShadowCaps", "0", CVAR_RENDERER | CVAR_BOOL, "0 = skip rendering shadow caps if view is outside shadow volume, 1 = always render shadow caps" );
+idCVar r_useShadowCache( "r_useShadowCache", "1", CVAR_RENDERER | CVAR_BOOL, "keep the dynamic shadow volume indices of light / entity pairs across frames while the light, the entity transform and the model don't change" );
+idCVar r_shadowCacheMegs( "r_shadowCacheMegs", "32", CVAR_RENDERER | CVAR_INTEGER, "memory budget for the kept dynamic shadow volume indices, the least recently used pairs are dropped first", 1, 1024 );
 // RB begin
 idCVar r_forceShadowMapsOnAlphaTestedSurfaces( "r_forceShadowMapsOnAlphaTestedSurfaces", "1", CVAR_RENDERER | CVAR_BOOL, "0 = same shadowing as with stencil shadows, 1 = ignore noshadows for alpha tested materials" );
 // RB end
@@ -177,6 +181,516 @@ bool R_IssueEntityDefCallback( idRenderEntityLocal* def )
 	return update;
 }
 
+/*
+===================
+R_FreeDynamicModelInputs
+===================
+*/
+void R_FreeDynamicModelInputs( idRenderEntityLocal* def )
+{
+	dynamicModelInputs_t* inputs = def->cachedDynamicModelInputs;
+	if( inputs == NULL )
+	{
+		return;
+	}
+	Mem_Free16( inputs->joints );
+	Mem_Free( inputs );
+	def->cachedDynamicModelInputs = NULL;
+}
+
+/*
+===================
+R_SetDynamicModelInputs
+
+Everything but the joints that the snapshot of a dynamic model is made from.
+DM_CACHED models (md5, md3) are snapshotted in model space and don't look at
+the view, DM_CONTINUOUS models (particles, beams, liquids) depend on the view
+time and some of them on the view origin and axis.
+===================
+*/
+static void R_SetDynamicModelInputs( const idRenderEntityLocal* def, dynamicModel_t type, dynamicModelInputs_t& inputs )
+{
+	memcpy( &inputs.parms, &def->parms, sizeof( inputs.parms ) );
+	inputs.parms.joints = NULL;
+	inputs.time = 0;
+	inputs.viewOrigin.Zero();
+	inputs.viewAxis.Zero();
+	inputs.gpuSkinning = r_useGPUSkinning.GetBool();
+	
+	if( type == DM_CACHED )
+	{
+		inputs.parms.origin.Zero();
+		inputs.parms.axis.Zero();
+	}
+	else if( tr.viewDef != NULL )
+	{
+		inputs.time = tr.viewDef->renderView.time[def->parms.timeGroup];
+		inputs.viewOrigin = tr.viewDef->renderView.vieworg;
+		inputs.viewAxis = tr.viewDef->renderView.viewaxis;
+	}
+}
+
+/*
+===================
+R_DynamicModelInputsMatch
+
+Returns true if cachedDynamicModel was instantiated from exactly the
+current joints, parms, time and view.
+===================
+*/
+static bool R_DynamicModelInputsMatch( const idRenderEntityLocal* def, dynamicModel_t type )
+{
+	const dynamicModelInputs_t* cached = def->cachedDynamicModelInputs;
+	if( cached == NULL || !cached->valid || def->cachedDynamicModel == NULL )
+	{
+		return false;
+	}
+	
+	// the skeleton debug drawing is done while instantiating
+	if( !r_useDynamicModelInputs.GetBool() || !r_useCachedDynamicModels.GetBool() || r_showSkel.GetInteger() != 0 )
+	{
+		return false;
+	}
+	
+	const int numJoints = ( def->parms.joints != NULL ) ? def->parms.numJoints : 0;
+	if( numJoints != cached->numJoints )
+	{
+		return false;
+	}
+	
+	dynamicModelInputs_t current;
+	R_SetDynamicModelInputs( def, type, current );
+	
+	if( current.time != cached->time || current.gpuSkinning != cached->gpuSkinning )
+	{
+		return false;
+	}
+	if( current.viewOrigin != cached->viewOrigin || current.viewAxis != cached->viewAxis )
+	{
+		return false;
+	}
+	if( memcmp( &current.parms, &cached->parms, sizeof( current.parms ) ) != 0 )
+	{
+		return false;
+	}
+	if( numJoints > 0 && memcmp( def->parms.joints, cached->joints, numJoints * sizeof( idJointMat ) ) != 0 )
+	{
+		return false;
+	}
+	return true;
+}
+
+/*
+===================
+R_StoreDynamicModelInputs
+
+Remembers what cachedDynamicModel was just instantiated from.
+===================
+*/
+static void R_StoreDynamicModelInputs( idRenderEntityLocal* def, dynamicModel_t type )
+{
+	dynamicModelInputs_t* inputs = def->cachedDynamicModelInputs;
+	
+	if( def->cachedDynamicModel == NULL || !r_useDynamicModelInputs.GetBool() )
+	{
+		if( inputs != NULL )
+		{
+			inputs->valid = false;
+		}
+		return;
+	}
+	
+	if( inputs == NULL )
+	{
+		inputs = ( dynamicModelInputs_t* )Mem_ClearedAlloc( sizeof( *inputs ), TAG_RENDER_ENTITY );
+		def->cachedDynamicModelInputs = inputs;
+	}
+	
+	R_SetDynamicModelInputs( def, type, *inputs );
+	
+	inputs->numJoints = ( def->parms.joints != NULL ) ? def->parms.numJoints : 0;
+	if( inputs->numJoints > inputs->maxJoints )
+	{
+		Mem_Free16( inputs->joints );
+		inputs->maxJoints = inputs->numJoints;
+		inputs->joints = ( idJointMat* )Mem_Alloc16( inputs->maxJoints * sizeof( idJointMat ), TAG_JOINTMAT );
+	}
+	if( inputs->numJoints > 0 )
+	{
+		memcpy( inputs->joints, def->parms.joints, inputs->numJoints * sizeof( idJointMat ) );
+	}
+	inputs->valid = true;
+}
+
+static idSysInterlockedInteger shadowCacheAllocated;		// bytes of index memory in all shadowCacheEntry_t
+
+/*
+===================
+R_FreeShadowCacheEntry
+===================
+*/
+static void R_FreeShadowCacheEntry( shadowCacheEntry_t* entry )
+{
+	shadowCacheAllocated.Add( -entry->allocated );
+	Mem_Free16( entry->indices.shadowIndices );
+	Mem_Free16( entry->indices.lightIndices );
+	Mem_Free( entry );
+}
+
+/*
+===================
+R_FreeShadowCache
+===================
+*/
+void R_FreeShadowCache( idRenderEntityLocal* def )
+{
+	shadowCacheEntry_t* next = NULL;
+	for( shadowCacheEntry_t* entry = def->shadowCache; entry != NULL; entry = next )
+	{
+		next = entry->next;
+		R_FreeShadowCacheEntry( entry );
+	}
+	def->shadowCache = NULL;
+}
+
+/*
+===================
+R_FreeLightShadowCache
+
+Drops the pairs of a light that is freed or changed.
+===================
+*/
+void R_FreeLightShadowCache( const idRenderLightLocal* lightDef )
+{
+	if( shadowCacheAllocated.GetValue() == 0 )
+	{
+		return;
+	}
+	
+	const idRenderWorldLocal* world = lightDef->world;
+	for( int e = 0; e < world->entityDefs.Num(); e++ )
+	{
+		idRenderEntityLocal* def = world->entityDefs[e];
+		if( def == NULL )
+		{
+			continue;
+		}
+		for( shadowCacheEntry_t** link = &def->shadowCache; *link != NULL; )
+		{
+			shadowCacheEntry_t* entry = *link;
+			if( entry->lightDef == lightDef )
+			{
+				*link = entry->next;
+				R_FreeShadowCacheEntry( entry );
+			}
+			else
+			{
+				link = &entry->next;
+			}
+		}
+	}
+}
+
+/*
+===================
+R_InvalidateShadowCache
+
+The entity's model was instantiated or updated again, so the verts the indices were made from may have changed.
+===================
+*/
+void R_InvalidateShadowCache( idRenderEntityLocal* def )
+{
+	for( shadowCacheEntry_t* entry = def->shadowCache; entry != NULL; entry = entry->next )
+	{
+		entry->indices.shadowIndicesValid = false;
+		entry->indices.lightIndicesValid = false;
+		entry->changed = true;
+	}
+}
+
+/*
+===================
+R_ResizeShadowCacheIndices
+
+Keeps the first numKeep indices.
+===================
+*/
+static void R_ResizeShadowCacheIndices( shadowCacheEntry_t* entry, triIndex_t*& indices, int& maxIndices, int newMaxIndices, int numKeep )
+{
+	triIndex_t* newIndices = NULL;
+	if( newMaxIndices > 0 )
+	{
+		newIndices = ( triIndex_t* )Mem_Alloc16( newMaxIndices * sizeof( triIndex_t ), TAG_RENDER_INTERACTION );
+		if( numKeep > 0 )
+		{
+			memcpy( newIndices, indices, numKeep * sizeof( triIndex_t ) );
+		}
+	}
+	Mem_Free16( indices );
+	
+	const int grow = ( newMaxIndices - maxIndices ) * sizeof( triIndex_t );
+	entry->allocated += grow;
+	shadowCacheAllocated.Add( grow );
+	
+	indices = newIndices;
+	maxIndices = newMaxIndices;
+}
+
+/*
+===================
+R_ShadowCacheBudget
+===================
+*/
+static int R_ShadowCacheBudget()
+{
+	return r_shadowCacheMegs.GetInteger() * 1024 * 1024;
+}
+
+/*
+===================
+R_SetupDynamicShadowCache
+
+Points the job at the cached indices of the light / surface pair. Moving the light
+or the entity changes the local light origin and projection, which drops the
+indices, and so does a surface with a different vertex or index count.
+
+A pair is only cached once it stayed the same for a frame, a moving light or entity
+would otherwise pay for reserving and copying indices that are never used again.
+Pairs that keep changing give back their indices.
+===================
+*/
+static void R_SetupDynamicShadowCache( idRenderEntityLocal* def, const idRenderLightLocal* lightDef, const srfTriangles_t* tri, dynamicShadowVolumeParms_t* parms )
+{
+	static const int RELEASE_CHANGED_FRAMES = 8;
+	
+	parms->cache = NULL;
+	
+	// GPU skinned verts change with the joints
+	if( !r_useShadowCache.GetBool() || parms->joints != NULL )
+	{
+		return;
+	}
+	
+	shadowCacheEntry_t* entry = def->shadowCache;
+	while( entry != NULL && ( entry->lightDef != lightDef || entry->tri != tri ) )
+	{
+		entry = entry->next;
+	}
+	if( entry == NULL )
+	{
+		// pairs that are already cached are still used, but no new ones are added until it is trimmed
+		if( shadowCacheAllocated.GetValue() >= R_ShadowCacheBudget() )
+		{
+			return;
+		}
+		entry = ( shadowCacheEntry_t* )Mem_ClearedAlloc( sizeof( *entry ), TAG_RENDER_INTERACTION );
+		entry->lightDef = lightDef;
+		entry->tri = tri;
+		entry->next = def->shadowCache;
+		def->shadowCache = entry;
+	}
+	
+	dynamicShadowVolumeCache_t& indices = entry->indices;
+	
+	if( entry->numVerts != tri->numVerts || entry->numIndexes != tri->numIndexes || entry->localLightOrigin != parms->localLightOrigin ||
+			memcmp( &entry->localLightProject, &parms->localLightProject, sizeof( entry->localLightProject ) ) != 0 )
+	{
+		entry->numVerts = tri->numVerts;
+		entry->numIndexes = tri->numIndexes;
+		entry->localLightOrigin = parms->localLightOrigin;
+		entry->localLightProject = parms->localLightProject;
+		indices.shadowIndicesValid = false;
+		indices.lightIndicesValid = false;
+		entry->changed = true;
+	}
+	
+	// the light triangles don't depend on culling the shadow triangles, and
+	// the same parms are setup for the light triangles before the shadow
+	if( parms->shadowIndices != NULL && entry->cullShadowTrianglesToLight != parms->cullShadowTrianglesToLight )
+	{
+		entry->cullShadowTrianglesToLight = parms->cullShadowTrianglesToLight;
+		indices.shadowIndicesValid = false;
+		entry->changed = true;
+	}
+	
+	// count the frames in a row the pair did or didn't change, once a frame
+	if( entry->lastUsedFrame != tr.frameCount )
+	{
+		entry->lastUsedFrame = tr.frameCount;
+		if( entry->changed )
+		{
+			entry->stableFrames = Min( entry->stableFrames, 0 ) - 1;
+		}
+		else
+		{
+			entry->stableFrames = Max( entry->stableFrames, 0 ) + 1;
+		}
+		entry->changed = false;
+		
+		if( entry->stableFrames == -RELEASE_CHANGED_FRAMES )
+		{
+			R_ResizeShadowCacheIndices( entry, indices.shadowIndices, indices.maxShadowIndices, 0, 0 );
+			R_ResizeShadowCacheIndices( entry, indices.lightIndices, indices.maxLightIndices, 0, 0 );
+		}
+	}
+	if( entry->stableFrames <= 0 )
+	{
+		return;
+	}
+	
+	// reserve the worst case for indices the job has to create, R_UpdateShadowCacheCounters
+	// shrinks them to the number that was created once they are used
+	if( parms->shadowIndices != NULL && !indices.shadowIndicesValid && parms->maxShadowIndices > indices.maxShadowIndices )
+	{
+		R_ResizeShadowCacheIndices( entry, indices.shadowIndices, indices.maxShadowIndices, parms->maxShadowIndices, 0 );
+	}
+	if( parms->lightIndices != NULL && !indices.lightIndicesValid && parms->maxLightIndices > indices.maxLightIndices )
+	{
+		R_ResizeShadowCacheIndices( entry, indices.lightIndices, indices.maxLightIndices, parms->maxLightIndices, 0 );
+	}
+	
+	parms->cache = &indices;
+}
+
+struct shadowCacheUse_t
+{
+	int		lastUsedFrame;
+	int		allocated;
+};
+
+class idSort_ShadowCacheUse : public idSort_Quick< shadowCacheUse_t, idSort_ShadowCacheUse >
+{
+public:
+	int Compare( const shadowCacheUse_t& a, const shadowCacheUse_t& b ) const
+	{
+		return a.lastUsedFrame - b.lastUsedFrame;
+	}
+};
+
+/*
+===================
+R_TrimShadowCache
+
+Drops the least recently used pairs of all worlds until the cache fits in the budget again.
+Pairs used in the current frame are kept, the views of the frame would only create them again.
+===================
+*/
+static void R_TrimShadowCache( int budget )
+{
+	idList<shadowCacheUse_t, TAG_RENDER_INTERACTION> uses;
+	
+	for( int w = 0; w < tr.worlds.Num(); w++ )
+	{
+		const idRenderWorldLocal* world = tr.worlds[w];
+		for( int e = 0; e < world->entityDefs.Num(); e++ )
+		{
+			const idRenderEntityLocal* def = world->entityDefs[e];
+			if( def == NULL )
+			{
+				continue;
+			}
+			for( const shadowCacheEntry_t* entry = def->shadowCache; entry != NULL; entry = entry->next )
+			{
+				if( entry->lastUsedFrame >= tr.frameCount )
+				{
+					continue;
+				}
+				shadowCacheUse_t& use = uses.Alloc();
+				use.lastUsedFrame = entry->lastUsedFrame;
+				use.allocated = entry->allocated;
+			}
+		}
+	}
+	
+	uses.SortWithTemplate( idSort_ShadowCacheUse() );
+	
+	// find the most recent frame that has to go
+	int remaining = shadowCacheAllocated.GetValue();
+	int lastDroppedFrame = -1;
+	for( int i = 0; i < uses.Num() && remaining > budget; i++ )
+	{
+		remaining -= uses[i].allocated;
+		lastDroppedFrame = uses[i].lastUsedFrame;
+	}
+	if( lastDroppedFrame < 0 )
+	{
+		return;
+	}
+	
+	for( int w = 0; w < tr.worlds.Num(); w++ )
+	{
+		idRenderWorldLocal* world = tr.worlds[w];
+		for( int e = 0; e < world->entityDefs.Num(); e++ )
+		{
+			idRenderEntityLocal* def = world->entityDefs[e];
+			if( def == NULL )
+			{
+				continue;
+			}
+			for( shadowCacheEntry_t** link = &def->shadowCache; *link != NULL; )
+			{
+				shadowCacheEntry_t* entry = *link;
+				if( entry->lastUsedFrame <= lastDroppedFrame )
+				{
+					*link = entry->next;
+					R_FreeShadowCacheEntry( entry );
+				}
+				else
+				{
+					link = &entry->next;
+				}
+			}
+		}
+	}
+}
+
+/*
+===================
+R_UpdateShadowCacheCounters
+
+Called after the shadow volume jobs of the view are done. Shrinks the indices
+of the pairs that were copied out of the cache to the number that was created,
+pairs that had to be created again keep their room for the next frame.
+===================
+*/
+static void R_UpdateShadowCacheCounters()
+{
+	for( viewEntity_t* vEntity = tr.viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next )
+	{
+		for( shadowCacheEntry_t* entry = vEntity->entityDef->shadowCache; entry != NULL; entry = entry->next )
+		{
+			dynamicShadowVolumeCache_t& indices = entry->indices;
+			
+			tr.pc.c_shadowCacheHits += indices.hits;
+			tr.pc.c_shadowCacheMisses += indices.misses;
+			
+			if( indices.hits > 0 && indices.misses == 0 )
+			{
+				if( indices.shadowIndicesValid && indices.maxShadowIndices > indices.numShadowIndices )
+				{
+					R_ResizeShadowCacheIndices( entry, indices.shadowIndices, indices.maxShadowIndices, indices.numShadowIndices, indices.numShadowIndices );
+				}
+				if( indices.lightIndicesValid && indices.maxLightIndices > indices.numLightIndices )
+				{
+					R_ResizeShadowCacheIndices( entry, indices.lightIndices, indices.maxLightIndices, indices.numLightIndices, indices.numLightIndices );
+				}
+			}
+			
+			indices.hits = 0;
+			indices.misses = 0;
+		}
+	}
+	
+	const int budget = R_ShadowCacheBudget();
+	if( shadowCacheAllocated.GetValue() > budget )
+	{
+		// leave some room so this doesn't run every frame
+		R_TrimShadowCache( budget - budget / 4 );
+	}
+	
+	tr.pc.c_shadowCacheAllocated = shadowCacheAllocated.GetValue();
+}
+
 /*
 ===================
 R_EntityDefDynamicModel
@@ -215,7 +729,15 @@ idRenderModel* R_EntityDefDynamicModel( idRenderEntityLocal* def )
 		return NULL;
 	}
 	
-	if( model->IsDynamicModel() == DM_STATIC )
+	// the callback may have rebuilt the surfaces of the model in place
+	if( callbackUpdate )
+	{
+		R_InvalidateShadowCache( def );
+	}
+	
+	const dynamicModel_t dynamicType = model->IsDynamicModel();
+	
+	if( dynamicType == DM_STATIC )
 	{
 		def->dynamicModel = NULL;
 		def->dynamicModelFrameCount = 0;
@@ -223,31 +745,52 @@ idRenderModel* R_EntityDefDynamicModel( idRenderEntityLocal* def )
 	}
 	
 	// continously animating models (particle systems, etc) will have their snapshot updated every single view
-	if( callbackUpdate || ( model->IsDynamicModel() == DM_CONTINUOUS && def->dynamicModelFrameCount != tr.frameCount ) )
+	if( callbackUpdate || ( dynamicType == DM_CONTINUOUS && def->dynamicModelFrameCount != tr.frameCount ) )
 	{
-		R_ClearEntityDefDynamicModel( def );
+		if( def->dynamicModel != NULL && R_DynamicModelInputsMatch( def, dynamicType ) )
+		{
+			// nothing the snapshot depends on changed, so it and the
+			// interaction surfaces made from it are still good
+			tr.pc.c_dynamicModelReuses++;
+			def->dynamicModelFrameCount = tr.frameCount;
+		}
+		else
+		{
+			R_ClearEntityDefDynamicModel( def );
+		}
 	}
 	
 	// if we don't have a snapshot of the dynamic model, generate it now
 	if( def->dynamicModel == NULL )
 	{
-	
-		SCOPED_PROFILE_EVENT( "InstantiateDynamicModel" );
-		
-		// instantiate the snapshot of the dynamic model, possibly reusing memory from the cached snapshot
-		def->cachedDynamicModel = model->InstantiateDynamicModel( &def->parms, tr.viewDef, def->cachedDynamicModel );
-		
-		if( def->cachedDynamicModel != NULL && r_checkBounds.GetBool() )
+		if( R_DynamicModelInputsMatch( def, dynamicType ) )
+		{
+			// the entity was updated, but the joints and parms the snapshot was made from are the same
+			tr.pc.c_dynamicModelReuses++;
+		}
+		else
 		{
-			idBounds b = def->cachedDynamicModel->Bounds();
-			if(	b[0][0] < def->localReferenceBounds[0][0] - CHECK_BOUNDS_EPSILON ||
-					b[0][1] < def->localReferenceBounds[0][1] - CHECK_BOUNDS_EPSILON ||
-					b[0][2] < def->localReferenceBounds[0][2] - CHECK_BOUNDS_EPSILON ||
-					b[1][0] > def->localReferenceBounds[1][0] + CHECK_BOUNDS_EPSILON ||
-					b[1][1] > def->localReferenceBounds[1][1] + CHECK_BOUNDS_EPSILON ||
-					b[1][2] > def->localReferenceBounds[1][2] + CHECK_BOUNDS_EPSILON )
+			SCOPED_PROFILE_EVENT( "InstantiateDynamicModel" );
+			
+			// instantiate the snapshot of the dynamic model, possibly reusing memory from the cached snapshot
+			def->cachedDynamicModel = model->InstantiateDynamicModel( &def->parms, tr.viewDef, def->cachedDynamicModel );
+			tr.pc.c_dynamicModelInstances++;
+			
+			R_StoreDynamicModelInputs( def, dynamicType );
+			R_InvalidateShadowCache( def );
+			
+			if( def->cachedDynamicModel != NULL && r_checkBounds.GetBool() )
 			{
-				common->Printf( "entity %i dynamic model exceeded reference bounds\n", def->index );
+				idBounds b = def->cachedDynamicModel->Bounds();
+				if(	b[0][0] < def->localReferenceBounds[0][0] - CHECK_BOUNDS_EPSILON ||
+						b[0][1] < def->localReferenceBounds[0][1] - CHECK_BOUNDS_EPSILON ||
+						b[0][2] < def->localReferenceBounds[0][2] - CHECK_BOUNDS_EPSILON ||
+						b[1][0] > def->localReferenceBounds[1][0] + CHECK_BOUNDS_EPSILON ||
+						b[1][1] > def->localReferenceBounds[1][1] + CHECK_BOUNDS_EPSILON ||
+						b[1][2] > def->localReferenceBounds[1][2] + CHECK_BOUNDS_EPSILON )
+				{
+					common->Printf( "entity %i dynamic model exceeded reference bounds\n", def->index );
+				}
 			}
 		}
 		
@@ -272,6 +815,61 @@ idRenderModel* R_EntityDefDynamicModel( idRenderEntityLocal* def )
 	return def->dynamicModel;
 }
 
+/*
+===================
+R_EvaluateMaterialRegisters
+
+The part of the material registers that only depends on time and the globalParms is
+evaluated once per view and shared by all surfaces of the material, only the ops that
+read the shaderParms or the sound amplitude are run again for each call.
+===================
+*/
+const float* R_EvaluateMaterialRegisters( const idMaterial* shader, const float shaderParms[MAX_ENTITY_SHADER_PARMS], int timeGroup, idSoundEmitter* soundEmitter )
+{
+	const float* constRegs = shader->ConstantRegisters();
+	if( constRegs != NULL )
+	{
+		return constRegs;
+	}
+	
+	const viewDef_t* viewDef = tr.viewDef;
+	const int numRegisters = shader->GetNumRegisters();
+	const float floatTime = viewDef->renderView.time[timeGroup] * 0.001f;
+	
+	const float* frameRegs = NULL;
+	const int index = shader->Index() * 2 + timeGroup;
+	if( index < viewDef->numMaterialRegisters )
+	{
+		frameRegs = viewDef->materialRegisters[index];
+		if( frameRegs == NULL )
+		{
+			float* regs = ( float* )R_FrameAlloc( numRegisters * sizeof( float ), FRAME_ALLOC_SHADER_REGISTER );
+			shader->EvaluateFrameRegisters( regs, viewDef->renderView.shaderParms, floatTime );
+			
+			// another job may have evaluated the same material meanwhile, keep the first one
+			void* published = Sys_InterlockedCompareExchangePointer( ( void*& )viewDef->materialRegisters[index], NULL, regs );
+			frameRegs = ( published != NULL ) ? ( const float* )published : regs;
+		}
+		if( !shader->RegistersDependOnEntity() )
+		{
+			return frameRegs;
+		}
+	}
+	
+	float* regs = ( float* )R_FrameAlloc( numRegisters * sizeof( float ), FRAME_ALLOC_SHADER_REGISTER );
+	if( frameRegs != NULL )
+	{
+		memcpy( regs, frameRegs, numRegisters * sizeof( float ) );
+	}
+	else
+	{
+		shader->EvaluateFrameRegisters( regs, viewDef->renderView.shaderParms, floatTime );
+	}
+	shader->EvaluateEntityRegisters( regs, shaderParms, soundEmitter );
+	
+	return regs;
+}
+
 /*
 ===================
 R_SetupDrawSurfShader
@@ -289,6 +887,11 @@ void R_SetupDrawSurfShader( drawSurf_t* drawSurf, const idMaterial* shader, cons
 		// shader only uses constant values
 		drawSurf->shaderRegisters = constRegs;
 	}
+	else if( !shader->RegistersDependOnEntity() )
+	{
+		// shared by every surface of the material in this view
+		drawSurf->shaderRegisters = R_EvaluateMaterialRegisters( shader, renderEntity->shaderParms, renderEntity->timeGroup, renderEntity->referenceSound );
+	}
 	else
 	{
 		// by default evaluate with the entityDef's shader parms
@@ -317,13 +920,45 @@ void R_SetupDrawSurfShader( drawSurf_t* drawSurf, const idMaterial* shader, cons
 			shaderParms = generatedShaderParms;
 		}
 		
-		// allocate frame memory for the shader register values
-		float* regs = ( float* )R_FrameAlloc( shader->GetNumRegisters() * sizeof( float ), FRAME_ALLOC_SHADER_REGISTER );
-		drawSurf->shaderRegisters = regs;
-		
 		// process the shader expressions for conditionals / color / texcoords
-		shader->EvaluateRegisters( regs, shaderParms, tr.viewDef->renderView.shaderParms,
-								   tr.viewDef->renderView.time[renderEntity->timeGroup] * 0.001f, renderEntity->referenceSound );
+		drawSurf->shaderRegisters = R_EvaluateMaterialRegisters( shader, shaderParms, renderEntity->timeGroup, renderEntity->referenceSound );
+	}
+}
+
+/*
+===================
+R_RecordImageUsage
+
+Gives the images of the material the projected size of the surface bounds, the image
+manager uses it to decide which mip levels have to be resident.
+===================
+*/
+static void R_RecordImageUsage( const idMaterial* shader, const idBounds& localBounds, const idVec3& localViewOrigin, const viewDef_t* viewDef )
+{
+	if( !image_mipStreaming.GetBool() )
+	{
+		return;
+	}
+	
+	idVec3 nearestPointOnBounds;
+	for( int i = 0; i < 3; i++ )
+	{
+		nearestPointOnBounds[i] = idMath::ClampFloat( localBounds[0][i], localBounds[1][i], localViewOrigin[i] );
+	}
+	const float distance = Max( ( nearestPointOnBounds - localViewOrigin ).LengthFast(), 1.0f );
+	const float size = ( localBounds[1] - localBounds[0] ).LengthFast();
+	
+	// projectionMatrix[0] is 1 / tan( fov_x / 2 )
+	const float halfWidth = ( viewDef->viewport.x2 - viewDef->viewport.x1 + 1 ) * 0.5f;
+	const int pixels = idMath::Ftoi( size * viewDef->projectionMatrix[0] * halfWidth / distance ) + 1;
+	
+	for( int i = 0; i < shader->GetNumStages(); i++ )
+	{
+		idImage* image = shader->GetStage( i )->texture.image;
+		if( image != NULL )
+		{
+			image->RecordScreenUsage( pixels );
+		}
 	}
 }
 
@@ -427,7 +1062,7 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 				if( vLight->entityInteractionState[entityIndex] == viewLight_t::INTERACTION_YES )
 				{
 					contactedLights[numContactedLights] = vLight;
-					staticInteractions[numContactedLights] = world->interactionTable[vLight->lightDef->index * world->interactionTableWidth + entityIndex];
+					staticInteractions[numContactedLights] = world->interactionTable.Find( vLight->lightDef->index, entityIndex );
 					if( ++numContactedLights == MAX_CONTACTED_LIGHTS )
 					{
 						break;
@@ -483,7 +1118,7 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 				}
 			}
 			contactedLights[numContactedLights] = vLight;
-			staticInteractions[numContactedLights] = world->interactionTable[vLight->lightDef->index * world->interactionTableWidth + entityIndex];
+			staticInteractions[numContactedLights] = world->interactionTable.Find( vLight->lightDef->index, entityIndex );
 			if( ++numContactedLights == MAX_CONTACTED_LIGHTS )
 			{
 				break;
@@ -740,6 +1375,8 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 				R_SetupDrawSurfShader( baseDrawSurf, shader, renderEntity );
 
 				shaderRegisters = baseDrawSurf->shaderRegisters;
+				
+				R_RecordImageUsage( shader, tri->bounds, localViewOrigin, viewDef );
 
 				// Check for deformations (eyeballs, flares, etc)
 				const deform_t shaderDeform = shader->Deform();
@@ -908,6 +1545,7 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 									dynamicShadowParms->shadowZMin = NULL;
 									dynamicShadowParms->shadowZMax = NULL;
 									dynamicShadowParms->shadowVolumeState = & lightDrawSurf->shadowVolumeState;
+									R_SetupDynamicShadowCache( entityDef, lightDef, tri, dynamicShadowParms );
 
 									lightDrawSurf->shadowVolumeState = SHADOWVOLUME_UNFINISHED;
 
@@ -1179,6 +1817,9 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 					if( dynamicShadowParms == NULL )
 					{
 						dynamicShadowParms = ( dynamicShadowVolumeParms_t* )R_FrameAlloc( sizeof( dynamicShadowParms[0] ), FRAME_ALLOC_SHADOW_VOLUME_PARMS );
+						dynamicShadowParms->lightIndices = NULL;
+						dynamicShadowParms->maxLightIndices = 0;
+						dynamicShadowParms->numLightIndices = NULL;
 					}
 					else
 					{
@@ -1220,6 +1861,7 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 					dynamicShadowParms->shadowZMin = & shadowDrawSurf->scissorRect.zmin;
 					dynamicShadowParms->shadowZMax = & shadowDrawSurf->scissorRect.zmax;
 					dynamicShadowParms->shadowVolumeState = & shadowDrawSurf->shadowVolumeState;
+					R_SetupDynamicShadowCache( entityDef, lightDef, tri, dynamicShadowParms );
 					
 					shadowDrawSurf->shadowVolumeState = SHADOWVOLUME_UNFINISHED;
 					
@@ -1305,6 +1947,9 @@ void R_AddModels()
 	
 	tr.viewDef->viewEntitys = R_SortViewEntities( tr.viewDef->viewEntitys );
 	
+	// entities hidden behind occluders are only added for their shadows
+	R_CullEntitiesToOccluders();
+	
 	//-------------------------------------------------
 	// Go through each view entity that is either visible to the view, or to
 	// any light that intersects the view (for shadows).
@@ -1376,6 +2021,8 @@ void R_AddModels()
 			int end = Sys_Microseconds();
 			backEnd.pc.shadowMicroSec += end - start;
 		}
+		
+		R_UpdateShadowCacheCounters();
 	}
 	
 	
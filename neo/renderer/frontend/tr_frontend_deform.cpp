@@ -945,6 +945,10 @@ static drawSurf_t* R_ParticleDeform( drawSurf_t* surf, bool useArea )
 	idTempArray<byte> tempIndex( ALIGN( maxQuads * 6 * sizeof( triIndex_t ), 16 ) );
 	triIndex_t* newIndexes = ( triIndex_t* ) tempIndex.Ptr();
 	
+	// every stage has at most maxQuads particles, each with its own origin and axis on the surface
+	idParticleBatch batch;
+	batch.SetMemory( R_FrameAlloc( idParticleBatch::StorageSize( maxQuads, true ) ), maxQuads, true );
+	
 	drawSurf_t* drawSurfList = NULL;
 	
 	for( int stageNum = 0; stageNum < particleSystem->stages.Num(); stageNum++ )
@@ -956,7 +960,7 @@ static drawSurf_t* R_ParticleDeform( drawSurf_t* surf, bool useArea )
 		
 		idParticleStage* stage = particleSystem->stages[stageNum];
 		
-		int numVerts = 0;
+		batch.Clear();
 		for( int currentTri = 0; currentTri < ( ( useArea ) ? 1 : numSourceTris ); currentTri++ )
 		{
 		
@@ -1057,17 +1061,14 @@ static drawSurf_t* R_ParticleDeform( drawSurf_t* surf, bool useArea )
 				g.axis[1] = v1.GetBiTangent() * f1 + v2.GetBiTangent() * f2 + v3.GetBiTangent() * f3;
 				g.axis[2] = v1.GetNormal() * f1 + v2.GetNormal() * f2 + v3.GetNormal() * f3;
 				
-				// this is needed so aimed particles can calculate origins at different times
-				g.originalRandom = g.random;
-				
-				g.age = g.frac * stage->particleLife;
-				
-				// if the particle doesn't get drawn because it is faded out or beyond a kill region,
-				// don't increment the verts
-				numVerts += stage->CreateParticle( &g, newVerts + numVerts );
+				batch.Append( g );
 			}
 		}
 		
+		// if a particle doesn't get drawn because it is faded out or beyond a kill region,
+		// it doesn't get any verts
+		const int numVerts = stage->CreateParticles( &g, batch, newVerts );
+		
 		if( numVerts == 0 )
 		{
 			continue;
@@ -248,6 +248,161 @@ FONT-END RENDERING
 ==========================================================================================
 */
 
+/*
+==========================================================================================
+
+DRAWSURF SORTING
+
+The draw surfs are sorted on a 48 bit key with a stable LSD radix sort, 8 bits per pass.
+The index of the draw surf is carried next to the key instead of inside it, so there is
+no limit on the number of draw surfs, and because the sort is stable surfaces with equal
+keys keep the order they were added in. Passes where all keys have the same digit are
+skipped, which is the common case for the upper bits of the sort value.
+
+Large lists are split into blocks that are keyed, counted and scattered by jobs.
+
+==========================================================================================
+*/
+
+idCVar r_sortDrawSurfsParallelMin( "r_sortDrawSurfsParallelMin", "4096", CVAR_RENDERER | CVAR_INTEGER, "sort the drawsurfs with jobs when there are at least this many, 0 = never" );
+
+static const int DRAWSURF_SORT_KEY_BITS			= 48;
+static const int DRAWSURF_SORT_RADIX_BITS		= 8;
+static const int DRAWSURF_SORT_BUCKETS			= 1 << DRAWSURF_SORT_RADIX_BITS;
+static const int DRAWSURF_SORT_PASSES			= DRAWSURF_SORT_KEY_BITS / DRAWSURF_SORT_RADIX_BITS;
+static const int MAX_DRAWSURF_SORT_JOBS			= 16;
+static const int MIN_DRAWSURFS_PER_SORT_JOB		= 1024;
+
+struct drawSurfSort_t
+{
+	drawSurf_t* const* 		drawSurfs;
+	uint64_t* 				keys[2];		// double buffered
+	int* 					indexes[2];
+	int						current;		// buffer holding the keys sorted by the previous passes
+	int						shift;			// digit of the current pass
+};
+
+struct drawSurfSortBlock_t
+{
+	drawSurfSort_t* 		sort;
+	int						first;
+	int						num;
+	int						counts[DRAWSURF_SORT_BUCKETS];	// digit counts, then scatter offsets
+};
+
+/*
+=================
+R_DrawSurfSortKey
+
+Sorted in ascending order this gives:
+1. sort value (smallest first)
+2. depth (largest first)
+=================
+*/
+static ID_INLINE uint64_t R_DrawSurfSortKey( const drawSurf_t* drawSurf )
+{
+	float sort = SS_POST_PROCESS - drawSurf->sort;
+	assert( sort >= 0.0f );
+	
+	uint64_t dist = 0;
+	if( drawSurf->frontEndGeo != NULL )
+	{
+		float min = 0.0f;
+		float max = 1.0f;
+		idRenderMatrix::DepthBoundsForBounds( min, max, drawSurf->space->mvp, drawSurf->frontEndGeo->bounds );
+		dist = idMath::Ftoui16( min * 0xFFFF );
+	}
+	
+	// the positive sort value sorts correctly as an integer, inverted so the largest comes first
+	const uint64_t key = ( ( uint64_t )( *( uint32_t* )&sort ) << 16 ) | dist;
+	return ~key & ( ( ( uint64_t )1 << DRAWSURF_SORT_KEY_BITS ) - 1 );
+}
+
+/*
+=================
+R_DrawSurfSortKeysJob
+=================
+*/
+static void R_DrawSurfSortKeysJob( drawSurfSortBlock_t* block )
+{
+	drawSurfSort_t* sort = block->sort;
+	uint64_t* keys = sort->keys[0];
+	int* indexes = sort->indexes[0];
+	
+	for( int i = block->first; i < block->first + block->num; i++ )
+	{
+		keys[i] = R_DrawSurfSortKey( sort->drawSurfs[i] );
+		indexes[i] = i;
+	}
+}
+
+REGISTER_PARALLEL_JOB( R_DrawSurfSortKeysJob, "R_DrawSurfSortKeysJob" );
+
+/*
+=================
+R_DrawSurfSortCountJob
+=================
+*/
+static void R_DrawSurfSortCountJob( drawSurfSortBlock_t* block )
+{
+	const drawSurfSort_t* sort = block->sort;
+	const uint64_t* keys = sort->keys[sort->current];
+	const int shift = sort->shift;
+	
+	memset( block->counts, 0, sizeof( block->counts ) );
+	for( int i = block->first; i < block->first + block->num; i++ )
+	{
+		block->counts[( keys[i] >> shift ) & ( DRAWSURF_SORT_BUCKETS - 1 )]++;
+	}
+}
+
+REGISTER_PARALLEL_JOB( R_DrawSurfSortCountJob, "R_DrawSurfSortCountJob" );
+
+/*
+=================
+R_DrawSurfSortScatterJob
+=================
+*/
+static void R_DrawSurfSortScatterJob( drawSurfSortBlock_t* block )
+{
+	const drawSurfSort_t* sort = block->sort;
+	const uint64_t* srcKeys = sort->keys[sort->current];
+	const int* srcIndexes = sort->indexes[sort->current];
+	uint64_t* dstKeys = sort->keys[sort->current ^ 1];
+	int* dstIndexes = sort->indexes[sort->current ^ 1];
+	const int shift = sort->shift;
+	
+	for( int i = block->first; i < block->first + block->num; i++ )
+	{
+		const uint64_t key = srcKeys[i];
+		const int offset = block->counts[( key >> shift ) & ( DRAWSURF_SORT_BUCKETS - 1 )]++;
+		dstKeys[offset] = key;
+		dstIndexes[offset] = srcIndexes[i];
+	}
+}
+
+REGISTER_PARALLEL_JOB( R_DrawSurfSortScatterJob, "R_DrawSurfSortScatterJob" );
+
+/*
+=================
+R_RunDrawSurfSortJobs
+=================
+*/
+static void R_RunDrawSurfSortJobs( jobRun_t function, drawSurfSortBlock_t* blocks, const int numBlocks )
+{
+	if( numBlocks == 1 )
+	{
+		function( &blocks[0] );
+		return;
+	}
+	for( int i = 0; i < numBlocks; i++ )
+	{
+		tr.frontEndJobList->AddJob( function, &blocks[i] );
+	}
+	tr.frontEndJobList->Submit();
+	tr.frontEndJobList->Wait();
+}
+
 /*
 =================
 R_SortDrawSurfs
@@ -257,98 +412,82 @@ static void R_SortDrawSurfs( drawSurf_t** drawSurfs, const int numDrawSurfs )
 {
 #if 1
 
-	uint64_t* indices = ( uint64_t* ) _alloca16( numDrawSurfs * sizeof( indices[0] ) );
+	if( numDrawSurfs <= 1 )
+	{
+		return;
+	}
 	
-	// sort the draw surfs based on:
-	// 1. sort value (largest first)
-	// 2. depth (smallest first)
-	// 3. index (largest first)
-	assert( numDrawSurfs <= 0xFFFF );
-	for( int i = 0; i < numDrawSurfs; i++ )
+	drawSurfSort_t sort;
+	sort.drawSurfs = drawSurfs;
+	sort.keys[0] = ( uint64_t* )R_FrameAlloc( numDrawSurfs * sizeof( uint64_t ), FRAME_ALLOC_DRAW_SURFACE_POINTER );
+	sort.keys[1] = ( uint64_t* )R_FrameAlloc( numDrawSurfs * sizeof( uint64_t ), FRAME_ALLOC_DRAW_SURFACE_POINTER );
+	sort.indexes[0] = ( int* )R_FrameAlloc( numDrawSurfs * sizeof( int ), FRAME_ALLOC_DRAW_SURFACE_POINTER );
+	sort.indexes[1] = ( int* )R_FrameAlloc( numDrawSurfs * sizeof( int ), FRAME_ALLOC_DRAW_SURFACE_POINTER );
+	sort.current = 0;
+	sort.shift = 0;
+	
+	int numBlocks = 1;
+	if( r_sortDrawSurfsParallelMin.GetInteger() > 0 && numDrawSurfs >= r_sortDrawSurfsParallelMin.GetInteger() )
 	{
-		float sort = SS_POST_PROCESS - drawSurfs[i]->sort;
-		assert( sort >= 0.0f );
-		
-		uint64_t dist = 0;
-		if( drawSurfs[i]->frontEndGeo != NULL )
-		{
-			float min = 0.0f;
-			float max = 1.0f;
-			idRenderMatrix::DepthBoundsForBounds( min, max, drawSurfs[i]->space->mvp, drawSurfs[i]->frontEndGeo->bounds );
-			dist = idMath::Ftoui16( min * 0xFFFF );
-		}
-		
-		indices[i] = ( ( numDrawSurfs - i ) & 0xFFFF ) | ( dist << 16 ) | ( ( uint64_t )( *( uint32_t* )&sort ) << 32 );
+		numBlocks = idMath::ClampInt( 1, MAX_DRAWSURF_SORT_JOBS, numDrawSurfs / MIN_DRAWSURFS_PER_SORT_JOB );
 	}
 	
-	const int64_t MAX_LEVELS = 128;
-	int64_t lo[MAX_LEVELS];
-	int64_t hi[MAX_LEVELS];
+	drawSurfSortBlock_t blocks[MAX_DRAWSURF_SORT_JOBS];
+	const int blockSize = ( numDrawSurfs + numBlocks - 1 ) / numBlocks;
+	for( int i = 0; i < numBlocks; i++ )
+	{
+		blocks[i].sort = &sort;
+		blocks[i].first = i * blockSize;
+		blocks[i].num = Min( blockSize, numDrawSurfs - blocks[i].first );
+	}
 	
-	// Keep the top of the stack in registers to avoid load-hit-stores.
-	int64_t st_lo = 0;
-	int64_t st_hi = numDrawSurfs - 1;
-	int64_t level = 0;
+	R_RunDrawSurfSortJobs( ( jobRun_t )R_DrawSurfSortKeysJob, blocks, numBlocks );
 	
-	for( ; ; )
+	for( int pass = 0; pass < DRAWSURF_SORT_PASSES; pass++ )
 	{
-		int64_t i = st_lo;
-		int64_t j = st_hi;
-		if( j - i >= 4 && level < MAX_LEVELS - 1 )
-		{
-			uint64_t pivot = indices[( i + j ) / 2];
-			do
-			{
-				while( indices[i] > pivot ) i++;
-				while( indices[j] < pivot ) j--;
-				if( i > j ) break;
-				uint64_t h = indices[i];
-				indices[i] = indices[j];
-				indices[j] = h;
-			}
-			while( ++i <= --j );
-			
-			// No need for these iterations because we are always sorting unique values.
-			//while ( indices[j] == pivot && st_lo < j ) j--;
-			//while ( indices[i] == pivot && i < st_hi ) i++;
-			
-			assert( level < MAX_LEVELS - 1 );
-			lo[level] = i;
-			hi[level] = st_hi;
-			st_hi = j;
-			level++;
-		}
-		else
+		sort.shift = pass * DRAWSURF_SORT_RADIX_BITS;
+		
+		R_RunDrawSurfSortJobs( ( jobRun_t )R_DrawSurfSortCountJob, blocks, numBlocks );
+		
+		// turn the counts into the offsets each block scatters to, the blocks of a
+		// digit are written in order, which keeps the sort stable
+		int offset = 0;
+		bool singleDigit = false;
+		for( int digit = 0; digit < DRAWSURF_SORT_BUCKETS; digit++ )
 		{
-			for( ; i < j; j-- )
+			const int start = offset;
+			for( int i = 0; i < numBlocks; i++ )
 			{
-				int64_t m = i;
-				for( int64_t k = i + 1; k <= j; k++ )
-				{
-					if( indices[k] < indices[m] )
-					{
-						m = k;
-					}
-				}
-				uint64_t h = indices[m];
-				indices[m] = indices[j];
-				indices[j] = h;
+				const int count = blocks[i].counts[digit];
+				blocks[i].counts[digit] = offset;
+				offset += count;
 			}
-			if( --level < 0 )
+			if( offset - start == numDrawSurfs )
 			{
+				singleDigit = true;
 				break;
 			}
-			st_lo = lo[level];
-			st_hi = hi[level];
 		}
+		
+		// all keys have the same digit, this pass wouldn't move anything
+		if( singleDigit )
+		{
+			continue;
+		}
+		
+		R_RunDrawSurfSortJobs( ( jobRun_t )R_DrawSurfSortScatterJob, blocks, numBlocks );
+		sort.current ^= 1;
 	}
 	
-	drawSurf_t** newDrawSurfs = ( drawSurf_t** ) indices;
+	// the unused key buffer holds a copy of the draw surf pointers while they are reordered
+	drawSurf_t** oldDrawSurfs = ( drawSurf_t** )sort.keys[sort.current ^ 1];
+	memcpy( oldDrawSurfs, drawSurfs, numDrawSurfs * sizeof( drawSurfs[0] ) );
+	
+	const int* indexes = sort.indexes[sort.current];
 	for( int i = 0; i < numDrawSurfs; i++ )
 	{
-		newDrawSurfs[i] = drawSurfs[numDrawSurfs - ( indices[i] & 0xFFFF )];
+		drawSurfs[i] = oldDrawSurfs[indexes[i]];
 	}
-	memcpy( drawSurfs, newDrawSurfs, numDrawSurfs * sizeof( drawSurfs[0] ) );
 	
 #else
 	
@@ -465,6 +604,16 @@ void R_RenderView( viewDef_t* parms )
 	
 	tr.viewDef = parms;
 	
+	// the shared material registers depend on the time and globalParms of the view,
+	// so a subview copied from its parent can't keep using the parent's
+	parms->materialRegisters = NULL;
+	parms->numMaterialRegisters = 0;
+	if( r_useSharedMaterialRegisters.GetBool() )
+	{
+		parms->numMaterialRegisters = declManager->GetNumDecls( DECL_MATERIAL ) * 2;
+		parms->materialRegisters = ( float** )R_ClearedFrameAlloc( parms->numMaterialRegisters * sizeof( float* ), FRAME_ALLOC_SHADER_REGISTER );
+	}
+	
 	// we need to set the projection matrix before doing
 	// portal-to-screen scissor calculations
 	if (!parms->isObliqueProjection)
@@ -502,6 +651,9 @@ void R_RenderView( viewDef_t* parms )
 	// wait for any shadow volume jobs from the previous frame to finish
 	tr.frontEndJobList->Wait();
 	
+	// draw the occluders of the visible areas for culling the lights and entities inside them
+	R_RenderOccluders();
+	
 	// make sure that interactions exist for all light / entity combinations that are visible
 	// add any pre-generated light shadows, and calculate the light shader values
 	R_AddLights();
@@ -0,0 +1,782 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#pragma hdrstop
+#include "precompiled.h"
+
+#include "tr_local.h"
+
+/*
+================================================================================================
+
+	Software occlusion culling
+
+	The portal flow only removes whole areas, so large areas and big walls inside an area
+	don't cull anything. After the visible areas are known, the occluder triangles of those
+	areas are drawn into a small depth buffer on the CPU, and the bounds of every visible
+	entity and light are tested against it before R_AddModels and R_AddLights do any work.
+
+	Occluders are picked when the map is loaded: large triangles of opaque world surfaces,
+	and every triangle of a material with the "occluder" keyword, which may also be nodraw
+	surfaces placed only for this purpose.
+
+	The buffer holds 1/w, which is linear in screen space, cleared to 0 (infinitely far).
+	Each 8x8 tile keeps the farthest value of its pixels so most bounds tests don't have to
+	look at the pixels. Triangle setup is done in jobs over blocks of triangles, and the
+	rasterization in jobs over rows of tiles.
+
+	Entities that are occluded keep casting shadows into the view, they are only changed
+	to the shadow only case, same as entities that were not seen through the portals.
+
+================================================================================================
+*/
+
+idCVar r_useSoftwareOcclusion( "r_useSoftwareOcclusion", "1", CVAR_RENDERER | CVAR_INTEGER, "cull entities and lights hidden behind world geometry, 0 = off, 1 = threaded, 2 = single threaded", 0, 2 );
+idCVar r_occluderMinArea( "r_occluderMinArea", "4096", CVAR_RENDERER | CVAR_FLOAT, "world triangles with a larger area are used as occluders, takes effect on map load" );
+idCVar r_showOcclusion( "r_showOcclusion", "0", CVAR_RENDERER | CVAR_BOOL, "print the number of occluder triangles and occluded entities and lights" );
+
+static const int OCCLUSION_TILE_SIZE		= 8;
+static const int OCCLUSION_WIDTH			= 256;
+static const int OCCLUSION_HEIGHT			= 144;
+static const int OCCLUSION_TILES_WIDE		= OCCLUSION_WIDTH / OCCLUSION_TILE_SIZE;
+static const int OCCLUSION_TILES_HIGH		= OCCLUSION_HEIGHT / OCCLUSION_TILE_SIZE;
+static const int OCCLUDERS_PER_SETUP_JOB	= 512;
+
+// occluder triangles of a portal area, built on map load
+struct occluderMesh_t
+{
+	int						numTris;
+	idVec3* 				verts;			// 3 per triangle
+	idPlane* 				planes;			// the positive side is the side the triangle is drawn from
+};
+
+// a triangle in buffer space, ready to rasterize
+struct occluderTri_t
+{
+	float					edgeA[3];		// edge equations, positive inside
+	float					edgeB[3];
+	float					edgeC[3];
+	float					depthA;			// 1/w plane equation
+	float					depthB;
+	float					depthC;
+	short					x1, y1;			// inclusive pixel bounds, x1 aligned to 4
+	short					x2, y2;
+};
+
+struct occluderSetupParms_t
+{
+	const occluderMesh_t* 	mesh;
+	int						firstTri;
+	int						numTris;
+	occluderTri_t* 			tris;			// room for two triangles per source triangle after near clipping
+	int						numOutTris;
+};
+
+struct occluderRasterParms_t
+{
+	int						tileRow;
+};
+
+static struct occlusionBuffer_t
+{
+	ALIGNTYPE16 float		depth[OCCLUSION_HEIGHT][OCCLUSION_WIDTH];
+	float					tileDepth[OCCLUSION_TILES_HIGH][OCCLUSION_TILES_WIDE];	// farthest pixel of each tile
+	
+	const viewDef_t* 		viewDef;		// the buffer is only valid for this view
+	idRenderMatrix			mvp;
+	idVec3					viewOrigin;
+	float					zNear;
+	
+	occluderSetupParms_t* 	setupParms;
+	int						numSetupParms;
+} occlusion;
+
+/*
+================================================================================================
+
+	Occluder selection
+
+================================================================================================
+*/
+
+/*
+===================
+R_IsOccluderSurface
+===================
+*/
+static bool R_IsOccluderSurface( const idMaterial* shader, bool& authored )
+{
+	authored = shader->TestMaterialFlag( MF_OCCLUDER );
+	if( authored )
+	{
+		return true;
+	}
+	if( !shader->IsDrawn() || shader->Coverage() != MC_OPAQUE )
+	{
+		return false;
+	}
+	if( shader->Deform() != DFRM_NONE || shader->HasSubview() || shader->HasGui() || shader->IsPortalSky() )
+	{
+		return false;
+	}
+	if( shader->TestMaterialFlag( MF_POLYGONOFFSET ) )
+	{
+		return false;
+	}
+	return true;
+}
+
+/*
+===================
+R_CreateAreaOccluders
+
+Collects the occluder triangles of a world area model.
+===================
+*/
+occluderMesh_t* R_CreateAreaOccluders( const idRenderModel* model )
+{
+	const float minArea = r_occluderMinArea.GetFloat();
+	
+	// count first so the mesh is a single allocation
+	int numTris = 0;
+	for( int pass = 0; pass < 2; pass++ )
+	{
+		occluderMesh_t* mesh = NULL;
+		if( pass == 1 )
+		{
+			if( numTris == 0 )
+			{
+				return NULL;
+			}
+			const int size = sizeof( occluderMesh_t ) + numTris * ( 3 * sizeof( idVec3 ) + sizeof( idPlane ) );
+			mesh = ( occluderMesh_t* )R_StaticAlloc( size, TAG_RENDER );
+			mesh->numTris = 0;
+			mesh->verts = ( idVec3* )( mesh + 1 );
+			mesh->planes = ( idPlane* )( mesh->verts + numTris * 3 );
+		}
+		
+		numTris = 0;
+		for( int i = 0; i < model->NumSurfaces(); i++ )
+		{
+			const modelSurface_t* surf = model->Surface( i );
+			const srfTriangles_t* tri = surf->geometry;
+			if( surf->shader == NULL || tri == NULL || tri->verts == NULL || tri->indexes == NULL )
+			{
+				continue;
+			}
+			
+			bool authored;
+			if( !R_IsOccluderSurface( surf->shader, authored ) )
+			{
+				continue;
+			}
+			
+			const cullType_t cullType = surf->shader->GetCullType();
+			
+			for( int j = 0; j + 2 < tri->numIndexes; j += 3 )
+			{
+				const idVec3& a = tri->verts[tri->indexes[j + 0]].xyz;
+				const idVec3& b = tri->verts[tri->indexes[j + 1]].xyz;
+				const idVec3& c = tri->verts[tri->indexes[j + 2]].xyz;
+				
+				// facing the same way as the shadow volume code
+				const idVec3 normal = ( c - a ).Cross( b - a );
+				const float area = normal.Length() * 0.5f;
+				if( area < idMath::FLT_SMALLEST_NON_DENORMAL || ( !authored && area < minArea ) )
+				{
+					continue;
+				}
+				
+				for( int side = 0; side < 2; side++ )
+				{
+					if( side == 0 && cullType == CT_BACK_SIDED )
+					{
+						continue;
+					}
+					if( side == 1 && cullType != CT_BACK_SIDED && cullType != CT_TWO_SIDED )
+					{
+						continue;
+					}
+					
+					if( mesh != NULL )
+					{
+						idVec3* v = &mesh->verts[numTris * 3];
+						idPlane& plane = mesh->planes[numTris];
+						v[0] = a;
+						v[1] = ( side == 0 ) ? b : c;
+						v[2] = ( side == 0 ) ? c : b;
+						plane.SetNormal( ( side == 0 ) ? normal : -normal );
+						plane.FitThroughPoint( a );
+					}
+					numTris++;
+				}
+			}
+		}
+		
+		if( mesh != NULL )
+		{
+			mesh->numTris = numTris;
+			return mesh;
+		}
+	}
+	return NULL;
+}
+
+/*
+===================
+R_FreeAreaOccluders
+===================
+*/
+void R_FreeAreaOccluders( occluderMesh_t* mesh )
+{
+	if( mesh != NULL )
+	{
+		R_StaticFree( mesh );
+	}
+}
+
+/*
+================================================================================================
+
+	Setup and rasterization
+
+================================================================================================
+*/
+
+/*
+===================
+R_SetupOccluderTri
+
+Takes a near clipped triangle in clip space, returns false if it doesn't cover a pixel center.
+===================
+*/
+static bool R_SetupOccluderTri( const idVec4& c0, const idVec4& c1, const idVec4& c2, occluderTri_t& out )
+{
+	const idVec4* clip[3] = { &c0, &c1, &c2 };
+	float x[3], y[3], z[3];
+	for( int i = 0; i < 3; i++ )
+	{
+		const float invW = 1.0f / clip[i]->w;
+		x[i] = ( clip[i]->x * invW * 0.5f + 0.5f ) * OCCLUSION_WIDTH;
+		y[i] = ( clip[i]->y * invW * 0.5f + 0.5f ) * OCCLUSION_HEIGHT;
+		z[i] = invW;
+	}
+	
+	const float minX = Min3( x[0], x[1], x[2] );
+	const float maxX = Max3( x[0], x[1], x[2] );
+	const float minY = Min3( y[0], y[1], y[2] );
+	const float maxY = Max3( y[0], y[1], y[2] );
+	
+	// pixel centers are at +0.5
+	const int x1 = Max( idMath::Ftoi( ceilf( minX - 0.5f ) ), 0 );
+	const int x2 = Min( idMath::Ftoi( floorf( maxX - 0.5f ) ), OCCLUSION_WIDTH - 1 );
+	const int y1 = Max( idMath::Ftoi( ceilf( minY - 0.5f ) ), 0 );
+	const int y2 = Min( idMath::Ftoi( floorf( maxY - 0.5f ) ), OCCLUSION_HEIGHT - 1 );
+	if( x1 > x2 || y1 > y2 )
+	{
+		return false;
+	}
+	
+	// the edge opposite of each vertex, so the edge values are barycentric weights
+	for( int i = 0; i < 3; i++ )
+	{
+		const int j = ( i + 1 ) % 3;
+		const int k = ( i + 2 ) % 3;
+		out.edgeA[i] = y[j] - y[k];
+		out.edgeB[i] = x[k] - x[j];
+		out.edgeC[i] = x[j] * y[k] - x[k] * y[j];
+	}
+	const float area = out.edgeA[0] * x[0] + out.edgeB[0] * y[0] + out.edgeC[0];
+	if( fabsf( area ) < 1e-4f )
+	{
+		return false;
+	}
+	
+	// the winding in buffer space depends on the projection, the facing was decided in world space
+	const float invArea = 1.0f / area;
+	for( int i = 0; i < 3; i++ )
+	{
+		out.edgeA[i] *= invArea;
+		out.edgeB[i] *= invArea;
+		out.edgeC[i] *= invArea;
+	}
+	
+	out.depthA = out.edgeA[0] * z[0] + out.edgeA[1] * z[1] + out.edgeA[2] * z[2];
+	out.depthB = out.edgeB[0] * z[0] + out.edgeB[1] * z[1] + out.edgeB[2] * z[2];
+	out.depthC = out.edgeC[0] * z[0] + out.edgeC[1] * z[1] + out.edgeC[2] * z[2];
+	
+	out.x1 = ( short )( x1 & ~3 );
+	out.y1 = ( short )y1;
+	out.x2 = ( short )x2;
+	out.y2 = ( short )y2;
+	return true;
+}
+
+/*
+===================
+R_SetupOccludersJob
+
+Transforms a block of occluder triangles, removes the back facing ones and clips them to the near plane.
+===================
+*/
+static void R_SetupOccludersJob( occluderSetupParms_t* parms )
+{
+	const idRenderMatrix& mvp = occlusion.mvp;
+	const float zNear = occlusion.zNear;
+	
+	parms->numOutTris = 0;
+	
+	for( int i = parms->firstTri; i < parms->firstTri + parms->numTris; i++ )
+	{
+		if( parms->mesh->planes[i].Distance( occlusion.viewOrigin ) <= 0.0f )
+		{
+			continue;
+		}
+		
+		const idVec3* v = &parms->mesh->verts[i * 3];
+		idVec4 clip[3];
+		int numInFront = 0;
+		for( int j = 0; j < 3; j++ )
+		{
+			mvp.TransformPoint( v[j], clip[j] );
+			numInFront += ( clip[j].w >= zNear );
+		}
+		
+		if( numInFront == 0 )
+		{
+			continue;
+		}
+		
+		if( numInFront == 3 )
+		{
+			if( R_SetupOccluderTri( clip[0], clip[1], clip[2], parms->tris[parms->numOutTris] ) )
+			{
+				parms->numOutTris++;
+			}
+			continue;
+		}
+		
+		// clip the triangle to the near plane, gives a triangle or a quad
+		idVec4 poly[4];
+		int numPoly = 0;
+		for( int j = 0; j < 3; j++ )
+		{
+			const idVec4& a = clip[j];
+			const idVec4& b = clip[( j + 1 ) % 3];
+			const bool aIn = ( a.w >= zNear );
+			const bool bIn = ( b.w >= zNear );
+			if( aIn )
+			{
+				poly[numPoly++] = a;
+			}
+			if( aIn != bIn )
+			{
+				const float f = ( zNear - a.w ) / ( b.w - a.w );
+				poly[numPoly++] = a + ( b - a ) * f;
+			}
+		}
+		
+		for( int j = 2; j < numPoly; j++ )
+		{
+			if( R_SetupOccluderTri( poly[0], poly[j - 1], poly[j], parms->tris[parms->numOutTris] ) )
+			{
+				parms->numOutTris++;
+			}
+		}
+	}
+}
+
+REGISTER_PARALLEL_JOB( R_SetupOccludersJob, "R_SetupOccludersJob" );
+
+/*
+===================
+R_RasterizeOccludersJob
+
+Draws every occluder triangle that touches one row of tiles, four pixels at a time,
+then updates the farthest depth of the tiles.
+===================
+*/
+static void R_RasterizeOccludersJob( occluderRasterParms_t* parms )
+{
+	const int rowStart = parms->tileRow * OCCLUSION_TILE_SIZE;
+	const int rowEnd = rowStart + OCCLUSION_TILE_SIZE - 1;
+	
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 pixelCenters = _mm_setr_ps( 0.5f, 1.5f, 2.5f, 3.5f );
+	
+	for( int y = rowStart; y <= rowEnd; y++ )
+	{
+		float* row = occlusion.depth[y];
+		for( int x = 0; x < OCCLUSION_WIDTH; x += 4 )
+		{
+			_mm_store_ps( row + x, zero );
+		}
+	}
+	
+	for( int p = 0; p < occlusion.numSetupParms; p++ )
+	{
+		const occluderSetupParms_t& setup = occlusion.setupParms[p];
+		for( int t = 0; t < setup.numOutTris; t++ )
+		{
+			const occluderTri_t& tri = setup.tris[t];
+			const int y1 = Max( ( int )tri.y1, rowStart );
+			const int y2 = Min( ( int )tri.y2, rowEnd );
+			if( y1 > y2 )
+			{
+				continue;
+			}
+			
+			const __m128 a0 = _mm_set1_ps( tri.edgeA[0] );
+			const __m128 a1 = _mm_set1_ps( tri.edgeA[1] );
+			const __m128 a2 = _mm_set1_ps( tri.edgeA[2] );
+			const __m128 da = _mm_set1_ps( tri.depthA );
+			
+			for( int y = y1; y <= y2; y++ )
+			{
+				const float fy = y + 0.5f;
+				const __m128 e0y = _mm_set1_ps( tri.edgeB[0] * fy + tri.edgeC[0] );
+				const __m128 e1y = _mm_set1_ps( tri.edgeB[1] * fy + tri.edgeC[1] );
+				const __m128 e2y = _mm_set1_ps( tri.edgeB[2] * fy + tri.edgeC[2] );
+				const __m128 dy = _mm_set1_ps( tri.depthB * fy + tri.depthC );
+				
+				float* row = occlusion.depth[y];
+				for( int x = tri.x1; x <= tri.x2; x += 4 )
+				{
+					const __m128 fx = _mm_add_ps( _mm_set1_ps( ( float )x ), pixelCenters );
+					
+					const __m128 e0 = _mm_add_ps( _mm_mul_ps( a0, fx ), e0y );
+					const __m128 e1 = _mm_add_ps( _mm_mul_ps( a1, fx ), e1y );
+					const __m128 e2 = _mm_add_ps( _mm_mul_ps( a2, fx ), e2y );
+					const __m128 inside = _mm_and_ps( _mm_and_ps( _mm_cmpge_ps( e0, zero ), _mm_cmpge_ps( e1, zero ) ), _mm_cmpge_ps( e2, zero ) );
+					
+					// the pixels outside get 0, which never replaces anything
+					const __m128 depth = _mm_and_ps( inside, _mm_add_ps( _mm_mul_ps( da, fx ), dy ) );
+					_mm_store_ps( row + x, _mm_max_ps( _mm_load_ps( row + x ), depth ) );
+				}
+			}
+		}
+	}
+	
+	// farthest depth of each tile in this row
+	for( int tx = 0; tx < OCCLUSION_TILES_WIDE; tx++ )
+	{
+		__m128 farthest = _mm_load_ps( &occlusion.depth[rowStart][tx * OCCLUSION_TILE_SIZE] );
+		for( int y = rowStart; y <= rowEnd; y++ )
+		{
+			farthest = _mm_min_ps( farthest, _mm_load_ps( &occlusion.depth[y][tx * OCCLUSION_TILE_SIZE + 0] ) );
+			farthest = _mm_min_ps( farthest, _mm_load_ps( &occlusion.depth[y][tx * OCCLUSION_TILE_SIZE + 4] ) );
+		}
+		farthest = _mm_min_ps( farthest, _mm_shuffle_ps( farthest, farthest, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+		farthest = _mm_min_ps( farthest, _mm_shuffle_ps( farthest, farthest, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+		_mm_store_ss( &occlusion.tileDepth[parms->tileRow][tx], farthest );
+	}
+}
+
+REGISTER_PARALLEL_JOB( R_RasterizeOccludersJob, "R_RasterizeOccludersJob" );
+
+/*
+===================
+R_RenderOccluders
+
+Draws the occluders of all areas that were reached by the portal flow of the current view.
+===================
+*/
+void R_RenderOccluders()
+{
+	occlusion.viewDef = NULL;
+	
+	const viewDef_t* viewDef = tr.viewDef;
+	if( r_useSoftwareOcclusion.GetInteger() == 0 || viewDef->isSubview || viewDef->isXraySubview || viewDef->isEditor || viewDef->is2Dgui )
+	{
+		return;
+	}
+	
+	const idRenderWorldLocal* world = static_cast<const idRenderWorldLocal*>( viewDef->renderWorld );
+	if( world == NULL || world->portalAreas == NULL )
+	{
+		return;
+	}
+	
+	SCOPED_PROFILE_EVENT( "R_RenderOccluders" );
+	
+	const int start = Sys_Microseconds();
+	
+	occlusion.mvp = viewDef->worldSpace.mvp;
+	occlusion.viewOrigin = viewDef->renderView.vieworg;
+	occlusion.zNear = ( viewDef->renderView.cramZNear ) ? ( r_znear.GetFloat() * 0.25f ) : r_znear.GetFloat();
+	
+	// split the occluders of the visible areas into blocks for the setup jobs
+	int numSetupParms = 0;
+	int numSourceTris = 0;
+	for( int i = 0; i < world->numPortalAreas; i++ )
+	{
+		const portalArea_t& area = world->portalAreas[i];
+		if( area.viewCount == tr.viewCount && area.occluders != NULL )
+		{
+			numSetupParms += ( area.occluders->numTris + OCCLUDERS_PER_SETUP_JOB - 1 ) / OCCLUDERS_PER_SETUP_JOB;
+			numSourceTris += area.occluders->numTris;
+		}
+	}
+	
+	occlusion.setupParms = ( occluderSetupParms_t* )R_FrameAlloc( Max( numSetupParms, 1 ) * sizeof( occluderSetupParms_t ), FRAME_ALLOC_UNKNOWN );
+	occlusion.numSetupParms = numSetupParms;
+	occluderTri_t* tris = ( occluderTri_t* )R_FrameAlloc( Max( numSourceTris * 2, 1 ) * sizeof( occluderTri_t ), FRAME_ALLOC_UNKNOWN );
+	
+	numSetupParms = 0;
+	for( int i = 0; i < world->numPortalAreas; i++ )
+	{
+		const portalArea_t& area = world->portalAreas[i];
+		if( area.viewCount != tr.viewCount || area.occluders == NULL )
+		{
+			continue;
+		}
+		for( int first = 0; first < area.occluders->numTris; first += OCCLUDERS_PER_SETUP_JOB )
+		{
+			occluderSetupParms_t& parms = occlusion.setupParms[numSetupParms++];
+			parms.mesh = area.occluders;
+			parms.firstTri = first;
+			parms.numTris = Min( area.occluders->numTris - first, OCCLUDERS_PER_SETUP_JOB );
+			parms.tris = tris;
+			parms.numOutTris = 0;
+			tris += parms.numTris * 2;
+		}
+	}
+	
+	occluderRasterParms_t rasterParms[OCCLUSION_TILES_HIGH];
+	for( int i = 0; i < OCCLUSION_TILES_HIGH; i++ )
+	{
+		rasterParms[i].tileRow = i;
+	}
+	
+	if( r_useSoftwareOcclusion.GetInteger() == 1 )
+	{
+		for( int i = 0; i < occlusion.numSetupParms; i++ )
+		{
+			tr.frontEndJobList->AddJob( ( jobRun_t )R_SetupOccludersJob, &occlusion.setupParms[i] );
+		}
+		tr.frontEndJobList->Submit();
+		tr.frontEndJobList->Wait();
+		
+		for( int i = 0; i < OCCLUSION_TILES_HIGH; i++ )
+		{
+			tr.frontEndJobList->AddJob( ( jobRun_t )R_RasterizeOccludersJob, &rasterParms[i] );
+		}
+		tr.frontEndJobList->Submit();
+		tr.frontEndJobList->Wait();
+	}
+	else
+	{
+		for( int i = 0; i < occlusion.numSetupParms; i++ )
+		{
+			R_SetupOccludersJob( &occlusion.setupParms[i] );
+		}
+		for( int i = 0; i < OCCLUSION_TILES_HIGH; i++ )
+		{
+			R_RasterizeOccludersJob( &rasterParms[i] );
+		}
+	}
+	
+	for( int i = 0; i < occlusion.numSetupParms; i++ )
+	{
+		tr.pc.c_occluderTris += occlusion.setupParms[i].numOutTris;
+	}
+	
+	occlusion.viewDef = viewDef;
+	
+	tr.pc.occlusionMicroSec += Sys_Microseconds() - start;
+}
+
+/*
+================================================================================================
+
+	Culling
+
+================================================================================================
+*/
+
+/*
+===================
+R_CullBoundsToOccluders
+
+Returns true if the bounds are completely behind the occluders of the current view.
+===================
+*/
+bool R_CullBoundsToOccluders( const idBounds& bounds )
+{
+	if( occlusion.viewDef != tr.viewDef )
+	{
+		return false;
+	}
+	
+	float minX = idMath::INFINITY;
+	float minY = idMath::INFINITY;
+	float maxX = -idMath::INFINITY;
+	float maxY = -idMath::INFINITY;
+	float minW = idMath::INFINITY;
+	for( int i = 0; i < 8; i++ )
+	{
+		const idVec3 corner( bounds[( i >> 0 ) & 1][0], bounds[( i >> 1 ) & 1][1], bounds[( i >> 2 ) & 1][2] );
+		idVec4 clip;
+		occlusion.mvp.TransformPoint( corner, clip );
+		if( clip.w < occlusion.zNear )
+		{
+			// crosses the near plane, the view may be inside
+			return false;
+		}
+		const float invW = 1.0f / clip.w;
+		const float x = ( clip.x * invW * 0.5f + 0.5f ) * OCCLUSION_WIDTH;
+		const float y = ( clip.y * invW * 0.5f + 0.5f ) * OCCLUSION_HEIGHT;
+		minX = Min( minX, x );
+		maxX = Max( maxX, x );
+		minY = Min( minY, y );
+		maxY = Max( maxY, y );
+		minW = Min( minW, clip.w );
+	}
+	
+	// one extra pixel on all sides, the occluders only cover the pixel centers
+	const int x1 = Max( idMath::Ftoi( floorf( minX ) ) - 1, 0 );
+	const int x2 = Min( idMath::Ftoi( floorf( maxX ) ) + 1, OCCLUSION_WIDTH - 1 );
+	const int y1 = Max( idMath::Ftoi( floorf( minY ) ) - 1, 0 );
+	const int y2 = Min( idMath::Ftoi( floorf( maxY ) ) + 1, OCCLUSION_HEIGHT - 1 );
+	if( x1 > x2 || y1 > y2 )
+	{
+		return false;
+	}
+	
+	// the closest point of the bounds, a little closer for precision
+	const float nearest = 1.001f / minW;
+	const __m128 nearestV = _mm_set1_ps( nearest );
+	const __m128 lanes = _mm_setr_ps( 0.0f, 1.0f, 2.0f, 3.0f );
+	
+	for( int ty = y1 / OCCLUSION_TILE_SIZE; ty <= y2 / OCCLUSION_TILE_SIZE; ty++ )
+	{
+		for( int tx = x1 / OCCLUSION_TILE_SIZE; tx <= x2 / OCCLUSION_TILE_SIZE; tx++ )
+		{
+			if( occlusion.tileDepth[ty][tx] > nearest )
+			{
+				// every pixel of the tile is in front of the bounds
+				continue;
+			}
+			
+			// test the pixels of the tile that are inside the rectangle
+			const int px1 = Max( tx * OCCLUSION_TILE_SIZE, x1 );
+			const int px2 = Min( tx * OCCLUSION_TILE_SIZE + OCCLUSION_TILE_SIZE - 1, x2 );
+			const int py1 = Max( ty * OCCLUSION_TILE_SIZE, y1 );
+			const int py2 = Min( ty * OCCLUSION_TILE_SIZE + OCCLUSION_TILE_SIZE - 1, y2 );
+			const __m128 lo = _mm_set1_ps( ( float )px1 );
+			const __m128 hi = _mm_set1_ps( ( float )px2 );
+			
+			for( int y = py1; y <= py2; y++ )
+			{
+				for( int x = px1 & ~3; x <= px2; x += 4 )
+				{
+					const __m128 fx = _mm_add_ps( _mm_set1_ps( ( float )x ), lanes );
+					const __m128 used = _mm_and_ps( _mm_cmpge_ps( fx, lo ), _mm_cmple_ps( fx, hi ) );
+					const __m128 behind = _mm_cmple_ps( _mm_load_ps( &occlusion.depth[y][x] ), nearestV );
+					if( _mm_movemask_ps( _mm_and_ps( used, behind ) ) != 0 )
+					{
+						return false;
+					}
+				}
+			}
+		}
+	}
+	
+	return true;
+}
+
+/*
+===================
+R_CullEntitiesToOccluders
+
+Changes the visible entities that are completely occluded to shadow only entities.
+===================
+*/
+void R_CullEntitiesToOccluders()
+{
+	if( occlusion.viewDef != tr.viewDef )
+	{
+		return;
+	}
+	
+	const int start = Sys_Microseconds();
+	
+	for( viewEntity_t* vEntity = tr.viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next )
+	{
+		if( vEntity->scissorRect.IsEmpty() )
+		{
+			continue;
+		}
+		
+		const idRenderEntityLocal* def = vEntity->entityDef;
+		if( def->parms.weaponDepthHack || def->parms.modelDepthHack != 0.0f )
+		{
+			continue;
+		}
+		
+		if( R_CullBoundsToOccluders( def->globalReferenceBounds ) )
+		{
+			vEntity->scissorRect.Clear();
+			tr.pc.c_occludedEntities++;
+		}
+	}
+	
+	tr.pc.occlusionMicroSec += Sys_Microseconds() - start;
+}
+
+/*
+===================
+R_CullLightsToOccluders
+
+Removes the lights that only touch occluded space from the view light list.
+===================
+*/
+void R_CullLightsToOccluders()
+{
+	if( occlusion.viewDef != tr.viewDef )
+	{
+		return;
+	}
+	
+	const int start = Sys_Microseconds();
+	
+	viewLight_t** ptr = &tr.viewDef->viewLights;
+	while( *ptr != NULL )
+	{
+		viewLight_t* vLight = *ptr;
+		if( R_CullBoundsToOccluders( vLight->lightDef->globalLightBounds ) )
+		{
+			vLight->lightDef->viewCount = -1;
+			*ptr = vLight->next;
+			tr.pc.c_occludedLights++;
+			continue;
+		}
+		ptr = &vLight->next;
+	}
+	
+	tr.pc.occlusionMicroSec += Sys_Microseconds() - start;
+}
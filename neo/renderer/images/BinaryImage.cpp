@@ -47,6 +47,26 @@ idCVar image_highQualityCompression( "image_highQualityCompression", "1", CVAR_B
 
 idCVar r_useHightQualitySky( "r_useHightQualitySky", "0", CVAR_BOOL | CVAR_ARCHIVE, "Use high quality skyboxes" );
 
+/*
+========================
+R_CompressImageDXT
+
+Splits the compression in bands over the job threads when the image manager's compress job list is free.
+========================
+*/
+static void R_CompressImageDXT( idDxtEncoder::compressFunc_t func, const byte* inBuf, byte* outBuf, int width, int height, int blockSize )
+{
+	idDxtEncoder dxt;
+	idParallelJobList* jobList = globalImages->LockCompressJobList();
+	
+	dxt.CompressImageParallel( jobList, func, inBuf, outBuf, width, height, blockSize );
+	
+	if( jobList != nullptr )
+	{
+		globalImages->UnlockCompressJobList();
+	}
+}
+
 /*
 ========================
 idBinaryImage::Load2DFromMemory
@@ -148,25 +168,23 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 		// compress data or convert floats as necessary
 		if( textureFormat == FMT_DXT1 )
 		{
-			idDxtEncoder dxt;
 			img.Alloc( dxtWidth * dxtHeight / 2 );
 			if( image_highQualityCompression.GetBool() && !toolUsage )
 			{
 				commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - DXT1Fast", width, height ) );
 
 				//dxt.CompressImageDXT1HQ( dxtPic, img.data, dxtWidth, dxtHeight );
-				dxt.CompressImageDXT1Fast( dxtPic, img.data, dxtWidth, dxtHeight );
+				R_CompressImageDXT( &idDxtEncoder::CompressImageDXT1Fast, dxtPic, img.data, dxtWidth, dxtHeight, 8 );
 			}
 			else
 			{
 				commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - DXT1Fast", width, height ) );
 
-				dxt.CompressImageDXT1Fast( dxtPic, img.data, dxtWidth, dxtHeight );
+				R_CompressImageDXT( &idDxtEncoder::CompressImageDXT1Fast, dxtPic, img.data, dxtWidth, dxtHeight, 8 );
 			}
 		}
 		else if( textureFormat == FMT_DXT5 )
 		{
-			idDxtEncoder dxt;
 			img.Alloc( dxtWidth * dxtHeight );
 			if( colorFormat == CFM_NORMAL_DXT5 )
 			{
@@ -174,13 +192,13 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 				{
 					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - NormalMapDXT5HQ", width, height ) );
 
-					dxt.CompressNormalMapDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
+					R_CompressImageDXT( &idDxtEncoder::CompressNormalMapDXT5HQ, dxtPic, img.data, dxtWidth, dxtHeight, 16 );
 				}
 				else
 				{
 					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - NormalMapDXT5Fast", width, height ) );
 
-					dxt.CompressNormalMapDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
+					R_CompressImageDXT( &idDxtEncoder::CompressNormalMapDXT5Fast, dxtPic, img.data, dxtWidth, dxtHeight, 16 );
 				}
 			}
 			else if( colorFormat == CFM_YCOCG_DXT5 )
@@ -189,13 +207,13 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 				{
 					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - YCoCgDXT5HQ", width, height ) );
 
-					dxt.CompressYCoCgDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
+					R_CompressImageDXT( &idDxtEncoder::CompressYCoCgDXT5HQ, dxtPic, img.data, dxtWidth, dxtHeight, 16 );
 				}
 				else
 				{
 					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - YCoCgDXT5Fast", width, height ) );
 
-					dxt.CompressYCoCgDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
+					R_CompressImageDXT( &idDxtEncoder::CompressYCoCgDXT5Fast, dxtPic, img.data, dxtWidth, dxtHeight, 16 );
 				}
 			}
 			else
@@ -206,13 +224,13 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - DXT5Fast", width, height ) );
 
 					//dxt.CompressImageDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
-					dxt.CompressImageDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
+					R_CompressImageDXT( &idDxtEncoder::CompressImageDXT5Fast, dxtPic, img.data, dxtWidth, dxtHeight, 16 );
 				}
 				else
 				{
 					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - DXT5Fast", width, height ) );
 
-					dxt.CompressImageDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
+					R_CompressImageDXT( &idDxtEncoder::CompressImageDXT5Fast, dxtPic, img.data, dxtWidth, dxtHeight, 16 );
 				}
 			}
 		}
@@ -431,19 +449,18 @@ void idBinaryImage::LoadCubeFromMemory( int width, const byte* pics[6], int numL
 			img.Alloc( padSize * padSize * 4 );
 						
 			if( usage == TD_LOWQUALITY_CUBE ) { // motorsep 05-17-2015; check for uncompressed token
-				idDxtEncoder dxt;
 				common->Printf( "material token is SOMETHING ELSE" );
 				if( image_highQualityCompression.GetBool() ) {
 					commonLocal.LoadPacifierBinarizeInfo( va( "cube (%d) YCoCgDXT5HQ", width ) );
 
 					//dxt.CompressYCoCgDXT5HQ( dxtPic, img.data, padSize, padSize ); // padSrc was dxtPic
 					// dxt.CompressImageDXT5HQ( dxtPic, img.data, padSize, padSize );
-					dxt.CompressImageDXT5Fast( dxtPic, img.data, padSize, padSize ); // FIX ME: don't forget to set it back to DXT5HQ compressor for the release
+					R_CompressImageDXT( &idDxtEncoder::CompressImageDXT5Fast, dxtPic, img.data, padSize, padSize, 16 ); // FIX ME: don't forget to set it back to DXT5HQ compressor for the release
 				} else {
 					commonLocal.LoadPacifierBinarizeInfo( va( "cube (%d) YCoCgDXT5Fast", width ) );
 
 					//dxt.CompressYCoCgDXT5Fast( dxtPic, img.data, padSize, padSize ); // padSrc was dxtPic					
-					dxt.CompressImageDXT5Fast( dxtPic, img.data, padSize, padSize );
+					R_CompressImageDXT( &idDxtEncoder::CompressImageDXT5Fast, dxtPic, img.data, padSize, padSize, 16 );
 				}
 			} 
 			else if( usage == TD_HIGHQUALITY_CUBE ) { // motorsep 05-17-2015; do not compress cubemaps if we have material tocken "uncompressed", etc.			
@@ -676,3 +693,101 @@ void idBinaryImage::GetGeneratedFileName( idStr& gfn, const char* name, bool too
 }
 
 
+
+/*
+========================
+dxtBenchmark
+
+Compresses a generated image with every fast DXT encoder using SSE2, AVX2 and parallel bands,
+verifies the results are identical and reports the throughput.
+========================
+*/
+CONSOLE_COMMAND( dxtBenchmark, "compares and times the SSE2, AVX2 and parallel DXT encoders, usage: dxtBenchmark [size] [passes]", 0 )
+{
+	const int size = ( args.Argc() > 1 ) ? Max( 4, atoi( args.Argv( 1 ) ) & ~3 ) : 1024;
+	const int passes = ( args.Argc() > 2 ) ? Max( 1, atoi( args.Argv( 2 ) ) ) : 4;
+	
+	static const struct
+	{
+		const char*						name;
+		idDxtEncoder::compressFunc_t	sse2;
+		idDxtEncoder::compressFunc_t	avx2;
+		int								blockSize;
+	} encoders[] =
+	{
+		{ "DXT1Fast", &idDxtEncoder::CompressImageDXT1Fast_SSE2, &idDxtEncoder::CompressImageDXT1Fast_AVX2, 8 },
+		{ "DXT5Fast", &idDxtEncoder::CompressImageDXT5Fast_SSE2, &idDxtEncoder::CompressImageDXT5Fast_AVX2, 16 },
+		{ "YCoCgDXT5Fast", &idDxtEncoder::CompressYCoCgDXT5Fast_SSE2, &idDxtEncoder::CompressYCoCgDXT5Fast_AVX2, 16 },
+		{ "NormalMapDXT5Fast", &idDxtEncoder::CompressNormalMapDXT5Fast_SSE2, &idDxtEncoder::CompressNormalMapDXT5Fast_AVX2, 16 },
+	};
+	
+	// smooth gradients with some noise, so the blocks don't all take the same path
+	byte* pic = ( byte* )Mem_Alloc( size * size * 4, TAG_TEMP );
+	idRandom random( 0 );
+	for( int y = 0; y < size; y++ )
+	{
+		for( int x = 0; x < size; x++ )
+		{
+			byte* p = pic + ( y * size + x ) * 4;
+			p[0] = ( byte )( x * 255 / size + random.RandomInt( 16 ) );
+			p[1] = ( byte )( y * 255 / size + random.RandomInt( 16 ) );
+			p[2] = ( byte )( ( x ^ y ) + random.RandomInt( 8 ) );
+			p[3] = ( byte )( ( ( x >> 3 ) & 1 ) ? 255 : random.RandomInt( 256 ) );
+		}
+	}
+	
+	const bool hasAVX2 = idDxtEncoder::HasAVX2();
+	const int maxOutSize = ( size / 4 ) * ( size / 4 ) * 16;
+	byte* reference = ( byte* )Mem_Alloc( maxOutSize, TAG_TEMP );
+	byte* result = ( byte* )Mem_Alloc( maxOutSize, TAG_TEMP );
+	
+	idLib::Printf( "dxtBenchmark: %d x %d, %d passes, AVX2 %s\n", size, size, passes, hasAVX2 ? "enabled" : "not supported" );
+	
+	idSysInterlockedInteger progress;
+	for( int i = 0; i < sizeof( encoders ) / sizeof( encoders[0] ); i++ )
+	{
+		const int outSize = ( size / 4 ) * ( size / 4 ) * encoders[i].blockSize;
+		uint64_t times[3] = { 0, 0, 0 };
+		bool match = true;
+		
+		for( int pass = 0; pass < passes; pass++ )
+		{
+			idDxtEncoder dxt;
+			dxt.SetProgressCounter( &progress );
+			
+			uint64_t start = Sys_Microseconds();
+			( dxt.*encoders[i].sse2 )( pic, reference, size, size );
+			times[0] += Sys_Microseconds() - start;
+			
+			if( hasAVX2 )
+			{
+				start = Sys_Microseconds();
+				( dxt.*encoders[i].avx2 )( pic, result, size, size );
+				times[1] += Sys_Microseconds() - start;
+				match &= ( memcmp( reference, result, outSize ) == 0 );
+			}
+			
+			idParallelJobList* jobList = globalImages->LockCompressJobList();
+			start = Sys_Microseconds();
+			dxt.CompressImageParallel( jobList, hasAVX2 ? encoders[i].avx2 : encoders[i].sse2, pic, result, size, size, encoders[i].blockSize );
+			times[2] += Sys_Microseconds() - start;
+			if( jobList != nullptr )
+			{
+				globalImages->UnlockCompressJobList();
+			}
+			match &= ( memcmp( reference, result, outSize ) == 0 );
+		}
+		
+		const double megaPixels = ( double ) size * size * passes / ( 1000.0 * 1000.0 );
+		idLib::Printf( "  %-18s SSE2 %8.2f MP/s", encoders[i].name, megaPixels / Max( times[0], ( uint64_t )1 ) * 1000000.0 );
+		if( hasAVX2 )
+		{
+			idLib::Printf( "  AVX2 %8.2f MP/s", megaPixels / Max( times[1], ( uint64_t )1 ) * 1000000.0 );
+		}
+		idLib::Printf( "  parallel %8.2f MP/s  %s\n", megaPixels / Max( times[2], ( uint64_t )1 ) * 1000000.0, match ? "[^2OK^0]" : "[^1MISMATCH^0]" );
+	}
+	
+	Mem_Free( result );
+	Mem_Free( reference );
+	Mem_Free( pic );
+}
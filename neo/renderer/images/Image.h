@@ -96,6 +96,14 @@ typedef enum
 
 #define	MAX_IMAGE_NAME	256
 
+// residency of the image data, only tracked for images that are loaded from files
+enum imageResidency_t
+{
+	IMAGE_NOT_RESIDENT,
+	IMAGE_PENDING,			// queued for the background loader, a placeholder is bound instead
+	IMAGE_RESIDENT
+};
+
 class idImage
 {
 public:
@@ -175,6 +183,38 @@ public:
 		levelLoadReferenced = true;
 	}
 	void		ActuallyLoadImage( bool fromBackEnd );
+	
+	// ActuallyLoadImage split for the background loader, Begin and Finish are called on the
+	// main thread and the generated file is read on the loader thread in between
+	bool		BeginBackgroundLoad( idStr& generatedName, ID_TIME_T& sourceTime, bool& toolUsage );
+	void		FinishBackgroundLoad( idBinaryImage& im, ID_TIME_T binaryTime );
+	
+	imageResidency_t	GetResidency() const
+	{
+		return residency;
+	}
+	textureUsage_t		GetUsage() const
+	{
+		return usage;
+	}
+	
+	// called by the frontend with the projected size in pixels of every visible surface the
+	// image is drawn on, safe to call from the frontend jobs
+	void		RecordScreenUsage( int pixels );
+	
+	// number of top mip levels that were left out of the upload
+	int			GetResidentMipLevel() const
+	{
+		return residentMip;
+	}
+	int			GetScreenUsage() const
+	{
+		return usageSize;
+	}
+	int			GetLastReferencedFrame() const
+	{
+		return lastReferencedFrame;
+	}
 	//---------------------------------------------
 	// Platform specific implementations
 	//---------------------------------------------
@@ -228,6 +268,11 @@ private:
 	void				AllocImage();
 	void				DeriveOpts();
 	
+	void				LoadSourceFileTime();
+	bool				IsBinaryImageCurrent( const bimageFile_t& header, bool binaryFileFound, bool toolUsage ) const;
+	void				SetOptsFromBinaryImage( const bimageFile_t& header );
+	void				UploadBinaryImage( idBinaryImage& im );
+	
 	// parameters that define this image
 	idStr				imgName;				// game path, including extension (except for cube maps), may be an image program
 	cubeFiles_t			cubeFiles;				// If this is a cube map, and if so, what kind
@@ -247,6 +292,12 @@ private:
 	
 	int					refCount;				// overall ref count
 	
+	imageResidency_t	residency;				// only changed by idImageManager::SetResidency
+	interlockedInt_t	screenUsage;			// largest projected size since the last residency update
+	int					usageSize;				// screenUsage with a slow falloff, 0 if the image was never drawn by the frontend
+	int					lastReferencedFrame;	// residency frame the image was last bound or drawn
+	int					residentMip;			// top mip levels left out of the upload
+	
 	static const GLuint TEXTURE_NOT_LOADED = 0xFFFFFFFF;
 	
 	GLuint				texnum;				// gl texture binding
@@ -277,6 +328,11 @@ ID_INLINE idImage::idImage( const char* name ) : imgName( name )
 	sourceFileTime = FILE_NOT_FOUND_TIMESTAMP;
 	binaryFileTime = FILE_NOT_FOUND_TIMESTAMP;
 	refCount = 0;
+	residency = IMAGE_NOT_RESIDENT;
+	screenUsage = 0;
+	usageSize = 0;
+	lastReferencedFrame = 0;
+	residentMip = 0;
 }
 
 
@@ -287,6 +343,8 @@ void	R_WritePNG( const char* filename, const byte* data, int width, int height,
 
 
 
+class idImageLoaderThread;
+
 class idImageManager
 {
 public:
@@ -295,6 +353,11 @@ public:
 	{
 		insideLevelLoad = false;
 		preloadingMapImages = false;
+		compressJobList = nullptr;
+		loaderThread = nullptr;
+		residencyFrame = 0;
+		residencyMipBias = 0;
+		residentBytes = 0;
 	}
 	
 	void				Init();
@@ -352,6 +415,35 @@ public:
 	
 	void				PrintMemInfo( MemInfo_t* mi );
 	
+	// images that are first bound outside of level loads are read and decoded on the loader
+	// thread, returns false if the image has to be loaded right away
+	bool				QueueBackgroundLoad( idImage* image );
+	// intrinsic image that is bound while the image is pending
+	idImage* 			GetPlaceholderImage( const idImage* image ) const;
+	// uploads the finished background loads and restarts the loader with a new budget, called once a frame
+	void				UpdateBackgroundLoads();
+	// drops all the background loads that haven't been uploaded yet
+	void				CancelBackgroundLoads();
+	
+	void				SetResidency( idImage* image, imageResidency_t residency );
+	void				GetResidencyCounts( int& pending, int& resident, int& evicted ) const;
+	
+	// collects the screen usage recorded by the frontend and evicts unused images or changes the
+	// resident mip levels to stay inside image_residencyBudget, called once a frame
+	void				UpdateResidency();
+	// top mip levels of the image that don't have to be uploaded at its current screen usage
+	int					NeededMipLevel( const idImage* image ) const;
+	
+	int					GetResidencyFrame() const
+	{
+		return residencyFrame;
+	}
+	
+	// job list used to split the DXT compression of generated images, returns nullptr
+	// if it's disabled or another thread is already compressing with it
+	idParallelJobList* 	LockCompressJobList();
+	void				UnlockCompressJobList();
+	
 	// built-in images
 	void CreateIntrinsicImages();
 	idImage* 			defaultImage;
@@ -402,6 +494,18 @@ public:
 	
 	bool				insideLevelLoad;			// don't actually load images now
 	bool				preloadingMapImages;		// unless this is set
+	
+	idParallelJobList* 	compressJobList;
+	idSysMutex			compressJobListMutex;
+	
+	idImageLoaderThread* loaderThread;
+	idSysInterlockedInteger numPendingImages;
+	idSysInterlockedInteger numResidentImages;
+	idSysInterlockedInteger numEvictedImages;
+	
+	int					residencyFrame;
+	int					residencyMipBias;			// extra mip levels dropped while the budget is exceeded
+	int64_t				residentBytes;				// all loaded images at the last residency update
 };
 
 extern idImageManager*	globalImages;		// pointer to global list for the rest of the system
@@ -39,6 +39,17 @@ idImageManager	imageManager;
 idImageManager* globalImages = &imageManager;
 
 idCVar preLoad_Images( "preLoad_Images", "1", CVAR_SYSTEM | CVAR_BOOL, "preload images during beginlevelload" );
+idCVar image_parallelCompression( "image_parallelCompression", "1", CVAR_RENDERER | CVAR_BOOL, "split the DXT compression of generated images over the job threads" );
+idCVar image_backgroundLoad( "image_backgroundLoad", "1", CVAR_RENDERER | CVAR_BOOL, "read images that are first referenced outside of level loads on the loader thread" );
+idCVar image_backgroundLoadBytesPerFrame( "image_backgroundLoadBytesPerFrame", "8388608", CVAR_RENDERER | CVAR_INTEGER, "image bytes the loader thread may read each frame, 0 = no limit" );
+idCVar image_residencyBudget( "image_residencyBudget", "0", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "megabytes of image memory before unused images are evicted and mip levels are dropped, 0 = no limit" );
+idCVar image_residencyEvictFrames( "image_residencyEvictFrames", "300", CVAR_RENDERER | CVAR_INTEGER, "frames an image has to be unused before it can be evicted" );
+idCVar image_residencyMipChangesPerFrame( "image_residencyMipChangesPerFrame", "8", CVAR_RENDERER | CVAR_INTEGER, "images that may be reloaded with different mip levels each frame" );
+idCVar image_mipStreaming( "image_mipStreaming", "1", CVAR_RENDERER | CVAR_BOOL, "leave out the mip levels that are too detailed for the screen size of the images while the budget is exceeded" );
+idCVar image_streamingMinSize( "image_streamingMinSize", "64", CVAR_RENDERER | CVAR_INTEGER, "mip levels smaller than this are never dropped" );
+
+// the most extra mip levels that are dropped on top of the ones the screen size allows
+static const int MAX_RESIDENCY_MIP_BIAS = 4;
 
 /*
 ===============
@@ -185,7 +196,7 @@ void R_ListImages_f( const idCmdArgs& args )
 		return;
 	}
 	
-	const char* header = "       -w-- -h-- filt -fmt-- wrap  size --name-------\n";
+	const char* header = "       -w-- -h-- filt -fmt-- wrap  size res  mip --name-------\n";
 	common->Printf( "\n%s", header );
 	
 	totalSize = 0;
@@ -266,7 +277,11 @@ void R_ListImages_f( const idCmdArgs& args )
 	
 	common->Printf( "%s", header );
 	common->Printf( " %i images (%i total)\n", count, globalImages->images.Num() );
-	common->Printf( " %5.1f total megabytes of images\n\n\n", totalSize / ( 1024 * 1024.0 ) );
+	common->Printf( " %5.1f total megabytes of images\n", totalSize / ( 1024 * 1024.0 ) );
+	
+	int pending, resident, evicted;
+	globalImages->GetResidencyCounts( pending, resident, evicted );
+	common->Printf( " %i pending, %i resident, %i evicted\n\n\n", pending, resident, evicted );
 }
 
 /*
@@ -649,6 +664,8 @@ void idImageManager::PurgeAllImages()
 	int		i;
 	idImage*	image;
 	
+	CancelBackgroundLoads();
+	
 	for( i = 0; i < images.Num() ; i++ )
 	{
 		image = images[i];
@@ -663,12 +680,321 @@ ReloadImages
 */
 void idImageManager::ReloadImages( bool all )
 {
+	globalImages->CancelBackgroundLoads();
+	
 	for( int i = 0 ; i < globalImages->images.Num() ; i++ )
 	{
 		globalImages->images[ i ]->Reload( all );
 	}
 }
 
+/*
+================================================================================================
+
+	Background image loader
+
+================================================================================================
+*/
+
+struct imageLoadRequest_t
+{
+	imageLoadRequest_t( idImage* image_, const char* generatedName ) :
+		image( image_ ),
+		binaryImage( generatedName ),
+		sourceFileTime( FILE_NOT_FOUND_TIMESTAMP ),
+		binaryFileTime( FILE_NOT_FOUND_TIMESTAMP ),
+		toolUsage( false ),
+		prevResidency( IMAGE_NOT_RESIDENT ),
+		prevResidentMip( 0 ) { }
+		
+	idImage* 			image;
+	idBinaryImage		binaryImage;
+	ID_TIME_T			sourceFileTime;
+	ID_TIME_T			binaryFileTime;		// set by the loader thread
+	bool				toolUsage;
+	imageResidency_t	prevResidency;		// restored if the load is cancelled
+	int					prevResidentMip;
+};
+
+/*
+================================================
+idImageLoaderThread
+
+Reads the generated files of the queued images in order until the queue is empty or the
+byte budget of the frame is spent. The uploads are done by the main thread.
+================================================
+*/
+class idImageLoaderThread : public idSysThread
+{
+public:
+	idImageLoaderThread() : bytesBudget( 0 ) { }
+	
+	virtual int Run()
+	{
+		while( !IsTerminating() )
+		{
+			imageLoadRequest_t* request = NULL;
+			
+			mutex.Lock();
+			if( queued.Num() > 0 && ( bytesBudget <= 0 || bytesDecoded.GetValue() < bytesBudget ) )
+			{
+				request = queued[0];
+				queued.RemoveIndex( 0 );
+			}
+			mutex.Unlock();
+			
+			if( request == NULL )
+			{
+				break;
+			}
+			
+			request->binaryFileTime = request->binaryImage.LoadFromGeneratedFile( request->sourceFileTime, request->toolUsage );
+			
+			int bytes = 0;
+			for( int i = 0; i < request->binaryImage.NumImages(); i++ )
+			{
+				bytes += request->binaryImage.GetImageHeader( i ).dataSize;
+			}
+			bytesDecoded.Add( bytes );
+			
+			mutex.Lock();
+			finished.Append( request );
+			mutex.Unlock();
+		}
+		return 0;
+	}
+	
+	idSysMutex						mutex;
+	idList< imageLoadRequest_t* >	queued;			// waiting for the loader thread
+	idList< imageLoadRequest_t* >	finished;		// waiting for the upload on the main thread
+	int								bytesBudget;	// 0 = no limit
+	idSysInterlockedInteger			bytesDecoded;	// since the budget was last reset
+};
+
+/*
+===============
+R_SameBinaryImages
+===============
+*/
+static bool R_SameBinaryImages( idBinaryImage& a, idBinaryImage& b )
+{
+	if( a.NumImages() != b.NumImages() )
+	{
+		return false;
+	}
+	for( int i = 0; i < a.NumImages(); i++ )
+	{
+		const bimageImage_t& headerA = a.GetImageHeader( i );
+		const bimageImage_t& headerB = b.GetImageHeader( i );
+		if( headerA.level != headerB.level || headerA.width != headerB.width || headerA.height != headerB.height || headerA.dataSize != headerB.dataSize )
+		{
+			return false;
+		}
+		if( memcmp( a.GetImageData( i ), b.GetImageData( i ), headerA.dataSize ) != 0 )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+===============
+R_RunImageLoaderTest
+
+Reads the requests on a loader thread, they come back in the order they were queued.
+===============
+*/
+static int R_RunImageLoaderTest( idList< imageLoadRequest_t* >& requests, idList< imageLoadRequest_t* >& finished, int& bytesDecoded )
+{
+	idImageLoaderThread thread;
+	thread.StartWorkerThread( "ImageLoaderTest", CORE_ANY, THREAD_NORMAL );
+	thread.queued = requests;
+	
+	const int start = Sys_Milliseconds();
+	thread.SignalWork();
+	thread.WaitForThread();
+	const int threadedTime = Sys_Milliseconds() - start;
+	
+	thread.StopThread();
+	
+	finished = thread.finished;
+	bytesDecoded = thread.bytesDecoded.GetValue();
+	return threadedTime;
+}
+
+/*
+===============
+R_TestImageLoader_f
+
+Writes the generated files of made up images in several formats, reads them back on a loader
+thread and compares them with the images they were written from. Nothing is uploaded, so it
+doesn't need a renderer. With "loaded" it reads the generated files of the resident 2D images
+again instead and compares them with synchronous reads.
+===============
+*/
+void R_TestImageLoader_f( const idCmdArgs& args )
+{
+	const bool testLoaded = ( args.Argc() > 1 && idStr::Icmp( args.Argv( 1 ), "loaded" ) == 0 );
+	
+	idList< imageLoadRequest_t* > requests;
+	idList< idBinaryImage* > sources;
+	
+	if( testLoaded )
+	{
+		for( int i = 0; i < globalImages->images.Num(); i++ )
+		{
+			idImage* image = globalImages->images[i];
+			if( image->GetResidency() != IMAGE_RESIDENT || image->GetOpts().textureType != TT_2D )
+			{
+				continue;
+			}
+			idStr generatedName = image->GetName();
+			idImage::GetGeneratedName( generatedName, image->GetUsage(), CF_2D );
+			
+			imageLoadRequest_t* request = new( TAG_IMAGE ) imageLoadRequest_t( image, generatedName );
+			request->sourceFileTime = 0;	// accept any generated file
+			request->toolUsage = IsToolUsage( image->GetUsage() );
+			requests.Append( request );
+		}
+	}
+	else
+	{
+		// formats that are converted on the CPU without compression jobs
+		static const textureFormat_t testFormats[] = { FMT_RGBA8, FMT_RGB565, FMT_L8A8, FMT_LUM8 };
+		static const int NUM_TEST_IMAGES = 24;
+		
+		for( int i = 0; i < NUM_TEST_IMAGES; i++ )
+		{
+			const int size = 4 << ( i % 6 );
+			int numLevels = 1;
+			for( int levelSize = size; levelSize > 1; levelSize >>= 1 )
+			{
+				numLevels++;
+			}
+			
+			idTempArray<byte> pic( size * size * 4 );
+			for( int j = 0; j < size * size * 4; j++ )
+			{
+				pic[j] = ( byte )( ( j * 31 + i * 7 ) ^ ( j >> 5 ) );
+			}
+			
+			textureFormat_t format = testFormats[ i % ( sizeof( testFormats ) / sizeof( testFormats[0] ) ) ];
+			textureColor_t colorFormat = CFM_DEFAULT;
+			idBinaryImage* source = new( TAG_IMAGE ) idBinaryImage( va( "testImageLoader/image%02i", i ) );
+			source->Load2DFromMemory( size, size, pic.Ptr(), numLevels, format, colorFormat, false, false );
+			if( source->WriteGeneratedFile( 0, false ) == FILE_NOT_FOUND_TIMESTAMP )
+			{
+				common->Warning( "couldn't write the generated file of %s", source->GetName() );
+			}
+			sources.Append( source );
+			
+			imageLoadRequest_t* request = new( TAG_IMAGE ) imageLoadRequest_t( NULL, source->GetName() );
+			request->sourceFileTime = 0;
+			request->toolUsage = false;
+			requests.Append( request );
+		}
+	}
+	
+	idList< imageLoadRequest_t* > finished;
+	int bytesDecoded = 0;
+	const int threadedTime = R_RunImageLoaderTest( requests, finished, bytesDecoded );
+	
+	int mismatches = 0;
+	int missing = 0;
+	int syncTime = 0;
+	for( int i = 0; i < finished.Num(); i++ )
+	{
+		imageLoadRequest_t* request = finished[i];
+		
+		bool same;
+		if( testLoaded )
+		{
+			const int syncStart = Sys_Milliseconds();
+			idBinaryImage syncImage( request->binaryImage.GetName() );
+			const ID_TIME_T syncTimeStamp = syncImage.LoadFromGeneratedFile( request->sourceFileTime, request->toolUsage );
+			syncTime += Sys_Milliseconds() - syncStart;
+			
+			if( syncTimeStamp == FILE_NOT_FOUND_TIMESTAMP )
+			{
+				missing++;
+			}
+			same = ( syncTimeStamp == request->binaryFileTime ) && R_SameBinaryImages( syncImage, request->binaryImage );
+		}
+		else
+		{
+			if( request->binaryFileTime == FILE_NOT_FOUND_TIMESTAMP )
+			{
+				missing++;
+			}
+			same = ( request->binaryFileTime != FILE_NOT_FOUND_TIMESTAMP ) && R_SameBinaryImages( *sources[i], request->binaryImage );
+		}
+		
+		if( !same )
+		{
+			common->Printf( "mismatch: %s\n", request->binaryImage.GetName() );
+			mismatches++;
+		}
+	}
+	
+	if( testLoaded )
+	{
+		common->Printf( "%i images, %i without generated files, %i mismatches\n", finished.Num(), missing, mismatches );
+		common->Printf( "%i bytes read on the loader thread in %i msec, %i msec synchronous\n", bytesDecoded, threadedTime, syncTime );
+	}
+	else
+	{
+		common->Printf( "%i generated images, %i not read back, %i mismatches: %s\n", finished.Num(), missing, mismatches,
+						( finished.Num() == sources.Num() && mismatches == 0 ) ? "passed" : "FAILED" );
+		common->Printf( "%i bytes read on the loader thread in %i msec\n", bytesDecoded, threadedTime );
+	}
+	
+	for( int i = 0; i < sources.Num(); i++ )
+	{
+		idStr generatedFileName;
+		idBinaryImage::GetGeneratedFileName( generatedFileName, sources[i]->GetName(), false );
+		fileSystem->RemoveFile( generatedFileName );
+	}
+	sources.DeleteContents( true );
+	finished.DeleteContents( true );
+}
+
+/*
+===============
+R_ListImageResidency_f
+===============
+*/
+void R_ListImageResidency_f( const idCmdArgs& args )
+{
+	int numListed = 0;
+	int64_t listedBytes = 0;
+	
+	common->Printf( "-size-- used needed mip -age- --name-------\n" );
+	for( int i = 0; i < globalImages->images.Num(); i++ )
+	{
+		const idImage* image = globalImages->images[i];
+		if( image->GetResidency() == IMAGE_NOT_RESIDENT )
+		{
+			continue;
+		}
+		
+		const int age = globalImages->GetResidencyFrame() - image->GetLastReferencedFrame();
+		common->Printf( "%6ik %4i %6i %3i %5i %s%s\n", image->StorageSize() / 1024, image->GetScreenUsage(), globalImages->NeededMipLevel( image ),
+						image->GetResidentMipLevel(), age, image->GetName(), image->GetResidency() == IMAGE_PENDING ? " (pending)" : "" );
+						
+		listedBytes += image->StorageSize();
+		numListed++;
+	}
+	
+	int pending, resident, evicted;
+	globalImages->GetResidencyCounts( pending, resident, evicted );
+	
+	common->Printf( "%i images, %5.1f megabytes\n", numListed, listedBytes / ( 1024 * 1024.0f ) );
+	common->Printf( "%5.1f megabytes of all loaded images, budget %i megabytes, mip bias %i\n", globalImages->residentBytes / ( 1024 * 1024.0f ),
+					image_residencyBudget.GetInteger(), globalImages->residencyMipBias );
+	common->Printf( "%i pending, %i resident, %i evicted\n", pending, resident, evicted );
+}
+
 /*
 ===============
 R_CombineCubeImages_f
@@ -809,9 +1135,16 @@ void idImageManager::Init()
 	
 	CreateIntrinsicImages();
 	
+	compressJobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, 64, 0, nullptr );
+	
+	loaderThread = new( TAG_IMAGE ) idImageLoaderThread;
+	loaderThread->StartWorkerThread( "ImageLoader", CORE_ANY, THREAD_NORMAL );
+	
 	cmdSystem->AddCommand( "reloadImages", R_ReloadImages_f, CMD_FL_RENDERER, "reloads images" );
 	cmdSystem->AddCommand( "listImages", R_ListImages_f, CMD_FL_RENDERER, "lists images" );
 	cmdSystem->AddCommand( "combineCubeImages", R_CombineCubeImages_f, CMD_FL_RENDERER, "combines six images for roq compression" );
+	cmdSystem->AddCommand( "listImageResidency", R_ListImageResidency_f, CMD_FL_RENDERER, "lists the resident images with their screen usage and mip levels" );
+	cmdSystem->AddCommand( "testImageLoader", R_TestImageLoader_f, CMD_FL_RENDERER, "writes made up generated images, reads them back on the loader thread and compares them, 'loaded' reads the generated files of the loaded images" );
 	
 	// should forceLoadImages be here?
 }
@@ -823,9 +1156,22 @@ Shutdown
 */
 void idImageManager::Shutdown()
 {
+	if( loaderThread != nullptr )
+	{
+		CancelBackgroundLoads();
+		loaderThread->StopThread();
+		delete loaderThread;
+		loaderThread = nullptr;
+	}
+	
 	images.DeleteContents( true );
 	imageHash.Clear();
 	
+	if( compressJobList != nullptr )
+	{
+		parallelJobManager->FreeJobList( compressJobList );
+		compressJobList = nullptr;
+	}
 }
 
 /*
@@ -837,6 +1183,8 @@ Frees all images used by the previous level
 void idImageManager::BeginLevelLoad()
 {
 	insideLevelLoad = true;
+	
+	CancelBackgroundLoads();
 
 	// foresthale 2014-05-28: Brian Harris suggested the editors should never purge assets, because of potential for crashes on improperly refcounted assets
 	if ( com_editors )
@@ -1050,3 +1398,354 @@ void idImageManager::PrintMemInfo( MemInfo_t* mi )
 	f->Printf( "\nTotal image bytes allocated: %s\n", idStr::FormatNumber( total ).c_str() );
 	fileSystem->CloseFile( f );
 }
+
+/*
+===============
+idImageManager::LockCompressJobList
+===============
+*/
+idParallelJobList* idImageManager::LockCompressJobList()
+{
+	if( compressJobList == nullptr || !image_parallelCompression.GetBool() )
+	{
+		return nullptr;
+	}
+	
+	// never wait for another thread, compressing on this one is just as fast
+	if( !compressJobListMutex.Lock( false ) )
+	{
+		return nullptr;
+	}
+	return compressJobList;
+}
+
+/*
+===============
+idImageManager::UnlockCompressJobList
+===============
+*/
+void idImageManager::UnlockCompressJobList()
+{
+	compressJobListMutex.Unlock();
+}
+
+/*
+===============
+idImageManager::QueueBackgroundLoad
+===============
+*/
+bool idImageManager::QueueBackgroundLoad( idImage* image )
+{
+	if( loaderThread == nullptr || !image_backgroundLoad.GetBool() || insideLevelLoad )
+	{
+		return false;
+	}
+	
+	if( image->GetResidency() == IMAGE_PENDING )
+	{
+		return true;
+	}
+	
+	idStr generatedName;
+	ID_TIME_T sourceTime;
+	bool toolUsage;
+	if( !image->BeginBackgroundLoad( generatedName, sourceTime, toolUsage ) )
+	{
+		return false;
+	}
+	
+	imageLoadRequest_t* request = new( TAG_IMAGE ) imageLoadRequest_t( image, generatedName );
+	request->sourceFileTime = sourceTime;
+	request->toolUsage = toolUsage;
+	request->prevResidency = image->GetResidency();
+	request->prevResidentMip = image->residentMip;
+	
+	SetResidency( image, IMAGE_PENDING );
+	
+	loaderThread->mutex.Lock();
+	loaderThread->queued.Append( request );
+	loaderThread->mutex.Unlock();
+	
+	loaderThread->SignalWork();
+	return true;
+}
+
+/*
+===============
+idImageManager::GetPlaceholderImage
+===============
+*/
+idImage* idImageManager::GetPlaceholderImage( const idImage* image ) const
+{
+	switch( image->GetUsage() )
+	{
+		case TD_BUMP:
+			return flatNormalMap;
+		case TD_SPECULAR:
+		case TD_FONT:
+			return blackImage;
+		case TD_GLOSS:
+			return glossImage;
+		default:
+			return whiteImage;
+	}
+}
+
+/*
+===============
+idImageManager::UpdateBackgroundLoads
+===============
+*/
+void idImageManager::UpdateBackgroundLoads()
+{
+	if( loaderThread == nullptr )
+	{
+		return;
+	}
+	
+	idList< imageLoadRequest_t* > finished;
+	bool moreQueued;
+	
+	loaderThread->mutex.Lock();
+	finished.Swap( loaderThread->finished );
+	moreQueued = loaderThread->queued.Num() > 0;
+	loaderThread->bytesBudget = Max( 0, image_backgroundLoadBytesPerFrame.GetInteger() );
+	loaderThread->bytesDecoded.SetValue( 0 );
+	loaderThread->mutex.Unlock();
+	
+	for( int i = 0; i < finished.Num(); i++ )
+	{
+		imageLoadRequest_t* request = finished[i];
+		request->image->FinishBackgroundLoad( request->binaryImage, request->binaryFileTime );
+		delete request;
+	}
+	
+	if( moreQueued )
+	{
+		loaderThread->SignalWork();
+	}
+}
+
+/*
+===============
+idImageManager::CancelBackgroundLoads
+===============
+*/
+void idImageManager::CancelBackgroundLoads()
+{
+	if( loaderThread == nullptr )
+	{
+		return;
+	}
+	
+	idList< imageLoadRequest_t* > cancelled;
+	
+	loaderThread->mutex.Lock();
+	cancelled.Swap( loaderThread->queued );
+	loaderThread->mutex.Unlock();
+	
+	// let the loader finish the file it's reading
+	loaderThread->WaitForThread();
+	cancelled.Append( loaderThread->finished );
+	loaderThread->finished.Clear();
+	
+	for( int i = 0; i < cancelled.Num(); i++ )
+	{
+		imageLoadRequest_t* request = cancelled[i];
+		idImage* image = request->image;
+		
+		// a mip change of a loaded image keeps the pixels it already has
+		if( image->IsLoaded() && request->prevResidency == IMAGE_RESIDENT )
+		{
+			image->residentMip = request->prevResidentMip;
+			SetResidency( image, IMAGE_RESIDENT );
+		}
+		else
+		{
+			SetResidency( image, IMAGE_NOT_RESIDENT );
+		}
+		delete request;
+	}
+}
+
+/*
+===============
+idImageManager::SetResidency
+===============
+*/
+void idImageManager::SetResidency( idImage* image, imageResidency_t residency )
+{
+	const imageResidency_t oldResidency = image->residency;
+	if( oldResidency == residency )
+	{
+		return;
+	}
+	
+	if( oldResidency == IMAGE_PENDING )
+	{
+		numPendingImages.Decrement();
+	}
+	else if( oldResidency == IMAGE_RESIDENT )
+	{
+		numResidentImages.Decrement();
+		if( residency == IMAGE_NOT_RESIDENT )
+		{
+			numEvictedImages.Increment();
+		}
+	}
+	
+	if( residency == IMAGE_PENDING )
+	{
+		numPendingImages.Increment();
+	}
+	else if( residency == IMAGE_RESIDENT )
+	{
+		numResidentImages.Increment();
+	}
+	
+	image->residency = residency;
+}
+
+/*
+===============
+idImageManager::GetResidencyCounts
+===============
+*/
+void idImageManager::GetResidencyCounts( int& pending, int& resident, int& evicted ) const
+{
+	pending = numPendingImages.GetValue();
+	resident = numResidentImages.GetValue();
+	evicted = numEvictedImages.GetValue();
+}
+
+/*
+===============
+R_SortImagesByLastReferenced
+===============
+*/
+static int R_SortImagesByLastReferenced( idImage* const* a, idImage* const* b )
+{
+	return ( *a )->GetLastReferencedFrame() - ( *b )->GetLastReferencedFrame();
+}
+
+/*
+===============
+idImageManager::NeededMipLevel
+===============
+*/
+int idImageManager::NeededMipLevel( const idImage* image ) const
+{
+	// everything is uploaded at full size while the budget isn't exceeded
+	if( residencyMipBias == 0 || !image_mipStreaming.GetBool() )
+	{
+		return 0;
+	}
+	
+	// only images that are streamed from generated files, and the ones the frontend has drawn
+	if( image->generatorFunction != NULL || image->cubeFiles != CF_2D || image->opts.textureType != TT_2D || image->usageSize == 0 )
+	{
+		return 0;
+	}
+	
+	const int size = Max( image->opts.width << image->residentMip, image->opts.height << image->residentMip );
+	const int numLevels = image->opts.numLevels + image->residentMip;
+	
+	int mip = ( residencyMipBias - 1 );
+	if( size > image->usageSize )
+	{
+		mip += idMath::ILog2( size / image->usageSize );
+	}
+	
+	// keep the top level above the minimum size
+	const int minSize = Max( image_streamingMinSize.GetInteger(), 1 );
+	while( mip > 0 && ( size >> mip ) < minSize )
+	{
+		mip--;
+	}
+	return idMath::ClampInt( 0, numLevels - 1, mip );
+}
+
+/*
+===============
+idImageManager::UpdateResidency
+===============
+*/
+void idImageManager::UpdateResidency()
+{
+	residencyFrame++;
+	
+	const int evictFrames = Max( image_residencyEvictFrames.GetInteger(), 2 );
+	
+	idList< idImage* > unused;
+	idList< idImage* > mipChanges;
+	int64_t totalBytes = 0;
+	
+	for( int i = 0; i < images.Num(); i++ )
+	{
+		idImage* image = images[i];
+		
+		const int pixels = Sys_InterlockedExchange( image->screenUsage, 0 );
+		if( pixels > 0 )
+		{
+			// grow right away, shrink slowly so the mip levels don't flip back and forth
+			image->lastReferencedFrame = residencyFrame;
+			image->usageSize = Max( pixels, image->usageSize - image->usageSize / 64 );
+		}
+		
+		if( !image->IsLoaded() )
+		{
+			continue;
+		}
+		totalBytes += image->StorageSize();
+		
+		// only images the background loader can bring back are managed
+		if( image->GetResidency() != IMAGE_RESIDENT || image->generatorFunction != NULL || image->cubeFiles != CF_2D )
+		{
+			continue;
+		}
+		
+		if( residencyFrame - image->lastReferencedFrame > evictFrames )
+		{
+			unused.Append( image );
+		}
+		else if( image->residentMip != NeededMipLevel( image ) )
+		{
+			mipChanges.Append( image );
+		}
+	}
+	
+	residentBytes = totalBytes;
+	
+	const int64_t budget = ( int64_t )image_residencyBudget.GetInteger() * 1024 * 1024;
+	if( budget <= 0 )
+	{
+		residencyMipBias = 0;
+	}
+	else if( totalBytes > budget )
+	{
+		// evict the images that haven't been used for the longest time first
+		unused.Sort( R_SortImagesByLastReferenced );
+		for( int i = 0; i < unused.Num() && totalBytes > budget; i++ )
+		{
+			totalBytes -= unused[i]->StorageSize();
+			unused[i]->PurgeImage();
+		}
+		
+		// drop more mip levels if that wasn't enough, once the previous changes are done
+		if( totalBytes > budget && numPendingImages.GetValue() == 0 && residencyMipBias < MAX_RESIDENCY_MIP_BIAS )
+		{
+			residencyMipBias++;
+		}
+	}
+	else if( totalBytes < budget - budget / 4 && numPendingImages.GetValue() == 0 && residencyMipBias > 0 )
+	{
+		residencyMipBias--;
+	}
+	
+	// reload the images with the mip levels they need now, the old levels stay bound until then
+	const int maxChanges = Max( image_residencyMipChangesPerFrame.GetInteger(), 0 );
+	for( int i = 0; i < mipChanges.Num() && i < maxChanges; i++ )
+	{
+		QueueBackgroundLoad( mipChanges[i] );
+	}
+}
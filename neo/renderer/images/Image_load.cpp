@@ -520,35 +520,7 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 		return;
 	}
 	
-	if( com_productionMode.GetInteger() != 0 )
-	{
-		sourceFileTime = FILE_NOT_FOUND_TIMESTAMP;
-		if( cubeFiles != CF_2D )
-		{
-			opts.textureType = TT_CUBIC;
-			repeat = TR_CLAMP;
-		}
-	}
-	else
-	{
-		// RB begin
-		if( cubeFiles == CF_2D_ARRAY )
-		{
-			opts.textureType = TT_2D_ARRAY;
-		}
-		// RB end
-		else if( cubeFiles != CF_2D )
-		{
-			opts.textureType = TT_CUBIC;
-			repeat = TR_CLAMP;
-			R_LoadCubeImages( GetName(), cubeFiles, NULL, NULL, &sourceFileTime );
-		}
-		else
-		{
-			opts.textureType = TT_2D;
-			R_LoadImageProgram( GetName(), NULL, NULL, NULL, &sourceFileTime, &usage );
-		}
-	}
+	LoadSourceFileTime();
 	
 	const bool toolUsage = IsToolUsage( usage );
 
@@ -609,25 +581,9 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 	
 	const bimageFile_t& header = im.GetFileHeader();
 
-	if( ( (fileSystem->InProductionMode() || sourceFileTime<=0) && binaryFileFound )
-		|| ( ( binaryFileFound )
-			&& ( header.colorFormat == opts.colorFormat )
-			&& ( header.format == opts.format )
-			&& ( header.textureType == opts.textureType )
-			&& ( !toolUsage || r_cacheToolImages.GetBool() )
-			) )
+	if( IsBinaryImageCurrent( header, binaryFileFound, toolUsage ) )
 	{
-		opts.width = header.width;
-		opts.height = header.height;
-		opts.numLevels = header.numLevels;
-		opts.colorFormat = ( textureColor_t )header.colorFormat;
-		opts.format = ( textureFormat_t )header.format;
-		opts.textureType = ( textureType_t )header.textureType;
-		if( cvarSystem->GetCVarBool( "fs_buildresources" ) )
-		{
-			// for resource gathering write this image to the preload file for this map
-			fileSystem->AddImagePreload( GetName(), filter, repeat, usage, cubeFiles );
-		}
+		SetOptsFromBinaryImage( header );
 	}
 	else
 	{
@@ -710,6 +666,7 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 					SubImageUpload( level, 0, 0, 0, opts.width >> level, opts.height >> level, clear.Ptr() );
 				}
 				
+				globalImages->SetResidency( this, IMAGE_RESIDENT );
 				return;
 			}
 			
@@ -734,14 +691,200 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 			binaryFileTime = im.WriteGeneratedFile( sourceFileTime, toolUsage );
 	}
 
-	AllocImage();
+	UploadBinaryImage( im );
+}
+
+/*
+===============
+idImage::LoadSourceFileTime
+
+Sets the texture type and gets the time stamp of the source files the image is generated from
+===============
+*/
+void idImage::LoadSourceFileTime()
+{
+	if( com_productionMode.GetInteger() != 0 )
+	{
+		sourceFileTime = FILE_NOT_FOUND_TIMESTAMP;
+		if( cubeFiles != CF_2D )
+		{
+			opts.textureType = TT_CUBIC;
+			repeat = TR_CLAMP;
+		}
+	}
+	else
+	{
+		// RB begin
+		if( cubeFiles == CF_2D_ARRAY )
+		{
+			opts.textureType = TT_2D_ARRAY;
+		}
+		// RB end
+		else if( cubeFiles != CF_2D )
+		{
+			opts.textureType = TT_CUBIC;
+			repeat = TR_CLAMP;
+			R_LoadCubeImages( GetName(), cubeFiles, NULL, NULL, &sourceFileTime );
+		}
+		else
+		{
+			opts.textureType = TT_2D;
+			R_LoadImageProgram( GetName(), NULL, NULL, NULL, &sourceFileTime, &usage );
+		}
+	}
+}
+
+/*
+===============
+idImage::IsBinaryImageCurrent
+
+Returns true if the generated file can be used as is, otherwise the image has to be binarized again
+===============
+*/
+bool idImage::IsBinaryImageCurrent( const bimageFile_t& header, bool binaryFileFound, bool toolUsage ) const
+{
+	return ( ( fileSystem->InProductionMode() || sourceFileTime <= 0 ) && binaryFileFound )
+		   || ( ( binaryFileFound )
+				&& ( header.colorFormat == opts.colorFormat )
+				&& ( header.format == opts.format )
+				&& ( header.textureType == opts.textureType )
+				&& ( !toolUsage || r_cacheToolImages.GetBool() )
+			  );
+}
+
+/*
+===============
+idImage::SetOptsFromBinaryImage
+===============
+*/
+void idImage::SetOptsFromBinaryImage( const bimageFile_t& header )
+{
+	opts.width = header.width;
+	opts.height = header.height;
+	opts.numLevels = header.numLevels;
+	opts.colorFormat = ( textureColor_t )header.colorFormat;
+	opts.format = ( textureFormat_t )header.format;
+	opts.textureType = ( textureType_t )header.textureType;
+	if( cvarSystem->GetCVarBool( "fs_buildresources" ) )
+	{
+		// for resource gathering write this image to the preload file for this map
+		fileSystem->AddImagePreload( GetName(), filter, repeat, usage, cubeFiles );
+	}
+}
+
+/*
+===============
+idImage::UploadBinaryImage
+===============
+*/
+void idImage::UploadBinaryImage( idBinaryImage& im )
+{
+	// leave out the top levels that are too detailed for the screen size the image is drawn at,
+	// the opts are still those of the full image here
+	residentMip = 0;
+	const int skipMips = globalImages->NeededMipLevel( this );
+	if( skipMips > 0 )
+	{
+		const bimageImage_t& top = im.GetImageHeader( skipMips );
+		opts.width = top.width;
+		opts.height = top.height;
+		opts.numLevels -= skipMips;
+	}
 	
+	// AllocImage purges an image that is already resident, which clears residentMip
+	AllocImage();
+	residentMip = skipMips;
 	
 	for( int i = 0; i < im.NumImages(); i++ )
 	{
 		const bimageImage_t& img = im.GetImageHeader( i );
+		if( img.level < residentMip )
+		{
+			continue;
+		}
 		const byte* data = im.GetImageData( i );
-		SubImageUpload( img.level, 0, 0, img.destZ, img.width, img.height, data );
+		SubImageUpload( img.level - residentMip, 0, 0, img.destZ, img.width, img.height, data );
+	}
+	
+	globalImages->SetResidency( this, IMAGE_RESIDENT );
+}
+
+/*
+===============
+idImage::BeginBackgroundLoad
+
+Does the part of ActuallyLoadImage that can't be moved off the main thread: the source time stamp
+and the storage options. Returns false if the image has to be loaded with ActuallyLoadImage.
+===============
+*/
+bool idImage::BeginBackgroundLoad( idStr& generatedName, ID_TIME_T& sourceTime, bool& toolUsage )
+{
+	// generated, cube and array images have their own paths, and cube images change global state
+	if( !R_IsInitialized() || generatorFunction != NULL || cubeFiles != CF_2D )
+	{
+		return false;
+	}
+	
+	LoadSourceFileTime();
+	
+	toolUsage = IsToolUsage( usage );
+	if( toolUsage && !r_cacheToolImages.GetBool() )
+	{
+		// always binarized from the source image
+		return false;
+	}
+	
+	DeriveOpts();
+	
+	generatedName = GetName();
+	GetGeneratedName( generatedName, usage, cubeFiles );
+	sourceTime = sourceFileTime;
+	
+	return true;
+}
+
+/*
+===============
+idImage::FinishBackgroundLoad
+
+Uploads a generated file that was read by the background loader. Images without a usable
+generated file still have to be binarized, which is done synchronously.
+===============
+*/
+void idImage::FinishBackgroundLoad( idBinaryImage& im, ID_TIME_T binaryTime )
+{
+	binaryFileTime = binaryTime;
+	
+	const bool binaryFileFound = binaryFileTime != FILE_NOT_FOUND_TIMESTAMP;
+	const bimageFile_t& header = im.GetFileHeader();
+	
+	if( !IsBinaryImageCurrent( header, binaryFileFound, IsToolUsage( usage ) ) )
+	{
+		ActuallyLoadImage( false );
+		return;
+	}
+	
+	SetOptsFromBinaryImage( header );
+	UploadBinaryImage( im );
+}
+
+/*
+===============
+idImage::RecordScreenUsage
+===============
+*/
+void idImage::RecordScreenUsage( int pixels )
+{
+	// keep the largest size of all the surfaces this frame
+	interlockedInt_t current = screenUsage;
+	while( pixels > current )
+	{
+		const interlockedInt_t previous = Sys_InterlockedCompareExchange( screenUsage, current, pixels );
+		if( previous == current )
+		{
+			break;
+		}
+		current = previous;
 	}
 }
 
@@ -757,9 +900,18 @@ void idImage::Bind()
 
 	RENDERLOG_PRINTF( "idImage::Bind( %s )\n", GetName() );
 	
+	lastReferencedFrame = globalImages->GetResidencyFrame();
+	
 	// load the image if necessary (FIXME: not SMP safe!)
 	if( !IsLoaded() )
 	{
+		// hand the image to the background loader and use a stand-in until it's resident
+		if( globalImages->QueueBackgroundLoad( this ) )
+		{
+			globalImages->GetPlaceholderImage( this )->Bind();
+			return;
+		}
+		
 		// load the image on demand here, which isn't our normal game operating mode
 		ActuallyLoadImage( true );
 	}
@@ -1050,6 +1202,28 @@ void idImage::Print() const
 	
 	common->Printf( "%4ik ", StorageSize() / 1024 );
 	
+	switch( residency )
+	{
+		case IMAGE_PENDING:
+			common->Printf( "pend " );
+			break;
+		case IMAGE_RESIDENT:
+			common->Printf( "res  " );
+			break;
+		default:
+			common->Printf( "     " );
+			break;
+	}
+	
+	if( residentMip > 0 )
+	{
+		common->Printf( "-%i ", residentMip );
+	}
+	else
+	{
+		common->Printf( "   " );
+	}
+	
 	common->Printf( " %s\n", GetName() );
 }
 
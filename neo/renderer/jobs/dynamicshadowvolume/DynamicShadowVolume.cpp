@@ -984,74 +984,146 @@ void DynamicShadowVolumeJob( const dynamicShadowVolumeParms_t* parms )
 	if( shadowZMin < shadowZMax )
 	{
 	
-		// Check if we need to render the shadow volume with Z-fail.
-		bool* preciseInsideShadowVolume = NULL;
 		// If the view is potentially inside the shadow volume bounds we may need to render with Z-fail.
-		if( R_ViewPotentiallyInsideInfiniteShadowVolume( parms->triangleBounds, parms->localLightOrigin, parms->localViewOrigin, parms->zNear * INSIDE_SHADOW_VOLUME_EXTRA_STRETCH ) )
+		const bool potentiallyInsideShadowVolume = R_ViewPotentiallyInsideInfiniteShadowVolume( parms->triangleBounds, parms->localLightOrigin, parms->localViewOrigin, parms->zNear * INSIDE_SHADOW_VOLUME_EXTRA_STRETCH );
+		
+		// Cached indices can be used unless the precise inside test is needed,
+		// because that test is done while calculating the triangle facing.
+		dynamicShadowVolumeCache_t* cache = parms->cache;
+		const bool preciseInsideTest = potentiallyInsideShadowVolume && parms->useShadowPreciseInsideTest;
+		bool useCache = false;
+		if( cache != NULL && !preciseInsideTest )
+		{
+			const bool renderShadowCaps = parms->forceShadowCaps || potentiallyInsideShadowVolume;
+			useCache = ( parms->shadowIndices == NULL || ( cache->shadowIndicesValid && cache->shadowCaps == renderShadowCaps ) ) &&
+					   ( parms->lightIndices == NULL || cache->lightIndicesValid );
+		}
+		
+		if( useCache )
 		{
-			// Optionally perform a more precise test to see whether or not the view is inside the shadow volume.
-			if( parms->useShadowPreciseInsideTest )
+			renderZFail = potentiallyInsideShadowVolume;
+			
+			if( parms->shadowIndices != NULL )
 			{
-				preciseInsideShadowVolume = & renderZFail;
+				numShadowIndices = cache->numShadowIndices;
+				memcpy( parms->shadowIndices, cache->shadowIndices, numShadowIndices * sizeof( triIndex_t ) );
 			}
-			else
+			if( parms->lightIndices != NULL )
 			{
-				renderZFail = true;
+				numLightIndices = cache->numLightIndices;
+				memcpy( parms->lightIndices, cache->lightIndices, numLightIndices * sizeof( triIndex_t ) );
 			}
-		}
-		
-		// Calculate the facing of each triangle and cull each triangle to the light volume.
-		// Optionally also calculate more precisely whether or not the view is inside the shadow volume.
-		int numFrontFacing = 0;
-		if( parms->joints != NULL )
-		{
-			numFrontFacing = CalculateTriangleFacingCulledSkinned( parms->tempFacing, parms->tempCulled, parms->tempVerts, parms->indexes, parms->numIndexes,
-							 parms->verts, parms->numVerts, parms->joints,
-							 parms->localLightOrigin, parms->localViewOrigin,
-							 parms->cullShadowTrianglesToLight, parms->localLightProject,
-							 preciseInsideShadowVolume, parms->zNear * INSIDE_SHADOW_VOLUME_EXTRA_STRETCH );
+			
+			cache->hits++;
 		}
 		else
 		{
-			numFrontFacing = CalculateTriangleFacingCulledStatic( parms->tempFacing, parms->tempCulled, parms->indexes, parms->numIndexes,
-							 parms->verts, parms->numVerts,
-							 parms->localLightOrigin, parms->localViewOrigin,
-							 parms->cullShadowTrianglesToLight, parms->localLightProject,
-							 preciseInsideShadowVolume, parms->zNear * INSIDE_SHADOW_VOLUME_EXTRA_STRETCH );
-		}
-		
-		// Create shadow volume indices.
-		if( parms->shadowIndices != NULL )
-		{
-			const int numTriangles = parms->numIndexes / 3;
+			// When caching, create the indices in the cache and copy them out afterwards,
+			// the output buffers are write-combined memory that should not be read back.
+			// Valid cached indices are only as large as they have to be, so indices that
+			// have to be created again only fit when the front end reserved the worst case.
+			const bool cacheShadowIndices = ( cache != NULL && parms->shadowIndices != NULL && cache->maxShadowIndices >= parms->maxShadowIndices );
+			const bool cacheLightIndices = ( cache != NULL && parms->lightIndices != NULL && cache->maxLightIndices >= parms->maxLightIndices );
+			triIndex_t* shadowIndices = cacheShadowIndices ? cache->shadowIndices : parms->shadowIndices;
+			triIndex_t* lightIndices = cacheLightIndices ? cache->lightIndices : parms->lightIndices;
+			
+			// Check if we need to render the shadow volume with Z-fail.
+			bool* preciseInsideShadowVolume = NULL;
+			if( potentiallyInsideShadowVolume )
+			{
+				// Optionally perform a more precise test to see whether or not the view is inside the shadow volume.
+				if( parms->useShadowPreciseInsideTest )
+				{
+					preciseInsideShadowVolume = & renderZFail;
+				}
+				else
+				{
+					renderZFail = true;
+				}
+			}
 			
-			// If there are any triangles facing away from the light.
-			if( numTriangles - numFrontFacing > 0 )
+			// Calculate the facing of each triangle and cull each triangle to the light volume.
+			// Optionally also calculate more precisely whether or not the view is inside the shadow volume.
+			int numFrontFacing = 0;
+			if( parms->joints != NULL )
+			{
+				numFrontFacing = CalculateTriangleFacingCulledSkinned( parms->tempFacing, parms->tempCulled, parms->tempVerts, parms->indexes, parms->numIndexes,
+								 parms->verts, parms->numVerts, parms->joints,
+								 parms->localLightOrigin, parms->localViewOrigin,
+								 parms->cullShadowTrianglesToLight, parms->localLightProject,
+								 preciseInsideShadowVolume, parms->zNear * INSIDE_SHADOW_VOLUME_EXTRA_STRETCH );
+			}
+			else
 			{
-				// Set the "fake triangle" used by dangling edges to facing so a dangling edge will
-				// make a silhouette if the triangle that uses the dangling edges is not facing.
-				// Note that dangling edges outside the light frustum do not make silhouettes because
-				// a triangle outside the light frustum is also set to facing just like the "fake triangle"
-				// used by a dangling edge.
-				parms->tempFacing[numTriangles] = 255;
+				numFrontFacing = CalculateTriangleFacingCulledStatic( parms->tempFacing, parms->tempCulled, parms->indexes, parms->numIndexes,
+								 parms->verts, parms->numVerts,
+								 parms->localLightOrigin, parms->localViewOrigin,
+								 parms->cullShadowTrianglesToLight, parms->localLightProject,
+								 preciseInsideShadowVolume, parms->zNear * INSIDE_SHADOW_VOLUME_EXTRA_STRETCH );
+			}
+			
+			// Check if we can avoid rendering the shadow volume caps.
+			const bool renderShadowCaps = parms->forceShadowCaps || renderZFail;
+			
+			// Create shadow volume indices.
+			if( shadowIndices != NULL )
+			{
+				const int numTriangles = parms->numIndexes / 3;
 				
-				// Check if we can avoid rendering the shadow volume caps.
-				bool renderShadowCaps = parms->forceShadowCaps || renderZFail;
+				// If there are any triangles facing away from the light.
+				if( numTriangles - numFrontFacing > 0 )
+				{
+					// Set the "fake triangle" used by dangling edges to facing so a dangling edge will
+					// make a silhouette if the triangle that uses the dangling edges is not facing.
+					// Note that dangling edges outside the light frustum do not make silhouettes because
+					// a triangle outside the light frustum is also set to facing just like the "fake triangle"
+					// used by a dangling edge.
+					parms->tempFacing[numTriangles] = 255;
+					
+					// Create new triangles along the silhouette planes and optionally add end-cap triangles on the model and on the distant projection.
+					R_CreateShadowVolumeTriangles( shadowIndices, parms->indexBuffer, numShadowIndices, parms->tempFacing,
+												   parms->silEdges, parms->numSilEdges, parms->indexes, parms->numIndexes, renderShadowCaps );
+												   
+					assert( numShadowIndices <= parms->maxShadowIndices );
+				}
+			}
+			
+			// Create new indices with only the triangles that are inside the light volume.
+			if( lightIndices != NULL )
+			{
+				R_CreateLightTriangles( lightIndices, parms->indexBuffer, numLightIndices, parms->tempCulled, parms->indexes, parms->numIndexes );
 				
-				// Create new triangles along the silhouette planes and optionally add end-cap triangles on the model and on the distant projection.
-				R_CreateShadowVolumeTriangles( parms->shadowIndices, parms->indexBuffer, numShadowIndices, parms->tempFacing,
-											   parms->silEdges, parms->numSilEdges, parms->indexes, parms->numIndexes, renderShadowCaps );
-											   
-				assert( numShadowIndices <= parms->maxShadowIndices );
+				assert( numLightIndices <= parms->maxLightIndices );
 			}
-		}
-		
-		// Create new indices with only the triangles that are inside the light volume.
-		if( parms->lightIndices != NULL )
-		{
-			R_CreateLightTriangles( parms->lightIndices, parms->indexBuffer, numLightIndices, parms->tempCulled, parms->indexes, parms->numIndexes );
 			
-			assert( numLightIndices <= parms->maxLightIndices );
+			if( cache != NULL )
+			{
+				// indices that didn't fit in the cache are dropped, so the front end reserves room for them the next frame,
+				// but the cached ones are still good when they were only skipped for the precise inside test
+				if( cacheShadowIndices )
+				{
+					memcpy( parms->shadowIndices, shadowIndices, numShadowIndices * sizeof( triIndex_t ) );
+					cache->numShadowIndices = numShadowIndices;
+					cache->shadowCaps = renderShadowCaps;
+					cache->shadowIndicesValid = true;
+				}
+				else if( parms->shadowIndices != NULL && !preciseInsideTest )
+				{
+					cache->shadowIndicesValid = false;
+				}
+				if( cacheLightIndices )
+				{
+					memcpy( parms->lightIndices, lightIndices, numLightIndices * sizeof( triIndex_t ) );
+					cache->numLightIndices = numLightIndices;
+					cache->lightIndicesValid = true;
+				}
+				else if( parms->lightIndices != NULL && !preciseInsideTest )
+				{
+					cache->lightIndicesValid = false;
+				}
+				
+				cache->misses++;
+			}
 		}
 	}
 	
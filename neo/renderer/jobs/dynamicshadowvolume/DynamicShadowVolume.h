@@ -64,6 +64,34 @@ struct silEdge_t
 	triIndex_t					v1, v2;					// verts defining the edge
 };
 
+/*
+================================================
+dynamicShadowVolumeCache_t
+
+Shadow and light indices of a light / surface pair that are kept across frames.
+The front end clears the valid flags when the light, the entity transform or the
+model changed. The job copies out valid indices instead of recreating them, and
+otherwise creates them here first and then copies them out. The front end reserves
+the worst case for indices that have to be created, and shrinks them to the
+created number after the job.
+================================================
+*/
+struct dynamicShadowVolumeCache_t
+{
+	triIndex_t* 					shadowIndices;
+	int								maxShadowIndices;
+	int								numShadowIndices;
+	triIndex_t* 					lightIndices;
+	int								maxLightIndices;
+	int								numLightIndices;
+	bool							shadowIndicesValid;
+	bool							shadowCaps;				// the shadow indices include the end caps
+	bool							lightIndicesValid;
+	// statistics written by the job
+	int								hits;
+	int								misses;
+};
+
 /*
 ================================================
 dynamicShadowVolumeParms_t
@@ -108,6 +136,8 @@ struct dynamicShadowVolumeParms_t
 	float* 							shadowZMin;				// streamed out to main memory
 	float* 							shadowZMax;				// streamed out to main memory
 	volatile shadowVolumeState_t* 	shadowVolumeState;		// streamed out to main memory
+	// indices kept across frames, NULL if not cached
+	dynamicShadowVolumeCache_t* 	cache;
 	// next in chain on view entity
 	dynamicShadowVolumeParms_t* 	next;
 	int								pad;
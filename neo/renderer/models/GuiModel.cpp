@@ -167,18 +167,7 @@ void idGuiModel::EmitSurfaces( float modelMatrix[16], float modelViewMatrix[16],
 		drawSurf->sort = shader->GetSort();
 		drawSurf->renderZFail = 0;
 		// process the shader expressions for conditionals / color / texcoords
-		const float*	constRegs = shader->ConstantRegisters();
-		if( constRegs )
-		{
-			// shader only uses constant values
-			drawSurf->shaderRegisters = constRegs;
-		}
-		else
-		{
-			float* regs = ( float* )R_FrameAlloc( shader->GetNumRegisters() * sizeof( float ), FRAME_ALLOC_SHADER_REGISTER );
-			drawSurf->shaderRegisters = regs;
-			shader->EvaluateRegisters( regs, shaderParms, tr.viewDef->renderView.shaderParms, tr.viewDef->renderView.time[1] * 0.001f, NULL );
-		}
+		drawSurf->shaderRegisters = R_EvaluateMaterialRegisters( shader, shaderParms, 1, NULL );
 		R_LinkDrawSurfToView( drawSurf, tr.viewDef );
 		if( allowFullScreenStereoDepth )
 		{
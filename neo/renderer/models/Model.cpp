@@ -302,6 +302,23 @@ idRenderModelStatic::InitFromFile
 ================
 */
 void idRenderModelStatic::InitFromFile( const char* fileName )
+{
+	if( LoadSourceFile( fileName ) )
+	{
+		// create the bounds for culling and dynamic surface creation
+		FinishSurfaces();
+	}
+}
+
+/*
+================
+idRenderModelStatic::LoadSourceFile
+
+InitFromFile without finishing the surfaces. Returns false if the
+model couldn't be loaded and was made a default model.
+================
+*/
+bool idRenderModelStatic::LoadSourceFile( const char* fileName )
 {
 	bool loaded;
 	idStr extension;
@@ -337,14 +354,13 @@ void idRenderModelStatic::InitFromFile( const char* fileName )
 	{
 		common->Warning( "Couldn't load model: '%s'", name.c_str() );
 		MakeDefaultModel();
-		return;
+		return false;
 	}
 	
 	// it is now available for use
 	purged = false;
 	
-	// create the bounds for culling and dynamic surface creation
-	FinishSurfaces();
+	return true;
 }
 
 /*
@@ -1002,6 +1018,19 @@ Extends the bounds of deformed surfaces so they don't cull incorrectly at screen
 ================
 */
 void idRenderModelStatic::FinishSurfaces()
+{
+	FinishSurfaceGeometry();
+	AddSurfaceArea();
+}
+
+/*
+================
+idRenderModelStatic::FinishSurfaceGeometry
+
+The part of FinishSurfaces that only changes this model, so it can be run on the job threads.
+================
+*/
+void idRenderModelStatic::FinishSurfaceGeometry()
 {
 	int			i;
 	int			totalVerts, totalIndexes;
@@ -1098,20 +1127,6 @@ void idRenderModelStatic::FinishSurfaces()
 		}
 	}
 	
-	// add up the total surface area for development information
-	for( i = 0; i < surfaces.Num(); i++ )
-	{
-		const modelSurface_t*	surf = &surfaces[i];
-		srfTriangles_t*	tri = surf->geometry;
-		
-		for( int j = 0; j < tri->numIndexes; j += 3 )
-		{
-			float	area = idWinding::TriangleArea( tri->verts[tri->indexes[j]].xyz,
-													tri->verts[tri->indexes[j + 1]].xyz,  tri->verts[tri->indexes[j + 2]].xyz );
-			const_cast<idMaterial*>( surf->shader )->AddToSurfaceArea( area );
-		}
-	}
-	
 	// set flags for whole-model rejection
 	for( i = 0; i < surfaces.Num(); i++ )
 	{
@@ -1176,6 +1191,35 @@ void idRenderModelStatic::FinishSurfaces()
 	}
 }
 
+/*
+================
+idRenderModelStatic::AddSurfaceArea
+
+Adds up the total surface area of the materials for development information, the
+materials are shared between models so this is always done on the main thread.
+================
+*/
+void idRenderModelStatic::AddSurfaceArea()
+{
+	if( fastLoad )
+	{
+		return;
+	}
+	
+	for( int i = 0; i < surfaces.Num(); i++ )
+	{
+		const modelSurface_t*	surf = &surfaces[i];
+		srfTriangles_t*	tri = surf->geometry;
+		
+		for( int j = 0; j < tri->numIndexes; j += 3 )
+		{
+			float	area = idWinding::TriangleArea( tri->verts[tri->indexes[j]].xyz,
+													tri->verts[tri->indexes[j + 1]].xyz,  tri->verts[tri->indexes[j + 2]].xyz );
+			const_cast<idMaterial*>( surf->shader )->AddToSurfaceArea( area );
+		}
+	}
+}
+
 /*
 =================
 idRenderModelStatic::ConvertASEToModelSurfaces
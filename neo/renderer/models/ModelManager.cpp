@@ -36,6 +36,50 @@ If you have questions concerning this license or the applicable additional terms
 
 idCVar r_binaryLoadRenderModels( "r_binaryLoadRenderModels", "1", 0, "enable binary load/write of render models" );
 idCVar preload_MapModels( "preload_MapModels", "1", CVAR_SYSTEM | CVAR_BOOL, "preload models during begin or end levelload" );
+idCVar preload_parallelModels( "preload_parallelModels", "1", CVAR_SYSTEM | CVAR_BOOL, "finish the surfaces of preloaded models that are built from source files on the job threads, 0 = everything on the main thread" );
+
+static const int MAX_FINISH_MODEL_JOBS = 32;
+
+struct finishModelsParms_t
+{
+	idRenderModelStatic** 	models;
+	int						numModels;
+	idSysInterlockedInteger	nextModel;
+};
+
+/*
+=================
+R_FinishModelsJob
+
+Every job keeps taking the next model until all of them are done.
+=================
+*/
+static void R_FinishModelsJob( finishModelsParms_t* parms )
+{
+	for( ;; )
+	{
+		const int index = parms->nextModel.Increment() - 1;
+		if( index >= parms->numModels )
+		{
+			break;
+		}
+		parms->models[index]->FinishSurfaceGeometry();
+	}
+}
+
+REGISTER_PARALLEL_JOB( R_FinishModelsJob, "R_FinishModelsJob" );
+
+/*
+=================
+R_IsStaticSourceModel
+
+Models that are plain idRenderModelStatic built from an .ase, .lwo, .flt or .ma file.
+=================
+*/
+static bool R_IsStaticSourceModel( const char* extension )
+{
+	return ( idStr::Icmp( extension, "ase" ) == 0 ) || ( idStr::Icmp( extension, "lwo" ) == 0 ) || ( idStr::Icmp( extension, "flt" ) == 0 ) || ( idStr::Icmp( extension, "ma" ) == 0 );
+}
 
 class idRenderModelManagerLocal : public idRenderModelManager
 {
@@ -68,8 +112,10 @@ private:
 	idRenderModel* 			beamModel;
 	idRenderModel* 			spriteModel;
 	bool					insideLevelLoad;		// don't actually load now
+	idParallelJobList* 		finishModelsJobList;
 	
-	idRenderModel* 			GetModel( const char* modelName, bool createIfNotFound );
+	idRenderModel* 			GetModel( const char* modelName, bool createIfNotFound, idList< idRenderModelStatic* >* unfinishedModels = NULL );
+	void					FinishModels( idList< idRenderModelStatic* >& unfinishedModels, bool writeGeneratedFiles );
 	
 	static void				PrintModel_f( const idCmdArgs& args );
 	static void				ListModels_f( const idCmdArgs& args );
@@ -92,6 +138,7 @@ idRenderModelManagerLocal::idRenderModelManagerLocal()
 	beamModel = NULL;
 	spriteModel = NULL;
 	insideLevelLoad = false;
+	finishModelsJobList = NULL;
 }
 
 /*
@@ -237,6 +284,9 @@ void idRenderModelManagerLocal::Init()
 	
 	insideLevelLoad = false;
 	
+	finishModelsJobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, MAX_FINISH_MODEL_JOBS, 0, NULL );
+	R_InitSkinningJobList();
+	
 	// create a default model
 	idRenderModelStatic* model = new( TAG_MODEL ) idRenderModelStatic;
 	model->InitEmpty( "_DEFAULT" );
@@ -268,14 +318,24 @@ void idRenderModelManagerLocal::Shutdown()
 {
 	models.DeleteContents( true );
 	hash.Free();
+	
+	if( finishModelsJobList != NULL )
+	{
+		parallelJobManager->FreeJobList( finishModelsJobList );
+		finishModelsJobList = NULL;
+	}
+	R_ShutdownSkinningJobList();
 }
 
 /*
 =================
 idRenderModelManagerLocal::GetModel
+
+If unfinishedModels is given, static models that have to be built from their source
+files are added to it without finishing their surfaces or writing the generated file.
 =================
 */
-idRenderModel* idRenderModelManagerLocal::GetModel( const char* _modelName, bool createIfNotFound )
+idRenderModel* idRenderModelManagerLocal::GetModel( const char* _modelName, bool createIfNotFound, idList< idRenderModelStatic* >* unfinishedModels )
 {
 
 	if( !_modelName || !_modelName[0] )
@@ -334,10 +394,12 @@ idRenderModel* idRenderModelManagerLocal::GetModel( const char* _modelName, bool
 	// determine which subclass of idRenderModel to initialize
 	
 	idRenderModel* model = NULL;
+	idRenderModelStatic* staticModel = NULL;
 	
-	if( ( extension.Icmp( "ase" ) == 0 ) || ( extension.Icmp( "lwo" ) == 0 ) || ( extension.Icmp( "flt" ) == 0 ) || ( extension.Icmp( "ma" ) == 0 ) )
+	if( R_IsStaticSourceModel( extension ) )
 	{
-		model = new( TAG_MODEL ) idRenderModelStatic;
+		staticModel = new( TAG_MODEL ) idRenderModelStatic;
+		model = staticModel;
 	}
 	else if( extension.Icmp( MD5_MESH_EXT ) == 0 )
 	{
@@ -378,16 +440,27 @@ idRenderModel* idRenderModelManagerLocal::GetModel( const char* _modelName, bool
 		{
 			if( !model->LoadBinaryModel( file, sourceTimeStamp ) )
 			{
-				model->InitFromFile( canonical );
-				
-				// RB: default models shouldn't be cached as binary models
-				if( !model->IsDefaultModel() )
+				if( staticModel != NULL && unfinishedModels != NULL )
 				{
-					idFileLocal outputFile( fileSystem->OpenFileWrite( generatedFileName, "fs_basepath" ) );
-					idLib::Printf( "Writing %s\n", generatedFileName.c_str() );
-					model->WriteBinaryModel( outputFile );
+					// the surfaces are finished on the job threads and the generated file is written after that
+					if( staticModel->LoadSourceFile( canonical ) )
+					{
+						unfinishedModels->Append( staticModel );
+					}
+				}
+				else
+				{
+					model->InitFromFile( canonical );
+					
+					// RB: default models shouldn't be cached as binary models
+					if( !model->IsDefaultModel() )
+					{
+						idFileLocal outputFile( fileSystem->OpenFileWrite( generatedFileName, "fs_basepath" ) );
+						idLib::Printf( "Writing %s\n", generatedFileName.c_str() );
+						model->WriteBinaryModel( outputFile );
+					}
+					// RB end
 				}
-				// RB end
 			} /* else {
 				idLib::Printf( "loaded binary model %s from file %s\n", model->Name(), generatedFileName.c_str() );
 			} */
@@ -439,6 +512,61 @@ idRenderModel* idRenderModelManagerLocal::GetModel( const char* _modelName, bool
 	return model;
 }
 
+/*
+=================
+idRenderModelManagerLocal::FinishModels
+
+Finishes the surfaces of models loaded with LoadSourceFile, spread over the job threads.
+Everything that isn't local to a model is done afterwards in load order, so the materials
+and the generated files end up the same as with a serial load.
+=================
+*/
+void idRenderModelManagerLocal::FinishModels( idList< idRenderModelStatic* >& unfinishedModels, bool writeGeneratedFiles )
+{
+	if( unfinishedModels.Num() == 0 )
+	{
+		return;
+	}
+	
+	if( unfinishedModels.Num() > 1 && finishModelsJobList != NULL )
+	{
+		finishModelsParms_t parms;
+		parms.models = unfinishedModels.Ptr();
+		parms.numModels = unfinishedModels.Num();
+		
+		const int numJobs = Min( parms.numModels, MAX_FINISH_MODEL_JOBS );
+		for( int i = 0; i < numJobs; i++ )
+		{
+			finishModelsJobList->AddJob( ( jobRun_t )R_FinishModelsJob, &parms );
+		}
+		finishModelsJobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_CORES );
+		finishModelsJobList->Wait();
+	}
+	else
+	{
+		unfinishedModels[0]->FinishSurfaceGeometry();
+	}
+	
+	for( int i = 0; i < unfinishedModels.Num(); i++ )
+	{
+		idRenderModelStatic* model = unfinishedModels[i];
+		model->AddSurfaceArea();
+		
+		if( writeGeneratedFiles && !model->IsDefaultModel() )
+		{
+			idStrStatic< MAX_OSPATH > generatedFileName = "generated/rendermodels/";
+			idStrStatic< 16 > extension;
+			generatedFileName.AppendPath( model->Name() );
+			generatedFileName.ExtractFileExtension( extension );
+			generatedFileName.SetFileExtension( va( "b%s", extension.c_str() ) );
+			
+			idFileLocal outputFile( fileSystem->OpenFileWrite( generatedFileName, "fs_basepath" ) );
+			idLib::Printf( "Writing %s\n", generatedFileName.c_str() );
+			model->WriteBinaryModel( outputFile );
+		}
+	}
+}
+
 /*
 =================
 idRenderModelManagerLocal::AllocModel
@@ -685,13 +813,17 @@ void idRenderModelManagerLocal::Preload( const idPreloadManifest& manifest )
 		
 		preloadSort.SortWithTemplate( idSort_Preload() );
 		
+		// models that are built from their source files are finished together on the job threads
+		idList< idRenderModelStatic* > unfinishedModels;
+		idList< idRenderModelStatic* >* parallelModels = preload_parallelModels.GetBool() ? &unfinishedModels : NULL;
+		
 		for( int i = 0; i < preloadSort.Num(); i++ )
 		{
 			const preloadSort_t& ps = preloadSort[ i ];
 			const preloadEntry_s& p = manifest.GetPreloadByIndex( ps.idx );
 			if( p.resType == PRELOAD_MODEL )
 			{
-				idRenderModel* model = FindModel( p.resourceName );
+				idRenderModel* model = GetModel( p.resourceName, true, parallelModels );
 				if( model != NULL )
 				{
 					model->SetLevelLoadReferenced( true );
@@ -704,8 +836,14 @@ void idRenderModelManagerLocal::Preload( const idPreloadManifest& manifest )
 			numLoaded++;
 		}
 		
+		FinishModels( unfinishedModels, true );
+		
 		int	end = Sys_Milliseconds();
 		common->Printf( "%05d models preloaded ( or were already loaded ) in %5.1f seconds\n", numLoaded, ( end - start ) * 0.001 );
+		if( unfinishedModels.Num() > 0 )
+		{
+			common->Printf( "%05d models built from source files on the job threads\n", unfinishedModels.Num() );
+		}
 		common->Printf( "----------------------------------------\n" );
 	}
 }
@@ -758,6 +896,7 @@ void idRenderModelManagerLocal::EndLevelLoad()
 	}
 	modelProgress = 1;
 	// load any new ones
+	idList< idRenderModelStatic* > unfinishedModels;
 	for( int i = 0; i < models.Num(); i++ )
 	{
 		modelProgress = 12 + (i * 16) / modelCount;
@@ -769,9 +908,27 @@ void idRenderModelManagerLocal::EndLevelLoad()
 		if( model->IsLevelLoadReferenced() && !model->IsLoaded() && model->IsReloadable() )
 		{
 			loadCount++;
-			model->LoadModel();
+			
+			idStrStatic< MAX_OSPATH > modelName = model->Name();
+			idStrStatic< 16 > extension;
+			modelName.ExtractFileExtension( extension );
+			if( preload_parallelModels.GetBool() && R_IsStaticSourceModel( extension ) )
+			{
+				// LoadModel with the surfaces finished on the job threads below
+				idRenderModelStatic* staticModel = static_cast< idRenderModelStatic* >( model );
+				staticModel->PurgeModel();
+				if( staticModel->LoadSourceFile( modelName ) )
+				{
+					unfinishedModels.Append( staticModel );
+				}
+			}
+			else
+			{
+				model->LoadModel();
+			}
 		}
 	}
+	FinishModels( unfinishedModels, false );
 	modelProgress = 1;
 	// create static vertex/index buffers for all models
 	for( int i = 0; i < models.Num(); i++ )
@@ -116,6 +116,14 @@ public:
 	
 	void						MakeDefaultModel();
 	
+	// InitFromFile without FinishSurfaces, returns false if the model was defaulted
+	bool						LoadSourceFile( const char* fileName );
+	
+	// FinishSurfaces split in the part that only touches this model and can run on the job
+	// threads, and the part that changes the shared materials
+	void						FinishSurfaceGeometry();
+	void						AddSurfaceArea();
+	
 	bool						LoadASE( const char* fileName );
 	bool						LoadLWO( const char* fileName );
 	bool						LoadMA( const char* filename );
@@ -243,6 +251,10 @@ private:
 	void						ParseJoint( idLexer& parser, idMD5Joint* joint, idJointQuat* defaultPose );
 };
 
+// job list used to split the CPU skinning of large meshes, owned by the model manager
+void R_InitSkinningJobList();
+void R_ShutdownSkinningJobList();
+
 /*
 ===============================================================================
 
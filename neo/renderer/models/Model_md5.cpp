@@ -44,6 +44,8 @@ static const byte MD5B_VERSION = 106;
 static const unsigned int MD5B_MAGIC = ( '5' << 24 ) | ( 'D' << 16 ) | ( 'M' << 8 ) | MD5B_VERSION;
 
 idCVar r_useGPUSkinning( "r_useGPUSkinning", "1", CVAR_INTEGER, "animate normals and tangents instead of deriving" );
+idCVar r_useParallelSkinning( "r_useParallelSkinning", "1", CVAR_RENDERER | CVAR_BOOL, "split the CPU skinning of large meshes across the job threads when not called from a job" );
+idCVar r_parallelSkinningMinVerts( "r_parallelSkinningMinVerts", "4096", CVAR_RENDERER | CVAR_INTEGER, "minimum number of vertices in a mesh before the CPU skinning is split into jobs", 0, 1 << 20 );
 
 /***********************************************************************
 
@@ -477,6 +479,124 @@ void TransformVertsAndTangents( idDrawVert* targetVerts, const int numVerts, con
 	}
 }
 
+/***********************************************************************
+
+	Parallel CPU skinning
+
+	Every vertex is skinned independently, so a large mesh is cut into
+	contiguous ranges that are transformed on the job threads while the
+	calling thread does the last range itself. The job list is only used
+	from the main thread, the dynamic models that are instantiated inside
+	the R_AddSingleModel jobs must not wait on other jobs.
+
+***********************************************************************/
+
+static const int MAX_SKINNING_JOBS			= 32;
+static const int MIN_VERTS_PER_SKINNING_JOB	= 1024;
+static const int SKINNING_JOB_VERT_ALIGN	= 16;		// keep the ranges from sharing cache lines
+
+struct skinningJobParms_t
+{
+	idDrawVert* 				targetVerts;
+	const idDrawVert* 			baseVerts;
+	const idJointMat* 			joints;
+	int							numVerts;
+};
+
+static idParallelJobList* 		skinningJobList = NULL;
+static idSysMutex				skinningJobListMutex;
+
+/*
+============
+R_InitSkinningJobList
+============
+*/
+void R_InitSkinningJobList()
+{
+	if( skinningJobList == NULL )
+	{
+		skinningJobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, MAX_SKINNING_JOBS, 0, NULL );
+	}
+}
+
+/*
+============
+R_ShutdownSkinningJobList
+============
+*/
+void R_ShutdownSkinningJobList()
+{
+	if( skinningJobList != NULL )
+	{
+		parallelJobManager->FreeJobList( skinningJobList );
+		skinningJobList = NULL;
+	}
+}
+
+/*
+============
+R_SkinVertsJob
+============
+*/
+static void R_SkinVertsJob( skinningJobParms_t* parms )
+{
+	TransformVertsAndTangents( parms->targetVerts, parms->numVerts, parms->baseVerts, parms->joints );
+}
+
+REGISTER_PARALLEL_JOB( R_SkinVertsJob, "R_SkinVertsJob" );
+
+/*
+============
+TransformVertsAndTangentsParallel
+
+Falls back to skinning on the calling thread for small meshes, when called
+from a job thread, or when another thread is already using the job list.
+============
+*/
+static void TransformVertsAndTangentsParallel( idDrawVert* targetVerts, const int numVerts, const idDrawVert* baseVerts, const idJointMat* joints )
+{
+	int numJobs = 0;
+	if( skinningJobList != NULL && r_useParallelSkinning.GetBool() && numVerts >= r_parallelSkinningMinVerts.GetInteger() && idLib::IsMainThread() )
+	{
+		numJobs = Min( MAX_SKINNING_JOBS, numVerts / MIN_VERTS_PER_SKINNING_JOB );
+	}
+	
+	if( numJobs <= 1 || !skinningJobListMutex.Lock( false ) )
+	{
+		TransformVertsAndTangents( targetVerts, numVerts, baseVerts, joints );
+		return;
+	}
+	
+	skinningJobParms_t parms[MAX_SKINNING_JOBS];
+	
+	for( int i = 0; i < numJobs; i++ )
+	{
+		const int firstVert = ( ( numVerts * i / numJobs ) & ~( SKINNING_JOB_VERT_ALIGN - 1 ) );
+		const int lastVert = ( i == numJobs - 1 ) ? numVerts : ( ( numVerts * ( i + 1 ) / numJobs ) & ~( SKINNING_JOB_VERT_ALIGN - 1 ) );
+		
+		skinningJobParms_t& job = parms[i];
+		job.targetVerts = targetVerts + firstVert;
+		job.baseVerts = baseVerts + firstVert;
+		job.joints = joints;
+		job.numVerts = lastVert - firstVert;
+	}
+	
+	for( int i = 0; i < numJobs - 1; i++ )
+	{
+		skinningJobList->AddJob( ( jobRun_t )R_SkinVertsJob, &parms[i] );
+	}
+	skinningJobList->Submit();
+	
+	// the calling thread would otherwise just spin in Wait()
+	R_SkinVertsJob( &parms[numJobs - 1] );
+	
+	skinningJobList->Wait();
+	
+	skinningJobListMutex.Unlock();
+	
+	tr.pc.c_parallelSkinnedVerts += numVerts;
+}
+
 /*
 ====================
 idMD5Mesh::UpdateSurface
@@ -547,7 +667,7 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_s* ent, const idJointMa
 			assert( tri->verts != NULL );	// quiet analyze warning
 			memcpy( tri->verts, deformInfo->verts, deformInfo->numOutputVerts * sizeof( deformInfo->verts[0] ) );	// copy over the texture coordinates
 		}
-		TransformVertsAndTangents( tri->verts, deformInfo->numOutputVerts, deformInfo->verts, entJointsInverted );
+		TransformVertsAndTangentsParallel( tri->verts, deformInfo->numOutputVerts, deformInfo->verts, entJointsInverted );
 		tri->referencedVerts = false;
 	}
 	tri->tangentsCalculated = true;
@@ -126,6 +126,16 @@ idRenderModel* idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 	g.origin.Zero();
 	g.axis.Identity();
 	
+	int maxStageParticles = 0;
+	for( int stageNum = 0; stageNum < particleSystem->stages.Num(); stageNum++ )
+	{
+		maxStageParticles = Max( maxStageParticles, particleSystem->stages[stageNum]->totalParticles );
+	}
+	
+	// the live particles of a stage are collected first and created all at once
+	idParticleBatch batch;
+	batch.SetMemory( R_FrameAlloc( idParticleBatch::StorageSize( maxStageParticles, false ) ), maxStageParticles, false );
+	
 	for( int stageNum = 0; stageNum < particleSystem->stages.Num(); stageNum++ )
 	{
 		idParticleStage* stage = particleSystem->stages[stageNum];
@@ -173,9 +183,9 @@ idRenderModel* idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 			R_AllocStaticTriSurfIndexes( surf->geometry, 6 * count );
 		}
 		
-		int numVerts = 0;
 		idDrawVert* verts = surf->geometry->verts;
 		
+		batch.Clear();
 		for( int index = 0; index < stage->totalParticles; index++ )
 		{
 			g.index = index;
@@ -231,15 +241,12 @@ idRenderModel* idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 				continue;
 			}
 			
-			// this is needed so aimed particles can calculate origins at different times
-			g.originalRandom = g.random;
-			
-			g.age = g.frac * stage->particleLife;
-			
-			// if the particle doesn't get drawn because it is faded out or beyond a kill region, don't increment the verts
-			numVerts += stage->CreateParticle( &g, verts + numVerts );
+			batch.Append( g );
 		}
 		
+		// if a particle doesn't get drawn because it is faded out or beyond a kill region, it doesn't get any verts
+		const int numVerts = stage->CreateParticles( &g, batch, verts );
+		
 		// numVerts must be a multiple of 4
 		assert( ( numVerts & 3 ) == 0 && numVerts <= 4 * count );
 		
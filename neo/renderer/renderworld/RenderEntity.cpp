@@ -44,6 +44,8 @@ idRenderEntityLocal::idRenderEntityLocal()
 	dynamicModel = NULL;
 	dynamicModelFrameCount = 0;
 	cachedDynamicModel = NULL;
+	cachedDynamicModelInputs = NULL;
+	shadowCache = NULL;
 	localReferenceBounds = bounds_zero;
 	globalReferenceBounds = bounds_zero;
 	viewCount = 0;
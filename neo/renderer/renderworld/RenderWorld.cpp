@@ -153,10 +153,6 @@ idRenderWorldLocal::idRenderWorldLocal()
 	doublePortals = NULL;
 	numInterAreaPortals = 0;
 	
-	interactionTable = 0;
-	interactionTableWidth = 0;
-	interactionTableHeight = 0;
-	
 	for( int i = 0; i < decals.Num(); i++ )
 	{
 		decals[i].entityHandle = -1;
@@ -200,47 +196,6 @@ idRenderWorldLocal::~idRenderWorldLocal()
 	RB_ClearDebugText( 0 );
 }
 
-/*
-===================
-ResizeInteractionTable
-===================
-*/
-void idRenderWorldLocal::ResizeInteractionTable()
-{
-	// foresthale 2014-05-10: added a case for when there is no interaction table (this happens in the editor on the first R_AddSingleLight)
-	if (!interactionTable)
-	{
-		interactionTableWidth = entityDefs.Num() + 1000; // motorsep 11-27-2014; was 100
-		interactionTableHeight = lightDefs.Num() + 1000; // motorsep 11-27-2014; was 100
-		const int	size =  interactionTableWidth * interactionTableHeight * sizeof( *interactionTable );
-		interactionTable = ( idInteraction** )R_ClearedStaticAlloc( size );
-		return;
-	}
-
-	// we overflowed the interaction table, so make it larger
-	common->Printf( "idRenderWorldLocal::ResizeInteractionTable: overflowed interactionTable, resizing\n" );
-	
-	const int oldInteractionTableWidth = interactionTableWidth;
-	const int oldIinteractionTableHeight = interactionTableHeight;
-	idInteraction** oldInteractionTable = interactionTable;
-	
-	// build the interaction table
-	// this will be dynamically resized if the entity / light counts grow too much
-	interactionTableWidth = entityDefs.Num() + 1000; // motorsep 11-27-2014; was 100
-	interactionTableHeight = lightDefs.Num() + 1000; // motorsep 11-27-2014; was 100
-	const int	size =  interactionTableWidth * interactionTableHeight * sizeof( *interactionTable );
-	interactionTable = ( idInteraction** )R_ClearedStaticAlloc( size );
-	for( int l = 0; l < oldIinteractionTableHeight; l++ )
-	{
-		for( int e = 0; e < oldInteractionTableWidth; e++ )
-		{
-			interactionTable[ l * interactionTableWidth + e ] = oldInteractionTable[ l * oldInteractionTableWidth + e ];
-		}
-	}
-	
-	R_StaticFree( oldInteractionTable );
-}
-
 /*
 ===================
 AddEntityDef
@@ -253,11 +208,6 @@ qhandle_t idRenderWorldLocal::AddEntityDef( const renderEntity_t* re )
 	if( entityHandle == -1 )
 	{
 		entityHandle = entityDefs.Append( NULL );
-		
-		if( interactionTable && entityDefs.Num() > interactionTableWidth )
-		{
-			ResizeInteractionTable();
-		}
 	}
 	
 	UpdateEntityDef( entityHandle, re );
@@ -473,10 +423,6 @@ qhandle_t idRenderWorldLocal::AddLightDef( const renderLight_t* rlight )
 	if( lightHandle == -1 )
 	{
 		lightHandle = lightDefs.Append( NULL );
-		if( interactionTable && lightDefs.Num() > interactionTableHeight )
-		{
-			ResizeInteractionTable();
-		}
 	}
 	UpdateLightDef( lightHandle, rlight );
 	
@@ -1785,11 +1731,8 @@ void idRenderWorldLocal::GenerateAllInteractions()
 	tr.viewDef = NULL;
 	
 	// build the interaction table
-	// this will be dynamically resized if the entity / light counts grow too much
-	interactionTableWidth = entityDefs.Num() + 1000; // motorsep 11-27-2014; was 100
-	interactionTableHeight = lightDefs.Num() + 1000; // motorsep 11-27-2014; was 100
-	int	size =  interactionTableWidth * interactionTableHeight * sizeof( *interactionTable );
-	interactionTable = ( idInteraction** )R_ClearedStaticAlloc( size );
+	// lights and entities added later just grow their own entries
+	interactionTable.Init( lightDefs.Num() );
 	
 	// itterate through all lights
 	int	count = 0;
@@ -1851,7 +1794,7 @@ void idRenderWorldLocal::GenerateAllInteractions()
 	int	msec = end - start;
 	
 	common->Printf( "idRenderWorld::GenerateAllInteractions, msec = %i\n", msec );
-	common->Printf( "interactionTable size: %i bytes\n", size );
+	common->Printf( "interactionTable size: %i bytes for %i entries\n", ( int )interactionTable.Allocated(), interactionTable.Num() );
 	common->Printf( "%i interactions take %i bytes\n", count, count * sizeof( idInteraction ) );
 	
 	// entities flagged as noDynamicInteractions will no longer make any
@@ -428,6 +428,10 @@ public:
 	virtual void			StartWritingDemo( idDemoFile* demo ) = 0;
 	virtual void			StopWritingDemo() = 0;
 	
+	// Writes the state a demo keyframe needs on top of the loaded map, and
+	// clears archive counters so everything is written again when it is visible.
+	virtual void			WriteDemoKeyframe() = 0;
+	
 	// Returns true when demoRenderView has been filled in.
 	// adds/updates/frees entityDefs and lightDefs based on the current demo file
 	// and returns the renderView to be used to render this frame.
@@ -115,6 +115,13 @@ void R_FreeEntityDefDerivedData( idRenderEntityLocal* def, bool keepDecals, bool
 	{
 		delete def->cachedDynamicModel;
 		def->cachedDynamicModel = NULL;
+		R_FreeDynamicModelInputs( def );
+		R_FreeShadowCache( def );
+	}
+	else
+	{
+		// a static model can be updated in place, so the kept shadow indices may be stale
+		R_InvalidateShadowCache( def );
 	}
 	
 	// free the entityRefs from the areas
@@ -513,6 +520,9 @@ void R_FreeLightDefDerivedData( idRenderLightLocal* ldef )
 		ldef->firstInteraction->UnlinkAndFree();
 	}
 	
+	// the dynamic shadow indices of entities are kept by light pointer
+	R_FreeLightShadowCache( ldef );
+	
 	// free all the references to the light
 	areaReference_t* nextRef = NULL;
 	for( areaReference_t* lref = ldef->references; lref != NULL; lref = nextRef )
@@ -93,6 +93,59 @@ void idRenderWorldLocal::StopWritingDemo()
 	//	writeDemo = NULL;
 }
 
+/*
+==============
+WriteDemoKeyframe
+==============
+*/
+void idRenderWorldLocal::WriteDemoKeyframe()
+{
+	// only the main renderWorld writes stuff to demos, not the wipes or
+	// menu renders
+	if ( this != common->RW() )
+	{
+		return;
+	}
+	idDemoFile* f = common->WriteDemo();
+	f->WriteInt( DS_RENDER );
+	f->WriteInt( DC_KEYFRAME );
+	f->WriteHashString( mapName );
+
+	// the full door portal state, not just the closed ones
+	f->WriteInt( numInterAreaPortals );
+	for ( int i = 0; i < numInterAreaPortals; i++ )
+	{
+		f->WriteInt( doublePortals[ i ].blockingBits );
+	}
+
+	// the area models come with the map, everything else is freed by the keyframe
+	for ( int i = 0; i < lightDefs.Num(); i++ )
+	{
+		if ( lightDefs[ i ] )
+		{
+			lightDefs[ i ]->archived = false;
+		}
+	}
+	for ( int i = 0; i < entityDefs.Num(); i++ )
+	{
+		idRenderEntityLocal* def = entityDefs[ i ];
+		if ( def && !( def->parms.hModel && def->parms.hModel->IsStaticWorldModel() ) )
+		{
+			def->archived = false;
+		}
+	}
+	for ( int i = 0; i < MAX_DECAL_SURFACES; i++ )
+	{
+		decals[ i ].decals->demoSerialWrite = decals[ i ].decals->demoSerialCurrent - 1;
+		overlays[ i ].overlays->demoSerialWrite = overlays[ i ].overlays->demoSerialCurrent - 1;
+	}
+
+	if ( r_showDemo.GetBool() )
+	{
+		common->Printf( "write DC_KEYFRAME: %s\n", mapName.c_str() );
+	}
+}
+
 /*
 ==============
 ProcessDemoCommand
@@ -392,6 +445,62 @@ bool idRenderWorldLocal::ProcessDemoCommand( idDemoFile* readDemo, renderView_t*
 			}
 			break;
 		}
+		case DC_KEYFRAME:
+		{
+			idStr keyframeMap = readDemo->ReadHashString();
+
+			if ( keyframeMap.Icmp( mapName ) != 0 )
+			{
+				// seeked to a keyframe of another map
+				FreeWorld();
+				InitFromMap( keyframeMap );
+				newMap = true;
+			}
+			else
+			{
+				// drop everything but the area models, the keyframe writes again what is visible
+				for ( int i = 0; i < entityDefs.Num(); i++ )
+				{
+					idRenderEntityLocal* def = entityDefs[ i ];
+					if ( def && !( def->parms.hModel && def->parms.hModel->IsStaticWorldModel() ) )
+					{
+						FreeEntityDef( i );
+					}
+				}
+				for ( int i = 0; i < lightDefs.Num(); i++ )
+				{
+					if ( lightDefs[ i ] )
+					{
+						FreeLightDef( i );
+					}
+				}
+			}
+			for ( int i = 0; i < MAX_DECAL_SURFACES; i++ )
+			{
+				decals[ i ].entityHandle = -1;
+				decals[ i ].decals->ReUse();
+				overlays[ i ].entityHandle = -1;
+				overlays[ i ].overlays->ReUse();
+			}
+
+			int numPortals = 0;
+			readDemo->ReadInt( numPortals );
+			for ( int i = 0; i < numPortals; i++ )
+			{
+				int blockingBits = 0;
+				readDemo->ReadInt( blockingBits );
+				if ( i < numInterAreaPortals )
+				{
+					SetPortalState( i + 1, blockingBits );
+				}
+			}
+
+			if ( r_showDemo.GetBool() )
+			{
+				common->Printf( "DC_KEYFRAME: %s\n", keyframeMap.c_str() );
+			}
+			break;
+		}
 		case DC_END_FRAME:
 		{
 			if ( r_showDemo.GetBool() )
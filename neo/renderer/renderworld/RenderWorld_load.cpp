@@ -50,6 +50,9 @@ void idRenderWorldLocal::FreeWorld()
 		portal_t*		portal, *nextPortal;
 		
 		area = &portalAreas[i];
+		R_FreeAreaOccluders( area->occluders );
+		area->occluders = NULL;
+		
 		for( portal = area->portals; portal; portal = nextPortal )
 		{
 			nextPortal = portal->next;
@@ -754,11 +757,7 @@ void idRenderWorldLocal::FreeDefs()
 {
 	generateAllInteractionsCalled = false;
 	
-	if( interactionTable )
-	{
-		R_StaticFree( interactionTable );
-		interactionTable = NULL;
-	}
+	interactionTable.Shutdown();
 	
 	// free all lightDefs
 	for( int i = 0; i < lightDefs.Num(); i++ )
@@ -1134,6 +1133,8 @@ void idRenderWorldLocal::AddWorldModelEntities()
 		R_DeriveEntityData( def );
 		
 		AddEntityRefToArea( def, &portalAreas[i] );
+		
+		portalAreas[i].occluders = R_CreateAreaOccluders( hModel );
 	}
 }
 
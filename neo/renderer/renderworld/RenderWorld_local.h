@@ -68,6 +68,7 @@ typedef struct portalArea_s
 	portal_t* 		portals;		// never changes after load
 	areaReference_t	entityRefs;		// head/tail of doubly linked list, may change
 	areaReference_t	lightRefs;		// head/tail of doubly linked list, may change
+	struct occluderMesh_t* occluders;	// for software occlusion culling, NULL if the area has none
 } portalArea_t;
 
 
@@ -192,13 +193,9 @@ public:
 	idArray<reusableOverlay_t, MAX_DECAL_SURFACES>	overlays;
 	
 	// all light / entity interactions are referenced here for fast lookup without
-	// having to crawl the doubly linked lists.  EnntityDefs are sequential for better
-	// cache access, because the table is accessed by light in idRenderWorldLocal::CreateLightDefInteractions()
-	// Growing this table is time consuming, so we add a pad value to the number
-	// of entityDefs and lightDefs
-	idInteraction** 		interactionTable;
-	int						interactionTableWidth;		// entityDefs
-	int						interactionTableHeight;		// lightDefs
+	// having to crawl the doubly linked lists.  The table is accessed by light in
+	// R_AddSingleLight(), so each lightDef keeps its own hash set of entityDef indexes
+	idInteractionTable		interactionTable;
 	
 	bool					generateAllInteractionsCalled;
 	
@@ -258,6 +255,7 @@ public:
 	
 	void					StartWritingDemo( idDemoFile* demo );
 	void					StopWritingDemo();	
+	void					WriteDemoKeyframe();
 
 	bool					ProcessDemoCommand( idDemoFile* readDemo, renderView_t* demoRenderView, int* demoTimeOffset );
 	
@@ -278,7 +276,6 @@ public:
 	//--------------------------
 	// RenderWorld.cpp
 	
-	void					ResizeInteractionTable();
 	
 	void					AddEntityRefToArea( idRenderEntityLocal* def, portalArea_t* area );
 	void					AddLightRefToArea( idRenderLightLocal* light, portalArea_t* area );
@@ -79,6 +79,7 @@ enum demoCommand_t
 	DC_CACHE_SKINS,
 	DC_CACHE_PARTICLES,
 	DC_CACHE_MATERIALS,
+	DC_KEYFRAME,
 };
 
 /*
@@ -258,6 +259,41 @@ public:
 };
 
 
+// everything a dynamic model snapshot was instantiated from, so an entity update
+// or a new frame that didn't change any of it can keep the previous snapshot
+struct dynamicModelInputs_t
+{
+	renderEntity_t			parms;					// joints pointer cleared, origin and axis too for DM_CACHED models
+	idJointMat* 			joints;					// copy of the joints, parms.joints usually points at the same game buffer
+	int						numJoints;
+	int						maxJoints;
+	int						time;					// renderView time of the entity's time group, DM_CONTINUOUS only
+	idVec3					viewOrigin;				// DM_CONTINUOUS only, particles and beams face the view
+	idMat3					viewAxis;
+	bool					gpuSkinning;
+	bool					valid;
+};
+
+// dynamic shadow volume and light culling indices of one light / entity surface pair,
+// chained on the entityDef and kept across frames until the pair's inputs change
+struct shadowCacheEntry_t
+{
+	shadowCacheEntry_t* 		next;
+	const idRenderLightLocal* 	lightDef;
+	const srfTriangles_t* 		tri;
+	// what the indices were created from
+	int							numVerts;
+	int							numIndexes;
+	idVec3						localLightOrigin;
+	idRenderMatrix				localLightProject;
+	bool						cullShadowTrianglesToLight;
+	bool						changed;				// since the last frame the pair was set up
+	int							stableFrames;			// > 0 frames in a row without changes, < 0 frames in a row with changes
+	int							lastUsedFrame;
+	int							allocated;				// bytes of index memory
+	dynamicShadowVolumeCache_t	indices;
+};
+
 class idRenderEntityLocal : public idRenderEntity
 {
 public:
@@ -294,6 +330,8 @@ public:
 	int						dynamicModelFrameCount;	// continuously animating dynamic models will recreate
 	// dynamicModel if this doesn't == tr.viewCount
 	idRenderModel* 			cachedDynamicModel;
+	dynamicModelInputs_t* 	cachedDynamicModelInputs;	// what cachedDynamicModel was last instantiated from
+	shadowCacheEntry_t* 	shadowCache;			// dynamic shadow indices kept across frames
 	
 	
 	// the local bounds used to place entityRefs, either from parms for dynamic entities, or a model bounds
@@ -522,6 +560,11 @@ struct viewDef_t
 	// crossing a closed door.  This is used to avoid drawing interactions
 	// when the light is behind a closed door.
 	bool* 				connectedAreas;
+	
+	// registers of the materials evaluated with only the time and the globalParms of this
+	// view, shared by all surfaces, indexed by material index * 2 + timeGroup, NULL until used
+	float** 			materialRegisters;
+	int					numMaterialRegisters;
 };
 
 
@@ -684,8 +727,13 @@ struct performanceCounters_t
 	int		c_box_cull_out;
 	int		c_createInteractions;	// number of calls to idInteraction::CreateInteraction
 	int		c_createShadowVolumes;
+	int		c_shadowCacheHits;		// dynamic shadow volume jobs that copied their indices from the cache
+	int		c_shadowCacheMisses;	// cached pairs that had to recreate them
+	int		c_shadowCacheAllocated;	// bytes of kept indices
 	int		c_generateMd5;
 	int		c_entityDefCallbacks;
+	int		c_dynamicModelInstances;	// calls to InstantiateDynamicModel
+	int		c_dynamicModelReuses;		// snapshots kept because their inputs didn't change
 	int		c_alloc;			// counts for R_StaticAllc/R_StaticFree
 	int		c_free;
 	int		c_visibleViewEntities;
@@ -695,12 +743,17 @@ struct performanceCounters_t
 	int		c_deformedSurfaces;	// idMD5Mesh::GenerateSurface
 	int		c_deformedVerts;	// idMD5Mesh::GenerateSurface
 	int		c_deformedIndexes;	// idMD5Mesh::GenerateSurface
+	int		c_parallelSkinnedVerts;	// deformed verts that were split across the job threads
 	int		c_tangentIndexes;	// R_DeriveTangents()
 	int		c_entityUpdates;
 	int		c_lightUpdates;
 	int		c_entityReferences;
 	int		c_lightReferences;
 	int		c_guiSurfs;
+	int		c_occluderTris;		// triangles drawn into the software occlusion buffer
+	int		c_occludedEntities;
+	int		c_occludedLights;
+	int		occlusionMicroSec;
 	int		frontEndMicroSec;	// sum of time in all RE_RenderScene's in a frame
 };
 
@@ -972,7 +1025,7 @@ extern glconfig_t			glConfig;		// outside of TR since it shouldn't be cleared du
 // cvars
 //
 extern idCVar r_debugContext;				// enable various levels of context debug
-extern idCVar r_glDriver;					// "opengl32", etc
+extern idCVar r_glDriver;					// "opengl32", etc, "null" for the null driver
 extern idCVar r_skipIntelWorkarounds;		// skip work arounds for Intel driver bugs
 extern idCVar r_vidMode;					// video mode number
 extern idCVar r_displayRefresh;				// optional display refresh rate option for vid mode
@@ -1004,6 +1057,7 @@ extern idCVar r_useHDR;						// foresthale 2014-02-20: HDR view rendering
 extern idCVar r_useLightPortalFlow;			// 1 = do a more precise area reference determination
 extern idCVar r_useShadowSurfaceScissor;	// 1 = scissor shadows by the scissor rect of the interaction surfaces
 extern idCVar r_useConstantMaterials;		// 1 = use pre-calculated material registers if possible
+extern idCVar r_useSharedMaterialRegisters;	// 1 = evaluate the time and globalParm material registers once per view
 extern idCVar r_useNodeCommonChildren;		// stop pushing reference bounds early when possible
 extern idCVar r_useSilRemap;				// 1 = consider verts with the same XYZ, but different ST the same for shadows
 extern idCVar r_useLightPortalCulling;		// 0 = none, 1 = box, 2 = exact clip of polyhedron faces, 3 MVP to plane culling
@@ -1012,6 +1066,7 @@ extern idCVar r_useLightScissors;			// 1 = use custom scissor rectangle for each
 extern idCVar r_useEntityPortalCulling;		// 0 = none, 1 = box
 extern idCVar r_skipPrelightShadows;		// 1 = skip the dmap generated static shadow volumes
 extern idCVar r_useCachedDynamicModels;		// 1 = cache snapshots of dynamic models
+extern idCVar r_useDynamicModelInputs;		// 1 = keep dynamic model snapshots whose inputs didn't change
 extern idCVar r_useScissor;					// 1 = scissor clip as portals and lights are processed
 extern idCVar r_usePortals;					// 1 = use portals to perform area culling, otherwise draw everything
 extern idCVar r_useStateCaching;			// avoid redundant state changes in GL_*() calls
@@ -1062,6 +1117,7 @@ extern idCVar r_showUnsmoothedTangents;		// highlight geometry rendered with uns
 extern idCVar r_showSilhouette;				// highlight edges that are casting shadow planes
 extern idCVar r_showVertexColor;			// draws all triangles with the solid vertex color
 extern idCVar r_showUpdates;				// report entity and light updates and ref counts
+extern idCVar r_showOcclusion;				// report software occlusion culling
 extern idCVar r_showDemo;					// report reads and writes to the demo file
 extern idCVar r_showDynamic;				// report stats on dynamic surface generation
 extern idCVar r_showIntensity;				// draw the screen colors based on intensity, red = 0, green = 128, blue = 255
@@ -1248,6 +1304,24 @@ void R_OptimizeViewLightsList();
 /*
 ============================================================
 
+TR_FRONTEND_OCCLUSION
+
+============================================================
+*/
+
+struct occluderMesh_t;
+
+occluderMesh_t* R_CreateAreaOccluders( const idRenderModel* model );
+void R_FreeAreaOccluders( occluderMesh_t* mesh );
+
+void R_RenderOccluders();
+bool R_CullBoundsToOccluders( const idBounds& bounds );
+void R_CullEntitiesToOccluders();
+void R_CullLightsToOccluders();
+
+/*
+============================================================
+
 TR_FRONTEND_ADDMODELS
 
 ============================================================
@@ -1255,8 +1329,13 @@ TR_FRONTEND_ADDMODELS
 
 bool R_IssueEntityDefCallback( idRenderEntityLocal* def );
 idRenderModel* R_EntityDefDynamicModel( idRenderEntityLocal* def );
+void R_FreeDynamicModelInputs( idRenderEntityLocal* def );
+void R_FreeShadowCache( idRenderEntityLocal* def );
+void R_InvalidateShadowCache( idRenderEntityLocal* def );
+void R_FreeLightShadowCache( const idRenderLightLocal* lightDef );
 void R_ClearEntityDefDynamicModel( idRenderEntityLocal* def );
 
+const float* R_EvaluateMaterialRegisters( const idMaterial* shader, const float shaderParms[MAX_ENTITY_SHADER_PARMS], int timeGroup, idSoundEmitter* soundEmitter );
 void R_SetupDrawSurfShader( drawSurf_t* drawSurf, const idMaterial* shader, const renderEntity_t* renderEntity );
 void R_SetupDrawSurfJoints( drawSurf_t* drawSurf, const srfTriangles_t* tri, const idMaterial* shader );
 void R_LinkDrawSurfToView( drawSurf_t* drawSurf, viewDef_t* viewDef );
@@ -640,11 +640,10 @@ void R_CreateDupVerts( srfTriangles_t* tri )
 R_DefineEdge
 ===============
 */
-static int c_duplicatedEdges, c_tripledEdges;
 static const int MAX_SIL_EDGES			= 0x7ffff;
 
 static void R_DefineEdge( const int v1, const int v2, const int planeNum, const int numPlanes,
-						  idList<silEdge_t>& silEdges, idHashIndex&	 silEdgeHash )
+						  idList<silEdge_t>& silEdges, idHashIndex&	 silEdgeHash, int& c_duplicatedEdges, int& c_tripledEdges )
 {
 	int		i, hashKey;
 	
@@ -728,8 +727,6 @@ can never create silhouette plains, and can be omited
 
 void R_IdentifySilEdges( srfTriangles_t* tri, bool omitCoplanarEdges )
 {
-	static int c_coplanarSilEdges = 0;
-	static int c_totalSilEdges = 0;
 	int		i;
 	int		shared, single;
 	
@@ -746,8 +743,9 @@ void R_IdentifySilEdges( srfTriangles_t* tri, bool omitCoplanarEdges )
 	
 	silEdgeHash.Clear();
 	
-	c_duplicatedEdges = 0;
-	c_tripledEdges = 0;
+	// counted per call, static models are finished on the job threads
+	int c_duplicatedEdges = 0;
+	int c_tripledEdges = 0;
 	
 	for( i = 0; i < numTris; i++ )
 	{
@@ -758,9 +756,9 @@ void R_IdentifySilEdges( srfTriangles_t* tri, bool omitCoplanarEdges )
 		i3 = tri->silIndexes[ i * 3 + 2 ];
 		
 		// create the edges
-		R_DefineEdge( i1, i2, i, numPlanes, silEdges, silEdgeHash );
-		R_DefineEdge( i2, i3, i, numPlanes, silEdges, silEdgeHash );
-		R_DefineEdge( i3, i1, i, numPlanes, silEdges, silEdgeHash );
+		R_DefineEdge( i1, i2, i, numPlanes, silEdges, silEdgeHash, c_duplicatedEdges, c_tripledEdges );
+		R_DefineEdge( i2, i3, i, numPlanes, silEdges, silEdgeHash, c_duplicatedEdges, c_tripledEdges );
+		R_DefineEdge( i3, i1, i, numPlanes, silEdges, silEdgeHash, c_duplicatedEdges, c_tripledEdges );
 	}
 	
 	if( c_duplicatedEdges || c_tripledEdges )
@@ -823,13 +821,10 @@ void R_IdentifySilEdges( srfTriangles_t* tri, bool omitCoplanarEdges )
 		}
 		if( c_coplanarCulled )
 		{
-			c_coplanarSilEdges += c_coplanarCulled;
 //			common->Printf( "%i of %i sil edges coplanar culled\n", c_coplanarCulled,
 //				c_coplanarCulled + numSilEdges );
 		}
 	}
-	c_totalSilEdges += silEdges.Num();
-	
 	// sort the sil edges based on plane number
 	qsort( silEdges.Ptr(), silEdges.Num(), sizeof( silEdges[0] ), SilEdgeSort );
 	
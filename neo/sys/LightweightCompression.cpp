@@ -434,6 +434,482 @@ void idLZWCompressor::ClearHash()
 	memset( hash, 0xFF, sizeof( hash ) );
 }
 
+/*
+========================
+idLZCompressor::Hash
+========================
+*/
+int idLZCompressor::Hash( const uint8_t* bytes )
+{
+	uint32_t sequence;
+	memcpy( &sequence, bytes, sizeof( sequence ) );
+	return ( int )( ( sequence * 2654435761U ) >> ( 32 - lzCompressionData_t::LZ_HASH_BITS ) );
+}
+
+/*
+========================
+idLZCompressor::InitDictionary
+========================
+*/
+void idLZCompressor::InitDictionary( lzDictionary_t& dictionary, const uint8_t* data, int size )
+{
+	extern unsigned int CRC32_BlockChecksum( const void * data, int length );
+	
+	dictionary.size = Min( size, lzCompressionData_t::LZ_MAX_DICTIONARY );
+	memcpy( dictionary.data, data, dictionary.size );
+	dictionary.checksum = CRC32_BlockChecksum( dictionary.data, dictionary.size );
+	
+	memset( dictionary.hashTable, 0, sizeof( dictionary.hashTable ) );
+	for( int i = 0; i + LZ_MIN_MATCH <= dictionary.size; i++ )
+	{
+		dictionary.hashTable[Hash( &dictionary.data[i] )] = ( uint16_t )( i + 1 );
+	}
+}
+
+/*
+========================
+idLZCompressor::Start
+========================
+*/
+void idLZCompressor::Start( uint8_t* data_, int maxSize_, const lzDictionary_t* dictionary, bool append )
+{
+	if( !append )
+	{
+		if( dictionary != NULL && dictionary->size > 0 )
+		{
+			memcpy( lzData->window, dictionary->data, dictionary->size );
+			memcpy( lzData->hashTable, dictionary->hashTable, sizeof( lzData->hashTable ) );
+			lzData->windowStart = dictionary->size;
+		}
+		else
+		{
+			memset( lzData->hashTable, 0, sizeof( lzData->hashTable ) );
+			lzData->windowStart = 0;
+		}
+		
+		lzData->windowLength	= lzData->windowStart;
+		lzData->encodedLength	= lzData->windowStart;
+		lzData->bytesWritten	= 0;
+	}
+	
+	data		= data_;
+	maxSize		= maxSize_;
+	overflowed	= false;
+	
+	bytesRead	= 0;
+	readPos		= lzData->windowStart;
+	
+	savedWindowLength	= lzData->encodedLength;
+	savedBytesWritten	= lzData->bytesWritten;
+}
+
+/*
+========================
+idLZCompressor::EncodeLength
+========================
+*/
+void idLZCompressor::EncodeLength( int length )
+{
+	while( length >= 255 )
+	{
+		data[lzData->bytesWritten++] = 255;
+		length -= 255;
+	}
+	data[lzData->bytesWritten++] = ( uint8_t )length;
+}
+
+/*
+========================
+idLZCompressor::EncodeSequence
+========================
+*/
+bool idLZCompressor::EncodeSequence( int literalStart, int literalLength, int matchLength, int offset )
+{
+	int matchCode = ( matchLength > 0 ) ? matchLength - LZ_MIN_MATCH + 1 : 0;
+	
+	int needed = 1 + literalLength;
+	if( literalLength >= 15 )
+	{
+		needed += 1 + ( literalLength - 15 ) / 255;
+	}
+	if( matchLength > 0 )
+	{
+		needed += 2;
+		if( matchCode >= 15 )
+		{
+			needed += 1 + ( matchCode - 15 ) / 255;
+		}
+	}
+	
+	if( lzData->bytesWritten + needed > maxSize )
+	{
+		return false;
+	}
+	
+	data[lzData->bytesWritten++] = ( uint8_t )( ( Min( literalLength, 15 ) << 4 ) | Min( matchCode, 15 ) );
+	
+	if( literalLength >= 15 )
+	{
+		EncodeLength( literalLength - 15 );
+	}
+	
+	memcpy( &data[lzData->bytesWritten], &lzData->window[literalStart], literalLength );
+	lzData->bytesWritten += literalLength;
+	
+	if( matchLength > 0 )
+	{
+		data[lzData->bytesWritten++] = ( uint8_t )( offset & 255 );
+		data[lzData->bytesWritten++] = ( uint8_t )( offset >> 8 );
+		
+		if( matchCode >= 15 )
+		{
+			EncodeLength( matchCode - 15 );
+		}
+	}
+	
+	return true;
+}
+
+/*
+========================
+idLZCompressor::Flush
+Encodes everything that was written since the last flush
+========================
+*/
+void idLZCompressor::Flush()
+{
+	if( overflowed )
+	{
+		return;
+	}
+	
+	const uint8_t* window = lzData->window;
+	
+	int pos		= lzData->encodedLength;
+	int end		= lzData->windowLength;
+	int anchor	= pos;
+	
+	while( pos + LZ_MIN_MATCH <= end )
+	{
+		int h = Hash( &window[pos] );
+		int candidate = lzData->hashTable[h] - 1;
+		lzData->hashTable[h] = ( uint16_t )( pos + 1 );
+		
+		// candidates past pos were left behind by a Restore
+		if( candidate < 0 || candidate >= pos || pos - candidate > LZ_MAX_OFFSET || memcmp( &window[candidate], &window[pos], LZ_MIN_MATCH ) != 0 )
+		{
+			pos++;
+			continue;
+		}
+		
+		int matchLength = LZ_MIN_MATCH;
+		while( pos + matchLength < end && window[candidate + matchLength] == window[pos + matchLength] )
+		{
+			matchLength++;
+		}
+		
+		if( !EncodeSequence( anchor, pos - anchor, matchLength, pos - candidate ) )
+		{
+			overflowed = true;
+			return;
+		}
+		
+		pos += matchLength;
+		anchor = pos;
+	}
+	
+	if( anchor < end && !EncodeSequence( anchor, end - anchor, 0, 0 ) )
+	{
+		overflowed = true;
+		return;
+	}
+	
+	lzData->encodedLength = end;
+}
+
+/*
+========================
+idLZCompressor::WriteByte
+========================
+*/
+void idLZCompressor::WriteByte( uint8_t value )
+{
+	if( overflowed )
+	{
+		return;
+	}
+	
+	if( lzData->windowLength >= lzCompressionData_t::LZ_WINDOW_SIZE )
+	{
+		overflowed = true;
+		return;
+	}
+	
+	lzData->window[lzData->windowLength++] = value;
+	
+	// At any point, we need to be able to call End, so encode early if the pending bytes might not fit as literals
+	int pending = lzData->windowLength - lzData->encodedLength;
+	if( lzData->bytesWritten + pending + pending / 255 + 2 > maxSize )
+	{
+		Flush();
+	}
+}
+
+/*
+========================
+idLZCompressor::DecodeLength
+========================
+*/
+bool idLZCompressor::DecodeLength( int& length )
+{
+	int value;
+	do
+	{
+		if( bytesRead >= maxSize )
+		{
+			return false;
+		}
+		value = data[bytesRead++];
+		length += value;
+	}
+	while( value == 255 );
+	
+	return true;
+}
+
+/*
+========================
+idLZCompressor::DecodeSequence
+========================
+*/
+bool idLZCompressor::DecodeSequence()
+{
+	if( bytesRead >= maxSize )
+	{
+		return false;
+	}
+	
+	int token = data[bytesRead++];
+	
+	int literalLength = token >> 4;
+	if( literalLength == 15 && !DecodeLength( literalLength ) )
+	{
+		return false;
+	}
+	
+	if( bytesRead + literalLength > maxSize || lzData->windowLength + literalLength > lzCompressionData_t::LZ_WINDOW_SIZE )
+	{
+		return false;
+	}
+	
+	memcpy( &lzData->window[lzData->windowLength], &data[bytesRead], literalLength );
+	lzData->windowLength += literalLength;
+	bytesRead += literalLength;
+	
+	int matchCode = token & 15;
+	if( matchCode == 0 )
+	{
+		return true;
+	}
+	
+	if( bytesRead + 2 > maxSize )
+	{
+		return false;
+	}
+	
+	int offset = data[bytesRead] | ( data[bytesRead + 1] << 8 );
+	bytesRead += 2;
+	
+	int matchLength = matchCode;
+	if( matchCode == 15 && !DecodeLength( matchLength ) )
+	{
+		return false;
+	}
+	matchLength += LZ_MIN_MATCH - 1;
+	
+	if( offset == 0 || offset > lzData->windowLength || lzData->windowLength + matchLength > lzCompressionData_t::LZ_WINDOW_SIZE )
+	{
+		return false;
+	}
+	
+	// Byte at a time, the match can overlap what it is writing
+	uint8_t* dest = &lzData->window[lzData->windowLength];
+	const uint8_t* src = dest - offset;
+	for( int i = 0; i < matchLength; i++ )
+	{
+		dest[i] = src[i];
+	}
+	lzData->windowLength += matchLength;
+	
+	return true;
+}
+
+/*
+========================
+idLZCompressor::ReadByte
+========================
+*/
+int idLZCompressor::ReadByte( bool ignoreOverflow )
+{
+	while( readPos == lzData->windowLength )
+	{
+		if( !DecodeSequence() )
+		{
+			if( !ignoreOverflow )
+			{
+				overflowed = true;
+				assert( !"idLZCompressor::ReadByte overflowed!" );
+			}
+			return -1;
+		}
+	}
+	
+	return lzData->window[readPos++];
+}
+
+/*
+========================
+idLZCompressor::End
+========================
+*/
+int idLZCompressor::End()
+{
+	Flush();
+	
+	if( overflowed )
+	{
+		return -1;
+	}
+	
+	return lzData->bytesWritten > 0 ? lzData->bytesWritten : -1;		// Total bytes written (or failure)
+}
+
+/*
+========================
+idLZCompressor::Save
+========================
+*/
+void idLZCompressor::Save()
+{
+	Flush();
+	
+	assert( !overflowed );
+	
+	savedWindowLength	= lzData->windowLength;
+	savedBytesWritten	= lzData->bytesWritten;
+}
+
+/*
+========================
+idLZCompressor::Restore
+========================
+*/
+void idLZCompressor::Restore()
+{
+	lzData->windowLength	= savedWindowLength;
+	lzData->encodedLength	= savedWindowLength;
+	lzData->bytesWritten	= savedBytesWritten;
+	overflowed				= false;
+}
+
+/*
+========================
+idSnapCompressor
+========================
+*/
+static lzDictionary_t snapDictionary;
+
+/*
+========================
+idSnapCompressor::SetDictionary
+========================
+*/
+void idSnapCompressor::SetDictionary( const uint8_t* data, int size )
+{
+	if( data == NULL || size <= 0 )
+	{
+		memset( &snapDictionary, 0, sizeof( snapDictionary ) );
+		return;
+	}
+	idLZCompressor::InitDictionary( snapDictionary, data, size );
+}
+
+/*
+========================
+idSnapCompressor::GetDictionary
+========================
+*/
+const lzDictionary_t* idSnapCompressor::GetDictionary()
+{
+	return ( snapDictionary.size > 0 ) ? &snapDictionary : NULL;
+}
+
+/*
+========================
+idSnapCompressor::Start
+========================
+*/
+void idSnapCompressor::Start( uint8_t* data_, int maxSize, bool append )
+{
+	switch( compressionData->compressor )
+	{
+		case SNAP_COMPRESSOR_LZW:
+			lzw.Start( data_, maxSize, append );
+			break;
+		case SNAP_COMPRESSOR_LZ:
+			lz.Start( data_, maxSize, NULL, append );
+			break;
+		default:
+			assert( GetDictionary() != NULL );
+			lz.Start( data_, maxSize, GetDictionary(), append );
+			break;
+	}
+}
+
+/*
+========================
+idSnapCompressor::End
+========================
+*/
+int idSnapCompressor::End()
+{
+	return ( compressionData->compressor == SNAP_COMPRESSOR_LZW ) ? lzw.End() : lz.End();
+}
+
+/*
+========================
+idSnapCompressor::Save
+========================
+*/
+void idSnapCompressor::Save()
+{
+	if( compressionData->compressor == SNAP_COMPRESSOR_LZW )
+	{
+		lzw.Save();
+	}
+	else
+	{
+		lz.Save();
+	}
+}
+
+/*
+========================
+idSnapCompressor::Restore
+========================
+*/
+void idSnapCompressor::Restore()
+{
+	if( compressionData->compressor == SNAP_COMPRESSOR_LZW )
+	{
+		lzw.Restore();
+	}
+	else
+	{
+		lz.Restore();
+	}
+}
+
 /*
 ========================
 idZeroRunLengthCompressor
@@ -441,7 +917,7 @@ Simple zero based run length encoder/decoder
 ========================
 */
 
-void idZeroRunLengthCompressor::Start( uint8_t* dest_, idLZWCompressor* comp_, int maxSize_ )
+void idZeroRunLengthCompressor::Start( uint8_t* dest_, idSnapCompressor* comp_, int maxSize_ )
 {
 	zeroCount	= 0;
 	dest		= dest_;
@@ -199,6 +199,225 @@ private:
 	int					savedTempBits;
 };
 
+struct lzCompressionData_t
+{
+	static const int	LZ_HASH_BITS		= 12;
+	static const int	LZ_HASH_SIZE		= 1 << LZ_HASH_BITS;
+	static const int	LZ_MAX_DICTIONARY	= 8 * 1024;
+	static const int	LZ_MAX_STREAM		= 24 * 1024;
+	static const int	LZ_WINDOW_SIZE		= LZ_MAX_DICTIONARY + LZ_MAX_STREAM;
+	
+	uint8_t					window[LZ_WINDOW_SIZE];		// Dictionary, followed by the uncompressed stream
+	uint16_t				hashTable[LZ_HASH_SIZE];	// Last window position + 1 of each hashed 4 byte sequence
+	
+	int						windowStart;				// Size of the dictionary at the start of the window
+	int						windowLength;				// End of the uncompressed stream in the window
+	int						encodedLength;				// End of the part of the stream that has been encoded
+	int						bytesWritten;
+};
+
+struct lzDictionary_t
+{
+	uint8_t					data[lzCompressionData_t::LZ_MAX_DICTIONARY];
+	int						size;
+	uint32_t				checksum;
+	uint16_t				hashTable[lzCompressionData_t::LZ_HASH_SIZE];	// Pre-hashed, so starting a stream is just a copy
+};
+
+/*
+========================
+idLZCompressor
+Byte oriented lz encoder/decoder, with an optional static dictionary that
+both sides prime the window with.
+
+Each sequence is a token byte (literal count in the high nibble, match length - 3 in
+the low nibble, 0 meaning no match), followed by the literals, and a 16 bit offset
+back into the window when there is a match. Nibbles of 15 are extended with bytes
+until one is less than 255.
+
+Bytes are buffered in the window and encoded when Flush is called, or when the
+encoded size could otherwise overflow.
+========================
+*/
+class idLZCompressor
+{
+public:
+	idLZCompressor( lzCompressionData_t* lzData_ ) : lzData( lzData_ ) {}
+	
+	static const int	LZ_MIN_MATCH	= 4;
+	static const int	LZ_MAX_OFFSET	= 0xFFFF;
+	
+	void	Start( uint8_t* data_, int maxSize, const lzDictionary_t* dictionary, bool append = false );
+	void	WriteByte( uint8_t value );
+	int		ReadByte( bool ignoreOverflow = false );
+	void	Flush();
+	int		End();
+	
+	int		Length()
+	{
+		Flush();
+		return lzData->bytesWritten;
+	}
+	int		GetReadCount() const
+	{
+		return bytesRead;
+	}
+	
+	void	Save();
+	void	Restore();
+	
+	bool	IsOverflowed() const
+	{
+		return overflowed;
+	}
+	
+	static void	InitDictionary( lzDictionary_t& dictionary, const uint8_t* data, int size );
+	
+private:
+	bool	EncodeSequence( int literalStart, int literalLength, int matchLength, int offset );
+	void	EncodeLength( int length );
+	bool	DecodeSequence();
+	bool	DecodeLength( int& length );
+	
+	static int	Hash( const uint8_t* bytes );
+	
+	lzCompressionData_t* 	lzData;
+	
+	uint8_t* 				data;		// Read/write
+	int					maxSize;
+	bool				overflowed;
+	
+	// For reading
+	int					bytesRead;
+	int					readPos;
+	
+	// saving/restoring when overflow (when writing)
+	int					savedWindowLength;
+	int					savedBytesWritten;
+};
+
+/*
+================================================
+Snapshot compression
+The zrle'd snapshot object stream is compressed with one of these. Peers advertise what they
+support in the connection handshake, and the host picks the best one both sides understand.
+================================================
+*/
+enum snapCompressor_t
+{
+	SNAP_COMPRESSOR_LZW,			// 12 bit lzw, understood by every peer
+	SNAP_COMPRESSOR_LZ,				// Byte oriented lz
+	SNAP_COMPRESSOR_LZ_DICT,		// Byte oriented lz, primed with the static snapshot dictionary
+	SNAP_COMPRESSOR_MAX
+};
+
+struct snapCompressionData_t
+{
+	snapCompressor_t		compressor;
+	lzwCompressionData_t	lzw;
+	lzCompressionData_t		lz;
+};
+
+/*
+========================
+idSnapCompressor
+Stream interface over the compressor selected in snapCompressionData_t
+========================
+*/
+class idSnapCompressor
+{
+public:
+	idSnapCompressor( snapCompressionData_t* data_ ) : compressionData( data_ ), lzw( &data_->lzw ), lz( &data_->lz ) {}
+	
+	void	Start( uint8_t* data_, int maxSize, bool append = false );
+	int		End();
+	
+	void	WriteByte( uint8_t value )
+	{
+		if( compressionData->compressor == SNAP_COMPRESSOR_LZW )
+		{
+			lzw.WriteByte( value );
+		}
+		else
+		{
+			lz.WriteByte( value );
+		}
+	}
+	
+	int		ReadByte( bool ignoreOverflow = false )
+	{
+		if( compressionData->compressor == SNAP_COMPRESSOR_LZW )
+		{
+			return lzw.ReadByte( ignoreOverflow );
+		}
+		return lz.ReadByte( ignoreOverflow );
+	}
+	
+	int		Length()
+	{
+		return ( compressionData->compressor == SNAP_COMPRESSOR_LZW ) ? lzw.Length() : lz.Length();
+	}
+	
+	void	Save();
+	void	Restore();
+	
+	bool	IsOverflowed()
+	{
+		return ( compressionData->compressor == SNAP_COMPRESSOR_LZW ) ? lzw.IsOverflowed() : lz.IsOverflowed();
+	}
+	
+	int		Write( const void* data, int length )
+	{
+		uint8_t* src = ( uint8_t* )data;
+		
+		for( int i = 0; i < length && !IsOverflowed(); i++ )
+		{
+			WriteByte( src[i] );
+		}
+		
+		return length;
+	}
+	
+	int		Read( void* data, int length, bool ignoreOverflow = false )
+	{
+		uint8_t* src = ( uint8_t* )data;
+		
+		for( int i = 0; i < length; i++ )
+		{
+			int byte = ReadByte( ignoreOverflow );
+			
+			if( byte == -1 )
+			{
+				return i;
+			}
+			
+			src[i] = ( uint8_t )byte;
+		}
+		
+		return length;
+	}
+	
+	template<class type> ID_INLINE size_t WriteAgnostic( const type& c )
+	{
+		return Write( &c, sizeof( c ) );
+	}
+	
+	template<class type> ID_INLINE size_t ReadAgnostic( type& c, bool ignoreOverflow = false )
+	{
+		size_t r = Read( &c, sizeof( c ), ignoreOverflow );
+		return r;
+	}
+	
+	// The static dictionary used by SNAP_COMPRESSOR_LZ_DICT, must be the same on both sides (compare checksums)
+	static void						SetDictionary( const uint8_t* data, int size );
+	static const lzDictionary_t* 	GetDictionary();
+	
+private:
+	snapCompressionData_t* 	compressionData;
+	idLZWCompressor			lzw;
+	idLZCompressor			lz;
+};
+
 /*
 ========================
 idZeroRunLengthCompressor
@@ -212,7 +431,7 @@ public:
 	{
 	}
 	
-	void Start( uint8_t* dest_, idLZWCompressor* comp_, int maxSize_ );
+	void Start( uint8_t* dest_, idSnapCompressor* comp_, int maxSize_ );
 	bool WriteRun();
 	bool WriteByte( uint8_t value );
 	byte ReadByte();
@@ -229,7 +448,7 @@ private:
 	int ReadInternal();
 	
 	int					zeroCount;		// Number of pending zeroes
-	idLZWCompressor* 	comp;
+	idSnapCompressor* 	comp;
 	uint8_t* 				destStart;
 	uint8_t* 				dest;
 	int					compressed;		// Compressed size
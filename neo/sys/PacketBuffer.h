@@ -0,0 +1,112 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+Copyright (C) 2014-2016 Robert Beckebans
+Copyright (C) 2014-2016 Kot in Action Creative Artel
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#ifndef __PACKET_BUFFER_H__
+#define __PACKET_BUFFER_H__
+
+/*
+================================================
+idPacketBuffer
+
+A reference counted message buffer that carries an outgoing payload from the game,
+through the packet processor, to the socket. The payload is written at GetPayload(),
+HEADER_SPACE bytes into the buffer, so the packet processor can put its reliable
+data and packet headers in front of it without moving the payload.
+================================================
+*/
+class idPacketBuffer
+{
+public:
+	static const int HEADER_SPACE		= 64;
+	static const int BUFFER_SIZE		= HEADER_SPACE + idPacketProcessor::MAX_MSG_SIZE;
+	
+	byte* 			GetBuffer()
+	{
+		return buffer;
+	}
+	byte* 			GetPayload()
+	{
+		return buffer + HEADER_SPACE;
+	}
+	static int		GetMaxPayloadSize()
+	{
+		return idPacketProcessor::MAX_MSG_SIZE;
+	}
+	
+	void			AddRef()
+	{
+		refCount.Increment();
+	}
+	// Returns the buffer to the pool when the last reference is released
+	void			Release();
+	
+	int				GetRefCount() const
+	{
+		return refCount.GetValue();
+	}
+	// True if nobody else can see the buffer, so it can be written in place
+	bool			IsExclusive() const
+	{
+		return refCount.GetValue() == 1;
+	}
+	
+private:
+	idSysInterlockedInteger	refCount;
+	byte					buffer[ BUFFER_SIZE ];
+};
+
+/*
+================================================
+idPacketBufferPool
+================================================
+*/
+class idPacketBufferPool
+{
+public:
+	// Returns a buffer with a single reference
+	idPacketBuffer* 	Alloc();
+	void				Free( idPacketBuffer* packet );
+	
+	int					GetAllocCount() const
+	{
+		return allocator.GetAllocCount();
+	}
+	int					GetTotalCount() const
+	{
+		return allocator.GetTotalCount();
+	}
+	
+private:
+	idSysMutex			mutex;
+	idBlockAlloc< idPacketBuffer, 16, TAG_NETWORKING >	allocator;
+};
+
+extern idPacketBufferPool	packetBufferPool;
+
+#endif /* !__PACKET_BUFFER_H__ */
@@ -128,11 +128,8 @@ int idPacketProcessor::FinalizeRead( idBitMsg& inMsg, idBitMsg& outMsg, int& use
 			
 			for( int r = 0; r < numReliableRecv; r++ )
 			{
-				uint8_t uncompMem[ MAX_MSG_SIZE ];
-				
 				uint16_t reliableDataLength = 0;
 				lzwCompressor.ReadAgnostic< uint16_t >( reliableDataLength );
-				lzwCompressor.Read( uncompMem, reliableDataLength );
 				
 				if( reliableSequence + r > reliableSequenceRecv )  		// Only accept newer reliable msg's than we've currently already received
 				{
@@ -146,13 +143,17 @@ int idPacketProcessor::FinalizeRead( idBitMsg& inMsg, idBitMsg& outMsg, int& use
 						idLib::Printf( "Reliable msg count overflow.\n" );
 						return RETURN_TYPE_NONE;
 					}
-					memcpy( reliableBuffer + bufferPos, uncompMem, reliableDataLength );
+					// Decompress straight into the reliable buffer
+					lzwCompressor.Read( reliableBuffer + bufferPos, reliableDataLength );
 					reliableMsgSize[ numReliable ] = reliableDataLength;
 					reliableMsgPtrs[ numReliable++ ] = &reliableBuffer[ bufferPos ];
 					bufferPos += reliableDataLength;
 				}
 				else
 				{
+					uint8_t uncompMem[ MAX_MSG_SIZE ];
+					lzwCompressor.Read( uncompMem, reliableDataLength );
+					
 					extern idCVar net_verboseReliable;
 					if( net_verboseReliable.GetBool() )
 					{
@@ -173,14 +174,31 @@ int idPacketProcessor::FinalizeRead( idBitMsg& inMsg, idBitMsg& outMsg, int& use
 		}
 	}
 	
-	// Load actual msg
-	outMsg.BeginWriting();
-	outMsg.WriteData( inMsg.GetReadData() + inMsg.GetReadCount(), inMsg.GetRemainingData() );
-	outMsg.SetSize( inMsg.GetRemainingData() );
+	// Read the actual msg in place
+	outMsg.InitRead( inMsg.GetReadData() + inMsg.GetReadCount(), inMsg.GetRemainingData() );
 	
 	return ( header.Type() == PACKET_TYPE_OOB ) ? RETURN_TYPE_OOB : RETURN_TYPE_INBAND;
 }
 
+/*
+================================================
+idPacketProcessor::ReleasePackets
+================================================
+*/
+void idPacketProcessor::ReleasePackets()
+{
+	if( unsentPacket != NULL )
+	{
+		unsentPacket->Release();
+		unsentPacket = NULL;
+	}
+	if( incomingPacket != NULL )
+	{
+		incomingPacket->Release();
+		incomingPacket = NULL;
+	}
+}
+
 /*
 ================================================
 idPacketProcessor::QueueReliableMessage
@@ -188,6 +206,7 @@ idPacketProcessor::QueueReliableMessage
 */
 bool idPacketProcessor::QueueReliableMessage( byte type, const byte* data, int dataLen )
 {
+	copiedBytes += 1 + dataLen;
 	return reliable.Append( reliableSequenceSend++, &type, 1, data, dataLen );
 }
 
@@ -235,6 +254,8 @@ void idPacketProcessor::UpdateOutgoingRate( const int time, const int size )
 		lastOutgoingBytes = outgoingBytes;
 		lastOutgoingRateTime = time;
 	}
+	
+	UpdateCopyRate( time );
 }
 
 /*
@@ -265,69 +286,113 @@ void idPacketProcessor::UpdateIncomingRate( const int time, const int size )
 		lastIncomingBytes = incomingBytes;
 		lastIncomingRateTime = time;
 	}
+	
+	UpdateCopyRate( time );
+}
+
+/*
+=================
+idPacketProcessor::UpdateCopyRate
+=================
+*/
+void idPacketProcessor::UpdateCopyRate( const int time )
+{
+	if( time - lastCopyRateTime > BANDWIDTH_AVERAGE_PERIOD )
+	{
+		currentCopyRate = 1000 * ( copiedBytes - lastCopiedBytes ) / ( time - lastCopyRateTime );
+		lastCopiedBytes = copiedBytes;
+		lastCopyRateTime = time;
+	}
 }
 
 /*
 ================================================
 idPacketProcessor::ProcessOutgoing
-NOTE - We only compress reliables because we assume everything else has already been compressed.
 ================================================
 */
 bool idPacketProcessor::ProcessOutgoing( const int time, const idBitMsg& msg, bool isOOB, int userData )
 {
+	if( !verify( msg.GetSize() <= idPacketBuffer::GetMaxPayloadSize() ) )
+	{
+		idLib::Warning( "ProcessOutgoing: msg too large %i", msg.GetSize() );
+		return false;
+	}
+	
+	idPacketBuffer* packet = packetBufferPool.Alloc();
+	CopyData( packet->GetPayload(), msg.GetReadData(), msg.GetSize() );
+	
+	return ProcessOutgoing( time, packet, msg.GetSize(), isOOB, userData );
+}
+
+/*
+================================================
+idPacketProcessor::ProcessOutgoing
+NOTE - We only compress reliables because we assume everything else has already been compressed.
+The headers and reliables are built in prefixBuffer and placed in front of the payload, which
+normally leaves the payload where the caller wrote it.
+================================================
+*/
+bool idPacketProcessor::ProcessOutgoing( const int time, idPacketBuffer* packet, int size, bool isOOB, int userData )
+{
+	assert( size >= 0 && size <= idPacketBuffer::GetMaxPayloadSize() );
+	
 	// We can only do ONE ProcessOutgoing call, then we need to do GetSendFragment to
 	// COMPLETELY empty unsentMsg before calling ProcessOutgoing again.
 	if( !verify( fragmentedSend == false ) )
 	{
 		idLib::Warning( "ProcessOutgoing: fragmentedSend == true!" );
+		packet->Release();
 		return false;
 	}
 	
 	if( !verify( unsentMsg.GetRemainingData() == 0 ) )
 	{
 		idLib::Warning( "ProcessOutgoing: unsentMsg.GetRemainingData() > 0!" );
+		packet->Release();
 		return false;
 	}
 	
-	// Build the full msg to send, which could include reliable data
-	unsentMsg.InitWrite( unsentBuffer, sizeof( unsentBuffer ) );
-	unsentMsg.BeginWriting();
+	// Build the headers to send in front of the msg, which could include reliable data
+	idBitMsg prefixMsg;
+	prefixMsg.InitWrite( prefixBuffer, sizeof( prefixBuffer ) - size );
+	prefixMsg.BeginWriting();
 	
 	// Ack reliables if we need to (NOTE - We will send this ack on both the in-band and out-of-band channels)
 	if( queuedReliableAck >= 0 )
 	{
 		idInnerPacketHeader header( PACKET_TYPE_RELIABLE_ACK, 0 );
-		header.WriteToMsg( unsentMsg );
-		unsentMsg.WriteLong( queuedReliableAck );
+		header.WriteToMsg( prefixMsg );
+		prefixMsg.WriteLong( queuedReliableAck );
 		queuedReliableAck = -1;
 	}
 	
 	if( isOOB )
 	{
-		if( msg.GetSize() + unsentMsg.GetSize() > MAX_OOB_MSG_SIZE )  		// Fragmentation not allowed for out-of-band msg's
+		if( size + prefixMsg.GetSize() > MAX_OOB_MSG_SIZE )  		// Fragmentation not allowed for out-of-band msg's
 		{
-			idLib::Printf( "Out-of-band packet too large %i\n", unsentMsg.GetSize() );
+			idLib::Printf( "Out-of-band packet too large %i\n", prefixMsg.GetSize() );
 			assert( 0 );
+			packet->Release();
 			return false;
 		}
 		// We don't need to worry about reliable for out of band packets
 		idInnerPacketHeader header( PACKET_TYPE_OOB, userData );
-		header.WriteToMsg( unsentMsg );
+		header.WriteToMsg( prefixMsg );
 	}
 	else
 	{
 		// Add reliable msg's here if this is an in-band packet
 		idInnerPacketHeader header( PACKET_TYPE_INBAND, reliable.Num() );
-		header.WriteToMsg( unsentMsg );
+		header.WriteToMsg( prefixMsg );
 		if( reliable.Num() > 0 )
 		{
-			// Byte align unsentMsg
-			unsentMsg.WriteByteAlign();
+			// Byte align prefixMsg
+			prefixMsg.WriteByteAlign();
 			
 			lzwCompressionData_t	lzwData;
 			idLZWCompressor			lzwCompressor( &lzwData );
 			
-			lzwCompressor.Start( unsentMsg.GetWriteData() + unsentMsg.GetSize() + 2, unsentMsg.GetRemainingSpace() - 2 );		// Write to compressed mem, not exceeding MAX_MSG_SIZE (+2 to reserve space for compressed size)
+			lzwCompressor.Start( prefixMsg.GetWriteData() + prefixMsg.GetSize() + 2, prefixMsg.GetRemainingSpace() - 2 );		// Write to compressed mem, not exceeding MAX_MSG_SIZE (+2 to reserve space for compressed size)
 			
 			int uncompressedSize = 4;
 			lzwCompressor.WriteAgnostic< int >( reliable.ItemSequence( 0 ) );
@@ -345,8 +410,8 @@ bool idPacketProcessor::ProcessOutgoing( const int time, const idBitMsg& msg, bo
 				idLib::Error( "reliable msg compressor overflow." );
 			}
 			
-			unsentMsg.WriteShort( lzwCompressor.Length() );
-			unsentMsg.SetSize( unsentMsg.GetSize() + lzwCompressor.Length() );
+			prefixMsg.WriteShort( lzwCompressor.Length() );
+			prefixMsg.SetSize( prefixMsg.GetSize() + lzwCompressor.Length() );
 			
 			if( net_showReliableCompression.GetBool() )
 			{
@@ -364,8 +429,38 @@ bool idPacketProcessor::ProcessOutgoing( const int time, const idBitMsg& msg, bo
 		}
 	}
 	
-	// Fill up with actual msg
-	unsentMsg.WriteData( msg.GetReadData(), msg.GetSize() );
+	const int prefixSize = prefixMsg.GetSize();
+	
+	// The headers normally fit in the space reserved in front of the payload.  Large reliables push the payload
+	// further into the buffer, and a packet somebody else still references is copied so it can be written to.
+	int payloadOffset = idPacketBuffer::HEADER_SPACE;
+	if( FRAGMENT_HEADER_SIZE + prefixSize > payloadOffset )
+	{
+		payloadOffset = FRAGMENT_HEADER_SIZE + prefixSize;
+	}
+	
+	if( !packet->IsExclusive() )
+	{
+		idPacketBuffer* copy = packetBufferPool.Alloc();
+		CopyData( copy->GetBuffer() + payloadOffset, packet->GetPayload(), size );
+		packet->Release();
+		packet = copy;
+	}
+	else if( payloadOffset != idPacketBuffer::HEADER_SPACE )
+	{
+		memmove( packet->GetBuffer() + payloadOffset, packet->GetPayload(), size );
+		copiedBytes += size;
+	}
+	
+	if( unsentPacket != NULL )
+	{
+		unsentPacket->Release();
+	}
+	unsentPacket = packet;
+	unsentOffset = payloadOffset - prefixSize;
+	
+	CopyData( unsentPacket->GetBuffer() + unsentOffset, prefixBuffer, prefixSize );
+	unsentMsg.InitRead( unsentPacket->GetBuffer() + unsentOffset, prefixSize + size );
 	
 	if( unsentMsg.GetSize() > MAX_PACKET_SIZE )
 	{
@@ -385,27 +480,61 @@ idPacketProcessor::GetSendFragment
 ================================================
 */
 bool idPacketProcessor::GetSendFragment( const int time, sessionId_t sessionID, idBitMsg& outMsg )
+{
+	const byte* data = NULL;
+	int size = 0;
+	
+	if( !GetSendFragment( time, sessionID, data, size ) )
+	{
+		return false;
+	}
+	
+	outMsg.BeginWriting();
+	outMsg.WriteData( data, size );
+	copiedBytes += size;
+	
+	return true;
+}
+
+/*
+================================================
+idPacketProcessor::GetSendFragment
+
+The packet headers are written in place, right in front of the fragment data.  The first fragment
+uses the space reserved in front of the unsent msg, the next ones overwrite the end of the previous
+fragment, which the caller has already handed to the socket.
+================================================
+*/
+bool idPacketProcessor::GetSendFragment( const int time, sessionId_t sessionID, const byte*& data, int& size )
 {
 	lastSendTime = time;
 	
 	if( unsentMsg.GetRemainingData() <= 0 )
 	{
+		if( unsentPacket != NULL )
+		{
+			unsentPacket->Release();
+			unsentPacket = NULL;
+		}
 		return false;	// Nothing to send
 	}
 	
-	outMsg.BeginWriting();
-	
+	byte* fragment = unsentPacket->GetBuffer() + unsentOffset + unsentMsg.GetReadCount();
 	
 	idOuterPacketHeader	outerHeader( sessionID );
 	
-	// Write outer packet header to the msg
-	outerHeader.WriteToMsg( outMsg );
-	
 	if( !fragmentedSend )
 	{
 		// Simple case, no fragments to sent
-		outMsg.WriteData( unsentMsg.GetReadData(), unsentMsg.GetSize() );
-		unsentMsg.SetSize( 0 );
+		const int currentSize = unsentMsg.GetRemainingData();
+		
+		idBitMsg headerMsg( fragment - 2, 2 );
+		outerHeader.WriteToMsg( headerMsg );
+		
+		unsentMsg.ReadData( NULL, currentSize );
+		
+		data = fragment - 2;
+		size = 2 + currentSize;
 	}
 	else
 	{
@@ -416,22 +545,29 @@ bool idPacketProcessor::GetSendFragment( const int time, sessionId_t sessionID,
 		// See if we'll have more fragments once we subtract off how much we're about to write
 		bool moreFragments = ( unsentMsg.GetRemainingData() - currentSize > 0 ) ? true : false;
 		
+		idBitMsg headerMsg( fragment - FRAGMENT_HEADER_SIZE, FRAGMENT_HEADER_SIZE );
+		outerHeader.WriteToMsg( headerMsg );
+		
 		if( !unsentMsg.GetReadCount() )  		// If this is the first read, then we know it's the first fragment
 		{
 			assert( moreFragments );			// If we have a first, we must have more or something went wrong
 			idInnerPacketHeader header( PACKET_TYPE_FRAGMENTED, FRAGMENT_START );
-			header.WriteToMsg( outMsg );
+			header.WriteToMsg( headerMsg );
 		}
 		else
 		{
 			idInnerPacketHeader header( PACKET_TYPE_FRAGMENTED, moreFragments ? FRAGMENT_MIDDLE : FRAGMENT_END );
-			header.WriteToMsg( outMsg );
+			header.WriteToMsg( headerMsg );
 		}
 		
-		outMsg.WriteLong( fragmentSequence );
-		outMsg.WriteData( unsentMsg.GetReadData() + unsentMsg.GetReadCount(), currentSize );
+		headerMsg.WriteLong( fragmentSequence );
+		assert( headerMsg.GetRemainingSpace() == 0 );
+		
 		unsentMsg.ReadData( NULL, currentSize );
 		
+		data = fragment - FRAGMENT_HEADER_SIZE;
+		size = FRAGMENT_HEADER_SIZE + currentSize;
+		
 		assert( moreFragments == unsentMsg.GetRemainingData() > 0 );
 		fragmentedSend = moreFragments;
 		
@@ -442,7 +578,7 @@ bool idPacketProcessor::GetSendFragment( const int time, sessionId_t sessionID,
 	
 	
 	// The caller needs to send this packet, so assume he did, and update rates
-	UpdateOutgoingRate( time, outMsg.GetSize() );
+	UpdateOutgoingRate( time, size );
 	
 	return true;
 }
@@ -486,6 +622,12 @@ int idPacketProcessor::ProcessIncoming( int time, sessionId_t expectedSessionID,
 	if( header.Type() != PACKET_TYPE_FRAGMENTED )
 	{
 		// Non fragmented
+		if( incomingPacket != NULL && msgWritePos == 0 )
+		{
+			// The last reconstructed msg has been read by now, give its buffer back
+			incomingPacket->Release();
+			incomingPacket = NULL;
+		}
 		msg.RestoreReadState( c, b );		// Reset since we took a byte to check the type
 		return FinalizeRead( msg, out, userData );
 	}
@@ -496,8 +638,12 @@ int idPacketProcessor::ProcessIncoming( int time, sessionId_t expectedSessionID,
 	if( header.Value() == FRAGMENT_START )
 	{
 		msgWritePos = 0;				// Reset msg reconstruction write pos
+		if( incomingPacket == NULL )
+		{
+			incomingPacket = packetBufferPool.Alloc();
+		}
 	}
-	else if( fragmentSequence == -1 || readSequence != fragmentSequence + 1 )
+	else if( fragmentSequence == -1 || readSequence != fragmentSequence + 1 || msgWritePos == 0 )
 	{
 		droppedFrags++;
 		idLib::Printf( "Dropped Fragments - PeerNum: %i FragmentSeq: %i, ReadSeq: %i, Total: %i\n", peerNum, fragmentSequence, readSequence, droppedFrags );
@@ -509,19 +655,19 @@ int idPacketProcessor::ProcessIncoming( int time, sessionId_t expectedSessionID,
 	fragmentSequence = readSequence;
 	assert( msg.GetRemainingData() > 0 );
 	
-	if( !verify( msgWritePos + msg.GetRemainingData() < sizeof( msgBuffer ) ) )
+	if( !verify( msgWritePos + msg.GetRemainingData() < MAX_MSG_SIZE ) )
 	{
 		idLib::Error( "ProcessIncoming: Fragmented msg buffer overflow." );
 	}
 	
-	memcpy( msgBuffer + msgWritePos, msg.GetReadData() + msg.GetReadCount(), msg.GetRemainingData() );
+	CopyData( incomingPacket->GetBuffer() + msgWritePos, msg.GetReadData() + msg.GetReadCount(), msg.GetRemainingData() );
 	msgWritePos += msg.GetRemainingData();
 	
 	if( header.Value() == FRAGMENT_END )
 	{
-		// Done reconstructing the msg
-		idBitMsg msg( msgBuffer, sizeof( msgBuffer ) );
-		msg.SetSize( msgWritePos );
+		// Done reconstructing the msg, out reads it from incomingPacket, which is released on the next call
+		idBitMsg msg( ( const byte* )incomingPacket->GetBuffer(), msgWritePos );
+		msgWritePos = 0;
 		return FinalizeRead( msg, out, userData );
 	}
 	
@@ -591,9 +737,7 @@ bool idPacketProcessor::ProcessConnectionlessIncoming( idBitMsg& msg, idBitMsg&
 	
 	userData = header.Value();
 	
-	out.BeginWriting();
-	out.WriteData( msg.GetReadData() + msg.GetReadCount(), msg.GetRemainingData() );
-	out.SetSize( msg.GetRemainingData() );
+	out.InitRead( msg.GetReadData() + msg.GetReadCount(), msg.GetRemainingData() );
 	
 	return true;
 }
@@ -30,6 +30,8 @@ If you have questions concerning this license or the applicable additional terms
 #ifndef __PACKET_PROCESSOR_H__
 #define __PACKET_PROCESSOR_H__
 
+class idPacketBuffer;
+
 /*
 ================================================
 idPacketProcessor
@@ -57,11 +59,20 @@ public:
 	
 	idPacketProcessor()
 	{
+		unsentPacket			= NULL;
+		incomingPacket			= NULL;
 		Reset();
 	}
 	
+	~idPacketProcessor()
+	{
+		ReleasePackets();
+	}
+	
 	void Reset()
 	{
+		ReleasePackets();
+		
 		msgWritePos				= 0;
 		fragmentSequence		= 0;
 		droppedFrags			= 0;
@@ -77,6 +88,7 @@ public:
 		queuedReliableAck		= -1;
 		
 		unsentMsg = idBitMsg();
+		unsentOffset			= 0;
 		
 		lastSendTime			= 0;
 		
@@ -97,7 +109,10 @@ public:
 		
 		fragmentAccumulator		= 0;
 		
-		
+		copiedBytes				= 0;
+		currentCopyRate			= 0;
+		lastCopyRateTime		= 0;
+		lastCopiedBytes			= 0;
 	}
 	
 	static const int MAX_MSG_SIZE			= 8000;							// This is the max size you can pass into ProcessOutgoing
@@ -112,6 +127,13 @@ public:
 private:
 	void QueueReliableAck( int lastReliable );
 	int FinalizeRead( idBitMsg& inMsg, idBitMsg& outMsg, int& userValue );
+	void ReleasePackets();
+	void UpdateCopyRate( const int time );
+	void CopyData( void* dest, const void* src, int size )
+	{
+		memcpy( dest, src, size );
+		copiedBytes += size;
+	}
 	
 public:
 	bool CanSendMoreData() const;
@@ -128,9 +150,16 @@ public:
 	bool QueueReliableMessage( byte type, const byte* data, int dataLen );
 	// Used to process a msg ready to be sent, could get fragmented into multiple fragments
 	bool ProcessOutgoing( const int time, const idBitMsg& msg, bool isOOB, int userData );
+	// Same as above, but sends the size bytes at packet->GetPayload() without copying them.
+	// Takes over the caller's reference, AddRef first to keep using the packet (it is then copied instead).
+	bool ProcessOutgoing( const int time, idPacketBuffer* packet, int size, bool isOOB, int userData );
 	// Used to get each fragment for sending through the actual net connection
 	bool GetSendFragment( const int time, sessionId_t sessionID, idBitMsg& outMsg );
+	// Same as above, but points data at the finished fragment inside the packet buffer.
+	// The fragment is only valid until the next call, so it must be handed to the socket right away.
+	bool GetSendFragment( const int time, sessionId_t sessionID, const byte*& data, int& size );
 	// Used to process a fragment received.  Returns true when msg was reconstructed.
+	// out is set up to read the msg in place, so it is only valid until the next call.
 	int ProcessIncoming( int time, sessionId_t expectedSessionID, idBitMsg& msg, idBitMsg& out, int& userData, const int peerNum );
 	
 	// Returns true if there are more fragments to send
@@ -153,6 +182,7 @@ public:
 	// Used for out-of-band non connected peers
 	// This doesn't actually support fragmentation, it is just simply here to hide the
 	// header structure, so the caller doesn't have to skip over the header data.
+	// The incoming out msg reads from the data of msg.
 	static bool ProcessConnectionlessOutgoing( idBitMsg& msg, idBitMsg& out, int lobbyType, int userData );
 	static bool ProcessConnectionlessIncoming( idBitMsg& msg, idBitMsg& out, int& userData );
 	
@@ -222,6 +252,20 @@ public:
 		return reliable.GetDataLength();
 	}
 	
+	// Bytes copied on the way between the game and the socket (the socket's own copy isn't counted)
+	void			AddCopiedBytes( int size )
+	{
+		copiedBytes += size;
+	}
+	int				GetCopiedBytes() const
+	{
+		return copiedBytes;
+	}
+	int				GetCopyRate() const
+	{
+		return currentCopyRate;
+	}
+	
 	void			VerifyEmptyReliableQueue( byte keepMsgBelowThis, byte replaceWithThisMsg );
 	
 private:
@@ -240,6 +284,8 @@ private:
 	static const int FRAGMENT_END;	//			= 2;
 	// DG end
 	
+	static const int FRAGMENT_HEADER_SIZE		= 2 + 1 + 4;	// outer header, inner header and fragment sequence, reserved in front of the unsent msg
+	
 	class idOuterPacketHeader
 	{
 	public:
@@ -296,7 +342,7 @@ private:
 		int			userData;
 	};
 	
-	byte			msgBuffer[ MAX_MSG_SIZE ];					// Buffer used to reconstruct the msg
+	idPacketBuffer* incomingPacket;								// Buffer used to reconstruct the msg, only held while reconstructing
 	int				msgWritePos;								// Write position into the msg reconstruction buffer
 	int				fragmentSequence;							// Fragment sequence number
 	int				droppedFrags;								// Number of dropped fragments
@@ -315,8 +361,10 @@ private:
 	
 	int				queuedReliableAck;							// Used to piggy back on the next send to ack reliables
 	
-	idBitMsg		unsentMsg;
-	byte			unsentBuffer[ MAX_MSG_SIZE ];				// Buffer used hold the current msg until it's all sent
+	idBitMsg		unsentMsg;									// Reads the current msg from unsentPacket until it's all sent
+	idPacketBuffer* unsentPacket;
+	int				unsentOffset;								// Offset of unsentMsg in unsentPacket
+	byte			prefixBuffer[ MAX_MSG_SIZE ];				// Used to build the headers and reliables that go in front of the msg
 	
 	int				lastSendTime;
 	
@@ -338,6 +386,11 @@ private:
 	
 	
 	int				fragmentAccumulator;	// counts max size packets we are sending for the net debug hud
+	
+	int				copiedBytes;
+	int				currentCopyRate;
+	int				lastCopyRateTime;
+	int				lastCopiedBytes;
 };
 
 #endif /* !__PACKET_PROCESSOR_H__ */
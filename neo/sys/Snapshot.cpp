@@ -230,6 +230,7 @@ void idSnapShot::operator=( const idSnapShot& other )
 			state.changedCount	= otherState.changedCount;
 			state.expectedSequence = otherState.expectedSequence;
 			state.createdFromTemplate = otherState.createdFromTemplate;
+			memcpy( state.priority, otherState.priority, sizeof( state.priority ) );
 		}
 		time = other.time;
 		recvTime = other.recvTime;
@@ -241,10 +242,11 @@ void idSnapShot::operator=( const idSnapShot& other )
 idSnapShot::PeekDeltaSequence
 ========================
 */
-void idSnapShot::PeekDeltaSequence( const char* deltaMem, int deltaSize, int& sequence, int& baseSequence )
+void idSnapShot::PeekDeltaSequence( const char* deltaMem, int deltaSize, int& sequence, int& baseSequence, snapCompressor_t compressor )
 {
-	lzwCompressionData_t	lzwData;
-	idLZWCompressor			lzwCompressor( &lzwData );
+	snapCompressionData_t	lzwData;
+	lzwData.compressor = compressor;
+	idSnapCompressor		lzwCompressor( &lzwData );
 	
 	lzwCompressor.Start( ( uint8_t* )deltaMem, deltaSize );
 	lzwCompressor.ReadAgnostic( sequence );
@@ -256,15 +258,16 @@ void idSnapShot::PeekDeltaSequence( const char* deltaMem, int deltaSize, int& se
 idSnapShot::ReadDeltaForJob
 ========================
 */
-bool idSnapShot::ReadDeltaForJob( const char* deltaMem, int deltaSize, int visIndex, idSnapShot* templateStates )
+bool idSnapShot::ReadDeltaForJob( const char* deltaMem, int deltaSize, int visIndex, idSnapShot* templateStates, snapCompressor_t compressor )
 {
 
 	bool report = net_verboseSnapshotReport.GetBool();
 	net_verboseSnapshotReport.SetBool( false );
 	
-	lzwCompressionData_t		lzwData;
+	snapCompressionData_t		lzwData;
+	lzwData.compressor = compressor;
 	idZeroRunLengthCompressor	rleCompressor;
-	idLZWCompressor				lzwCompressor( &lzwData );
+	idSnapCompressor			lzwCompressor( &lzwData );
 	int bytesRead = 0; // how many uncompressed bytes we read in. Used to figure out compression ratio
 	
 	lzwCompressor.Start( ( uint8_t* )deltaMem, deltaSize );
@@ -530,7 +533,17 @@ void idSnapShot::SubmitObjectJob(	const submitDeltaJobsInfo_t& 	submitDeltaJobsI
 	assert_16_byte_aligned( curObjParm->newState.data );
 	assert_16_byte_aligned( curObjParm->oldState.data );
 	
-	SnapshotObjectJob( curObjParm );
+	idSnapDeltaCache* deltaCache = submitDeltaJobsInfo.deltaCache;
+	
+	if( deltaCache == NULL || !deltaCache->Find( *curObjParm, *curHeader ) )
+	{
+		SnapshotObjectJob( curObjParm );
+		
+		if( deltaCache != NULL )
+		{
+			deltaCache->Store( *curObjParm, *curHeader );
+		}
+	}
 	
 	// Advance past header + data
 	curObjDest += totalSize;
@@ -686,6 +699,12 @@ void idSnapShot::SubmitWriteDeltaToJobs( const submitDeltaJobsInfo_t& submitDelt
 				// New state (even though snapObj existed, its size was zero)
 				oldState = GetTemplateState( newState.objectNum, submitDeltaJobInfo.templateStates, &newState );
 			}
+			else if( newState.objectNum < submitDeltaJobInfo.numHeldObjects && submitDeltaJobInfo.heldObjects[newState.objectNum] != 0 )
+			{
+				// Held back to a later snapshot, leaving it out acks the old state like an unchanged object
+				j++;
+				continue;
+			}
 			
 			SubmitObjectJob( submitDeltaJobInfo, &newState, oldState, baseObjParms, curObjParms, curHeader, curObjMemory, curlzwParms );
 			j++;
@@ -715,6 +734,64 @@ void idSnapShot::SubmitWriteDeltaToJobs( const submitDeltaJobsInfo_t& submitDelt
 	SubmitLZWJob( submitDeltaJobInfo, baseObjParms, curObjParms, curlzwParms, false );
 }
 
+/*
+========================
+idSnapShot::GetPriorityCandidates
+========================
+*/
+void idSnapShot::GetPriorityCandidates( const idSnapShot& old, int visIndex, idList< priorityCandidate_t, TAG_NETWORKING >& candidates ) const
+{
+	candidates.SetNum( 0 );
+	
+	if( visIndex <= 0 || visIndex > MAX_PRIORITY_PEERS )
+	{
+		return;
+	}
+	
+	const uint32_t visBit = 1 << visIndex;
+	
+	int j = 0;
+	
+	for( int i = 0; i < objectStates.Num(); i++ )
+	{
+		objectState_t& newState = *objectStates[i];
+		
+		// both lists are sorted by object number
+		for( ; j < old.objectStates.Num() && old.objectStates[j]->objectNum < newState.objectNum; j++ )
+		{
+		}
+		
+		if( j >= old.objectStates.Num() )
+		{
+			break;		// everything from here on is new
+		}
+		
+		objectState_t& oldState = *old.objectStates[j];
+		
+		if( oldState.objectNum != newState.objectNum || oldState.buffer.Size() == 0 || newState.buffer.Size() == 0 )
+		{
+			continue;	// created
+		}
+		
+		if( ( ( oldState.visMask ^ newState.visMask ) & visBit ) != 0 || ( newState.visMask & visBit ) == 0 )
+		{
+			continue;	// going stale or coming back, or stale and nothing to send
+		}
+		
+		if( newState.buffer.Size() == oldState.buffer.Size() &&
+				( newState.buffer.Ptr() == oldState.buffer.Ptr() || memcmp( newState.buffer.Ptr(), oldState.buffer.Ptr(), newState.buffer.Size() ) == 0 ) )
+		{
+			continue;	// unchanged, costs nothing
+		}
+		
+		priorityCandidate_t& candidate = candidates.Alloc();
+		candidate.objectNum	= newState.objectNum;
+		candidate.priority	= newState.priority[visIndex - 1];
+		candidate.size		= newState.buffer.Size();
+		candidate.score		= 0.0f;
+	}
+}
+
 /*
 ========================
 idSnapShot::ReadDelta
@@ -1078,6 +1155,7 @@ idSnapShot::objectState_t* idSnapShot::S_AddObject( int objectNum, uint32_t visM
 	objectSize_t size = _size;
 	objectState_t& state = FindOrCreateObjectByID( objectNum );
 	state.visMask = visMask;
+	memset( state.priority, PRIORITY_ALWAYS, sizeof( state.priority ) );
 	if( state.buffer.Size() == size && state.buffer.NumRefs() == 1 )
 	{
 		// re-use the same buffer
@@ -1092,6 +1170,53 @@ idSnapShot::objectState_t* idSnapShot::S_AddObject( int objectNum, uint32_t visM
 	return &state;
 }
 
+/*
+========================
+idSnapShot::ShareObjectBuffers
+========================
+*/
+void idSnapShot::ShareObjectBuffers( idSnapShot& shared )
+{
+	int j = 0;
+	
+	for( int i = 0; i < objectStates.Num(); i++ )
+	{
+		objectState_t& state = *objectStates[i];
+		
+		// both lists are sorted by object number
+		for( ; j < shared.objectStates.Num() && shared.objectStates[j]->objectNum < state.objectNum; j++ )
+		{
+		}
+		
+		if( j >= shared.objectStates.Num() )
+		{
+			break;
+		}
+		
+		objectState_t& sharedState = *shared.objectStates[j];
+		
+		if( sharedState.objectNum != state.objectNum )
+		{
+			continue;
+		}
+		
+		if( state.buffer.Size() == 0 || state.buffer.Ptr() == sharedState.buffer.Ptr() || state.buffer.Size() != sharedState.buffer.Size() )
+		{
+			continue;
+		}
+		
+		if( sharedState.buffer.NumRefs() >= objectBuffer_t::MAX_REFS )
+		{
+			continue;
+		}
+		
+		if( memcmp( state.buffer.Ptr(), sharedState.buffer.Ptr(), state.buffer.Size() ) == 0 )
+		{
+			state.buffer = sharedState.buffer;
+		}
+	}
+}
+
 /*
 ========================
 idSnapShot::CopyObject
@@ -1117,6 +1242,7 @@ bool idSnapShot::CopyObject( const idSnapShot& oldss, int objectNum, bool forceS
 	newState.changedCount	= oldState.changedCount;
 	newState.expectedSequence = oldState.expectedSequence;
 	newState.createdFromTemplate = oldState.createdFromTemplate;
+	memcpy( newState.priority, oldState.priority, sizeof( newState.priority ) );
 	
 	if( forceStale )
 	{
@@ -1471,3 +1597,217 @@ CONSOLE_COMMAND( serializeQTest, "Serialization Sanity Test", 0 )
 	}
 }
 #endif
+
+/*
+========================
+idSnapDeltaCache::idSnapDeltaCache
+========================
+*/
+idSnapDeltaCache::idSnapDeltaCache() :
+	entries( NULL ),
+	numEntries( 0 ),
+	maxEntries( 0 ),
+	memory( NULL ),
+	usedMemory( 0 ),
+	maxMemory( 0 ),
+	numHits( 0 ),
+	numMisses( 0 )
+{
+}
+
+/*
+========================
+idSnapDeltaCache::~idSnapDeltaCache
+========================
+*/
+idSnapDeltaCache::~idSnapDeltaCache()
+{
+	Shutdown();
+}
+
+/*
+========================
+idSnapDeltaCache::Init
+========================
+*/
+void idSnapDeltaCache::Init( int maxObjects, int maxMemory_ )
+{
+	Shutdown();
+	
+	maxEntries	= maxObjects;
+	maxMemory	= maxMemory_;
+	entries		= ( entry_t* )Mem_Alloc( maxEntries * sizeof( entry_t ), TAG_NETWORKING );
+	memory		= ( uint8_t* )Mem_Alloc( maxMemory, TAG_NETWORKING );
+	
+	assert_16_byte_aligned( memory );
+	
+	hash.Clear( idMath::CeilPowerOfTwo( maxEntries ), maxEntries );
+	
+	Clear();
+}
+
+/*
+========================
+idSnapDeltaCache::Shutdown
+========================
+*/
+void idSnapDeltaCache::Shutdown()
+{
+	Mem_Free( entries );
+	Mem_Free( memory );
+	entries		= NULL;
+	memory		= NULL;
+	maxEntries	= 0;
+	maxMemory	= 0;
+	hash.Free();
+	Clear();
+}
+
+/*
+========================
+idSnapDeltaCache::Clear
+========================
+*/
+void idSnapDeltaCache::Clear()
+{
+	hash.Clear();
+	numEntries	= 0;
+	usedMemory	= 0;
+	numHits		= 0;
+	numMisses	= 0;
+}
+
+/*
+========================
+idSnapDeltaCache::VisBits
+The only way visIndex changes the output of SnapshotObjectJob is through the visibility bits
+========================
+*/
+uint8_t idSnapDeltaCache::VisBits( const objParms_t& parms )
+{
+	if( parms.visIndex == 0 || !parms.newState.valid || !parms.oldState.valid )
+	{
+		return 3;
+	}
+	
+	uint8_t oldVisible = ( parms.oldState.visMask & ( 1 << parms.visIndex ) ) != 0;
+	uint8_t newVisible = ( parms.newState.visMask & ( 1 << parms.visIndex ) ) != 0;
+	
+	return ( oldVisible << 1 ) | newVisible;
+}
+
+/*
+========================
+idSnapDeltaCache::GenerateKey
+========================
+*/
+int idSnapDeltaCache::GenerateKey( const objParms_t& parms )
+{
+	uintptr_t newData = ( uintptr_t )parms.newState.data;
+	uintptr_t oldData = ( uintptr_t )parms.oldState.data;
+	
+	// buffers are at least 16 byte aligned, so skip the low bits
+	return ( int )( ( newData >> 4 ) * 31 + ( oldData >> 4 ) ) ^ ( parms.newState.objectNum | parms.oldState.objectNum );
+}
+
+/*
+========================
+idSnapDeltaCache::Matches
+========================
+*/
+bool idSnapDeltaCache::Matches( const entry_t& entry, const objParms_t& parms )
+{
+	const uint8_t* newData = parms.newState.valid ? parms.newState.data : NULL;
+	const uint8_t* oldData = parms.oldState.valid ? parms.oldState.data : NULL;
+	uint16_t newSize = parms.newState.valid ? parms.newState.size : 0;
+	uint16_t oldSize = parms.oldState.valid ? parms.oldState.size : 0;
+	uint16_t objectNum = parms.newState.valid ? parms.newState.objectNum : parms.oldState.objectNum;
+	
+	return entry.newData == newData && entry.oldData == oldData && entry.newSize == newSize && entry.oldSize == oldSize &&
+		   entry.objectNum == objectNum && entry.visBits == VisBits( parms );
+}
+
+/*
+========================
+idSnapDeltaCache::Find
+========================
+*/
+bool idSnapDeltaCache::Find( const objParms_t& parms, objHeader_t& header )
+{
+	if( entries == NULL )
+	{
+		return false;
+	}
+	
+	for( int i = hash.First( GenerateKey( parms ) ); i != -1; i = hash.Next( i ) )
+	{
+		const entry_t& entry = entries[i];
+		
+		if( !Matches( entry, parms ) )
+		{
+			continue;
+		}
+		
+		header.objID	= entry.objID;
+		header.size		= entry.size;
+		header.csize	= entry.csize;
+		header.flags	= entry.flags;
+		header.data		= memory + entry.dataOffset;
+#ifdef SNAPSHOT_CHECKSUMS
+		header.checksum	= entry.checksum;
+#endif
+		numHits++;
+		return true;
+	}
+	
+	numMisses++;
+	return false;
+}
+
+/*
+========================
+idSnapDeltaCache::Store
+========================
+*/
+void idSnapDeltaCache::Store( const objParms_t& parms, const objHeader_t& header )
+{
+	if( entries == NULL || numEntries >= maxEntries )
+	{
+		return;
+	}
+	
+	// the object job leaves the raw delta in place when it didn't fit zrle compressed
+	int dataSize = ( header.csize == -1 ) ? header.size : header.csize;
+	
+	if( usedMemory + OBJ_DEST_SIZE_ALIGN16( dataSize ) > maxMemory )
+	{
+		return;
+	}
+	
+	entry_t& entry = entries[numEntries];
+	
+	entry.newData		= parms.newState.valid ? parms.newState.data : NULL;
+	entry.oldData		= parms.oldState.valid ? parms.oldState.data : NULL;
+	entry.newSize		= parms.newState.valid ? parms.newState.size : 0;
+	entry.oldSize		= parms.oldState.valid ? parms.oldState.size : 0;
+	entry.objectNum		= parms.newState.valid ? parms.newState.objectNum : parms.oldState.objectNum;
+	entry.visBits		= VisBits( parms );
+	
+	entry.objID			= header.objID;
+	entry.size			= header.size;
+	entry.csize			= header.csize;
+	entry.flags			= header.flags;
+	entry.dataOffset	= usedMemory;
+#ifdef SNAPSHOT_CHECKSUMS
+	entry.checksum		= header.checksum;
+#endif
+	
+	if( dataSize > 0 )
+	{
+		memcpy( memory + usedMemory, header.data, dataSize );
+		usedMemory += OBJ_DEST_SIZE_ALIGN16( dataSize );
+	}
+	
+	hash.Add( GenerateKey( parms ), numEntries );
+	numEntries++;
+}
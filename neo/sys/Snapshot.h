@@ -36,6 +36,8 @@ extern idCVar net_verboseSnapshot;
 #define NET_VERBOSESNAPSHOT_PRINT	if ( net_verboseSnapshot.GetInteger() > 0 ) idLib::Printf
 #define NET_VERBOSESNAPSHOT_PRINT_LEVEL( X, Y )  if ( net_verboseSnapshot.GetInteger() >= ( X ) ) idLib::Printf( Y )
 
+class idSnapDeltaCache;
+
 /*
 A snapshot contains a list of objects and their states
 */
@@ -70,15 +72,18 @@ public:
 	}
 	
 	// Loads only sequence and baseSequence values from the compressed stream
-	static void PeekDeltaSequence( const char* deltaMem, int deltaSize, int& sequence, int& baseSequence );
+	static void PeekDeltaSequence( const char* deltaMem, int deltaSize, int& sequence, int& baseSequence, snapCompressor_t compressor );
 	
 	// Reads a new object state packet, which is assumed to be delta compressed against this snapshot
-	bool ReadDeltaForJob( const char* deltaMem, int deltaSize, int visIndex, idSnapShot* templateStates );
+	bool ReadDeltaForJob( const char* deltaMem, int deltaSize, int visIndex, idSnapShot* templateStates, snapCompressor_t compressor );
 	bool ReadDelta( idFile* file, int visIndex );
 	
 	// Writes an object state packet which is delta compressed against the old snapshot
 	struct objectBuffer_t
 	{
+		// the reference count is a byte after the data, leave headroom when sharing buffers
+		static const int MAX_REFS = 224;
+		
 		objectBuffer_t() : data( NULL ), size( 0 ) { }
 		objectBuffer_t( int s ) : data( NULL ), size( s )
 		{
@@ -119,6 +124,11 @@ public:
 		objectSize_t	size;
 	};
 	
+	// Objects can be given a priority per peer, which idSnapshotProcessor accumulates to decide which changed
+	// objects fit in the peer's snapshot budget. Objects left at PRIORITY_ALWAYS are sent whenever they change.
+	static const int		MAX_PRIORITY_PEERS	= 8;		// indexed by visIndex - 1, the lobby has at most MAX_PLAYERS peers
+	static const uint8_t	PRIORITY_ALWAYS		= 255;
+	
 	struct objectState_t
 	{
 		objectState_t() :
@@ -129,7 +139,9 @@ public:
 			changedCount( 0 ),
 			expectedSequence( 0 ),
 			createdFromTemplate( false )
-		{ }
+		{
+			memset( priority, PRIORITY_ALWAYS, sizeof( priority ) );
+		}
 		void Print( const char* name );
 		
 		uint16_t			objectNum;
@@ -140,6 +152,16 @@ public:
 		int				changedCount;	// Incremented each time the state changed
 		int				expectedSequence;
 		bool			createdFromTemplate;
+		uint8_t			priority[MAX_PRIORITY_PEERS];	// server only, how fast this object gains priority for each peer
+	};
+	
+	// An object that changed since the base state of a peer, which may be held back to a later snapshot unless it's PRIORITY_ALWAYS
+	struct priorityCandidate_t
+	{
+		uint16_t		objectNum;
+		uint8_t			priority;
+		int				size;
+		float			score;			// filled in by idSnapshotProcessor
 	};
 	
 	struct submitDeltaJobsInfo_t
@@ -160,12 +182,21 @@ public:
 		idSnapShot* 		templateStates;			// states for new snapObj that arent in old states
 		
 		lzwInOutData_t* 	lzwInOutData;
+		
+		idSnapDeltaCache*	deltaCache;				// Encoded objects shared with the other peers submitted this frame (can be NULL)
+		
+		const uint8_t*		heldObjects;			// Indexed by object number, non zero for changed objects that are held back to a later snapshot (can be NULL)
+		int					numHeldObjects;
 	};
 	
 	void SubmitWriteDeltaToJobs( const submitDeltaJobsInfo_t& submitDeltaJobInfo );
 	
 	bool WriteDelta( idSnapShot& old, int visIndex, idFile* file, int maxLength, int optimalLength = 0 );
 	
+	// Lists the objects that differ from the old snapshot for this peer and will be written as plain deltas.
+	// Creates, deletes and visibility changes always have to be sent, so they are left out.
+	void GetPriorityCandidates( const idSnapShot& old, int visIndex, idList< priorityCandidate_t, TAG_NETWORKING >& candidates ) const;
+	
 	// Adds an object to the state, overwrites any existing object with the same number
 	objectState_t* S_AddObject( int objectNum, uint32_t visMask, const idBitMsg& msg, const char* tag = NULL )
 	{
@@ -177,6 +208,10 @@ public:
 	}
 	objectState_t* S_AddObject( int objectNum, uint32_t visMask, const char* buffer, int size, const char* tag = NULL );
 	bool CopyObject( const idSnapShot& oldss, int objectNum, bool forceStale = false );
+	
+	// Replaces object buffers with identical ones from the shared snapshot, so the states of all peers
+	// reference a single copy of each object, and can be delta'd by pointer instead of by content
+	void ShareObjectBuffers( idSnapShot& shared );
 	int CompareObject( const idSnapShot* oldss, int objectNum, int start = 0, int end = 0, int oldStart = 0 );
 	
 	// returns the number of objects in this snapshot
@@ -248,4 +283,72 @@ private:
 	void FreeObjectState( int index );
 };
 
+/*
+================================================
+idSnapDeltaCache
+Holds the delta'd + zrle encoded objects written for the peers submitted in one frame.
+Peers with the same base state for an object (same shared buffers, same visibility)
+would produce identical output, so SnapshotObjectJob only runs once for them.
+The cache is keyed on buffer pointers, so it must be cleared before any of the
+buffers it has seen can be freed.
+================================================
+*/
+class idSnapDeltaCache
+{
+public:
+	idSnapDeltaCache();
+	~idSnapDeltaCache();
+	
+	void	Init( int maxObjects, int maxMemory );
+	void	Shutdown();
+	void	Clear();
+	
+	// Fills in header if these parms were already encoded, header->data will point into the cache
+	bool	Find( const objParms_t& parms, objHeader_t& header );
+	void	Store( const objParms_t& parms, const objHeader_t& header );
+	
+	int		GetNumHits() const
+	{
+		return numHits;
+	}
+	int		GetNumMisses() const
+	{
+		return numMisses;
+	}
+	
+private:
+	struct entry_t
+	{
+		const uint8_t* 	newData;
+		const uint8_t* 	oldData;
+		uint16_t		newSize;
+		uint16_t		oldSize;
+		uint16_t		objectNum;
+		uint8_t			visBits;
+		
+		int32_t			objID;
+		int32_t			size;
+		int32_t			csize;
+		uint32_t		flags;
+		int				dataOffset;
+#ifdef SNAPSHOT_CHECKSUMS
+		uint32_t		checksum;
+#endif
+	};
+	
+	static uint8_t	VisBits( const objParms_t& parms );
+	static int		GenerateKey( const objParms_t& parms );
+	static bool		Matches( const entry_t& entry, const objParms_t& parms );
+	
+	idHashIndex		hash;
+	entry_t* 		entries;
+	int				numEntries;
+	int				maxEntries;
+	uint8_t* 		memory;
+	int				usedMemory;
+	int				maxMemory;
+	int				numHits;
+	int				numMisses;
+};
+
 #endif // __SNAPSHOT_H__
@@ -33,6 +33,13 @@ If you have questions concerning this license or the applicable additional terms
 idCVar net_optimalSnapDeltaSize( "net_optimalSnapDeltaSize", "1000", CVAR_INTEGER, "Optimal size of snapshot delta msgs." );
 idCVar net_debugBaseStates( "net_debugBaseStates", "0", CVAR_BOOL, "Log out base state information" );
 idCVar net_skipClientDeltaAppend( "net_skipClientDeltaAppend", "0", CVAR_BOOL, "Simulate delta receive buffer overflowing" );
+idCVar net_snapCompressor( "net_snapCompressor", "2", CVAR_INTEGER, "Best snapshot compression stage offered to peers. 0 = legacy lzw, 1 = byte lz, 2 = byte lz with static dictionary", 0, SNAP_COMPRESSOR_MAX - 1 );
+idCVar net_snapDictionary( "net_snapDictionary", "network/snapshot.dict", CVAR_INIT, "Static dictionary used by the snapshot lz stage" );
+idCVar net_snapRecordStreams( "net_snapRecordStreams", "0", CVAR_BOOL, "Record the uncompressed snapshot streams sent to peers, for net_snapTrainDictionary and net_snapCompressionBenchmark" );
+idCVar net_snapRecordFile( "net_snapRecordFile", "network/snapshots.rec", 0, "File net_snapRecordStreams appends to" );
+idCVar net_snapPriority( "net_snapPriority", "1", CVAR_BOOL, "Hold back changed snapshot objects that don't fit a peer's budget, sending them by accumulated priority" );
+idCVar net_snapPriorityBudget( "net_snapPriorityBudget", "3000", CVAR_INTEGER, "Bytes of changed object state sent to each peer per snapshot, before objects are held back", 256, 65536 );
+idCVar net_snapPriorityMaxHold( "net_snapPriorityMaxHold", "1000", CVAR_INTEGER, "Longest time in milliseconds a changed object is held back", 0, 10000 );
 
 /*
 ========================
@@ -51,6 +58,8 @@ idSnapshotProcessor::idSnapshotProcessor()
 	assert_16_byte_aligned( jobMemory->headers.Ptr() );
 	assert_16_byte_aligned( jobMemory->lzwParms.Ptr() );
 	
+	compressor = SNAP_COMPRESSOR_LZW;
+	
 	Reset( true );
 }
 
@@ -90,6 +99,11 @@ void idSnapshotProcessor::Reset( bool cstor )
 	
 	partialBaseSequence = -1;
 	
+	objPriorities.Clear();
+	heldObjects.Clear();
+	lastPrioritySnapTime = 0;
+	numHeldObjects = 0;
+	
 	memset( &jobMemory->lzwInOutData, 0, sizeof( jobMemory->lzwInOutData ) );
 }
 
@@ -117,7 +131,7 @@ idSnapshotProcessor::PeekDeltaSequence
 */
 void idSnapshotProcessor::PeekDeltaSequence( const char* deltaMem, int deltaSize, int& deltaSequence, int& deltaBaseSequence )
 {
-	idSnapShot::PeekDeltaSequence( deltaMem, deltaSize, deltaSequence, deltaBaseSequence );
+	idSnapShot::PeekDeltaSequence( deltaMem, deltaSize, deltaSequence, deltaBaseSequence, compressor );
 }
 
 /*
@@ -127,7 +141,7 @@ idSnapshotProcessor::ApplyDeltaToSnapshot
 */
 bool idSnapshotProcessor::ApplyDeltaToSnapshot( idSnapShot& snap, const char* deltaMem, int deltaSize, int visIndex )
 {
-	return snap.ReadDeltaForJob( deltaMem, deltaSize, visIndex, &templateStates );
+	return snap.ReadDeltaForJob( deltaMem, deltaSize, visIndex, &templateStates, compressor );
 }
 
 #ifdef STRESS_LZW_MEM
@@ -141,7 +155,7 @@ static int g_maxlwMem = 100;
 idSnapshotProcessor::SubmitPendingSnap
 ========================
 */
-void idSnapshotProcessor::SubmitPendingSnap( int visIndex, uint8_t* objMemory, int objMemorySize, lzwCompressionData_t* lzwData )
+void idSnapshotProcessor::SubmitPendingSnap( int visIndex, uint8_t* objMemory, int objMemorySize, snapCompressionData_t* lzwData, idSnapDeltaCache* deltaCache )
 {
 
 	assert_16_byte_aligned( objMemory );
@@ -170,6 +184,8 @@ void idSnapshotProcessor::SubmitPendingSnap( int visIndex, uint8_t* objMemory, i
 	jobMemory->lzwInOutData.lastObjId		= 0;
 	jobMemory->lzwInOutData.lzwData			= lzwData;
 	
+	lzwData->compressor						= compressor;
+	
 	idSnapShot::submitDeltaJobsInfo_t submitInfo;
 	
 	submitInfo.objParms			= jobMemory->objParms.Ptr();
@@ -194,10 +210,173 @@ void idSnapshotProcessor::SubmitPendingSnap( int visIndex, uint8_t* objMemory, i
 	submitInfo.baseSequence		= baseSequence;
 	
 	submitInfo.lzwInOutData		= &jobMemory->lzwInOutData;
+	submitInfo.deltaCache		= deltaCache;
+	
+	PrioritizePendingSnap( visIndex );
+	
+	submitInfo.heldObjects		= heldObjects.Ptr();
+	submitInfo.numHeldObjects	= heldObjects.Num();
 	
 	pendingSnap.SubmitWriteDeltaToJobs( submitInfo );
 }
 
+/*
+========================
+idSort_SnapPriority
+========================
+*/
+class idSort_SnapPriority : public idSort_Quick< idSnapShot::priorityCandidate_t, idSort_SnapPriority >
+{
+public:
+	int Compare( const idSnapShot::priorityCandidate_t& a, const idSnapShot::priorityCandidate_t& b ) const
+	{
+		if( a.score == b.score )
+		{
+			return a.objectNum - b.objectNum;
+		}
+		return ( a.score > b.score ) ? -1 : 1;
+	}
+};
+
+/*
+========================
+idSnapshotProcessor::PrioritizePendingSnap
+
+Every changed object of the pending snap builds up priority for this peer while it's held back, at the
+rate the game gave it (distance, visibility, relevance). The highest ones are sent until the budget is
+used up, the rest keep their acked state on the peer and compete again next snap. PRIORITY_ALWAYS
+objects, and objects held for net_snapPriorityMaxHold, are always sent.
+========================
+*/
+void idSnapshotProcessor::PrioritizePendingSnap( int visIndex )
+{
+	heldObjects.SetNum( 0 );
+	numHeldObjects = 0;
+	
+	if( !net_snapPriority.GetBool() )
+	{
+		return;
+	}
+	
+	// The first full snap has to make it across in one piece
+	if( lastFullSnapBaseSequence < INITIAL_SNAP_SEQUENCE )
+	{
+		return;
+	}
+	
+	pendingSnap.GetPriorityCandidates( baseState, visIndex, priorityCandidates );
+	
+	if( priorityCandidates.Num() == 0 )
+	{
+		return;
+	}
+	
+	// Resubmits of the same snap don't accumulate again, and keep the objects they already sent
+	const int snapTime = pendingSnap.GetTime();
+	const float elapsedSeconds = idMath::ClampFloat( 0.0f, 1.0f, ( snapTime - lastPrioritySnapTime ) * 0.001f );
+	lastPrioritySnapTime = snapTime;
+	
+	const int maxHold = net_snapPriorityMaxHold.GetInteger();
+	int maxObjectNum = 0;
+	
+	for( int i = 0; i < priorityCandidates.Num(); i++ )
+	{
+		idSnapShot::priorityCandidate_t& candidate = priorityCandidates[i];
+		
+		while( objPriorities.Num() <= candidate.objectNum )
+		{
+			objPriority_t& newPriority = objPriorities.Alloc();
+			newPriority.accumulated		= 0.0f;
+			newPriority.lastSentTime	= snapTime;
+		}
+		
+		objPriority_t& priority = objPriorities[candidate.objectNum];
+		priority.accumulated += candidate.priority * elapsedSeconds;
+		
+		if( candidate.priority == idSnapShot::PRIORITY_ALWAYS || priority.lastSentTime == snapTime || snapTime - priority.lastSentTime >= maxHold )
+		{
+			candidate.score = idMath::INFINITY;
+		}
+		else
+		{
+			candidate.score = priority.accumulated;
+		}
+		
+		maxObjectNum = Max( maxObjectNum, ( int )candidate.objectNum );
+	}
+	
+	priorityCandidates.SortWithTemplate( idSort_SnapPriority() );
+	
+	heldObjects.SetNum( maxObjectNum + 1 );
+	memset( heldObjects.Ptr(), 0, heldObjects.Num() );
+	
+	int budget = net_snapPriorityBudget.GetInteger();
+	
+	for( int i = 0; i < priorityCandidates.Num(); i++ )
+	{
+		const idSnapShot::priorityCandidate_t& candidate = priorityCandidates[i];
+		objPriority_t& priority = objPriorities[candidate.objectNum];
+		
+		if( candidate.score == idMath::INFINITY || candidate.size <= budget )
+		{
+			budget -= candidate.size;
+			priority.accumulated	= 0.0f;
+			priority.lastSentTime	= snapTime;
+		}
+		else
+		{
+			heldObjects[candidate.objectNum] = 1;
+			numHeldObjects++;
+		}
+	}
+	
+	NET_VERBOSESNAPSHOT_PRINT_LEVEL( 3, va( "NET: peer %d snap %d: %d changed objects, %d held back\n", visIndex - 1, snapTime, priorityCandidates.Num(), numHeldObjects ) );
+}
+
+/*
+========================
+RecordSnapshotStream
+Appends the uncompressed stream of a delta we are about to send to net_snapRecordFile.
+The recording is what net_snapTrainDictionary and net_snapCompressionBenchmark work from.
+========================
+*/
+static void RecordSnapshotStream( const uint8_t* deltaData, int deltaSize, snapCompressor_t compressor )
+{
+	static idFile* recordFile = NULL;
+	static snapCompressionData_t recordData;
+	static uint8_t stream[lzCompressionData_t::LZ_MAX_STREAM];
+	
+	if( !net_snapRecordStreams.GetBool() )
+	{
+		if( recordFile != NULL )
+		{
+			delete recordFile;
+			recordFile = NULL;
+		}
+		return;
+	}
+	
+	if( recordFile == NULL )
+	{
+		recordFile = fileSystem->OpenFileAppend( net_snapRecordFile.GetString() );
+		if( recordFile == NULL )
+		{
+			idLib::Warning( "RecordSnapshotStream: couldn't open %s", net_snapRecordFile.GetString() );
+			net_snapRecordStreams.SetBool( false );
+			return;
+		}
+	}
+	
+	recordData.compressor = compressor;
+	idSnapCompressor decompressor( &recordData );
+	decompressor.Start( ( uint8_t* )deltaData, deltaSize );
+	
+	int length = decompressor.Read( stream, sizeof( stream ), true );
+	
+	recordFile->WriteBig( length );
+	recordFile->Write( stream, length );
+}
+
 /*
 ========================
 idSnapshotProcessor::GetPendingSnapDelta
@@ -251,6 +430,11 @@ int idSnapshotProcessor::GetPendingSnapDelta( byte* outBuffer, int maxLength )
 	// Copy to out buffer
 	memcpy( outBuffer, deltaData, size );
 	
+	if( net_snapRecordStreams.GetBool() )
+	{
+		RecordSnapshotStream( deltaData, size, compressor );
+	}
+	
 	// Set the sequence to what this delta actually belongs to
 	assert( jobMemory->lzwDeltas[0].snapSequence == snapSequence + 1 );
 	snapSequence = jobMemory->lzwDeltas[0].snapSequence;
@@ -516,7 +700,7 @@ void idSnapshotProcessor::RemoveDeltasForOldBaseSequence()
 	{
 		int deltaSequence		= 0;
 		int deltaBaseSequence	= 0;
-		baseState.PeekDeltaSequence( ( const char* )deltas.ItemData( i ), deltas.ItemLength( i ), deltaSequence, deltaBaseSequence );
+		PeekDeltaSequence( ( const char* )deltas.ItemData( i ), deltas.ItemLength( i ), deltaSequence, deltaBaseSequence );
 		if( deltaBaseSequence < baseSequence )
 		{
 			// Remove this delta, and all deltas before this one
@@ -541,7 +725,7 @@ void idSnapshotProcessor::SanityCheckDeltas()
 	
 	for( int i = 0; i < deltas.Num(); i++ )
 	{
-		baseState.PeekDeltaSequence( ( const char* )deltas.ItemData( i ), deltas.ItemLength( i ), deltaSequence, deltaBaseSequence );
+		PeekDeltaSequence( ( const char* )deltas.ItemData( i ), deltas.ItemLength( i ), deltaSequence, deltaBaseSequence );
 		assert( deltaSequence == deltas.ItemSequence( i ) );	// Make sure delta stored in compressed form matches the one stored in the data queue
 		assert( deltaSequence > lastDeltaSequence );			// Make sure they are in order (we reject out of order sequences in ApplysnapshotDelta)
 		assert( deltaBaseSequence >= lastDeltaBaseSequence );	// Make sure they are in order (they can be the same, since base sequences don't change until they've been ack'd)
@@ -571,3 +755,491 @@ void idSnapshotProcessor::AddSnapObjTemplate( int objID, idBitMsg& msg )
 		state->expectedSequence = snapSequence;
 	}
 }
+
+/*
+========================
+idSnapshotProcessor::GetSupportedCompressors
+========================
+*/
+int idSnapshotProcessor::GetSupportedCompressors()
+{
+	int mask = 0;
+	for( int i = 0; i <= net_snapCompressor.GetInteger(); i++ )
+	{
+		if( i == SNAP_COMPRESSOR_LZ_DICT && idSnapCompressor::GetDictionary() == NULL )
+		{
+			continue;
+		}
+		mask |= BIT( i );
+	}
+	return mask;
+}
+
+/*
+========================
+idSnapshotProcessor::GetDictionaryChecksum
+========================
+*/
+uint32_t idSnapshotProcessor::GetDictionaryChecksum()
+{
+	const lzDictionary_t* dictionary = idSnapCompressor::GetDictionary();
+	return ( dictionary != NULL ) ? dictionary->checksum : 0;
+}
+
+/*
+========================
+idSnapshotProcessor::NegotiateCompressor
+========================
+*/
+snapCompressor_t idSnapshotProcessor::NegotiateCompressor( int remoteMask, uint32_t remoteChecksum )
+{
+	int mask = GetSupportedCompressors() & remoteMask;
+	
+	// Both sides need the exact same dictionary
+	if( remoteChecksum != GetDictionaryChecksum() )
+	{
+		mask &= ~BIT( SNAP_COMPRESSOR_LZ_DICT );
+	}
+	
+	for( int i = SNAP_COMPRESSOR_MAX - 1; i > SNAP_COMPRESSOR_LZW; i-- )
+	{
+		if( mask & BIT( i ) )
+		{
+			return ( snapCompressor_t )i;
+		}
+	}
+	return SNAP_COMPRESSOR_LZW;
+}
+
+/*
+========================
+idSnapshotProcessor::LoadCompressionDictionary
+========================
+*/
+void idSnapshotProcessor::LoadCompressionDictionary()
+{
+	void* buffer = NULL;
+	int length = fileSystem->ReadFile( net_snapDictionary.GetString(), &buffer );
+	
+	if( length <= 0 || buffer == NULL )
+	{
+		idSnapCompressor::SetDictionary( NULL, 0 );
+		return;
+	}
+	
+	idSnapCompressor::SetDictionary( ( const uint8_t* )buffer, length );
+	fileSystem->FreeFile( buffer );
+	
+	idLib::Printf( "Loaded snapshot dictionary %s (%d bytes, checksum 0x%08x)\n", net_snapDictionary.GetString(), length, GetDictionaryChecksum() );
+}
+
+/*
+========================
+LoadRecordedStreams
+Reads the streams recorded with net_snapRecordStreams, returns the number of streams
+========================
+*/
+static int LoadRecordedStreams( const char* fileName, idList< byte >& data, idList< int >& offsets )
+{
+	idFile* file = fileSystem->OpenFileRead( fileName );
+	if( file == NULL )
+	{
+		idLib::Printf( "Couldn't open %s, record some streams with net_snapRecordStreams 1 first\n", fileName );
+		return 0;
+	}
+	
+	data.SetNum( file->Length() );
+	
+	int total = 0;
+	int length = 0;
+	while( file->ReadBig( length ) == sizeof( length ) )
+	{
+		if( length <= 0 || length > lzCompressionData_t::LZ_MAX_STREAM || total + length > data.Num() )
+		{
+			break;
+		}
+		if( file->Read( &data[total], length ) != length )
+		{
+			break;
+		}
+		offsets.Append( total );
+		total += length;
+	}
+	offsets.Append( total );
+	
+	delete file;
+	
+	data.SetNum( total );
+	return offsets.Num() - 1;
+}
+
+/*
+========================
+net_snapTrainDictionary
+Builds a static dictionary out of the segments of the recorded streams whose substrings show up in the most streams.
+The best segments are placed at the end of the dictionary, closest to the data, so matches against them get the shortest offsets.
+========================
+*/
+static const int DICT_DMER_SIZE		= 8;
+static const int DICT_SEGMENT_SIZE	= 64;
+static const int DICT_HASH_BITS		= 20;
+
+static int DictHash( const byte* bytes )
+{
+	uint64_t dmer;
+	memcpy( &dmer, bytes, sizeof( dmer ) );
+	return ( int )( ( dmer * 0x9E3779B97F4A7C15ULL ) >> ( 64 - DICT_HASH_BITS ) );
+}
+
+CONSOLE_COMMAND( net_snapTrainDictionary, "Trains the snapshot compression dictionary on recorded streams. usage: net_snapTrainDictionary [recordFile] [dictionaryFile]", 0 )
+{
+	const char* recordFile = ( args.Argc() > 1 ) ? args.Argv( 1 ) : net_snapRecordFile.GetString();
+	const char* dictFile = ( args.Argc() > 2 ) ? args.Argv( 2 ) : net_snapDictionary.GetString();
+	
+	idList< byte > data;
+	idList< int > offsets;
+	int numStreams = LoadRecordedStreams( recordFile, data, offsets );
+	if( numStreams == 0 )
+	{
+		return;
+	}
+	
+	// Count how many streams each d-mer shows up in
+	idList< uint16_t > frequency;
+	idList< int > lastStream;
+	frequency.SetNum( 1 << DICT_HASH_BITS );
+	lastStream.SetNum( 1 << DICT_HASH_BITS );
+	memset( frequency.Ptr(), 0, frequency.Allocated() );
+	memset( lastStream.Ptr(), -1, lastStream.Allocated() );
+	
+	idList< int > segments;
+	for( int s = 0; s < numStreams; s++ )
+	{
+		for( int i = offsets[s]; i + DICT_DMER_SIZE <= offsets[s + 1]; i++ )
+		{
+			int h = DictHash( &data[i] );
+			if( lastStream[h] != s )
+			{
+				lastStream[h] = s;
+				frequency[h] = ( uint16_t )Min( frequency[h] + 1, 0xFFFF );
+			}
+		}
+		for( int i = offsets[s]; i + DICT_SEGMENT_SIZE <= offsets[s + 1]; i += DICT_SEGMENT_SIZE )
+		{
+			segments.Append( i );
+		}
+	}
+	
+	idList< byte > dictionary;
+	dictionary.SetNum( lzCompressionData_t::LZ_MAX_DICTIONARY );
+	int dictionaryStart = dictionary.Num();
+	
+	while( dictionaryStart >= DICT_SEGMENT_SIZE )
+	{
+		int bestSegment = -1;
+		int bestScore = 0;
+		for( int i = 0; i < segments.Num(); i++ )
+		{
+			int score = 0;
+			for( int b = 0; b + DICT_DMER_SIZE <= DICT_SEGMENT_SIZE; b++ )
+			{
+				score += frequency[DictHash( &data[segments[i] + b] )];
+			}
+			if( score > bestScore )
+			{
+				bestScore = score;
+				bestSegment = i;
+			}
+		}
+		
+		// Only substrings seen in more than one stream are worth having
+		if( bestSegment == -1 || bestScore < 2 * ( DICT_SEGMENT_SIZE - DICT_DMER_SIZE + 1 ) )
+		{
+			break;
+		}
+		
+		const byte* segment = &data[segments[bestSegment]];
+		
+		// Don't count what the dictionary already covers
+		for( int b = 0; b + DICT_DMER_SIZE <= DICT_SEGMENT_SIZE; b++ )
+		{
+			frequency[DictHash( &segment[b] )] = 0;
+		}
+		
+		dictionaryStart -= DICT_SEGMENT_SIZE;
+		memcpy( &dictionary[dictionaryStart], segment, DICT_SEGMENT_SIZE );
+		segments.RemoveIndexFast( bestSegment );
+	}
+	
+	int dictionarySize = dictionary.Num() - dictionaryStart;
+	if( dictionarySize == 0 )
+	{
+		idLib::Printf( "Not enough repetition in %d streams to build a dictionary\n", numStreams );
+		return;
+	}
+	
+	fileSystem->WriteFile( dictFile, &dictionary[dictionaryStart], dictionarySize );
+	idSnapCompressor::SetDictionary( &dictionary[dictionaryStart], dictionarySize );
+	
+	idLib::Printf( "Wrote %d byte dictionary to %s from %d streams (%d bytes), checksum 0x%08x\n", dictionarySize, dictFile, numStreams, data.Num(), idSnapshotProcessor::GetDictionaryChecksum() );
+}
+
+/*
+========================
+net_snapCompressionBenchmark
+Compresses the recorded streams with each snapshot compression stage, and checks they decompress back to the same bytes.
+========================
+*/
+CONSOLE_COMMAND( net_snapCompressionBenchmark, "Compares compression ratio and speed of the snapshot compression stages on recorded streams. usage: net_snapCompressionBenchmark [recordFile]", 0 )
+{
+	static const char* compressorNames[SNAP_COMPRESSOR_MAX] = { "lzw", "lz", "lz+dict" };
+	static const int MAX_COMPRESSED = idPacketProcessor::MAX_MSG_SIZE * 4;
+	
+	const char* recordFile = ( args.Argc() > 1 ) ? args.Argv( 1 ) : net_snapRecordFile.GetString();
+	
+	idList< byte > data;
+	idList< int > offsets;
+	int numStreams = LoadRecordedStreams( recordFile, data, offsets );
+	if( numStreams == 0 )
+	{
+		return;
+	}
+	
+	snapCompressionData_t* compressionData = ( snapCompressionData_t* )Mem_Alloc( sizeof( snapCompressionData_t ), TAG_NETWORKING );
+	byte* compressed = ( byte* )Mem_Alloc( MAX_COMPRESSED, TAG_NETWORKING );
+	byte* decompressed = ( byte* )Mem_Alloc( lzCompressionData_t::LZ_MAX_STREAM, TAG_NETWORKING );
+	
+	idLib::Printf( "%d streams, %d bytes\n", numStreams, data.Num() );
+	idLib::Printf( "stage     ratio  compress MB/s  decompress MB/s\n" );
+	
+	for( int c = 0; c < SNAP_COMPRESSOR_MAX; c++ )
+	{
+		if( c == SNAP_COMPRESSOR_LZ_DICT && idSnapCompressor::GetDictionary() == NULL )
+		{
+			idLib::Printf( "%-8s  no dictionary loaded, see net_snapTrainDictionary\n", compressorNames[c] );
+			continue;
+		}
+		
+		compressionData->compressor = ( snapCompressor_t )c;
+		idSnapCompressor compressor( compressionData );
+		
+		uint64_t compressMicroSec = 0;
+		uint64_t decompressMicroSec = 0;
+		int compressedBytes = 0;
+		int failed = 0;
+		
+		for( int s = 0; s < numStreams; s++ )
+		{
+			const byte* stream = &data[offsets[s]];
+			int length = offsets[s + 1] - offsets[s];
+			
+			uint64_t startMicroSec = Sys_Microseconds();
+			compressor.Start( compressed, MAX_COMPRESSED );
+			compressor.Write( stream, length );
+			int size = compressor.End();
+			compressMicroSec += Sys_Microseconds() - startMicroSec;
+			
+			if( size <= 0 )
+			{
+				failed++;
+				continue;
+			}
+			compressedBytes += size;
+			
+			startMicroSec = Sys_Microseconds();
+			compressor.Start( compressed, size );
+			int readLength = compressor.Read( decompressed, length, true );
+			decompressMicroSec += Sys_Microseconds() - startMicroSec;
+			
+			if( readLength != length || memcmp( decompressed, stream, length ) != 0 )
+			{
+				failed++;
+			}
+		}
+		
+		float ratio = ( compressedBytes > 0 ) ? ( float )data.Num() / compressedBytes : 0.0f;
+		float compressRate = data.Num() / Max( ( float )compressMicroSec, 1.0f );
+		float decompressRate = data.Num() / Max( ( float )decompressMicroSec, 1.0f );
+		
+		idLib::Printf( "%-8s  %5.2f  %13.1f  %15.1f%s\n", compressorNames[c], ratio, compressRate, decompressRate, ( failed > 0 ) ? va( " ^1(%d streams failed)", failed ) : "" );
+	}
+	
+	Mem_Free( decompressed );
+	Mem_Free( compressed );
+	Mem_Free( compressionData );
+}
+
+/*
+========================
+SnapshotBenchmark
+Simulates a server sending snapshots to numPeers peers that ack every delta they get.
+Peers are spread over a few visibility groups, each group sees a different set of objects.
+Returns the average time spent encoding deltas per snapshot tick.
+========================
+*/
+static const int BENCH_NUM_OBJECTS		= 256;
+static const int BENCH_OBJECT_SIZE		= 64;
+static const int BENCH_VIS_GROUPS		= 4;
+static const int BENCH_WARMUP_TICKS		= 60;
+static const int BENCH_TICKS			= 120;
+static const int BENCH_OBJ_MEMORY		= 1024 * 128;
+
+static float SnapshotBenchmark( int numPeers, bool shareEncoding, int& bytesPerTick, float& reusedFraction )
+{
+	idRandom random( 0x5eed );
+	
+	uint8_t* objMemory = ( uint8_t* )Mem_Alloc( BENCH_OBJ_MEMORY, TAG_NETWORKING );
+	snapCompressionData_t* lzwData = ( snapCompressionData_t* )Mem_Alloc( sizeof( snapCompressionData_t ), TAG_NETWORKING );
+	byte* deltaBuffer = ( byte* )Mem_Alloc( idPacketProcessor::MAX_MSG_SIZE, TAG_NETWORKING );
+	byte* objectData = ( byte* )Mem_Alloc( BENCH_NUM_OBJECTS * BENCH_OBJECT_SIZE, TAG_NETWORKING );
+	
+	idSnapDeltaCache deltaCache;
+	deltaCache.Init( idSnapshotProcessor::MAX_SNAPSHOT_QUEUE * BENCH_NUM_OBJECTS, 1024 * 512 );
+	
+	idList< idSnapshotProcessor* > peers;
+	for( int p = 0; p < numPeers; p++ )
+	{
+		peers.Append( new( TAG_NETWORKING ) idSnapshotProcessor() );
+	}
+	
+	for( int i = 0; i < BENCH_NUM_OBJECTS * BENCH_OBJECT_SIZE; i++ )
+	{
+		objectData[i] = random.RandomInt( 256 );
+	}
+	
+	idSnapShot sharedSnap;
+	uint64_t encodeMicroSec = 0;
+	int totalBytes = 0;
+	int totalHits = 0;
+	int totalLookups = 0;
+	
+	for( int tick = 0; tick < BENCH_WARMUP_TICKS + BENCH_TICKS; tick++ )
+	{
+		const bool measure = ( tick >= BENCH_WARMUP_TICKS );
+		
+		// move a tenth of the objects
+		for( int i = 0; i < BENCH_NUM_OBJECTS / 10; i++ )
+		{
+			byte* object = &objectData[ random.RandomInt( BENCH_NUM_OBJECTS ) * BENCH_OBJECT_SIZE ];
+			for( int b = 0; b < BENCH_OBJECT_SIZE / 4; b++ )
+			{
+				object[ random.RandomInt( BENCH_OBJECT_SIZE ) ] += random.RandomInt( 8 );
+			}
+		}
+		
+		idSnapShot ss;
+		ss.SetTime( tick * 16 );
+		for( int i = 0; i < BENCH_NUM_OBJECTS; i++ )
+		{
+			uint32_t visMask = MAX_UNSIGNED_TYPE( uint32_t );
+			for( int g = 0; g < BENCH_VIS_GROUPS; g++ )
+			{
+				if( ( i + g + tick / 30 ) % 3 == 0 )
+				{
+					visMask &= ~( 1 << ( g + 1 ) );
+				}
+			}
+			ss.S_AddObject( i, visMask, &objectData[ i * BENCH_OBJECT_SIZE ], BENCH_OBJECT_SIZE );
+		}
+		
+		uint64_t startMicroSec = Sys_Microseconds();
+		
+		if( shareEncoding )
+		{
+			ss.ShareObjectBuffers( sharedSnap );
+			sharedSnap = ss;
+			deltaCache.Clear();
+		}
+		
+		for( int p = 0; p < numPeers; p++ )
+		{
+			peers[p]->TrySetPendingSnapshot( ss );
+			peers[p]->SubmitPendingSnap( 1 + ( p % BENCH_VIS_GROUPS ), objMemory, BENCH_OBJ_MEMORY, lzwData, shareEncoding ? &deltaCache : NULL );
+		}
+		
+		uint64_t endMicroSec = Sys_Microseconds();
+		
+		if( measure )
+		{
+			encodeMicroSec += endMicroSec - startMicroSec;
+			totalHits += deltaCache.GetNumHits();
+			totalLookups += deltaCache.GetNumHits() + deltaCache.GetNumMisses();
+		}
+		
+		// send and immediately ack the deltas
+		for( int p = 0; p < numPeers; p++ )
+		{
+			if( !peers[p]->PendingSnapReadyToSend() )
+			{
+				continue;
+			}
+			
+			int size = peers[p]->GetPendingSnapDelta( deltaBuffer, idPacketProcessor::MAX_MSG_SIZE );
+			
+			if( measure )
+			{
+				totalBytes += abs( size );
+			}
+			
+			peers[p]->ApplySnapshotDelta( 1 + ( p % BENCH_VIS_GROUPS ), peers[p]->GetSnapSequence() );
+			
+			if( shareEncoding )
+			{
+				peers[p]->GetBaseState()->ShareObjectBuffers( sharedSnap );
+			}
+		}
+	}
+	
+	peers.DeleteContents();
+	deltaCache.Shutdown();
+	
+	Mem_Free( objectData );
+	Mem_Free( deltaBuffer );
+	Mem_Free( lzwData );
+	Mem_Free( objMemory );
+	
+	bytesPerTick = totalBytes / BENCH_TICKS;
+	reusedFraction = ( totalLookups > 0 ) ? ( float )totalHits / totalLookups : 0.0f;
+	
+	return ( float )encodeMicroSec / ( BENCH_TICKS * 1000.0f );
+}
+
+/*
+========================
+net_snapshotBenchmark
+========================
+*/
+CONSOLE_COMMAND( net_snapshotBenchmark, "Times snapshot delta encoding for simulated peers, with and without shared encoding. usage: net_snapshotBenchmark [numPeers]", 0 )
+{
+	static const int defaultPeerCounts[] = { 8, 16, 32, 64 };
+	
+	idList< int > peerCounts;
+	if( args.Argc() > 1 )
+	{
+		peerCounts.Append( Max( 1, atoi( args.Argv( 1 ) ) ) );
+	}
+	else
+	{
+		for( int i = 0; i < sizeof( defaultPeerCounts ) / sizeof( defaultPeerCounts[0] ); i++ )
+		{
+			peerCounts.Append( defaultPeerCounts[i] );
+		}
+	}
+	
+	idLib::Printf( "%d objects of %d bytes, %d visibility groups, %d ticks\n", BENCH_NUM_OBJECTS, BENCH_OBJECT_SIZE, BENCH_VIS_GROUPS, BENCH_TICKS );
+	idLib::Printf( "peers  separate ms/tick  shared ms/tick  reused  bytes/tick\n" );
+	
+	for( int i = 0; i < peerCounts.Num(); i++ )
+	{
+		int separateBytes = 0;
+		int sharedBytes = 0;
+		float separateReused = 0.0f;
+		float sharedReused = 0.0f;
+		
+		float separateMsec = SnapshotBenchmark( peerCounts[i], false, separateBytes, separateReused );
+		float sharedMsec = SnapshotBenchmark( peerCounts[i], true, sharedBytes, sharedReused );
+		
+		idLib::Printf( "%5d  %16.3f  %14.3f  %5.1f%%  %d%s\n", peerCounts[i], separateMsec, sharedMsec, sharedReused * 100.0f, sharedBytes,
+					   ( sharedBytes != separateBytes ) ? va( " ^1(separate %d)", separateBytes ) : "" );
+	}
+}
@@ -55,7 +55,8 @@ public:
 	bool ApplyDeltaToSnapshot( idSnapShot& snap, const char* deltaMem, int deltaSize, int visIndex );
 	// Attempts to write the currently pending snap to the supplied buffer, which can then be sent as an unreliable msg.
 	// SubmitPendingSnap will submit the pending snap to a job, so that it can be retrieved later for sending.
-	void SubmitPendingSnap( int visIndex, uint8_t* objMemory, int objMemorySize, lzwCompressionData_t* lzwData );
+	// deltaCache (optional) lets peers submitted in the same frame share the encoding of objects they have the same base for.
+	void SubmitPendingSnap( int visIndex, uint8_t* objMemory, int objMemorySize, snapCompressionData_t* lzwData, idSnapDeltaCache* deltaCache = NULL );
 	// GetPendingSnapDelta
 	int GetPendingSnapDelta( byte* outBuffer, int maxLength );
 	// If PendingSnapReadyToSend is true, then GetPendingSnapDelta will return something to send
@@ -119,10 +120,39 @@ public:
 	
 	void AddSnapObjTemplate( int objID, idBitMsg& msg );
 	
+	// Compression stage used for the snapshot deltas of this peer, agreed on during the connection handshake
+	void SetCompressor( snapCompressor_t c )
+	{
+		compressor = c;
+	}
+	snapCompressor_t GetCompressor() const
+	{
+		return compressor;
+	}
+	
+	// Mask of the snapCompressor_t stages this side can encode and decode
+	static int GetSupportedCompressors();
+	// Checksum of the loaded static dictionary, 0 if none
+	static uint32_t GetDictionaryChecksum();
+	// Picks the best stage both sides support, falling back to SNAP_COMPRESSOR_LZW for older peers
+	static snapCompressor_t NegotiateCompressor( int remoteMask, uint32_t remoteChecksum );
+	// Loads the static dictionary named by net_snapDictionary, if present
+	static void LoadCompressionDictionary();
+	
 	static const int MAX_SNAPSHOT_QUEUE		= 64;
 	
+	// Number of changed objects held back from the last submitted snap by the priority budget
+	int GetNumHeldObjects() const
+	{
+		return numHeldObjects;
+	}
+	
 private:
 
+	// Accumulates the priority of the changed objects in the pending snap, and holds back
+	// the ones that don't fit the net_snapPriorityBudget of this peer
+	void PrioritizePendingSnap( int visIndex );
+
 	// Internal commands to set up, and flush the compressors
 	static const int MAX_SNAP_SIZE			= idPacketProcessor::MAX_MSG_SIZE;
 	static const int MAX_SNAPSHOT_QUEUE_MEM	= 64 * 1024;	// 64k
@@ -174,6 +204,20 @@ private:
 	idSnapShot		submittedTemplateStates;
 	
 	int				partialBaseSequence;
+	
+	snapCompressor_t	compressor;
+	
+	struct objPriority_t
+	{
+		float		accumulated;	// grows by the object priority every second it's held back
+		int			lastSentTime;	// snap time of the last snap the object was sent in
+	};
+	
+	idList< objPriority_t, TAG_NETWORKING >							objPriorities;	// indexed by object number
+	idList< uint8_t, TAG_NETWORKING >								heldObjects;	// indexed by object number
+	idList< idSnapShot::priorityCandidate_t, TAG_NETWORKING >		priorityCandidates;
+	int				lastPrioritySnapTime;
+	int				numHeldObjects;
 };
 
 #endif /* !__SNAP_PROCESSOR_H__ */
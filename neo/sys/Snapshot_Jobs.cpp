@@ -57,11 +57,10 @@ ID_INLINE bool ObjectsSame( objJobState_t& newState, objJobState_t& oldState )
 		return false;		// Can't match if sizes different
 	}
 	
-	/*
-	if ( newState.data == oldState.data ) {
-		return true;		// Definite match
+	if( newState.data == oldState.data )
+	{
+		return true;		// Definite match (peers reference the shared buffers, see idSnapShot::ShareObjectBuffers)
 	}
-	*/
 	
 	if( memcmp( newState.data, oldState.data, newState.size ) == 0 )
 	{
@@ -245,7 +244,7 @@ void SnapshotObjectJob( objParms_t* parms )
 FinishLZWStream
 ========================
 */
-static void FinishLZWStream( lzwParm_t* parm, idLZWCompressor* lzwCompressor )
+static void FinishLZWStream( lzwParm_t* parm, idSnapCompressor* lzwCompressor )
 {
 	if( lzwCompressor->IsOverflowed() )
 	{
@@ -280,7 +279,7 @@ static void FinishLZWStream( lzwParm_t* parm, idLZWCompressor* lzwCompressor )
 NewLZWStream
 ========================
 */
-static void NewLZWStream( lzwParm_t* parm, idLZWCompressor* lzwCompressor )
+static void NewLZWStream( lzwParm_t* parm, idSnapCompressor* lzwCompressor )
 {
 
 	// Reset compressor
@@ -301,7 +300,7 @@ static void NewLZWStream( lzwParm_t* parm, idLZWCompressor* lzwCompressor )
 ContinueLZWStream
 ========================
 */
-static void ContinueLZWStream( lzwParm_t* parm, idLZWCompressor* lzwCompressor )
+static void ContinueLZWStream( lzwParm_t* parm, idSnapCompressor* lzwCompressor )
 {
 	// Continue compressor where we left off
 	int maxSize = parm->ioData->maxlzwMem - parm->ioData->lzwBytes;
@@ -336,10 +335,10 @@ void LZWJobInternal( lzwParm_t* parm, unsigned int dmaTag )
 	
 #ifdef __GNUC__
 	// DG: remove ALIGN16 for GCC/clang, as they can't use it here and clang gets an error
-	idLZWCompressor lzwCompressor( parm->ioData->lzwData );
+	idSnapCompressor lzwCompressor( parm->ioData->lzwData );
 	// DG end
 #else
-	ALIGN16( idLZWCompressor lzwCompressor( parm->ioData->lzwData ) );
+	ALIGN16( idSnapCompressor lzwCompressor( parm->ioData->lzwData ) );
 #endif
 	
 	if( parm->fragmented )
@@ -110,7 +110,7 @@ struct ALIGNTYPE16 lzwInOutData_t
 	int						optimalLength;			// Optimal length of lzw streams
 	int						snapSequence;
 	uint16_t					lastObjId;				// Last obj id written out
-	lzwCompressionData_t* 	lzwData;
+	snapCompressionData_t* 	lzwData;
 };
 
 // Input to the job that takes the results of the delta'd zrle obj's, and turns them into lzw delta packets
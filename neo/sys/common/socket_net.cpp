@@ -1416,6 +1416,8 @@ idUDP::idUDP( void )
 	bytesRead = 0;
 	packetsWritten = 0;
 	bytesWritten = 0;
+	readCalls = 0;
+	writeCalls = 0;
 }
 
 /*
@@ -1471,6 +1473,8 @@ idUDP::GetPacket
 */
 bool idUDP::GetPacket( netadr_t& from, void* data, int& size, int maxSize )
 {
+	readCalls++;
+	
 	// DG: this fake while(1) loop pissed me off so I replaced it.. no functional change.
 	if( ! Net_GetUDPPacket( netSocket, from, ( char* )data, size, maxSize ) )
 	{
@@ -1526,6 +1530,188 @@ void idUDP::SendPacket( const netadr_t to, const void* data, int size )
 		return;
 	}
 	
+	writeCalls++;
+	
 	Net_SendUDPPacket( netSocket, size, data, to );
 }
 
+/*
+========================
+idUDP::WaitForData
+========================
+*/
+bool idUDP::WaitForData( int timeout )
+{
+	return Net_WaitForData( netSocket, timeout );
+}
+
+/*
+========================
+idUDP::GetPackets
+========================
+*/
+int idUDP::GetPackets( udpPacket_t* packets, int maxPackets )
+{
+#if defined(__linux__)
+	static const int MAX_BATCH = 64;
+	
+	if( !netSocket || maxPackets <= 0 )
+	{
+		return 0;
+	}
+	
+	// socks packets come through the relay with a header, let the single packet path strip it
+	if( usingSocks )
+	{
+		int numPackets = 0;
+		while( numPackets < maxPackets && GetPacket( packets[numPackets].address, packets[numPackets].data, packets[numPackets].size, sizeof( packets[numPackets].data ) ) )
+		{
+			numPackets++;
+		}
+		return numPackets;
+	}
+	
+	mmsghdr			msgs[MAX_BATCH];
+	iovec			iovecs[MAX_BATCH];
+	sockaddr_in		from[MAX_BATCH];
+	
+	const int batch = Min( maxPackets, MAX_BATCH );
+	
+	memset( msgs, 0, batch * sizeof( msgs[0] ) );
+	for( int i = 0; i < batch; i++ )
+	{
+		iovecs[i].iov_base				= packets[i].data;
+		iovecs[i].iov_len				= sizeof( packets[i].data );
+		msgs[i].msg_hdr.msg_name		= &from[i];
+		msgs[i].msg_hdr.msg_namelen		= sizeof( from[i] );
+		msgs[i].msg_hdr.msg_iov			= &iovecs[i];
+		msgs[i].msg_hdr.msg_iovlen		= 1;
+	}
+	
+	readCalls++;
+	
+	int ret = recvmmsg( netSocket, msgs, batch, MSG_DONTWAIT, NULL );
+	if( ret == SOCKET_ERROR )
+	{
+		int err = Net_GetLastError();
+		if( err != D3_NET_EWOULDBLOCK && err != D3_NET_ECONNRESET )
+		{
+			idLib::Printf( "idUDP::GetPackets: %s\n", NET_ErrorString() );
+		}
+		return 0;
+	}
+	
+	int numPackets = 0;
+	for( int i = 0; i < ret; i++ )
+	{
+		netadr_t address;
+		Net_SockadrToNetadr( &from[i], &address );
+		
+		if( msgs[i].msg_hdr.msg_flags & MSG_TRUNC )
+		{
+			idLib::Printf( "idUDP::GetPackets: oversize packet from %s\n", Sys_NetAdrToString( address ) );
+			continue;
+		}
+		
+		if( numPackets != i )
+		{
+			memcpy( packets[numPackets].data, packets[i].data, msgs[i].msg_len );
+		}
+		packets[numPackets].address = address;
+		packets[numPackets].size = msgs[i].msg_len;
+		
+		packetsRead++;
+		bytesRead += msgs[i].msg_len;
+		numPackets++;
+	}
+	
+	return numPackets;
+#else
+	int numPackets = 0;
+	while( numPackets < maxPackets && GetPacket( packets[numPackets].address, packets[numPackets].data, packets[numPackets].size, sizeof( packets[numPackets].data ) ) )
+	{
+		numPackets++;
+	}
+	return numPackets;
+#endif
+}
+
+/*
+========================
+idUDP::SendPackets
+========================
+*/
+int idUDP::SendPackets( const udpPacket_t* packets, int numPackets )
+{
+#if defined(__linux__)
+	static const int MAX_BATCH = 64;
+	
+	// socks needs every packet wrapped, let the single packet path deal with it
+	if( usingSocks || silent || !netSocket )
+	{
+		for( int i = 0; i < numPackets; i++ )
+		{
+			SendPacket( packets[i].address, packets[i].data, packets[i].size );
+		}
+		return numPackets;
+	}
+	
+	mmsghdr			msgs[MAX_BATCH];
+	iovec			iovecs[MAX_BATCH];
+	sockaddr_in		to[MAX_BATCH];
+	
+	int sent = 0;
+	while( sent < numPackets )
+	{
+		int batch = 0;
+		while( batch < MAX_BATCH && sent + batch < numPackets )
+		{
+			const udpPacket_t& packet = packets[sent + batch];
+			
+			Net_NetadrToSockadr( &packet.address, &to[batch] );
+			
+			memset( &msgs[batch], 0, sizeof( msgs[batch] ) );
+			iovecs[batch].iov_base				= ( void* )packet.data;
+			iovecs[batch].iov_len				= packet.size;
+			msgs[batch].msg_hdr.msg_name		= &to[batch];
+			msgs[batch].msg_hdr.msg_namelen		= sizeof( to[batch] );
+			msgs[batch].msg_hdr.msg_iov			= &iovecs[batch];
+			msgs[batch].msg_hdr.msg_iovlen		= 1;
+			
+			batch++;
+		}
+		
+		writeCalls++;
+		
+		int ret = sendmmsg( netSocket, msgs, batch, 0 );
+		if( ret == SOCKET_ERROR )
+		{
+			int err = Net_GetLastError();
+			
+			// same as Net_SendUDPPacket, the packet is dropped but we carry on with the rest
+			if( err != D3_NET_EADDRNOTAVAIL || packets[sent].address.type != NA_BROADCAST )
+			{
+				idLib::Printf( "UDP sendmmsg error - packet dropped: %s\n", NET_ErrorString() );
+			}
+			ret = 1;
+		}
+		
+		// a partial send means the next packet failed, the next call will report it
+		for( int i = 0; i < ret; i++ )
+		{
+			packetsWritten++;
+			bytesWritten += packets[sent + i].size;
+		}
+		sent += ret;
+	}
+	
+	return numPackets;
+#else
+	for( int i = 0; i < numPackets; i++ )
+	{
+		SendPacket( packets[i].address, packets[i].data, packets[i].size );
+	}
+	return numPackets;
+#endif
+}
+
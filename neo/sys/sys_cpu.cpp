@@ -231,6 +231,14 @@ cpuid_t Sys_GetProcessorId( void )
 	if( SDL_HasSSE3() )
 		cpuid |= CPUID_SSE3;
 	
+    // check for Advanced Vector Extensions
+	if( SDL_HasAVX() )
+		cpuid |= CPUID_AVX;
+	
+    // check for Advanced Vector Extensions 2
+	if( SDL_HasAVX2() )
+		cpuid |= CPUID_AVX2;
+	
     // check for Conditional Move (CMOV) and fast floating point comparison (FCOMI) instructions
 	if( HasCMOV() )
 		cpuid |= CPUID_CMOV;
@@ -0,0 +1,989 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+Copyright (C) 2014-2016 Robert Beckebans
+Copyright (C) 2014-2016 Kot in Action Creative Artel
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#pragma hdrstop
+
+#include "precompiled.h"
+#include "sys_session_local.h"
+#include "sys_loadtest.h"
+
+extern unsigned int NetGetVersionChecksum();
+
+extern idCVar net_port;
+extern idCVar net_useGameStateLobby;
+extern idCVar net_ucmdRate;
+
+idCVar net_loadTestHelloTimeout( "net_loadTestHelloTimeout", "10000", CVAR_INTEGER, "milliseconds a load test client waits for the host to accept its hello before giving up", 1000, 60000 );
+idCVar net_loadTestInput( "net_loadTestInput", "1", CVAR_INTEGER, "scripted input of load test clients. 0 = idle, 1 = run in circles, 2 = run in circles and fire", 0, 2 );
+
+idLoadTest netLoadTest;
+
+/*
+================================================
+idLoadTestClient
+
+A simulated peer of the acting game state lobby of a host. It connects with the regular
+connectionless hello, answers the loading and ping reliables, and then sends a scripted
+stream of usercmds that also ack the snapshots it gets. Snapshots are never decoded, the
+sequence is peeked out of the delta which is all the host needs for the ack.
+================================================
+*/
+class idLoadTestClient
+{
+public:
+	enum state_t
+	{
+		STATE_CONNECTING,		// sent the hello, waiting for RELIABLE_HELLO
+		STATE_LOBBY,			// connected, waiting for RELIABLE_START_LOADING
+		STATE_LOADING,			// sent RELIABLE_LOADING_DONE, waiting for the first snapshot
+		STATE_IN_GAME,			// receiving snapshots and sending usercmds
+		STATE_DISCONNECTED,		// dropped by the host, or never got in
+	};
+	
+	idLoadTestClient();
+	
+	bool			Init( int index, const lobbyAddress_t& host );
+	void			Shutdown();
+	
+	void			Pump();
+	
+	void			WriteResults( idStr& out, int testMsec ) const;
+	
+	state_t			GetState() const
+	{
+		return state;
+	}
+	
+private:
+	static const int USERCMD_MSEC			= 16;
+	static const int MAX_SEND_USERCMDS		= 8;		// same as NUM_USERCMD_SEND
+	static const int HELLO_RESEND_MSEC		= 1000;
+	static const int HEARTBEAT_MSEC			= 1000;
+	static const int RELIABLE_RESEND_MSEC	= 100;
+	
+	void			SendHello( int time );
+	void			SendGoodbye();
+	void			SendUsercmds( int time );
+	void			SendSnapshotAck();
+	void			SendFragments( int time );
+	void			ProcessOutgoing( int time, const byte* data, int size );
+	void			QueueReliable( byte type, const byte* data, int size );
+	
+	void			HandlePacket( int time, byte* data, int size );
+	void			HandleReliable( int time, idBitMsg& msg );
+	void			HandleSnapshot( int time, const byte* data, int size );
+	void			HandleHelloAck( int time, idBitMsg& msg );
+	
+	void			BuildUsercmd( usercmd_t& cmd );
+	
+	void			SetState( state_t newState );
+	
+	int					index;
+	int					lobbyType;
+	state_t				state;
+	
+	idUDP				udp;
+	lobbyAddress_t		hostAddress;
+	idPacketProcessor	packetProc;
+	idPacketProcessor::sessionId_t	sessionID;
+	snapCompressor_t	compressor;
+	
+	int					peerIndexOnHost;
+	int					lastSnapSequence;
+	
+	usercmd_t			cmds[MAX_SEND_USERCMDS];
+	int					numCmds;
+	int					gameMilliseconds;
+	int					lastCmdTime;
+	int					nextUsercmdTime;
+	
+	int					startTime;
+	int					nextHelloTime;
+	int					lastSendTime;
+	int					lastInBandSendTime;
+	
+	// results
+	int					connectMsec;
+	int					inGameMsec;
+	int					bytesSent;
+	int					bytesReceived;
+	int					packetsSent;
+	int					packetsReceived;
+	int					snapsReceived;
+	int					snapBytes;
+	int					lastSnapTime;
+	int					lastSnapInterval;
+	int64_t				snapIntervalTotal;
+	int64_t				snapJitterTotal;
+	int					snapIntervalMax;
+	int					pingMs;
+	int64_t				pingTotal;
+	int					pingSamples;
+	int					pingMax;
+};
+
+/*
+========================
+idLoadTestClient::idLoadTestClient
+========================
+*/
+idLoadTestClient::idLoadTestClient() :
+	index( 0 ),
+	lobbyType( idLobby::TYPE_GAME ),
+	state( STATE_DISCONNECTED ),
+	sessionID( idPacketProcessor::SESSION_ID_INVALID ),
+	compressor( SNAP_COMPRESSOR_LZW ),
+	peerIndexOnHost( -1 ),
+	lastSnapSequence( -1 ),
+	numCmds( 0 ),
+	gameMilliseconds( 0 ),
+	lastCmdTime( 0 ),
+	nextUsercmdTime( 0 ),
+	startTime( 0 ),
+	nextHelloTime( 0 ),
+	lastSendTime( 0 ),
+	lastInBandSendTime( 0 ),
+	connectMsec( -1 ),
+	inGameMsec( -1 ),
+	bytesSent( 0 ),
+	bytesReceived( 0 ),
+	packetsSent( 0 ),
+	packetsReceived( 0 ),
+	snapsReceived( 0 ),
+	snapBytes( 0 ),
+	lastSnapTime( 0 ),
+	lastSnapInterval( -1 ),
+	snapIntervalTotal( 0 ),
+	snapJitterTotal( 0 ),
+	snapIntervalMax( 0 ),
+	pingMs( -1 ),
+	pingTotal( 0 ),
+	pingSamples( 0 ),
+	pingMax( 0 )
+{
+}
+
+/*
+========================
+idLoadTestClient::Init
+========================
+*/
+bool idLoadTestClient::Init( int index_, const lobbyAddress_t& host )
+{
+	index		= index_;
+	hostAddress	= host;
+	lobbyType	= net_useGameStateLobby.GetBool() ? idLobby::TYPE_GAME_STATE : idLobby::TYPE_GAME;
+	
+	if( !udp.InitForPort( PORT_ANY ) )
+	{
+		idLib::Warning( "NET: load test client %i could not open a socket", index );
+		return false;
+	}
+	udp.SetSilent( true );
+	
+	packetProc.Reset();
+	
+	// Same encoding as idLobby::EncodeSessionID, the lobby type in the low bits routes the packets on the host
+	const int key = ( idLib::frameNumber * 131 + Sys_Milliseconds() + index * 7919 ) & 0x3FFF;
+	sessionID = ( idPacketProcessor::sessionId_t )( ( ( key | 1 ) << idPacketProcessor::NUM_LOBBY_TYPE_BITS ) | ( lobbyType + 1 ) );
+	
+	startTime = Sys_Milliseconds();
+	SetState( STATE_CONNECTING );
+	SendHello( startTime );
+	
+	return true;
+}
+
+/*
+========================
+idLoadTestClient::Shutdown
+========================
+*/
+void idLoadTestClient::Shutdown()
+{
+	if( state != STATE_DISCONNECTED )
+	{
+		SendGoodbye();
+		SetState( STATE_DISCONNECTED );
+	}
+	udp.Close();
+}
+
+/*
+========================
+idLoadTestClient::SetState
+========================
+*/
+void idLoadTestClient::SetState( state_t newState )
+{
+	state = newState;
+	
+	if( newState == STATE_IN_GAME )
+	{
+		inGameMsec = Sys_Milliseconds() - startTime;
+	}
+}
+
+/*
+========================
+idLoadTestClient::SendHello
+
+Mirrors idLobby::SendConnectionRequest with a single made up user.
+========================
+*/
+void idLoadTestClient::SendHello( int time )
+{
+	byte buffer[ idPacketProcessor::MAX_PACKET_SIZE - 2 ];
+	idBitMsg msg( buffer, sizeof( buffer ) );
+	
+	msg.WriteLong( NetGetVersionChecksum() );
+	msg.WriteUShort( sessionID );
+	msg.WriteBool( false );
+	
+	// The handle only has to be unique on the host, keep it away from the small handles of real users
+	lobbyUser_t user;
+	user.lobbyUserID = lobbyUserID_t( localUserHandle_t( 0x4C540000 | ( sessionID & 0xFF00 ) | index ), lobbyType );
+	user.teamNumber = index & 1;
+	idStr::snPrintf( user.gamertag, sizeof( user.gamertag ), "loadtest_%i", index );
+	
+	msg.WriteByte( 1 );
+	user.WriteToMsg( msg );
+	
+	msg.WriteByte( idSnapshotProcessor::GetSupportedCompressors() );
+	msg.WriteLong( idSnapshotProcessor::GetDictionaryChecksum() );
+	
+	byte processedBuffer[ idPacketProcessor::MAX_OOB_MSG_SIZE ];
+	idBitMsg processedMsg( processedBuffer, sizeof( processedBuffer ) );
+	
+	idPacketProcessor::ProcessConnectionlessOutgoing( msg, processedMsg, lobbyType, idLobby::OOB_HELLO );
+	
+	udp.SendPacket( hostAddress.netAddr, processedMsg.GetReadData(), processedMsg.GetSize() );
+	bytesSent += processedMsg.GetSize();
+	packetsSent++;
+	
+	nextHelloTime = time + HELLO_RESEND_MSEC;
+}
+
+/*
+========================
+idLoadTestClient::SendGoodbye
+========================
+*/
+void idLoadTestClient::SendGoodbye()
+{
+	byte buffer[ idPacketProcessor::MAX_OOB_MSG_SIZE ];
+	idBitMsg processedMsg( buffer, sizeof( buffer ) );
+	idBitMsg msg;
+	
+	idPacketProcessor::ProcessConnectionlessOutgoing( msg, processedMsg, lobbyType, idLobby::OOB_GOODBYE );
+	
+	udp.SendPacket( hostAddress.netAddr, processedMsg.GetReadData(), processedMsg.GetSize() );
+	bytesSent += processedMsg.GetSize();
+	packetsSent++;
+}
+
+/*
+========================
+idLoadTestClient::QueueReliable
+========================
+*/
+void idLoadTestClient::QueueReliable( byte type, const byte* data, int size )
+{
+	if( !packetProc.QueueReliableMessage( type, data, size ) )
+	{
+		idLib::Warning( "NET: load test client %i overflowed its reliable queue", index );
+		SetState( STATE_DISCONNECTED );
+	}
+}
+
+/*
+========================
+idLoadTestClient::ProcessOutgoing
+========================
+*/
+void idLoadTestClient::ProcessOutgoing( int time, const byte* data, int size )
+{
+	if( packetProc.HasMoreFragments() )
+	{
+		return;
+	}
+	
+	idBitMsg msg;
+	msg.InitRead( data, size );
+	packetProc.ProcessOutgoing( time, msg, false, 0 );
+	
+	lastInBandSendTime = time;
+	
+	SendFragments( time );
+}
+
+/*
+========================
+idLoadTestClient::SendFragments
+========================
+*/
+void idLoadTestClient::SendFragments( int time )
+{
+	while( true )
+	{
+		const byte* fragment = NULL;
+		int fragmentSize = 0;
+		
+		if( !packetProc.GetSendFragment( time, sessionID, fragment, fragmentSize ) )
+		{
+			break;
+		}
+		
+		udp.SendPacket( hostAddress.netAddr, fragment, fragmentSize );
+		bytesSent += fragmentSize;
+		packetsSent++;
+		lastSendTime = time;
+	}
+}
+
+/*
+========================
+idLoadTestClient::BuildUsercmd
+
+Runs in circles, turning at a different rate per client so they spread out over the map.
+========================
+*/
+void idLoadTestClient::BuildUsercmd( usercmd_t& cmd )
+{
+	cmd = usercmd_t();
+	cmd.clientGameMilliseconds = gameMilliseconds;
+	
+	if( net_loadTestInput.GetInteger() == 0 )
+	{
+		return;
+	}
+	
+	const float seconds = gameMilliseconds * 0.001f;
+	
+	cmd.forwardmove	= 127;
+	cmd.rightmove	= ( ( gameMilliseconds / 2000 ) & 1 ) ? 64 : -64;
+	cmd.angles[1]	= ANGLE2SHORT( seconds * ( 45.0f + ( index % 8 ) * 10.0f ) + index * 37.0f );
+	cmd.angles[0]	= ANGLE2SHORT( idMath::Sin( seconds ) * 10.0f );
+	
+	if( net_loadTestInput.GetInteger() >= 2 && ( ( gameMilliseconds / 500 ) % 4 ) == 0 )
+	{
+		cmd.buttons		|= BUTTON_ATTACK;
+		cmd.fireCount	= ( uint16_t )( gameMilliseconds / 2000 );
+	}
+}
+
+/*
+========================
+idLoadTestClient::SendUsercmds
+
+Mirrors idCommonLocal::SendUsercmds and idSessionLocal::SendUsercmds, the last few commands
+go out lzw compressed behind the snapshot ack.
+========================
+*/
+void idLoadTestClient::SendUsercmds( int time )
+{
+	if( time < nextUsercmdTime || packetProc.HasMoreFragments() )
+	{
+		return;
+	}
+	nextUsercmdTime = time + net_ucmdRate.GetInteger();
+	
+	// Generate a command for each game frame that passed since the last send
+	int frames = ( time - lastCmdTime ) / USERCMD_MSEC;
+	if( frames <= 0 )
+	{
+		return;
+	}
+	lastCmdTime += frames * USERCMD_MSEC;
+	frames = Min( frames, ( int )MAX_SEND_USERCMDS );
+	
+	for( int i = 0; i < frames; i++ )
+	{
+		gameMilliseconds += USERCMD_MSEC;
+		
+		if( numCmds == MAX_SEND_USERCMDS )
+		{
+			memmove( &cmds[0], &cmds[1], sizeof( cmds[0] ) * ( MAX_SEND_USERCMDS - 1 ) );
+			numCmds--;
+		}
+		BuildUsercmd( cmds[numCmds++] );
+	}
+	
+	byte cmdBuffer[ idPacketProcessor::MAX_FINAL_PACKET_SIZE ];
+	idBitMsg cmdMsg( cmdBuffer, sizeof( cmdBuffer ) );
+	idSerializer ser( cmdMsg, true );
+	usercmd_t empty;
+	usercmd_t* last = &empty;
+	
+	cmdMsg.WriteByte( numCmds );
+	for( int i = 0; i < numCmds; i++ )
+	{
+		cmds[i].Serialize( ser, *last );
+		last = &cmds[i];
+	}
+	
+	const float incomingBPS = idMath::ClampFloat( 0.0f, static_cast<float>( idLobby::BANDWIDTH_REPORTING_MAX ), packetProc.GetIncomingRateBytes() );
+	uint16_t incomingBPS_quantized = idMath::Ftoi( incomingBPS * ( ( BIT( idLobby::BANDWIDTH_REPORTING_BITS ) - 1 ) / idLobby::BANDWIDTH_REPORTING_MAX ) );
+	
+	byte buffer[ idPacketProcessor::MAX_FINAL_PACKET_SIZE ];
+	lzwCompressionData_t lzwData;
+	idLZWCompressor lzwCompressor( &lzwData );
+	lzwCompressor.Start( buffer, sizeof( buffer ) );
+	lzwCompressor.WriteAgnostic( lastSnapSequence );
+	lzwCompressor.WriteAgnostic( incomingBPS_quantized );
+	lzwCompressor.Write( cmdMsg.GetReadData(), cmdMsg.GetSize() );
+	lzwCompressor.End();
+	
+	ProcessOutgoing( time, buffer, lzwCompressor.Length() );
+}
+
+/*
+========================
+idLoadTestClient::SendSnapshotAck
+
+Until the host knows we are in game the acks go out as reliables, same as idLobby does.
+========================
+*/
+void idLoadTestClient::SendSnapshotAck()
+{
+	byte ackbuffer[32];
+	idBitMsg ackmsg( ackbuffer, sizeof( ackbuffer ) );
+	ackmsg.WriteLong( lastSnapSequence );
+	
+	const float incomingBPS = idMath::ClampFloat( 0.0f, static_cast<float>( idLobby::BANDWIDTH_REPORTING_MAX ), packetProc.GetIncomingRateBytes() );
+	ackmsg.WriteQuantizedUFloat< idLobby::BANDWIDTH_REPORTING_MAX, idLobby::BANDWIDTH_REPORTING_BITS >( incomingBPS );
+	
+	QueueReliable( idLobby::RELIABLE_SNAPSHOT_ACK, ackbuffer, ackmsg.GetSize() );
+}
+
+/*
+========================
+idLoadTestClient::Pump
+========================
+*/
+void idLoadTestClient::Pump()
+{
+	const int time = Sys_Milliseconds();
+	
+	// Read everything the host sent us
+	byte buffer[ idPacketProcessor::MAX_FINAL_PACKET_SIZE ];
+	netadr_t from;
+	int size = 0;
+	
+	while( udp.GetPacket( from, buffer, size, sizeof( buffer ) ) )
+	{
+		HandlePacket( time, buffer, size );
+	}
+	
+	if( state == STATE_DISCONNECTED )
+	{
+		return;
+	}
+	
+	if( state == STATE_CONNECTING )
+	{
+		if( time - startTime > net_loadTestHelloTimeout.GetInteger() )
+		{
+			idLib::Printf( "NET: load test client %i timed out connecting to %s\n", index, hostAddress.ToString() );
+			SetState( STATE_DISCONNECTED );
+		}
+		else if( time >= nextHelloTime )
+		{
+			SendHello( time );
+		}
+		return;
+	}
+	
+	packetProc.RefreshRates( time );
+	
+	if( state == STATE_IN_GAME )
+	{
+		SendUsercmds( time );
+	}
+	
+	// Resend reliables, and keep the heartbeat going so the host doesn't drop us
+	if( !packetProc.HasMoreFragments() )
+	{
+		const bool needReliable = ( packetProc.NumQueuedReliables() > 0 || packetProc.NeedToSendReliableAck() ) && time - lastInBandSendTime >= RELIABLE_RESEND_MSEC;
+		if( needReliable || time - lastSendTime >= HEARTBEAT_MSEC )
+		{
+			ProcessOutgoing( time, NULL, 0 );
+		}
+	}
+	
+	SendFragments( time );
+}
+
+/*
+========================
+idLoadTestClient::HandlePacket
+========================
+*/
+void idLoadTestClient::HandlePacket( int time, byte* data, int size )
+{
+	bytesReceived += size;
+	packetsReceived++;
+	
+	idBitMsg fragMsg;
+	fragMsg.InitRead( data, size );
+	
+	idBitMsg msg;		// reads the msg in place
+	int userData = 0;
+	
+	const idPacketProcessor::sessionId_t packetSessionID = idPacketProcessor::GetSessionID( fragMsg );
+	
+	if( packetSessionID != sessionID )
+	{
+		// The only connectionless msg we care about is the host getting rid of us
+		if( !idPacketProcessor::ProcessConnectionlessIncoming( fragMsg, msg, userData ) )
+		{
+			return;
+		}
+		if( userData == idLobby::OOB_GOODBYE || userData == idLobby::OOB_GOODBYE_W_PARTY || userData == idLobby::OOB_GOODBYE_FULL )
+		{
+			idLib::Printf( "NET: load test client %i got goodbye %i from host\n", index, userData );
+			SetState( STATE_DISCONNECTED );
+		}
+		return;
+	}
+	
+	const int type = packetProc.ProcessIncoming( time, sessionID, fragMsg, msg, userData, 0 );
+	
+	if( type != idPacketProcessor::RETURN_TYPE_INBAND )
+	{
+		return;
+	}
+	
+	for( int r = 0; r < packetProc.GetNumReliables() && state != STATE_DISCONNECTED; r++ )
+	{
+		idBitMsg reliableMsg( packetProc.GetReliable( r ), packetProc.GetReliableSize( r ) );
+		reliableMsg.SetSize( packetProc.GetReliableSize( r ) );
+		
+		HandleReliable( time, reliableMsg );
+	}
+	
+	if( msg.GetRemainingData() > 0 && ( state == STATE_LOADING || state == STATE_IN_GAME ) )
+	{
+		HandleSnapshot( time, msg.GetReadData() + msg.GetReadCount(), msg.GetRemainingData() );
+	}
+}
+
+/*
+========================
+idLoadTestClient::HandleHelloAck
+
+Mirrors idLobby::HandleHelloAck.
+========================
+*/
+void idLoadTestClient::HandleHelloAck( int time, idBitMsg& msg )
+{
+	if( state != STATE_CONNECTING )
+	{
+		return;
+	}
+	
+	peerIndexOnHost = msg.ReadLong();
+	
+	idMatchParameters parms;
+	parms.Read( msg );
+	
+	const int numUsers = msg.ReadByte();
+	for( int u = 0; u < numUsers; u++ )
+	{
+		lobbyUser_t user;
+		user.ReadFromMsg( msg );
+	}
+	
+	// The direct backend has no post connect info, the next byte is the snapshot compressor the host picked
+	if( msg.GetRemainingData() > 0 )
+	{
+		const int snapCompressor = msg.ReadByte();
+		if( snapCompressor >= 0 && snapCompressor < SNAP_COMPRESSOR_MAX && ( idSnapshotProcessor::GetSupportedCompressors() & BIT( snapCompressor ) ) != 0 )
+		{
+			compressor = ( snapCompressor_t )snapCompressor;
+		}
+	}
+	
+	connectMsec = time - startTime;
+	SetState( STATE_LOBBY );
+}
+
+/*
+========================
+idLoadTestClient::HandleReliable
+========================
+*/
+void idLoadTestClient::HandleReliable( int time, idBitMsg& msg )
+{
+	const int reliableType = msg.ReadByte();
+	
+	if( reliableType == idLobby::RELIABLE_HELLO )
+	{
+		HandleHelloAck( time, msg );
+	}
+	else if( reliableType == idLobby::RELIABLE_START_LOADING )
+	{
+		// Nothing to load, tell the host right away
+		byte buffer[ 8 ];
+		idBitMsg doneMsg( buffer, sizeof( buffer ) );
+		doneMsg.WriteLong( 0 );
+		QueueReliable( idLobby::RELIABLE_LOADING_DONE, doneMsg.GetReadData(), doneMsg.GetSize() );
+		
+		lastSnapSequence = -1;
+		SetState( STATE_LOADING );
+	}
+	else if( reliableType == idLobby::RELIABLE_PING )
+	{
+		// Reflect it back so the host can measure the round trip
+		QueueReliable( idLobby::RELIABLE_PING, msg.GetReadData() + msg.GetReadCount(), msg.GetRemainingData() );
+	}
+	else if( reliableType == idLobby::RELIABLE_PING_VALUES )
+	{
+		for( int i = 0; msg.GetRemainingData() >= 2; i++ )
+		{
+			const int ping = msg.ReadShort();
+			if( i == peerIndexOnHost && ping >= 0 )
+			{
+				pingMs = ping;
+				pingTotal += ping;
+				pingSamples++;
+				pingMax = Max( pingMax, ping );
+			}
+		}
+	}
+	else if( reliableType == idLobby::RELIABLE_ENDMATCH || reliableType == idLobby::RELIABLE_ENDMATCH_PREMATURE )
+	{
+		// Back to the lobby, the host sends RELIABLE_START_LOADING again for the next match
+		SetState( STATE_LOBBY );
+	}
+	else if( reliableType == idLobby::RELIABLE_KICK_PLAYER || reliableType == idLobby::RELIABLE_PARTY_LEAVE_GAME_LOBBY )
+	{
+		idLib::Printf( "NET: load test client %i was removed by the host\n", index );
+		SetState( STATE_DISCONNECTED );
+	}
+}
+
+/*
+========================
+idLoadTestClient::HandleSnapshot
+========================
+*/
+void idLoadTestClient::HandleSnapshot( int time, const byte* data, int size )
+{
+	int sequence = -1;
+	int baseSequence = -1;
+	idSnapShot::PeekDeltaSequence( ( const char* )data, size, sequence, baseSequence, compressor );
+	
+	if( sequence <= lastSnapSequence )
+	{
+		return;		// same as the real client, old out of order deltas are rejected
+	}
+	lastSnapSequence = sequence;
+	
+	if( snapsReceived > 0 )
+	{
+		const int interval = time - lastSnapTime;
+		snapIntervalTotal += interval;
+		snapIntervalMax = Max( snapIntervalMax, interval );
+		
+		if( lastSnapInterval >= 0 )
+		{
+			snapJitterTotal += abs( interval - lastSnapInterval );
+		}
+		lastSnapInterval = interval;
+	}
+	
+	lastSnapTime = time;
+	snapsReceived++;
+	snapBytes += size;
+	
+	if( state == STATE_LOADING )
+	{
+		SendSnapshotAck();
+		
+		byte buffer[ 8 ];
+		idBitMsg inGameMsg( buffer, sizeof( buffer ) );
+		QueueReliable( idLobby::RELIABLE_IN_GAME, inGameMsg.GetReadData(), inGameMsg.GetSize() );
+		
+		lastCmdTime = time;
+		nextUsercmdTime = time;
+		SetState( STATE_IN_GAME );
+	}
+}
+
+/*
+========================
+idLoadTestClient::WriteResults
+========================
+*/
+void idLoadTestClient::WriteResults( idStr& out, int testMsec ) const
+{
+	static const char* stateNames[] = { "connecting", "lobby", "loading", "ingame", "disconnected" };
+	
+	const float seconds = Max( testMsec, 1 ) * 0.001f;
+	const int intervals = snapsReceived - 1;
+	const int jitters = snapsReceived - 2;
+	
+	out += va( "\t\t{ \"index\": %i, \"state\": \"%s\", \"connectMsec\": %i, \"inGameMsec\": %i, ", index, stateNames[ state ], connectMsec, inGameMsec );
+	out += va( "\"bytesSentPerSec\": %.1f, \"bytesReceivedPerSec\": %.1f, \"packetsSent\": %i, \"packetsReceived\": %i, ", bytesSent / seconds, bytesReceived / seconds, packetsSent, packetsReceived );
+	out += va( "\"snapshots\": %i, \"snapshotBytesPerSec\": %.1f, ", snapsReceived, snapBytes / seconds );
+	out += va( "\"snapshotIntervalAvgMsec\": %.2f, \"snapshotIntervalMaxMsec\": %i, \"snapshotJitterMsec\": %.2f, ",
+			   intervals > 0 ? ( float )snapIntervalTotal / intervals : 0.0f, snapIntervalMax, jitters > 0 ? ( float )snapJitterTotal / jitters : 0.0f );
+	out += va( "\"pingMsec\": %i, \"pingAvgMsec\": %.1f, \"pingMaxMsec\": %i }", pingMs, pingSamples > 0 ? ( float )pingTotal / pingSamples : -1.0f, pingMax );
+}
+
+/*
+================================================================================================
+
+	idLoadTest
+
+================================================================================================
+*/
+
+/*
+========================
+idLoadTest::idLoadTest
+========================
+*/
+idLoadTest::idLoadTest() :
+	startTime( 0 ),
+	endTime( 0 ),
+	lastPumpMicroseconds( 0 )
+{
+}
+
+/*
+========================
+idLoadTest::~idLoadTest
+========================
+*/
+idLoadTest::~idLoadTest()
+{
+	clients.DeleteContents( true );
+}
+
+/*
+========================
+idLoadTest::Start
+========================
+*/
+bool idLoadTest::Start( int numClients, int seconds, const char* address, const char* outputFile_ )
+{
+	if( IsRunning() )
+	{
+		idLib::Printf( "A load test is already running, net_loadTestStop it first.\n" );
+		return false;
+	}
+	
+	lobbyAddress_t hostAddress;
+	hostAddress.InitFromIPandPort( address, net_port.GetInteger() );
+	
+	for( int i = 0; i < numClients; i++ )
+	{
+		idLoadTestClient* client = new( TAG_NETWORKING ) idLoadTestClient;
+		if( !client->Init( i, hostAddress ) )
+		{
+			delete client;
+			break;
+		}
+		clients.Append( client );
+	}
+	
+	if( clients.Num() == 0 )
+	{
+		return false;
+	}
+	
+	outputFile				= outputFile_;
+	startTime				= Sys_Milliseconds();
+	endTime					= startTime + seconds * 1000;
+	lastPumpMicroseconds	= 0;
+	frameMicroseconds.Clear();
+	frameMicroseconds.SetGranularity( 1024 );
+	
+	idLib::Printf( "Load test: %i clients against %s for %i seconds\n", clients.Num(), hostAddress.ToString(), seconds );
+	
+	return true;
+}
+
+/*
+========================
+idLoadTest::Stop
+========================
+*/
+void idLoadTest::Stop()
+{
+	if( !IsRunning() )
+	{
+		return;
+	}
+	
+	for( int i = 0; i < clients.Num(); i++ )
+	{
+		clients[i]->Shutdown();
+	}
+	
+	WriteResults();
+	
+	clients.DeleteContents( true );
+	frameMicroseconds.Clear();
+}
+
+/*
+========================
+idLoadTest::Pump
+========================
+*/
+void idLoadTest::Pump()
+{
+	if( !IsRunning() )
+	{
+		return;
+	}
+	
+	const uint64_t now = Sys_Microseconds();
+	if( lastPumpMicroseconds != 0 )
+	{
+		frameMicroseconds.Append( ( int )( now - lastPumpMicroseconds ) );
+	}
+	lastPumpMicroseconds = now;
+	
+	for( int i = 0; i < clients.Num(); i++ )
+	{
+		clients[i]->Pump();
+	}
+	
+	if( Sys_Milliseconds() >= endTime )
+	{
+		Stop();
+	}
+}
+
+/*
+========================
+idLoadTest::WriteResults
+========================
+*/
+void idLoadTest::WriteResults()
+{
+	const int testMsec = Sys_Milliseconds() - startTime;
+	
+	int connected = 0;
+	int inGame = 0;
+	for( int i = 0; i < clients.Num(); i++ )
+	{
+		if( clients[i]->GetState() != idLoadTestClient::STATE_DISCONNECTED && clients[i]->GetState() != idLoadTestClient::STATE_CONNECTING )
+		{
+			connected++;
+		}
+		if( clients[i]->GetState() == idLoadTestClient::STATE_IN_GAME )
+		{
+			inGame++;
+		}
+	}
+	
+	// Frame times are sorted for the percentiles
+	frameMicroseconds.SortWithTemplate( idSort_QuickDefault< int >() );
+	
+	int64_t frameTotal = 0;
+	for( int i = 0; i < frameMicroseconds.Num(); i++ )
+	{
+		frameTotal += frameMicroseconds[i];
+	}
+	const int numFrames = frameMicroseconds.Num();
+	const float frameAvg = numFrames > 0 ? frameTotal / ( numFrames * 1000.0f ) : 0.0f;
+	const float frameP50 = numFrames > 0 ? frameMicroseconds[ numFrames / 2 ] * 0.001f : 0.0f;
+	const float frameP99 = numFrames > 0 ? frameMicroseconds[ Min( numFrames - 1, numFrames * 99 / 100 ) ] * 0.001f : 0.0f;
+	const float frameMax = numFrames > 0 ? frameMicroseconds[ numFrames - 1 ] * 0.001f : 0.0f;
+	
+	idStr out;
+	out += "{\n";
+	out += va( "\t\"durationMsec\": %i,\n", testMsec );
+	out += va( "\t\"clients\": %i,\n", clients.Num() );
+	out += va( "\t\"clientsConnected\": %i,\n", connected );
+	out += va( "\t\"clientsInGame\": %i,\n", inGame );
+	out += va( "\t\"frames\": %i,\n", numFrames );
+	out += va( "\t\"frameAvgMsec\": %.3f,\n", frameAvg );
+	out += va( "\t\"frameP50Msec\": %.3f,\n", frameP50 );
+	out += va( "\t\"frameP99Msec\": %.3f,\n", frameP99 );
+	out += va( "\t\"frameMaxMsec\": %.3f,\n", frameMax );
+	out += "\t\"peers\": [\n";
+	for( int i = 0; i < clients.Num(); i++ )
+	{
+		clients[i]->WriteResults( out, testMsec );
+		out += ( i + 1 < clients.Num() ) ? ",\n" : "\n";
+	}
+	out += "\t]\n";
+	out += "}\n";
+	
+	idLib::Printf( "Load test: %i/%i clients in game, frame avg %.2f ms, p99 %.2f ms, max %.2f ms\n", inGame, clients.Num(), frameAvg, frameP99, frameMax );
+	
+	if( outputFile.Length() > 0 )
+	{
+		if( fileSystem->WriteFile( outputFile, out.c_str(), out.Length() ) >= 0 )
+		{
+			idLib::Printf( "Load test results written to %s\n", outputFile.c_str() );
+		}
+	}
+	else
+	{
+		idLib::Printf( "%s", out.c_str() );
+	}
+}
+
+/*
+========================
+net_loadTest
+========================
+*/
+CONSOLE_COMMAND( net_loadTest, "runs simulated clients against a host: net_loadTest <numClients> [seconds] [address] [outputFile]", 0 )
+{
+	if( args.Argc() < 2 )
+	{
+		idLib::Printf( "usage: net_loadTest <numClients> [seconds = 60] [address = localhost] [outputFile = loadtest.json]\n" );
+		return;
+	}
+	
+	const int numClients	= idMath::ClampInt( 1, idLobby::MAX_PEERS, atoi( args.Argv( 1 ) ) );
+	const int seconds		= ( args.Argc() > 2 ) ? Max( 1, atoi( args.Argv( 2 ) ) ) : 60;
+	const char* address		= ( args.Argc() > 3 ) ? args.Argv( 3 ) : "localhost";
+	const char* outputFile	= ( args.Argc() > 4 ) ? args.Argv( 4 ) : "loadtest.json";
+	
+	netLoadTest.Start( numClients, seconds, address, outputFile );
+}
+
+/*
+========================
+net_loadTestStop
+========================
+*/
+CONSOLE_COMMAND( net_loadTestStop, "stops a running load test and writes out its results", 0 )
+{
+	netLoadTest.Stop();
+}
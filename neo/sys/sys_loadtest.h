@@ -0,0 +1,76 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+Copyright (C) 2014-2016 Robert Beckebans
+Copyright (C) 2014-2016 Kot in Action Creative Artel
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+#ifndef __SYS_LOADTEST_H__
+#define __SYS_LOADTEST_H__
+
+class idLoadTestClient;
+
+/*
+================================================
+idLoadTest
+
+Runs a number of simulated clients against a host from inside this process. Each client
+has its own socket and speaks the same hello / reliable / usercmd protocol as an idLobby
+peer, so the host sees them as regular players. Used to load test dedicated servers
+without having to run real game clients, the results are written out as json.
+================================================
+*/
+class idLoadTest
+{
+public:
+	idLoadTest();
+	~idLoadTest();
+	
+	bool			Start( int numClients, int seconds, const char* address, const char* outputFile );
+	void			Stop();
+	
+	// Called once per frame by the session
+	void			Pump();
+	
+	bool			IsRunning() const
+	{
+		return clients.Num() > 0;
+	}
+	
+private:
+	void			WriteResults();
+	
+	idList< idLoadTestClient* >	clients;
+	idList< int >				frameMicroseconds;		// time between pumps, which is the server frame time when the host runs in this process
+	
+	idStr			outputFile;
+	int				startTime;
+	int				endTime;
+	uint64_t		lastPumpMicroseconds;
+};
+
+extern idLoadTest	netLoadTest;
+
+#endif // __SYS_LOADTEST_H__
@@ -135,7 +135,10 @@ void idLobby::Initialize( lobbyType_t sessionType_, idSessionCallbacks* callback
 	{
 		// only needed in multiplayer mode
 		objMemory		= ( uint8_t* )Mem_Alloc( SNAP_OBJ_JOB_MEMORY, TAG_NETWORKING );
-		lzwData			= ( lzwCompressionData_t* )Mem_Alloc( sizeof( lzwCompressionData_t ), TAG_NETWORKING );
+		lzwData			= ( snapCompressionData_t* )Mem_Alloc( sizeof( snapCompressionData_t ), TAG_NETWORKING );
+		snapDeltaCache.Init( SNAP_DELTA_CACHE_OBJECTS, SNAP_DELTA_CACHE_MEMORY );
+		
+		idSnapshotProcessor::LoadCompressionDictionary();
 	}
 }
 
@@ -325,6 +328,7 @@ void idLobby::Shutdown( bool retainMigrationInfo, bool skipGoodbye )
 	startLoadingFromHost	= false;
 	
 	snapDeltaAckQueue.Clear();
+	sharedSnap.Clear();
 	
 	// Shutdown the lobbyBackend
 	if( !retainMigrationInfo )
@@ -346,11 +350,8 @@ void idLobby::HandlePacket( lobbyAddress_t& remoteAddress, idBitMsg fragMsg, idP
 {
 	SCOPED_PROFILE_EVENT( "HandlePacket" );
 	
-	// msg will hold a fully constructed msg using the packet processor
-	byte msgBuffer[ idPacketProcessor::MAX_MSG_SIZE ];
-	
+	// msg will read a fully constructed msg in place, from fragMsg or the packet processor
 	idBitMsg msg;
-	msg.InitWrite( msgBuffer, sizeof( msgBuffer ) );
 	
 	int peerNum		= FindPeer( remoteAddress, sessionID );
 	int type		= idPacketProcessor::RETURN_TYPE_NONE;
@@ -1609,6 +1610,13 @@ void idLobby::SendConnectionRequest()
 	// We just used these users to fill up the msg above, we will get the real list from the server if we connect.
 	FreeAllUsers();
 	
+	// Offer the snapshot compression stages we support (hosts that don't know about this ignore it, and stay on lzw)
+	if( lobbyType == GetActingGameStateLobbyType() )
+	{
+		msg.WriteByte( idSnapshotProcessor::GetSupportedCompressors() );
+		msg.WriteLong( idSnapshotProcessor::GetDictionaryChecksum() );
+	}
+	
 	NET_VERBOSE_PRINT( "NET: Sending hello to: %s (lobbyType: %s, session ID %i, attempt: %i)\n", hostAddress.ToString(), GetLobbyName(), peers[host].sessionID, connectionAttempts );
 	
 	SendConnectionLess( hostAddress, OOB_HELLO, msg.GetReadData(), msg.GetSize() );
@@ -2013,6 +2021,19 @@ int idLobby::HandleInitialPeerConnection( idBitMsg& msg, const lobbyAddress_t& p
 	// (which will then forward the list to all peers except peerNum)
 	AddUsersFromMsg( msg, peerNum );
 	
+	// Pick the snapshot compression stage for this peer, older clients don't send anything and get lzw
+	int snapCompressor = -1;
+	if( newPeer.snapProc != NULL && msg.GetRemainingData() >= 5 )
+	{
+		const int remoteMask = msg.ReadByte();
+		const uint32_t remoteChecksum = msg.ReadLong();
+		
+		snapCompressor = idSnapshotProcessor::NegotiateCompressor( remoteMask, remoteChecksum );
+		newPeer.snapProc->SetCompressor( ( snapCompressor_t )snapCompressor );
+		
+		NET_VERBOSE_PRINT( "NET: Using snapshot compressor %i for %s\n", snapCompressor, peerAddress.ToString() );
+	}
+	
 	// Mark the peer as connected for this session type
 	SetPeerConnectionState( peerNum, CONNECTION_ESTABLISHED );
 	
@@ -2053,6 +2074,11 @@ int idLobby::HandleInitialPeerConnection( idBitMsg& msg, const lobbyAddress_t& p
 	
 	lobbyBackend->FillMsgWithPostConnectInfo( outmsg );
 	
+	if( snapCompressor != -1 )
+	{
+		outmsg.WriteByte( snapCompressor );
+	}
+	
 	NET_VERBOSE_PRINT( "NET: Sending response to %s, lobbyType %s, sessionID %i\n", peerAddress.ToString(), GetLobbyName(), sessionID );
 	
 	QueueReliableMessage( peerNum, RELIABLE_HELLO, outmsg.GetReadData(), outmsg.GetSize() );
@@ -2522,6 +2548,21 @@ void idLobby::HandleHelloAck( int p, idBitMsg& msg )
 	
 	lobbyBackend->PostConnectFromMsg( msg );
 	
+	// The snapshot compression stage the host picked for us, if it knows about them
+	if( peer.snapProc != NULL && msg.GetRemainingData() > 0 )
+	{
+		const int snapCompressor = msg.ReadByte();
+		
+		if( snapCompressor >= 0 && snapCompressor < SNAP_COMPRESSOR_MAX && ( idSnapshotProcessor::GetSupportedCompressors() & BIT( snapCompressor ) ) != 0 )
+		{
+			peer.snapProc->SetCompressor( ( snapCompressor_t )snapCompressor );
+		}
+		else
+		{
+			idLib::Warning( "NET: Host picked snapshot compressor %i, which we don't support", snapCompressor );
+		}
+	}
+	
 	// Tell the lobby controller to finalize the connection
 	SetState( STATE_FINALIZE_CONNECT );
 	
@@ -3244,7 +3285,7 @@ void idLobby::DrawDebugNetworkHUD2( void ) const
 	renderSystem->DrawSmallStringExt( idMath::Ftoi( X_OFFSET ), idMath::Ftoi( curY ), va( "State: %s. Local time: %d", stateName, Sys_Milliseconds() ), colorGreen, false );
 	curY += Y_SPACING;
 	
-	renderSystem->DrawSmallStringExt( idMath::Ftoi( X_OFFSET ), idMath::Ftoi( curY ), "Peer           | Sent kB/s | Recv kB/s | L | R | Resources", colorGreen, false );
+	renderSystem->DrawSmallStringExt( idMath::Ftoi( X_OFFSET ), idMath::Ftoi( curY ), "Peer           | Sent kB/s | Recv kB/s | Copy kB/s | L | R | Resources", colorGreen, false );
 	curY += Y_SPACING;
 	
 	renderSystem->DrawSmallStringExt( idMath::Ftoi( X_OFFSET ), idMath::Ftoi( curY ), "------------------------------------------------------------------", colorGreen, false );
@@ -3264,6 +3305,7 @@ void idLobby::DrawDebugNetworkHUD2( void ) const
 		totalRecvRate += proc.GetIncomingRate2();
 		float sentKps = ( float )proc.GetOutgoingRate2() / 1024.0f;
 		float recvKps = ( float )proc.GetIncomingRate2() / 1024.0f;
+		float copyKps = ( float )proc.GetCopyRate() / 1024.0f;
 		
 		// should probably complement that with a bandwidth reading
 		// right now I am mostly concerned about fragmentation and the latency spikes it will cause
@@ -3296,7 +3338,7 @@ void idLobby::DrawDebugNetworkHUD2( void ) const
 			peerName = "Local     ";
 		}
 		
-		renderSystem->DrawSmallStringExt( X_OFFSET, curY, va( "%i - %s | %2.02f kB/s | %2.02f kB/s | %i | %i | %d/%d", p, peerName.c_str(), sentKps, recvKps, peers[p].loaded, peers[p].address.UsingRelay(), rLoaded, rTotal ), color, false );
+		renderSystem->DrawSmallStringExt( X_OFFSET, curY, va( "%i - %s | %2.02f kB/s | %2.02f kB/s | %2.02f kB/s | %i | %i | %d/%d", p, peerName.c_str(), sentKps, recvKps, copyKps, peers[p].loaded, peers[p].address.UsingRelay(), rLoaded, rTotal ), color, false );
 		curY += Y_SPACING;
 	}
 	
@@ -4318,20 +4360,18 @@ bool idLobby::SendAnotherFragment( int p )
 	
 	while( true )
 	{
-		idBitMsg msg;
-		// We use the final packet size here because it has been processed, and no more headers will be added
-		byte buffer[ idPacketProcessor::MAX_FINAL_PACKET_SIZE ];
-		msg.InitWrite( buffer, sizeof( buffer ) );
+		// The fragment is sent straight from the packet processor's buffer, it's only valid until the next GetSendFragment
+		const byte* fragment = NULL;
+		int fragmentSize = 0;
 		
-		if( !peers[p].packetProc->GetSendFragment( time, peers[p].sessionID, msg ) )
+		if( !peers[p].packetProc->GetSendFragment( time, peers[p].sessionID, fragment, fragmentSize ) )
 		{
 			break;
 		}
 		
 		const bool useDirectPort = ( lobbyType == TYPE_GAME_STATE );
 		
-		msg.BeginReading();
-		sessionCB->SendRawPacket( peers[p].address, msg.GetReadData(), msg.GetSize(), useDirectPort );
+		sessionCB->SendRawPacket( peers[p].address, fragment, fragmentSize, useDirectPort );
 		sentFragment = true;
 		break;		// Comment this out to send all fragments in one burst
 	}
@@ -4372,6 +4412,35 @@ idLobby::ProcessOutgoingMsg
 ========================
 */
 void idLobby::ProcessOutgoingMsg( int p, const void* data, int size, bool isOOB, int userData )
+{
+	assert( size >= 0 && size <= idPacketBuffer::GetMaxPayloadSize() );
+	
+	peer_t& peer = peers[p];
+	
+	if( peer.GetConnectionState() != CONNECTION_ESTABLISHED )
+	{
+		idLib::Printf( "peer.GetConnectionState() != CONNECTION_ESTABLISHED\n" );
+		return;	// Peer not fully connected for this session type, return
+	}
+	
+	idPacketBuffer* packet = packetBufferPool.Alloc();
+	if( size > 0 )
+	{
+		memcpy( packet->GetPayload(), data, size );
+		peer.packetProc->AddCopiedBytes( size );
+	}
+	
+	ProcessOutgoingPacket( p, packet, size, isOOB, userData );
+}
+
+/*
+========================
+idLobby::ProcessOutgoingPacket
+
+Takes over the reference to packet, the size bytes at packet->GetPayload() are sent without being copied.
+========================
+*/
+void idLobby::ProcessOutgoingPacket( int p, idPacketBuffer* packet, int size, bool isOOB, int userData )
 {
 
 	peer_t& peer = peers[p];
@@ -4379,6 +4448,7 @@ void idLobby::ProcessOutgoingMsg( int p, const void* data, int size, bool isOOB,
 	if( peer.GetConnectionState() != CONNECTION_ESTABLISHED )
 	{
 		idLib::Printf( "peer.GetConnectionState() != CONNECTION_ESTABLISHED\n" );
+		packet->Release();
 		return;	// Peer not fully connected for this session type, return
 	}
 	
@@ -4402,9 +4472,7 @@ void idLobby::ProcessOutgoingMsg( int p, const void* data, int size, bool isOOB,
 		peer.lastInBandProcTime = peer.lastProcTime;
 	}
 	
-	idBitMsg msg;
-	msg.InitRead( ( byte* )data, size );
-	peer.packetProc->ProcessOutgoing( currentTime, msg, isOOB, userData );
+	peer.packetProc->ProcessOutgoing( currentTime, packet, size, isOOB, userData );
 }
 
 /*
@@ -595,6 +595,7 @@ public:		// Turning this on for now, for the sake of getting this up and running
 	bool								SendAnotherFragment( int p );
 	bool								CanSendMoreData( int p );
 	void								ProcessOutgoingMsg( int p, const void* data, int size, bool isOOB, int userData );
+	void								ProcessOutgoingPacket( int p, idPacketBuffer* packet, int size, bool isOOB, int userData );
 	void								ResendReliables( int p );
 	void								PumpPackets();
 	
@@ -746,6 +747,7 @@ public:		// Turning this on for now, for the sake of getting this up and running
 	void								ApplySnapshotDelta( int p, int snapshotNumber );
 	bool								ApplySnapshotDeltaInternal( int p, int snapshotNumber );
 	void								SendSnapshotToPeer( idSnapShot& ss, int p );
+	void								ShareSnapshot( idSnapShot& ss );
 	bool								AllPeersHaveBaseState();
 	void								ThrottleSnapsForXSeconds( int p, int seconds, bool recoverPing );
 	bool								FirstSnapHasBeenSent( int p );
@@ -925,10 +927,14 @@ public:		// Turning this on for now, for the sake of getting this up and running
 	// Snapshot jobs
 	//------------------------
 	static const int SNAP_OBJ_JOB_MEMORY = 1024 * 128;			// 128k of obj memory
+	static const int SNAP_DELTA_CACHE_OBJECTS = 1024 * 8;
+	static const int SNAP_DELTA_CACHE_MEMORY = 1024 * 256;		// 256k of encoded objects shared between peers
 	
-	lzwCompressionData_t* 				lzwData;				// Shared across all snapshot jobs
+	snapCompressionData_t* 				lzwData;				// Shared across all snapshot jobs
 	uint8_t* 								objMemory;				// Shared across all snapshot jobs
 	bool								haveSubmittedSnaps;		// True if we previously submitted snaps to jobs
+	idSnapShot							sharedSnap;				// Last snap sent, peer states reference its object buffers
+	idSnapDeltaCache					snapDeltaCache;			// Objects encoded for the peers submitted this frame
 	idSnapShot* 						localReadSS;
 	
 	struct snapDeltaAck_t
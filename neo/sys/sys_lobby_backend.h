@@ -72,10 +72,13 @@ public:
 	netadr_t				netAddr;
 };
 
+class idNetIOThread;
+
 class idNetSessionPort
 {
 public:
 	idNetSessionPort();
+	~idNetSessionPort();
 	
 	bool InitPort( int portNumber, bool useBackend );
 	bool ReadRawPacket( lobbyAddress_t& from, void* data, int& size, int maxSize );
@@ -84,11 +87,16 @@ public:
 	bool IsOpen();
 	void Close();
 	
+	// Counts a session tick, for the per tick numbers of net_printIOStats
+	void BeginTick();
+	
 private:
 	float	forcePacketDropCurr;	// Used with net_forceDrop and net_forceDropCorrelation
 	float	forcePacketDropPrev;
 	
 	idUDP	UDP;
+	
+	idNetIOThread* 	ioThread;		// Reads and writes UDP in batches when net_ioThread is set, NULL otherwise
 };
 
 struct lobbyUser_t
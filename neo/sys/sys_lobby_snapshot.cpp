@@ -55,6 +55,8 @@ idCVar net_pingIncPercentBeforeRecover( "net_pingIncPercentBeforeRecover", "1.3"
 idCVar net_maxFailedPingRecoveries( "net_maxFailedPingRecoveries", "10", CVAR_INTEGER, "Max failed ping recoveries before we stop trying" );
 idCVar net_pingRecoveryThrottleTimeInSeconds( "net_pingRecoveryThrottleTimeInSeconds", "3", CVAR_INTEGER, "Throttle snaps for this amount of time in seconds to recover from ping spike" );
 
+idCVar net_snapShareEncoding( "net_snapShareEncoding", "1", CVAR_BOOL, "Encode snapshot objects once for all peers that have the same base state for them" );
+
 idCVar net_peer_timeout_loading( "net_peer_timeout_loading", "90000", CVAR_INTEGER, "time in MS to disconnect clients during loading - production only" );
 
 
@@ -83,6 +85,9 @@ void idLobby::UpdateSnaps()
 		return;
 	}
 	
+	// Entries are keyed on object buffers that acks can free, so they only live for this loop
+	snapDeltaCache.Clear();
+	
 	for( int p = 0; p < peers.Num(); p++ )
 	{
 		peer_t& peer = peers[p];
@@ -222,8 +227,9 @@ bool idLobby::SubmitPendingSnap( int p )
 	peer.lastSnapJobTime = time;
 	assert( !peer.snapProc->PendingSnapReadyToSend() );
 	
-	// Submit snapshot delta to jobs
-	peer.snapProc->SubmitPendingSnap( p + 1, objMemory, SNAP_OBJ_JOB_MEMORY, lzwData );
+	// Submit snapshot delta to jobs (visIndex p + 1 also picks the peer's snapshot object priorities)
+	compile_time_assert( idSnapShot::MAX_PRIORITY_PEERS >= MAX_PEERS );
+	peer.snapProc->SubmitPendingSnap( p + 1, objMemory, SNAP_OBJ_JOB_MEMORY, lzwData, net_snapShareEncoding.GetBool() ? &snapDeltaCache : NULL );
 	
 	NET_VERBOSESNAPSHOT_PRINT_LEVEL( 2, va( "  Submitted snapshot to jobList for peer %d. Since last jobsub: %d\n", p, timeFromLastSub ) );
 	
@@ -260,25 +266,29 @@ void idLobby::SendCompletedPendingSnap( int p )
 	// Get the snap data blob now, even if we don't send it.
 	// This is somewhat wasteful, but we have to do this to keep the snap job pipe ready to keep doing work
 	// If we don't do this, this peer will cause other peers to be starved of snapshots, when they may very well be ready to send a snap
-	byte buffer[ MAX_SNAP_SIZE ];
-	int maxLength = sizeof( buffer ) - peer.packetProc->GetReliableDataSize() - 128;
+	// The delta goes straight into a packet buffer, which is handed to the packet processor without another copy
+	idPacketBuffer* packet = packetBufferPool.Alloc();
+	int maxLength = idPacketBuffer::GetMaxPayloadSize() - peer.packetProc->GetReliableDataSize() - 128;
 	
-	int size = peer.snapProc->GetPendingSnapDelta( buffer, maxLength );
+	int size = peer.snapProc->GetPendingSnapDelta( packet->GetPayload(), maxLength );
 	
 	if( !CanSendMoreData( p ) )
 	{
+		packet->Release();
 		return;
 	}
 	
 	// Can't send anymore snapshots until all fragments are sent
 	if( peer.packetProc->HasMoreFragments() )
 	{
+		packet->Release();
 		return;
 	}
 	
 	// If the peer doesn't have the latest resource list, send it to him before sending any new snapshots
 	if( SendResources( p ) )
 	{
+		packet->Release();
 		return;
 	}
 	
@@ -303,6 +313,7 @@ void idLobby::SendCompletedPendingSnap( int p )
 	{
 		if( time < peer.throttleSnapsForXSeconds )
 		{
+			packet->Release();
 			return;
 		}
 		
@@ -335,14 +346,16 @@ void idLobby::SendCompletedPendingSnap( int p )
 		if( size > 0 )
 		{
 			NET_VERBOSESNAPSHOT_PRINT_LEVEL( 3, va( "NET: (peer %d) Sending snapshot %d delta'd against %d. Since JobSub: %d Since LastSend: %d. Size: %d\n", p, peer.snapProc->GetSnapSequence(), peer.snapProc->GetBaseSequence(), timeFromJobSub, timeFromLastSend, size ) );
-			ProcessOutgoingMsg( p, buffer, size, false, 0 );
+			ProcessOutgoingPacket( p, packet, size, false, 0 );
+			packet = NULL;
 		}
 		else if( size < 0 )  	// Size < 0 indicates the delta buffer filled up
 		{
 			// There used to be code here that would disconnect peers if they were in game and filled up the buffer
 			// This was causing issues in the playtests we were running (Doom 4 MP) and after some conversation
 			// determined that it was not needed since a timeout mechanism has been added since
-			ProcessOutgoingMsg( p, buffer, -size, false, 0 );
+			ProcessOutgoingPacket( p, packet, -size, false, 0 );
+			packet = NULL;
 			if( peer.snapProc != NULL )
 			{
 				NET_VERBOSESNAPSHOT_PRINT( "NET: (peerNum: %d - name: %s) Resending last snapshot delta %d because his delta list filled up. Since JobSub: %d Since LastSend: %d Delta Size: %d\n", p, GetPeerName( p ), peer.snapProc->GetSnapSequence(), timeFromJobSub, timeFromLastSend, size );
@@ -350,6 +363,11 @@ void idLobby::SendCompletedPendingSnap( int p )
 		}
 	}
 	
+	if( packet != NULL )
+	{
+		packet->Release();		// Nothing was sent
+	}
+	
 	// We calculate what our outgoing rate was for each sequence, so we can have a relative comparison
 	// for when the client reports what his downstream was in the same timeframe
 	if( IsHost() && peer.snapProc != NULL && peer.snapProc->GetSnapSequence() > 0 )
@@ -544,6 +562,12 @@ bool idLobby::ApplySnapshotDeltaInternal( int p, int snapshotNumber )
 	// on the client, always 0
 	bool result = peer.snapProc->ApplySnapshotDelta( IsHost() ? p + 1 : 0, snapshotNumber );
 	
+	if( result && IsHost() && net_snapShareEncoding.GetBool() )
+	{
+		// The base state was rebuilt from the delta, point it back at the buffers shared with the other peers
+		peer.snapProc->GetBaseState()->ShareObjectBuffers( sharedSnap );
+	}
+	
 	if( result && IsHost() && peer.snapProc->HasPendingSnap() )
 	{
 		// Send more of the pending snap if we have one for this peer.
@@ -639,6 +663,27 @@ void idLobby::SendSnapshotToPeer( idSnapShot& ss, int p )
 	peer.needToSubmitPendingSnap = true;
 }
 
+/*
+========================
+idLobby::ShareSnapshot
+Called once per snapshot, before it is handed to each peer. Objects that didn't change since the last
+snapshot keep their old buffers, so every peer's pending and base states reference the same memory.
+========================
+*/
+void idLobby::ShareSnapshot( idSnapShot& ss )
+{
+	assert( lobbyType == GetActingGameStateLobbyType() );
+	
+	if( !net_snapShareEncoding.GetBool() )
+	{
+		sharedSnap.Clear();
+		return;
+	}
+	
+	ss.ShareObjectBuffers( sharedSnap );
+	sharedSnap = ss;
+}
+
 /*
 ========================
 idLobby::AllPeersHaveBaseState
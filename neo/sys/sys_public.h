@@ -68,7 +68,9 @@ enum cpuid_t
 	CPUID_FTZ							= ( 1 << 16 ),	// Flush-To-Zero mode (denormal results are flushed to zero)
 	CPUID_DAZ							= ( 1 << 17 ),	// Denormals-Are-Zero mode (denormal source operands are set to zero)
 	CPUID_XENON							= ( 1 << 18 ),	// Xbox 360
-	CPUID_CELL							= ( 1 << 19 )	// PS3
+	CPUID_CELL							= ( 1 << 19 ),	// PS3
+	CPUID_AVX							= ( 1 << 20 ),	// Advanced Vector Extensions
+	CPUID_AVX2							= ( 1 << 21 )	// Advanced Vector Extensions 2
 };
 
 enum fpuExceptions_t
@@ -705,6 +707,20 @@ typedef struct
 
 #define	PORT_ANY			-1
 
+/*
+================================================
+udpPacket_t
+================================================
+*/
+struct udpPacket_t
+{
+	static const int MAX_SIZE = 1500;
+	
+	netadr_t		address;
+	int				size;
+	uint8_t			data[MAX_SIZE];
+};
+
 /*
 ================================================
 idUDP
@@ -741,6 +757,14 @@ public:
 								   
 	void		SendPacket( const netadr_t to, const void* data, int size );
 	
+	// Batched versions, these use a single system call for many packets where the platform allows it (recvmmsg / sendmmsg)
+	// GetPackets returns the number of packets read without blocking, SendPackets the number of packets handed to the socket
+	int			GetPackets( udpPacket_t* packets, int maxPackets );
+	int			SendPackets( const udpPacket_t* packets, int numPackets );
+	
+	// Returns true if a packet can be read before timeout msec
+	bool		WaitForData( int timeout );
+	
 	void		SetSilent( bool silent )
 	{
 		this->silent = silent;
@@ -756,6 +780,9 @@ public:
 	int			packetsWritten;
 	int			bytesWritten;
 	
+	int			readCalls;		// system calls made to read / write the packets above
+	int			writeCalls;
+	
 	bool		IsOpen() const
 	{
 		return netSocket > 0;
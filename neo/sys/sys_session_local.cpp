@@ -33,6 +33,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "sys_session_local.h"
 #include "sys_voicechat.h"
 #include "sys_dedicated_server_search.h"
+#include "sys_loadtest.h"
 
 idCVar ui_skinIndex( "ui_skinIndex", "0", CVAR_ARCHIVE, "Selected skin index" );
 idCVar ui_autoSwitch( "ui_autoSwitch", "1", CVAR_ARCHIVE | CVAR_BOOL, "auto switch weapon" );
@@ -61,6 +62,8 @@ idCVar net_testPartyMemberConnectFail( "net_testPartyMemberConnectFail", "-1", C
 idCVar net_offlineTransitionThreshold( "net_offlineTransitionThreshold", "1000", CVAR_INTEGER, "Time, in milliseconds, to wait before kicking back to the main menu when a profile losses backend connection during an online game" );
 
 idCVar net_port( "net_port", "27015", CVAR_INTEGER | CVAR_NOCHEAT, "host port number" ); // Port to host when using dedicated servers, port to broadcast on when looking for a dedicated server to connect to
+idCVar net_ioThread( "net_ioThread", "1", CVAR_BOOL, "read and write the network port in batches on a dedicated thread, takes effect when the port is opened" );
+idCVar net_ioThreadWait( "net_ioThreadWait", "1", CVAR_INTEGER, "msec the network I/O thread waits for incoming packets before checking for packets to send", 0, 100 );
 idCVar net_headlessServer( "net_headlessServer", "0", CVAR_BOOL, "toggle to automatically host a game and allow peer[0] to control menus" );
 
 const char* idSessionLocal::stateToString[ NUM_STATES ] =
@@ -2104,6 +2107,9 @@ void idSessionLocal::Pump()
 	GetGameLobby().PumpPackets();
 	GetGameStateLobby().PumpPackets();
 	
+	// Pump the simulated clients of a running net_loadTest
+	netLoadTest.Pump();
+	
 	int currentTime = Sys_Milliseconds();
 	
 	const int SHOW_MIGRATING_INFO_IN_SECONDS = 3;	// Show for at least this long once we start showing it
@@ -2452,16 +2458,17 @@ void idSessionLocal::SendUsercmds( idBitMsg& msg )
 		}
 		uint16_t incomingBPS_quantized = idMath::Ftoi( incomingBPS * ( ( BIT( idLobby::BANDWIDTH_REPORTING_BITS ) - 1 )  / idLobby::BANDWIDTH_REPORTING_MAX ) );
 		
-		byte buffer[idPacketProcessor::MAX_FINAL_PACKET_SIZE];
+		// Compress straight into a packet buffer, the packet processor sends it from there
+		idPacketBuffer* packet = packetBufferPool.Alloc();
 		lzwCompressionData_t lzwData;
 		idLZWCompressor lzwCompressor( &lzwData );
-		lzwCompressor.Start( buffer, sizeof( buffer ) );
+		lzwCompressor.Start( packet->GetPayload(), idPacketProcessor::MAX_FINAL_PACKET_SIZE );
 		lzwCompressor.WriteAgnostic( sequence );
 		lzwCompressor.WriteAgnostic( incomingBPS_quantized );
 		lzwCompressor.Write( msg.GetReadData(), msg.GetSize() );
 		lzwCompressor.End();
 		
-		GetActingGameStateLobby().ProcessOutgoingMsg( GetActingGameStateLobby().host, buffer, lzwCompressor.Length(), false, 0 );
+		GetActingGameStateLobby().ProcessOutgoingPacket( GetActingGameStateLobby().host, packet, lzwCompressor.Length(), false, 0 );
 		
 		if( net_debugBaseStates.GetBool() && sequence < 50 )
 		{
@@ -2477,6 +2484,8 @@ idSessionLocal::SendSnapshot
 */
 void idSessionLocal::SendSnapshot( idSnapShot& ss )
 {
+	GetActingGameStateLobby().ShareSnapshot( ss );
+	
 	for( int p = 0; p < GetActingGameStateLobby().peers.Num(); p++ )
 	{
 		idLobby::peer_t& peer = GetActingGameStateLobby().peers[p];
@@ -2738,6 +2747,8 @@ bool idSessionLocal::HandlePackets()
 {
 	SCOPED_PROFILE_EVENT( "Session::HandlePackets" );
 	
+	GetPort().BeginTick();
+	
 	byte				packetBuffer[ idPacketProcessor::MAX_FINAL_PACKET_SIZE ];
 	lobbyAddress_t		remoteAddress;
 	int					recvSize = 0;
@@ -4446,6 +4457,146 @@ void lobbyAddress_t::ReadFromMsg( idBitMsg& msg )
 	msg.ReadData( &netAddr, sizeof( netAddr ) );
 }
 
+/*
+================================================================================================
+idNetIOThread
+================================================================================================
+*/
+
+/*
+================================================
+idNetPacketRing
+
+Single producer / single consumer ring of packets, the producer only moves head and the
+consumer only moves tail, so the two threads never wait on each other.
+================================================
+*/
+template< int SIZE >
+class idNetPacketRing
+{
+public:
+	idNetPacketRing() : head( 0 ), tail( 0 ) {}
+	
+	// Producer: contiguous free slots starting at the returned packet, call CommitWrite with how many were filled
+	udpPacket_t* 	BeginWrite( int& num )
+	{
+		const int offset = head & ( SIZE - 1 );
+		num = Min( SIZE - ( head - tail ), SIZE - offset );
+		return &packets[offset];
+	}
+	void			CommitWrite( int num )
+	{
+		SYS_MEMORYBARRIER;
+		head += num;
+	}
+	
+	// Consumer: contiguous filled slots starting at the returned packet, call CommitRead with how many were used
+	udpPacket_t* 	BeginRead( int& num )
+	{
+		const int offset = tail & ( SIZE - 1 );
+		num = Min( head - tail, SIZE - offset );
+		SYS_MEMORYBARRIER;
+		return &packets[offset];
+	}
+	void			CommitRead( int num )
+	{
+		SYS_MEMORYBARRIER;
+		tail += num;
+	}
+	
+private:
+	udpPacket_t		packets[SIZE];
+	volatile int	head;
+	volatile int	tail;
+};
+
+/*
+================================================
+netIOStats_t
+================================================
+*/
+struct netIOStats_t
+{
+	idSysInterlockedInteger	ticks;
+	idSysInterlockedInteger	readCalls;
+	idSysInterlockedInteger	packetsRead;
+	idSysInterlockedInteger	writeCalls;
+	idSysInterlockedInteger	packetsWritten;
+	idSysInterlockedInteger	recvQueueFull;		// times the I/O thread left packets in the socket because the game didn't keep up
+	idSysInterlockedInteger	sendQueueDropped;	// packets dropped because the I/O thread didn't make room for them in time
+};
+
+static netIOStats_t netIOStats;
+
+/*
+================================================
+idNetIOThread
+
+Owns the socket while it runs: drains it with as few reads as possible into recvQueue,
+and writes whatever the game queued in sendQueue in one go.
+================================================
+*/
+class idNetIOThread : public idSysThread
+{
+public:
+	static const int QUEUE_SIZE = 512;
+	
+	idNetIOThread( idUDP& udp_ ) : udp( udp_ ) {}
+	
+	virtual int Run()
+	{
+		while( !IsTerminating() )
+		{
+			int numToSend = 0;
+			udpPacket_t* send = sendQueue.BeginRead( numToSend );
+			if( numToSend > 0 )
+			{
+				const int writeCalls = udp.writeCalls;
+				udp.SendPackets( send, numToSend );
+				sendQueue.CommitRead( numToSend );
+				
+				netIOStats.writeCalls.Add( udp.writeCalls - writeCalls );
+				netIOStats.packetsWritten.Add( numToSend );
+			}
+			
+			int numFree = 0;
+			udpPacket_t* recv = recvQueue.BeginWrite( numFree );
+			int numRead = 0;
+			if( numFree > 0 )
+			{
+				const int readCalls = udp.readCalls;
+				numRead = udp.GetPackets( recv, numFree );
+				recvQueue.CommitWrite( numRead );
+				
+				netIOStats.readCalls.Add( udp.readCalls - readCalls );
+				netIOStats.packetsRead.Add( numRead );
+			}
+			else
+			{
+				netIOStats.recvQueueFull.Increment();
+			}
+			
+			if( numFree == 0 )
+			{
+				// The socket has data, but the game hasn't made room for it yet
+				Sys_Sleep( 1 );
+			}
+			else if( numToSend == 0 && numRead == 0 )
+			{
+				// Nothing to do, sleep until there is something to read, sends wait at most net_ioThreadWait msec
+				udp.WaitForData( net_ioThreadWait.GetInteger() );
+			}
+		}
+		return 0;
+	}
+	
+	idNetPacketRing< QUEUE_SIZE >	recvQueue;		// I/O thread -> game thread
+	idNetPacketRing< QUEUE_SIZE >	sendQueue;		// game thread -> I/O thread
+	
+private:
+	idUDP& 							udp;
+};
+
 /*
 ================================================================================================
 idNetSessionPort
@@ -4459,8 +4610,19 @@ idNetSessionPort::idNetSessionPort
 */
 idNetSessionPort::idNetSessionPort() :
 	forcePacketDropCurr( 0.0f ),
-	forcePacketDropPrev( 0.0f )
+	forcePacketDropPrev( 0.0f ),
+	ioThread( NULL )
+{
+}
+
+/*
+========================
+idNetSessionPort::~idNetSessionPort
+========================
+*/
+idNetSessionPort::~idNetSessionPort()
 {
+	Close();
 }
 
 /*
@@ -4470,7 +4632,18 @@ idNetSessionPort::InitPort
 */
 bool idNetSessionPort::InitPort( int portNumber, bool useBackend )
 {
-	return UDP.InitForPort( portNumber );
+	if( !UDP.InitForPort( portNumber ) )
+	{
+		return false;
+	}
+	
+	if( net_ioThread.GetBool() )
+	{
+		ioThread = new( TAG_NETWORKING ) idNetIOThread( UDP );
+		ioThread->StartThread( "NetIO", CORE_ANY, THREAD_ABOVE_NORMAL );
+	}
+	
+	return true;
 }
 
 /*
@@ -4480,7 +4653,29 @@ idNetSessionPort::ReadRawPacket
 */
 bool idNetSessionPort::ReadRawPacket( lobbyAddress_t& from, void* data, int& size, int maxSize )
 {
-	bool result = UDP.GetPacket( from.netAddr, data, size, maxSize );
+	bool result = false;
+	
+	if( ioThread != NULL )
+	{
+		int num = 0;
+		const udpPacket_t* packet = ioThread->recvQueue.BeginRead( num );
+		if( num > 0 )
+		{
+			from.netAddr = packet->address;
+			size = Min( packet->size, maxSize );
+			memcpy( data, packet->data, size );
+			ioThread->recvQueue.CommitRead( 1 );
+			result = true;
+		}
+	}
+	else
+	{
+		const int readCalls = UDP.readCalls;
+		result = UDP.GetPacket( from.netAddr, data, size, maxSize );
+		
+		netIOStats.readCalls.Add( UDP.readCalls - readCalls );
+		netIOStats.packetsRead.Add( result ? 1 : 0 );
+	}
 	
 	static idRandom2 random( Sys_Milliseconds() );
 	if( net_forceDrop.GetInteger() != 0 )
@@ -4509,7 +4704,38 @@ void idNetSessionPort::SendRawPacket( const lobbyAddress_t& to, const void* data
 	}
 	assert( size <= idPacketProcessor::MAX_FINAL_PACKET_SIZE );
 	
+	if( ioThread != NULL )
+	{
+		int num = 0;
+		udpPacket_t* packet = ioThread->sendQueue.BeginWrite( num );
+		
+		// The I/O thread is behind, give it a moment to make room. Sending from this thread
+		// would reorder the packets and race the I/O thread on the socket, so drop it after that.
+		const int waitStart = Sys_Milliseconds();
+		while( num == 0 && Sys_Milliseconds() - waitStart <= net_ioThreadWait.GetInteger() + 1 )
+		{
+			Sys_Yield();
+			packet = ioThread->sendQueue.BeginWrite( num );
+		}
+		
+		if( num > 0 )
+		{
+			packet->address = to.netAddr;
+			packet->size = size;
+			memcpy( packet->data, data, size );
+			ioThread->sendQueue.CommitWrite( 1 );
+		}
+		else
+		{
+			netIOStats.sendQueueDropped.Increment();
+		}
+		return;
+	}
+	
 	UDP.SendPacket( to.netAddr, data, size );
+	
+	netIOStats.writeCalls.Increment();
+	netIOStats.packetsWritten.Increment();
 }
 
 /*
@@ -4529,9 +4755,26 @@ idNetSessionPort::Close
 */
 void idNetSessionPort::Close()
 {
+	if( ioThread != NULL )
+	{
+		ioThread->StopThread();
+		delete ioThread;
+		ioThread = NULL;
+	}
+	
 	UDP.Close();
 }
 
+/*
+========================
+idNetSessionPort::BeginTick
+========================
+*/
+void idNetSessionPort::BeginTick()
+{
+	netIOStats.ticks.Increment();
+}
+
 /*
 ================================================================================================
 Commands
@@ -4540,6 +4783,36 @@ Commands
 
 //====================================================================================
 
+/*
+========================
+net_printIOStats
+========================
+*/
+CONSOLE_COMMAND( net_printIOStats, "Prints system calls per session tick and packets per system call of the network port. usage: net_printIOStats [reset]", 0 )
+{
+	const int ticks = Max( netIOStats.ticks.GetValue(), 1 );
+	const int readCalls = netIOStats.readCalls.GetValue();
+	const int writeCalls = netIOStats.writeCalls.GetValue();
+	const int packetsRead = netIOStats.packetsRead.GetValue();
+	const int packetsWritten = netIOStats.packetsWritten.GetValue();
+	
+	idLib::Printf( "%d ticks, I/O thread %s\n", netIOStats.ticks.GetValue(), net_ioThread.GetBool() ? "on" : "off" );
+	idLib::Printf( "read:  %8d calls %8d packets  %6.2f calls/tick  %6.2f packets/call\n", readCalls, packetsRead, ( float )readCalls / ticks, ( float )packetsRead / Max( readCalls, 1 ) );
+	idLib::Printf( "write: %8d calls %8d packets  %6.2f calls/tick  %6.2f packets/call\n", writeCalls, packetsWritten, ( float )writeCalls / ticks, ( float )packetsWritten / Max( writeCalls, 1 ) );
+	idLib::Printf( "receive queue full %d times, %d packets dropped with a full send queue\n", netIOStats.recvQueueFull.GetValue(), netIOStats.sendQueueDropped.GetValue() );
+	
+	if( args.Argc() > 1 && idStr::Icmp( args.Argv( 1 ), "reset" ) == 0 )
+	{
+		netIOStats.ticks.SetValue( 0 );
+		netIOStats.readCalls.SetValue( 0 );
+		netIOStats.packetsRead.SetValue( 0 );
+		netIOStats.writeCalls.SetValue( 0 );
+		netIOStats.packetsWritten.SetValue( 0 );
+		netIOStats.recvQueueFull.SetValue( 0 );
+		netIOStats.sendQueueDropped.SetValue( 0 );
+	}
+}
+
 CONSOLE_COMMAND( voicechat_mute, "TEMP", 0 )
 {
 	if( args.Argc() != 2 )
@@ -79,7 +79,7 @@ const vidMode_t *crDisplaySDL::Modes( uint32_t *in_count ) const
     return m_modes.Ptr();
 }
 
-crVideoSDL3::crVideoSDL3( void ) : m_grabbed( false ), m_vulkan( false )
+crVideoSDL3::crVideoSDL3( void ) : m_grabbed( false ), m_vulkan( false ), m_noDriver( false )
 {
 }
 
@@ -111,6 +111,12 @@ bool crVideoSDL3::StartUp( const uint32_t in_flags )
         if( !SDL_Vulkan_LoadLibrary( nullptr ) )
 			common->Error( "SDL Error while loading Vulkan Library : %s", SDL_GetError() );
     }
+    else if( idStr::Icmp( cvarSystem->GetCVarString( "r_glDriver" ), "null" ) == 0 )
+    {
+        // the null GL driver doesn't need a GL capable window, this also
+        // works with SDL_VIDEO_DRIVER=dummy or offscreen on machines without a display
+        m_noDriver = true;
+    }
     else
     {
         windowflags |= SDL_WINDOW_OPENGL;
@@ -151,7 +157,7 @@ void crVideoSDL3::ShutDown(void)
 
     if( m_vulkan )
         SDL_Vulkan_UnloadLibrary();
-    else
+    else if( !m_noDriver )
         SDL_GL_UnloadLibrary();
 }
 
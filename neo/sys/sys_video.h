@@ -44,6 +44,7 @@ public:
 private:
     bool                                m_grabbed;
     bool                                m_vulkan;
+    bool                                m_noDriver;     // r_glDriver "null", no GL library loaded
     SDL::Window                         m_mainWindow;
     idList<crDisplay*, TAG_VIDEO_SYS>   m_displays;
 };